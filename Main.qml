@@ -2,6 +2,7 @@ import QtQuick
 import QtQuick.Controls
 import RailFlux.Database
 import "layouts" as Layouts
+import "components" as Components
 
 ApplicationWindow {
     id: mainWindow
@@ -23,7 +24,9 @@ ApplicationWindow {
             // ✅ DIRECT property update
             connectionStatus.connected = isConnected
 
-            if (isConnected) {
+            if (isConnected && globalDatabaseManager.isStale) {
+                console.log("🔄 Database session resumed - applying changed rows only")
+            } else if (isConnected) {
                 console.log("✅ Database connected - refreshing all station data")
                 stationLayout.refreshAllData()
             } else {
@@ -36,35 +39,40 @@ ApplicationWindow {
             stationLayout.refreshAllData()
         }
 
+        // Qt.callLater coalesces bursts (e.g. a reconnect resync) into one reload per table
         function onSignalUpdated(signalId) {
             console.log("🚦 Signal updated:", signalId)
-            stationLayout.refreshSignalData()
+            Qt.callLater(stationLayout.refreshSignalData)
         }
 
         function onPointMachineUpdated(machineId) {
             console.log("🔄 Point machine updated:", machineId)
-            stationLayout.refreshPointMachineData()
+            Qt.callLater(stationLayout.refreshPointMachineData)
         }
 
         function onTrackSegmentUpdated(segmentId) {
             console.log("🛤️ Track segment updated:", segmentId)
-            stationLayout.refreshTrackData()
+            Qt.callLater(stationLayout.refreshTrackData)
         }
 
         function onTrackSegmentsChanged() {
-            stationLayout.refreshTrackData()
+            Qt.callLater(stationLayout.refreshTrackData)
         }
 
         function onSignalsChanged() {
-            stationLayout.refreshSignalData()
+            Qt.callLater(stationLayout.refreshSignalData)
         }
 
         function onPointMachinesChanged() {
-            stationLayout.refreshPointMachineData()
+            Qt.callLater(stationLayout.refreshPointMachineData)
         }
 
         function onTextLabelsChanged() {
-            stationLayout.refreshTextLabelData()
+            Qt.callLater(stationLayout.refreshTextLabelData)
+        }
+
+        function onReconnectScheduled(attempt, delayMs) {
+            console.log("🔌 Database reconnect attempt", attempt, "in", delayMs, "ms")
         }
 
         function onErrorOccurred(error) {
@@ -86,8 +94,8 @@ ApplicationWindow {
             if (success && globalDatabaseManager) {
                 console.log("Database reset successful - reconnecting and refreshing data")
 
-                // Give database a moment to settle
-                reconnectTimer.start()
+                // Reopened in the background; the restarted change log forces a full reload
+                globalDatabaseManager.reconnect()
             }
         }
 
@@ -105,38 +113,14 @@ ApplicationWindow {
         }
     }
 
-    // ✅ NEW: Timer for database reconnection after reset
-    Timer {
-        id: reconnectTimer
-        interval: 2000  // Wait 2 seconds for database to settle
-        running: false
-        repeat: false
-
-        onTriggered: {
-            console.log("Attempting to reconnect to database after reset")
-            if (globalDatabaseManager) {
-                globalDatabaseManager.connectToDatabase()
-                globalDatabaseManager.startPolling()
-
-                // Give connection time to establish, then refresh data
-                Qt.callLater(function() {
-                    if (globalDatabaseManager.isConnected) {
-                        stationLayout.refreshAllData()
-                    }
-                })
-            }
-        }
-    }
-
     // ✅ NEW: Application initialization
     Component.onCompleted: {
         console.log("🚀 RailFlux application starting up")
 
-        // Initialize database connection if not already connected
-        if (globalDatabaseManager && !globalDatabaseManager.isConnected) {
-            console.log("🔌 Initializing database connection")
-            globalDatabaseManager.connectToDatabase()
-            globalDatabaseManager.startPolling()
+        // main.cpp starts the connection before the engine loads; data
+        // arrives through onConnectionStateChanged when it is up
+        if (globalDatabaseManager && globalDatabaseManager.isConnecting) {
+            console.log("🔌 Database connection in progress")
         }
 
         // ✅ ADD: Update UI connection state immediately
@@ -569,11 +553,12 @@ ApplicationWindow {
                     width: 12
                     height: 12
                     radius: 6
-                    color: connectionStatus.connected ? theme.successGreen : theme.dangerRed
+                    color: connectionStatus.stale ? theme.warningYellow
+                         : connectionStatus.connected ? theme.successGreen : theme.dangerRed
                     anchors.verticalCenter: parent.verticalCenter
 
                     SequentialAnimation on opacity {
-                        running: connectionStatus.connected
+                        running: connectionStatus.connected || connectionStatus.stale
                         loops: Animation.Infinite
                         NumberAnimation { to: 0.5; duration: 1000 }
                         NumberAnimation { to: 1.0; duration: 1000 }
@@ -583,10 +568,16 @@ ApplicationWindow {
                 Text {
                     id: connectionStatus
                     property bool connected: false  // ✅ LOCAL STATE VARIABLE
+                    readonly property bool stale: globalDatabaseManager ? globalDatabaseManager.isStale : false
 
-                    text: connected ? "Database Connected" : "Database Disconnected"
+                    readonly property bool connecting: globalDatabaseManager ? globalDatabaseManager.isConnecting : false
+
+                    text: stale ? "Reconnecting - showing last known state (attempt "
+                                  + globalDatabaseManager.reconnectAttempts + ")"
+                        : connected ? "Database Connected"
+                        : connecting ? "Starting Database..." : "Database Disconnected"
                     font.pixelSize: 14
-                    color: connected ? theme.successGreen : theme.dangerRed
+                    color: stale || connecting ? theme.warningYellow : connected ? theme.successGreen : theme.dangerRed
                     anchors.verticalCenter: parent.verticalCenter
 
                     // ✅ Debug output
@@ -646,6 +637,30 @@ ApplicationWindow {
                 }
             }
 
+            Button {
+                width: 32
+                height: 32
+                text: "⏱"
+                ToolTip.text: "Command latency diagnostics"
+                ToolTip.visible: hovered
+
+                onClicked: latencyPanel.visible = !latencyPanel.visible
+
+                background: Rectangle {
+                    color: parent.hovered || latencyPanel.visible ? theme.accentBlue : "transparent"
+                    border.color: theme.borderColor
+                    border.width: 1
+                    radius: 4
+                }
+
+                contentItem: Text {
+                    text: parent.text
+                    color: theme.textPrimary
+                    horizontalAlignment: Text.AlignHCenter
+                    verticalAlignment: Text.AlignVCenter
+                }
+            }
+
             Button {
                 width: 80
                 height: 32
@@ -677,9 +692,23 @@ ApplicationWindow {
 
         // Pass database manager to station layout
         dbManager: globalDatabaseManager
+        trackTopology: globalTrackTopology
+        spatialIndex: globalSpatialIndex
+        pointTransitions: globalPointTransitions
         onDatabaseResetRequested: {
             console.log("Opening database reset dialog from status panel")
             databaseResetDialog.open()
         }
     }
+
+    // Command latency diagnostics overlay (toggled from the header)
+    Components.LatencyDiagnosticsPanel {
+        id: latencyPanel
+        anchors.top: parent.top
+        anchors.right: parent.right
+        anchors.margins: theme.spacingMedium
+        visible: false
+        tracer: globalCommandTracer
+        simulator: globalTrainSimulator
+    }
 }
@@ -0,0 +1,418 @@
+// Micro-benchmarks for DatabaseManager hot paths.
+//
+// Starts a throwaway PostgreSQL cluster, loads the schema and station data
+// through DatabaseInitializer and then measures per-call latency and heap
+// allocations of the list getters, by-ID getters, update functions and the
+// notification handler. Results are written as JSON with a stable key order
+// so two builds can be compared with a plain diff.
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTimer>
+#include <QDebug>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <vector>
+
+#include "database/databasemanager.h"
+#include "database/databaseinitializer.h"
+#include "broker/stationwire.h"
+#include "throwawaypostgres.h"
+
+// ============================================================================
+// ALLOCATION COUNTING
+// ============================================================================
+// Qt containers allocate through malloc() rather than operator new, so on
+// glibc the C allocator itself is interposed. Elsewhere only operator new is
+// visible, which still covers std::map-backed QVariantMap nodes.
+
+namespace {
+std::atomic<quint64> g_allocationCount{0};
+std::atomic<quint64> g_allocatedBytes{0};
+
+inline void countAllocation(std::size_t size)
+{
+    g_allocationCount.fetch_add(1, std::memory_order_relaxed);
+    g_allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+}
+}
+
+#if defined(__GLIBC__)
+extern "C" {
+void* __libc_malloc(std::size_t size);
+void* __libc_calloc(std::size_t count, std::size_t size);
+void* __libc_realloc(void* pointer, std::size_t size);
+
+void* malloc(std::size_t size)
+{
+    countAllocation(size);
+    return __libc_malloc(size);
+}
+
+void* calloc(std::size_t count, std::size_t size)
+{
+    countAllocation(count * size);
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* pointer, std::size_t size)
+{
+    countAllocation(size);
+    return __libc_realloc(pointer, size);
+}
+}
+#else
+void* operator new(std::size_t size)
+{
+    countAllocation(size);
+    if (void* pointer = std::malloc(size ? size : 1)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    countAllocation(size);
+    return std::malloc(size ? size : 1);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept
+{
+    return operator new(size, tag);
+}
+
+void operator delete(void* pointer) noexcept { std::free(pointer); }
+void operator delete[](void* pointer) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::size_t) noexcept { std::free(pointer); }
+void operator delete[](void* pointer, std::size_t) noexcept { std::free(pointer); }
+#endif
+
+// ============================================================================
+// MEASUREMENT
+// ============================================================================
+
+namespace {
+
+struct BenchmarkResult {
+    QString name;
+    QString group;
+    int iterations = 0;
+    double meanUs = 0;
+    double minUs = 0;
+    double p50Us = 0;
+    double p99Us = 0;
+    double maxUs = 0;
+    double allocationsPerCall = 0;
+    double bytesPerCall = 0;
+};
+
+double percentile(const std::vector<qint64>& sortedNs, double fraction)
+{
+    if (sortedNs.empty()) return 0;
+    const size_t index = std::min(sortedNs.size() - 1, static_cast<size_t>(fraction * (sortedNs.size() - 1) + 0.5));
+    return sortedNs[index] / 1000.0;
+}
+
+BenchmarkResult runBenchmark(const QString& group, const QString& name,
+                             int warmup, int iterations,
+                             const std::function<void(int)>& body)
+{
+    for (int i = 0; i < warmup; ++i) {
+        body(i);
+    }
+
+    std::vector<qint64> samples;
+    samples.reserve(iterations);
+    quint64 allocations = 0;
+    quint64 bytes = 0;
+    QElapsedTimer timer;
+
+    for (int i = 0; i < iterations; ++i) {
+        const quint64 allocationsBefore = g_allocationCount.load(std::memory_order_relaxed);
+        const quint64 bytesBefore = g_allocatedBytes.load(std::memory_order_relaxed);
+
+        timer.start();
+        body(warmup + i);
+        samples.push_back(timer.nsecsElapsed());
+
+        allocations += g_allocationCount.load(std::memory_order_relaxed) - allocationsBefore;
+        bytes += g_allocatedBytes.load(std::memory_order_relaxed) - bytesBefore;
+    }
+
+    std::sort(samples.begin(), samples.end());
+
+    BenchmarkResult result;
+    result.group = group;
+    result.name = name;
+    result.iterations = iterations;
+    double total = 0;
+    for (qint64 sample : samples) total += sample;
+    result.meanUs = iterations > 0 ? total / iterations / 1000.0 : 0;
+    result.minUs = percentile(samples, 0.0);
+    result.p50Us = percentile(samples, 0.50);
+    result.p99Us = percentile(samples, 0.99);
+    result.maxUs = percentile(samples, 1.0);
+    result.allocationsPerCall = iterations > 0 ? double(allocations) / iterations : 0;
+    result.bytesPerCall = iterations > 0 ? double(bytes) / iterations : 0;
+
+    qInfo().noquote() << QString("  %1 %2  p50=%3us p99=%4us allocs=%5")
+                             .arg(group, -12).arg(name, -36)
+                             .arg(result.p50Us, 0, 'f', 1)
+                             .arg(result.p99Us, 0, 'f', 1)
+                             .arg(result.allocationsPerCall, 0, 'f', 1);
+    return result;
+}
+
+QJsonObject toJson(const BenchmarkResult& result)
+{
+    // Rounded so that noise below 0.01us does not show up in diffs
+    auto round2 = [](double value) { return std::round(value * 100.0) / 100.0; };
+
+    QJsonObject object;
+    object["name"] = result.name;
+    object["group"] = result.group;
+    object["iterations"] = result.iterations;
+    object["mean_us"] = round2(result.meanUs);
+    object["min_us"] = round2(result.minUs);
+    object["p50_us"] = round2(result.p50Us);
+    object["p99_us"] = round2(result.p99Us);
+    object["max_us"] = round2(result.maxUs);
+    object["allocations_per_call"] = round2(result.allocationsPerCall);
+    object["bytes_per_call"] = round2(result.bytesPerCall);
+    return object;
+}
+
+// qDebug() formatting still runs (it is part of the hot path being measured),
+// but console I/O is dropped so the terminal does not dominate the timings.
+bool g_verbose = false;
+void benchmarkMessageHandler(QtMsgType type, const QMessageLogContext& context, const QString& message)
+{
+    if (type == QtDebugMsg && !g_verbose) {
+        return;
+    }
+    Q_UNUSED(context);
+    fprintf(stderr, "%s\n", qPrintable(message));
+}
+
+bool populateStation(const QString& host, int port, int scale)
+{
+    DatabaseInitializer initializer;
+    initializer.setSystemServer(host, port);
+
+    bool success = false;
+    QEventLoop loop;
+    QObject::connect(&initializer, &DatabaseInitializer::resetCompleted, &loop,
+                     [&](bool ok, const QString& message) {
+                         success = ok;
+                         if (!ok) qWarning() << "❌ Station population failed:" << message;
+                         loop.quit();
+                     });
+    if (scale > 1) {
+        initializer.resetDatabaseWithSyntheticStationAsync(scale);
+    } else {
+        initializer.resetDatabaseAsync();
+    }
+    loop.exec();
+
+    return success;
+}
+
+QVariant notificationPayload(const QString& table, const QString& entityId)
+{
+    QJsonObject payload;
+    payload["table"] = table;
+    payload["operation"] = "UPDATE";
+    payload["id"] = 1;
+    payload["entity_id"] = entityId;
+    payload["timestamp"] = QDateTime::currentMSecsSinceEpoch() / 1000.0;
+    return QString::fromUtf8(QJsonDocument(payload).toJson(QJsonDocument::Compact));
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("railfluxBenchmarks");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("RailFlux DatabaseManager micro-benchmarks");
+    parser.addHelpOption();
+    QCommandLineOption binOption("pg-bin", "Directory containing initdb and pg_ctl.", "dir");
+    QCommandLineOption portOption("port", "Port for the throwaway server (default 55432).", "port", "55432");
+    QCommandLineOption iterationsOption("iterations", "Measured iterations per benchmark (default 200).", "n", "200");
+    QCommandLineOption warmupOption("warmup", "Warm-up iterations per benchmark (default 20).", "n", "20");
+    QCommandLineOption scaleOption("scale", "Synthetic station size relative to the built-in one (default 1 = built-in).", "factor", "1");
+    QCommandLineOption outputOption({"o", "output"}, "Write JSON results to this file instead of stdout.", "file");
+    QCommandLineOption verboseOption("verbose", "Print DatabaseManager debug output.");
+    parser.addOptions({binOption, portOption, iterationsOption, warmupOption, scaleOption, outputOption, verboseOption});
+    parser.process(app);
+
+    g_verbose = parser.isSet(verboseOption);
+    qInstallMessageHandler(benchmarkMessageHandler);
+
+    const int iterations = std::max(1, parser.value(iterationsOption).toInt());
+    const int warmup = std::max(0, parser.value(warmupOption).toInt());
+    const int scale = std::max(1, parser.value(scaleOption).toInt());
+
+    ThrowawayPostgres server(ThrowawayPostgres::locateBinDirectory(parser.value(binOption)),
+                             parser.value(portOption).toInt());
+    if (!server.start() || !server.createDatabase("railway_control_system")) {
+        qCritical() << "❌ Could not prepare throwaway PostgreSQL:" << server.lastError();
+        return 1;
+    }
+
+    if (!populateStation(server.hostName(), server.port(), scale)) {
+        return 1;
+    }
+
+    DatabaseManager manager;
+    manager.setSystemServer(server.hostName(), server.port());
+    if (!manager.connectToSystemPostgreSQL()) {
+        qCritical() << "❌ DatabaseManager could not connect to the throwaway server";
+        return 1;
+    }
+
+    qInfo() << "📊 Running benchmarks:" << iterations << "iterations," << warmup << "warm-up";
+    std::vector<BenchmarkResult> results;
+
+    // List getters
+    results.push_back(runBenchmark("list", "getTrackSegmentsList", warmup, iterations,
+                                   [&](int) { manager.getTrackSegmentsList(); }));
+    results.push_back(runBenchmark("list", "getAllSignalsList", warmup, iterations,
+                                   [&](int) { manager.getAllSignalsList(); }));
+    results.push_back(runBenchmark("list", "getOuterSignalsList", warmup, iterations,
+                                   [&](int) { manager.getOuterSignalsList(); }));
+    results.push_back(runBenchmark("list", "getAllPointMachinesList", warmup, iterations,
+                                   [&](int) { manager.getAllPointMachinesList(); }));
+    results.push_back(runBenchmark("list", "getTextLabelsList", warmup, iterations,
+                                   [&](int) { manager.getTextLabelsList(); }));
+    results.push_back(runBenchmark("list", "getTrackSegmentInfos", warmup, iterations,
+                                   [&](int) { manager.getTrackSegmentInfos(); }));
+    results.push_back(runBenchmark("list", "getSignalInfos", warmup, iterations,
+                                   [&](int) { manager.getSignalInfos(); }));
+    results.push_back(runBenchmark("list", "getPointMachineInfos", warmup, iterations,
+                                   [&](int) { manager.getPointMachineInfos(); }));
+    results.push_back(runBenchmark("list", "getStationSnapshot", warmup, iterations,
+                                   [&](int) { manager.getStationSnapshot(); }));
+
+    // By-ID getters
+    results.push_back(runBenchmark("by_id", "getSignalById", warmup, iterations,
+                                   [&](int) { manager.getSignalById("HM001"); }));
+    results.push_back(runBenchmark("by_id", "getTrackSegmentById", warmup, iterations,
+                                   [&](int) { manager.getTrackSegmentById("T1S4"); }));
+    results.push_back(runBenchmark("by_id", "getPointMachineById", warmup, iterations,
+                                   [&](int) { manager.getPointMachineById("PM001"); }));
+
+    // Updates alternate between two states so every call really writes a row
+    results.push_back(runBenchmark("update", "updateSignalAspect", warmup, iterations,
+                                   [&](int i) { manager.updateSignalAspect("HM001", (i % 2) ? "YELLOW" : "RED"); }));
+    results.push_back(runBenchmark("update", "updatePointMachinePosition", warmup, iterations,
+                                   [&](int i) { manager.updatePointMachinePosition("PM001", (i % 2) ? "NORMAL" : "REVERSE"); }));
+    results.push_back(runBenchmark("update", "updateTrackOccupancy", warmup, iterations,
+                                   [&](int i) { manager.updateTrackOccupancy("T1S4", i % 2 == 0); }));
+    results.push_back(runBenchmark("update", "updateTrackAssignment", warmup, iterations,
+                                   [&](int i) { manager.updateTrackAssignment("T1S4", i % 2 == 0); }));
+
+    // Notification handling is a private slot; drive it through the meta-object
+    // system exactly like the QSqlDriver::notification connection does.
+    const QStringList notificationTables = {"signals", "point_machines", "track_segments"};
+    const QStringList notificationEntities = {"HM001", "PM001", "T1S4"};
+    for (int t = 0; t < notificationTables.size(); ++t) {
+        const QVariant payload = notificationPayload(notificationTables[t], notificationEntities[t]);
+        results.push_back(runBenchmark("notification", "handleDatabaseNotification/" + notificationTables[t],
+                                       warmup, iterations, [&](int) {
+                                           QMetaObject::invokeMethod(&manager, "handleDatabaseNotification",
+                                                                     Qt::DirectConnection,
+                                                                     Q_ARG(QString, QStringLiteral("railway_changes")),
+                                                                     Q_ARG(QVariant, payload));
+                                       }));
+    }
+
+    // Station state wire format (broker snapshots and deltas)
+    StationStateStore store;
+    store.reset(manager.activeStation(), manager.getTrackSegmentsList(), manager.getAllSignalsList(),
+                manager.getAllPointMachinesList(), manager.getTextLabelsList());
+    const QByteArray snapshot = StationWire::encodeSnapshot(store);
+    const int deltaRow = store.indexOf(StationStateStore::TrackSegments, "T1S4");
+    const QVariantMap deltaState = store.rowAt(StationStateStore::TrackSegments, deltaRow);
+
+    results.push_back(runBenchmark("wire", "encodeSnapshot", warmup, iterations,
+                                   [&](int) { StationWire::encodeSnapshot(store); }));
+    results.push_back(runBenchmark("wire", "decodeSnapshot", warmup, iterations, [&](int) {
+        StationStateStore decoded;
+        StationWire::decodeSnapshot(snapshot, &decoded);
+    }));
+    results.push_back(runBenchmark("wire", "StateView::parse", warmup, iterations, [&](int) {
+        StationWire::StateView view;
+        view.parse(snapshot);
+    }));
+    results.push_back(runBenchmark("wire", "encodeDelta", warmup, iterations, [&](int i) {
+        StationWire::encodeDelta(quint64(i), StationStateStore::TrackSegments, deltaRow, deltaState);
+    }));
+
+    QJsonObject jsonSnapshot;
+    jsonSnapshot["tracks"] = QJsonArray::fromVariantList(store.rows(StationStateStore::TrackSegments));
+    jsonSnapshot["signals"] = QJsonArray::fromVariantList(store.rows(StationStateStore::Signals));
+    jsonSnapshot["points"] = QJsonArray::fromVariantList(store.rows(StationStateStore::PointMachines));
+    jsonSnapshot["labels"] = QJsonArray::fromVariantList(store.textLabels());
+
+    QJsonObject wireSizes;
+    wireSizes["snapshot_bytes"] = snapshot.size();
+    wireSizes["snapshot_json_bytes"] = QJsonDocument(jsonSnapshot).toJson(QJsonDocument::Compact).size();
+    wireSizes["delta_bytes"] = StationWire::encodeDelta(1, StationStateStore::TrackSegments, deltaRow, deltaState).size();
+
+    std::sort(results.begin(), results.end(), [](const BenchmarkResult& a, const BenchmarkResult& b) {
+        return a.group == b.group ? a.name < b.name : a.group < b.group;
+    });
+
+    QJsonArray resultArray;
+    for (const BenchmarkResult& result : results) {
+        resultArray.append(toJson(result));
+    }
+
+    QJsonObject report;
+    report["schema_version"] = 1;
+    report["qt_version"] = QString::fromLatin1(qVersion());
+    report["postgres_version"] = server.serverVersion();
+    report["iterations"] = iterations;
+    report["warmup"] = warmup;
+    report["scale"] = scale;
+    report["binary_reads"] = manager.usesBinaryReads();
+    report["results"] = resultArray;
+    report["wire_sizes"] = wireSizes;
+
+    const QByteArray json = QJsonDocument(report).toJson(QJsonDocument::Indented);
+    if (parser.isSet(outputOption)) {
+        QFile file(parser.value(outputOption));
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            qCritical() << "❌ Cannot write" << file.fileName();
+            return 1;
+        }
+        file.write(json);
+        qInfo() << "✅ Results written to" << file.fileName();
+    } else {
+        fwrite(json.constData(), 1, json.size(), stdout);
+    }
+
+    manager.stopPolling();
+    return 0;
+}
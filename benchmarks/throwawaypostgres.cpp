@@ -0,0 +1,171 @@
+#include "throwawaypostgres.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QProcess>
+#include <QProcessEnvironment>
+#include <QStandardPaths>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QDebug>
+
+namespace {
+const char* kAdminConnection = "benchmark_admin_connection";
+
+QString executableName(const QString& tool)
+{
+#ifdef Q_OS_WIN
+    return tool + ".exe";
+#else
+    return tool;
+#endif
+}
+}
+
+ThrowawayPostgres::ThrowawayPostgres(const QString& binDirectory, int port)
+    : m_binDirectory(binDirectory)
+    , m_port(port)
+{
+}
+
+ThrowawayPostgres::~ThrowawayPostgres()
+{
+    stop();
+}
+
+QString ThrowawayPostgres::locateBinDirectory(const QString& preferred)
+{
+    QStringList candidates;
+    if (!preferred.isEmpty()) {
+        candidates << preferred;
+    }
+
+    const QString fromEnvironment = QProcessEnvironment::systemEnvironment().value("RAILFLUX_PG_BIN");
+    if (!fromEnvironment.isEmpty()) {
+        candidates << fromEnvironment;
+    }
+
+    for (const QString& candidate : candidates) {
+        if (QFile::exists(QDir(candidate).filePath(executableName("initdb")))) {
+            return candidate;
+        }
+    }
+
+    const QString onPath = QStandardPaths::findExecutable(executableName("initdb"));
+    if (!onPath.isEmpty()) {
+        return QFileInfo(onPath).absolutePath();
+    }
+
+    return QString();
+}
+
+QString ThrowawayPostgres::toolPath(const QString& tool) const
+{
+    return QDir(m_binDirectory).filePath(executableName(tool));
+}
+
+bool ThrowawayPostgres::runTool(const QString& tool, const QStringList& arguments, int timeoutMs)
+{
+    QProcess process;
+    process.setProcessChannelMode(QProcess::MergedChannels);
+    process.start(toolPath(tool), arguments);
+
+    if (!process.waitForFinished(timeoutMs)) {
+        m_lastError = QString("%1 timed out after %2 ms").arg(tool).arg(timeoutMs);
+        process.kill();
+        return false;
+    }
+
+    if (process.exitStatus() != QProcess::NormalExit || process.exitCode() != 0) {
+        m_lastError = QString("%1 failed: %2").arg(tool, QString::fromLocal8Bit(process.readAll()).trimmed());
+        return false;
+    }
+
+    return true;
+}
+
+bool ThrowawayPostgres::start()
+{
+    if (m_binDirectory.isEmpty()) {
+        m_lastError = "PostgreSQL binaries not found (use --pg-bin or RAILFLUX_PG_BIN)";
+        return false;
+    }
+
+    m_workDirectory = std::make_unique<QTemporaryDir>();
+    if (!m_workDirectory->isValid()) {
+        m_lastError = "Could not create temporary directory";
+        return false;
+    }
+
+    const QString dataPath = m_workDirectory->filePath("data");
+    const QString logPath = m_workDirectory->filePath("postgresql.log");
+
+    qInfo() << "🔧 Initializing throwaway cluster in" << dataPath;
+    if (!runTool("initdb", {"-D", dataPath, "-U", "postgres", "-A", "trust", "-E", "UTF8", "--no-sync"}, 120000)) {
+        return false;
+    }
+
+    // Durability is irrelevant for a throwaway cluster; disabling it keeps
+    // update timings stable between runs instead of measuring the disk.
+    QStringList serverOptions = {
+        "-p", QString::number(m_port),
+        "-c", "listen_addresses=localhost",
+        "-c", "fsync=off",
+        "-c", "full_page_writes=off"
+    };
+#ifndef Q_OS_WIN
+    serverOptions << "-k" << m_workDirectory->path();
+#endif
+
+    qInfo() << "🚀 Starting throwaway PostgreSQL on port" << m_port;
+    if (!runTool("pg_ctl", {"-D", dataPath, "-l", logPath, "-o", serverOptions.join(' '), "-w", "start"}, 60000)) {
+        return false;
+    }
+    m_running = true;
+
+    return true;
+}
+
+bool ThrowawayPostgres::createDatabase(const QString& databaseName)
+{
+    bool created = false;
+    {
+        QSqlDatabase admin = QSqlDatabase::addDatabase("QPSQL", kAdminConnection);
+        admin.setHostName(hostName());
+        admin.setPort(m_port);
+        admin.setDatabaseName("postgres");
+        admin.setUserName("postgres");
+
+        if (!admin.open()) {
+            m_lastError = "Admin connection failed: " + admin.lastError().text();
+        } else {
+            QSqlQuery query(admin);
+            if (query.exec("SHOW server_version") && query.next()) {
+                m_serverVersion = query.value(0).toString();
+            }
+
+            if (query.exec(QString("CREATE DATABASE %1").arg(databaseName))) {
+                created = true;
+            } else {
+                m_lastError = "CREATE DATABASE failed: " + query.lastError().text();
+            }
+            admin.close();
+        }
+    }
+    QSqlDatabase::removeDatabase(kAdminConnection);
+
+    return created;
+}
+
+void ThrowawayPostgres::stop()
+{
+    if (!m_running) {
+        return;
+    }
+
+    qInfo() << "🛑 Stopping throwaway PostgreSQL";
+    runTool("pg_ctl", {"-D", m_workDirectory->filePath("data"), "-m", "immediate", "-w", "stop"}, 30000);
+    m_running = false;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <QString>
+#include <QTemporaryDir>
+#include <memory>
+
+// Private PostgreSQL cluster living in a temporary directory for the lifetime
+// of a benchmark run. Nothing touches the system or portable servers.
+class ThrowawayPostgres {
+public:
+    ThrowawayPostgres(const QString& binDirectory, int port);
+    ~ThrowawayPostgres();
+
+    bool start();
+    void stop();
+
+    // Creates railway_control_system so DatabaseInitializer can populate it
+    bool createDatabase(const QString& databaseName);
+
+    QString hostName() const { return QStringLiteral("localhost"); }
+    int port() const { return m_port; }
+    QString serverVersion() const { return m_serverVersion; }
+    QString lastError() const { return m_lastError; }
+
+    // Locates initdb/pg_ctl: explicit directory, RAILFLUX_PG_BIN, then PATH
+    static QString locateBinDirectory(const QString& preferred);
+
+private:
+    bool runTool(const QString& tool, const QStringList& arguments, int timeoutMs);
+    QString toolPath(const QString& tool) const;
+
+    QString m_binDirectory;
+    int m_port;
+    bool m_running = false;
+    QString m_serverVersion;
+    QString m_lastError;
+    std::unique_ptr<QTemporaryDir> m_workDirectory;
+};
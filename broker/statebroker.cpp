@@ -0,0 +1,328 @@
+#include "statebroker.h"
+#include "broker/stationwire.h"
+#include "database/databasemanager.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QHostAddress>
+#include <QTcpServer>
+#include <QTcpSocket>
+
+StateBroker::StateBroker(QObject* parent)
+    : QObject(parent)
+{
+    // Coalesces the burst of *Changed signals a station switch emits
+    m_reloadTimer.setSingleShot(true);
+    m_reloadTimer.setInterval(0);
+    connect(&m_reloadTimer, &QTimer::timeout, this, &StateBroker::reloadState);
+}
+
+StateBroker::~StateBroker()
+{
+    close();
+}
+
+void StateBroker::setDatabaseManager(DatabaseManager* manager)
+{
+    if (m_dbManager) {
+        disconnect(m_dbManager, nullptr, this, nullptr);
+    }
+
+    m_dbManager = manager;
+    if (!m_dbManager) return;
+
+    connect(m_dbManager, &DatabaseManager::connectionStateChanged, this, [this](bool connected) {
+        // A resumed session replays only the changed rows (onRowUpdated)
+        if (connected && !m_dbManager->isStale()) scheduleReload();
+    });
+    connect(m_dbManager, &DatabaseManager::activeStationChanged, this, &StateBroker::scheduleReload);
+    connect(m_dbManager, &DatabaseManager::textLabelsChanged, this, &StateBroker::scheduleReload);
+
+    connect(m_dbManager, &DatabaseManager::trackSegmentUpdated, this, [this](const QString& id) {
+        onRowUpdated(StationStateStore::TrackSegments, id);
+    });
+    connect(m_dbManager, &DatabaseManager::signalUpdated, this, [this](const QString& id) {
+        onRowUpdated(StationStateStore::Signals, id);
+    });
+    connect(m_dbManager, &DatabaseManager::pointMachineUpdated, this, [this](const QString& id) {
+        onRowUpdated(StationStateStore::PointMachines, id);
+    });
+    connect(m_dbManager, &DatabaseManager::fieldInputsApplied, this, &StateBroker::onFieldInputsApplied);
+
+    if (m_dbManager->isConnected()) {
+        scheduleReload();
+    }
+}
+
+int StateBroker::port() const
+{
+    return m_server ? m_server->serverPort() : 0;
+}
+
+bool StateBroker::listen(int port, const QString& bindAddress)
+{
+    close();
+
+    m_server = new QTcpServer(this);
+    if (!m_server->listen(QHostAddress(bindAddress), quint16(port))) {
+        qWarning() << "❌ State broker: listen on" << bindAddress << port << "failed:" << m_server->errorString();
+        delete m_server;
+        m_server = nullptr;
+        return false;
+    }
+
+    connect(m_server, &QTcpServer::newConnection, this, &StateBroker::onNewConnection);
+    qDebug() << "📡 State broker listening on" << bindAddress << this->port();
+    scheduleReload();
+    emit listeningChanged();
+    return true;
+}
+
+void StateBroker::close()
+{
+    if (!m_server) return;
+
+    const QList<QTcpSocket*> sockets = m_clients.keys();
+    for (QTcpSocket* socket : sockets) {
+        dropClient(socket);
+    }
+
+    delete m_server;
+    m_server = nullptr;
+
+    // Not serving: hold no state and issue no queries
+    m_store.clear();
+    m_log.clear();
+    m_snapshotFrame.clear();
+    emit listeningChanged();
+}
+
+void StateBroker::scheduleReload()
+{
+    if (!m_reloadTimer.isActive()) {
+        m_reloadTimer.start();
+    }
+}
+
+void StateBroker::reloadState()
+{
+    if (!m_server || !m_dbManager || !m_dbManager->isConnected()) return;
+
+    // One consistent read: every workstation is served this state
+    const QVariantMap snapshot = m_dbManager->getStationSnapshot();
+    m_store.reset(m_dbManager->activeStation(), toVariantMaps<TrackSegmentInfo>(snapshot["tracks"].toList()),
+                  toVariantMaps<SignalInfo>(snapshot["signals"].toList()),
+                  toVariantMaps<PointMachineInfo>(snapshot["pointMachines"].toList()),
+                  snapshot["textLabels"].toList());
+    ++m_databaseReads;
+
+    // New epoch: every client's deltas are void, so everyone gets the snapshot
+    m_epoch = qMax(m_epoch + 1, quint64(QDateTime::currentMSecsSinceEpoch()));
+    ++m_sequence;
+    m_log.clear();
+    m_snapshotFrame.clear();
+
+    for (auto it = m_clients.begin(); it != m_clients.end(); ++it) {
+        if (it->greeted) sendSnapshot(it.key(), it.value());
+    }
+
+    qDebug() << "📡 State broker loaded station" << m_store.stationId() << "(epoch" << m_epoch
+             << "seq" << m_sequence << ")";
+    emit statisticsChanged();
+}
+
+void StateBroker::onRowUpdated(StationStateStore::Table table, const QString& id)
+{
+    if (!m_server || !m_dbManager || m_store.stationId().isEmpty() || m_reloadTimer.isActive()) return;
+
+    QVariantMap row;
+    switch (table) {
+    case StationStateStore::TrackSegments: row = m_dbManager->getTrackSegmentById(id); break;
+    case StationStateStore::Signals: row = m_dbManager->getSignalById(id); break;
+    case StationStateStore::PointMachines: row = m_dbManager->getPointMachineById(id); break;
+    default: return;
+    }
+    ++m_databaseReads;
+
+    publishRow(table, id, row);
+}
+
+void StateBroker::onFieldInputsApplied(const QVariantList& tracks, const QVariantList& pointMachines)
+{
+    if (!m_server || m_store.stationId().isEmpty() || m_reloadTimer.isActive()) return;
+
+    // The batch carries the new state values: patch the stored rows, no reads
+    auto patch = [this](StationStateStore::Table table, const QVariantList& changes) {
+        for (const QVariant& value : changes) {
+            const QVariantMap change = value.toMap();
+            const QString id = change["id"].toString();
+            const int index = m_store.indexOf(table, id);
+            if (index < 0) {
+                scheduleReload();
+                return;
+            }
+
+            QVariantMap row = m_store.rowAt(table, index);
+            for (auto it = change.cbegin(); it != change.cend(); ++it) {
+                row.insert(it.key(), it.value());
+            }
+            publishRow(table, id, row);
+        }
+    };
+    patch(StationStateStore::TrackSegments, tracks);
+    patch(StationStateStore::PointMachines, pointMachines);
+}
+
+void StateBroker::publishRow(StationStateStore::Table table, const QString& id, const QVariantMap& row)
+{
+    // Deltas carry state only: added, removed or re-laid-out rows start a new epoch
+    const int index = m_store.indexOf(table, id);
+    if (index < 0 || row.isEmpty() || !StationWire::sameLayout(table, m_store.rowAt(table, index), row)) {
+        scheduleReload();
+        return;
+    }
+    if (!m_store.apply(table, row)) return;
+
+    const QByteArray frame = StateProtocol::encode(StateProtocol::Delta,
+                                                   StationWire::encodeDelta(++m_sequence, table, index, row));
+
+    m_snapshotFrame.clear();
+    m_log.append({m_sequence, frame});
+    if (m_log.size() > kDeltaLogSize) {
+        m_log.removeFirst();
+    }
+
+    for (auto it = m_clients.begin(); it != m_clients.end(); ++it) {
+        if (!it->synced) continue;
+
+        // Slow consumer: stop feeding it, resync from a snapshot once drained
+        if (it.key()->bytesToWrite() > kMaxClientBacklog) {
+            it->synced = false;
+            ++m_resyncs;
+            qWarning() << "📡 State broker: client" << it.key()->peerAddress().toString()
+                       << "fell behind, resyncing";
+            continue;
+        }
+        it.key()->write(frame);
+        ++m_deltasSent;
+    }
+    emit statisticsChanged();
+}
+
+const QByteArray& StateBroker::snapshotFrame()
+{
+    if (m_snapshotFrame.isEmpty()) {
+        QByteArray payload;
+        StationWire::appendVarint(&payload, m_epoch);
+        StationWire::appendVarint(&payload, m_sequence);
+        payload += StationWire::encodeSnapshot(m_store);
+        m_snapshotFrame = StateProtocol::encode(StateProtocol::Snapshot, payload);
+        m_snapshotBytes = m_snapshotFrame.size();
+    }
+    return m_snapshotFrame;
+}
+
+void StateBroker::sendSnapshot(QTcpSocket* socket, Client& client)
+{
+    socket->write(snapshotFrame());
+    client.synced = true;
+    ++m_snapshotsSent;
+}
+
+void StateBroker::onNewConnection()
+{
+    while (QTcpSocket* socket = m_server->nextPendingConnection()) {
+        m_clients.insert(socket, Client());
+
+        connect(socket, &QTcpSocket::readyRead, this, [this, socket]() {
+            auto it = m_clients.find(socket);
+            if (it == m_clients.end()) return;
+            it->buffer.append(socket->readAll());
+
+            // onMessage() may drop the client: look it up again after every frame
+            StateProtocol::Kind kind;
+            QByteArray payload;
+            while (it != m_clients.end()) {
+                const StateProtocol::TakeResult result = StateProtocol::take(&it->buffer, &kind, &payload);
+                if (result == StateProtocol::TakeResult::NeedMore) break;
+                if (result == StateProtocol::TakeResult::Malformed) {
+                    qWarning() << "❌ State broker: malformed request from" << socket->peerAddress().toString();
+                    dropClient(socket);
+                    return;
+                }
+                onMessage(socket, kind, payload);
+                it = m_clients.find(socket);
+            }
+        });
+        connect(socket, &QTcpSocket::bytesWritten, this, [this, socket]() {
+            onBytesWritten(socket);
+        });
+        connect(socket, &QTcpSocket::disconnected, this, [this, socket]() {
+            dropClient(socket);
+        });
+
+        qDebug() << "📡 State broker: workstation connected from" << socket->peerAddress().toString();
+        emit clientsChanged();
+    }
+}
+
+void StateBroker::onMessage(QTcpSocket* socket, StateProtocol::Kind kind, const QByteArray& payload)
+{
+    Client& client = m_clients[socket];
+
+    if (kind == StateProtocol::Hello) {
+        StationWire::Reader reader(payload);
+        const quint64 version = reader.varint();
+        const quint64 epoch = reader.varint();
+        const quint64 sequence = reader.varint();
+        if (!reader.ok() || version != StateProtocol::kVersion) {
+            qWarning() << "❌ State broker: protocol version mismatch from" << socket->peerAddress().toString();
+            dropClient(socket);
+            return;
+        }
+        client.greeted = true;
+        if (m_store.stationId().isEmpty()) return;   // snapshot follows the first load
+
+        // Resume from the log when it still covers everything the client missed
+        const quint64 oldest = m_log.isEmpty() ? m_sequence + 1 : m_log.constFirst().sequence;
+        if (epoch == m_epoch && sequence <= m_sequence && sequence + 1 >= oldest) {
+            for (const LoggedDelta& delta : std::as_const(m_log)) {
+                if (delta.sequence > sequence) {
+                    socket->write(delta.frame);
+                    ++m_deltasSent;
+                }
+            }
+            client.synced = true;
+        } else {
+            sendSnapshot(socket, client);
+        }
+        emit statisticsChanged();
+    } else if (kind == StateProtocol::Resync) {
+        ++m_resyncs;
+        if (client.greeted && !m_store.stationId().isEmpty()) {
+            sendSnapshot(socket, client);
+        }
+        emit statisticsChanged();
+    }
+}
+
+void StateBroker::onBytesWritten(QTcpSocket* socket)
+{
+    auto it = m_clients.find(socket);
+    if (it == m_clients.end()) return;
+
+    if (it->greeted && !it->synced && socket->bytesToWrite() == 0 && !m_store.stationId().isEmpty()) {
+        sendSnapshot(socket, it.value());
+        emit statisticsChanged();
+    }
+}
+
+void StateBroker::dropClient(QTcpSocket* socket)
+{
+    if (!m_clients.remove(socket)) return;
+
+    socket->disconnect(this);
+    socket->abort();
+    socket->deleteLater();
+    emit clientsChanged();
+}
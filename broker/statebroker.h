@@ -0,0 +1,116 @@
+#pragma once
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QString>
+#include <QTimer>
+
+#include "broker/stateprotocol.h"
+#include "broker/statestore.h"
+
+class DatabaseManager;
+class QTcpServer;
+class QTcpSocket;
+
+// Fans one database subscription out to many HMI workstations.
+//
+// The broker owns the only LISTEN and the only state reads: each change
+// notification costs one row query here however many clients are attached.
+// Clients (StateBrokerClient) get a snapshot on connect and then ordered
+// deltas; a client that reconnects with an epoch/sequence the delta log still
+// covers only receives what it missed. A client whose socket backlog grows
+// beyond kMaxClientBacklog stops receiving deltas and gets a fresh snapshot
+// once it has drained, so a slow workstation never holds up the others.
+// Everything on the wire is StationWire-encoded: a delta carries only the
+// changed row's state, so a row whose layout changed (or a new row) reloads
+// the station under a new epoch instead.
+class StateBroker : public QObject {
+    Q_OBJECT
+    Q_PROPERTY(bool listening READ isListening NOTIFY listeningChanged)
+    Q_PROPERTY(int port READ port NOTIFY listeningChanged)
+    Q_PROPERTY(int clientCount READ clientCount NOTIFY clientsChanged)
+    Q_PROPERTY(QString station READ station NOTIFY statisticsChanged)
+    Q_PROPERTY(qint64 sequence READ sequence NOTIFY statisticsChanged)
+    Q_PROPERTY(qint64 snapshotsSent READ snapshotsSent NOTIFY statisticsChanged)
+    Q_PROPERTY(qint64 deltasSent READ deltasSent NOTIFY statisticsChanged)
+    Q_PROPERTY(qint64 resyncCount READ resyncCount NOTIFY statisticsChanged)
+    Q_PROPERTY(qint64 databaseReads READ databaseReads NOTIFY statisticsChanged)
+    Q_PROPERTY(qint64 snapshotBytes READ snapshotBytes NOTIFY statisticsChanged)
+
+public:
+    explicit StateBroker(QObject* parent = nullptr);
+    ~StateBroker() override;
+
+    void setDatabaseManager(DatabaseManager* manager);
+
+    bool isListening() const { return m_server != nullptr; }
+    int port() const;
+    int clientCount() const { return m_clients.size(); }
+    QString station() const { return m_store.stationId(); }
+    qint64 sequence() const { return qint64(m_sequence); }
+    qint64 snapshotsSent() const { return m_snapshotsSent; }
+    qint64 deltasSent() const { return m_deltasSent; }
+    qint64 resyncCount() const { return m_resyncs; }
+    qint64 databaseReads() const { return m_databaseReads; }
+    qint64 snapshotBytes() const { return m_snapshotBytes; }
+
+    // ===== QML API =====
+    // Workstations on other hosts need a non-loopback bind address
+    Q_INVOKABLE bool listen(int port, const QString& bindAddress = QStringLiteral("127.0.0.1"));
+    Q_INVOKABLE void close();
+
+signals:
+    void listeningChanged();
+    void clientsChanged();
+    void statisticsChanged();
+
+private slots:
+    void onNewConnection();
+    void reloadState();
+
+private:
+    static constexpr int kDeltaLogSize = 4096;
+    static constexpr qint64 kMaxClientBacklog = 4 * 1024 * 1024;
+
+    struct Client {
+        QByteArray buffer;        // unconsumed request bytes
+        bool greeted = false;     // hello received
+        bool synced = false;      // receiving deltas
+    };
+
+    struct LoggedDelta {
+        quint64 sequence = 0;
+        QByteArray frame;
+    };
+
+    void scheduleReload();
+    void onRowUpdated(StationStateStore::Table table, const QString& id);
+    void onFieldInputsApplied(const QVariantList& tracks, const QVariantList& pointMachines);
+    void publishRow(StationStateStore::Table table, const QString& id, const QVariantMap& row);
+    void onMessage(QTcpSocket* socket, StateProtocol::Kind kind, const QByteArray& payload);
+    void onBytesWritten(QTcpSocket* socket);
+    void sendSnapshot(QTcpSocket* socket, Client& client);
+    void dropClient(QTcpSocket* socket);
+    const QByteArray& snapshotFrame();
+
+    DatabaseManager* m_dbManager = nullptr;
+    QTcpServer* m_server = nullptr;
+    QHash<QTcpSocket*, Client> m_clients;
+
+    // ===== State =====
+    StationStateStore m_store;
+    quint64 m_epoch = 0;
+    quint64 m_sequence = 0;
+    QList<LoggedDelta> m_log;     // the last kDeltaLogSize deltas, in order
+    QByteArray m_snapshotFrame;   // encoded lazily, dropped on every delta
+    QTimer m_reloadTimer;
+
+    // ===== Statistics =====
+    qint64 m_snapshotsSent = 0;
+    qint64 m_deltasSent = 0;
+    qint64 m_resyncs = 0;
+    qint64 m_databaseReads = 0;
+    qint64 m_snapshotBytes = 0;
+};
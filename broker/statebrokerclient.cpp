@@ -0,0 +1,170 @@
+#include "statebrokerclient.h"
+#include "broker/stationwire.h"
+
+#include <QDebug>
+#include <QTcpSocket>
+
+StateBrokerClient::StateBrokerClient(QObject* parent)
+    : QObject(parent)
+    , m_socket(new QTcpSocket(this))
+{
+    connect(m_socket, &QTcpSocket::connected, this, &StateBrokerClient::onConnected);
+    connect(m_socket, &QTcpSocket::readyRead, this, &StateBrokerClient::onReadyRead);
+    connect(m_socket, &QTcpSocket::disconnected, this, &StateBrokerClient::onDisconnected);
+    connect(m_socket, &QTcpSocket::errorOccurred, this, [this](QAbstractSocket::SocketError) {
+        if (m_socket->state() == QAbstractSocket::UnconnectedState && m_port > 0) {
+            m_reconnectTimer.start();
+        }
+    });
+
+    m_reconnectTimer.setSingleShot(true);
+    m_reconnectTimer.setInterval(kReconnectMs);
+    connect(&m_reconnectTimer, &QTimer::timeout, this, [this]() {
+        if (m_port > 0) m_socket->connectToHost(m_hostName, quint16(m_port));
+    });
+}
+
+StateBrokerClient::~StateBrokerClient()
+{
+    disconnectFromBroker();
+}
+
+bool StateBrokerClient::isConnected() const
+{
+    return m_socket->state() == QAbstractSocket::ConnectedState;
+}
+
+void StateBrokerClient::connectToBroker(const QString& hostName, int port)
+{
+    disconnectFromBroker();
+
+    m_hostName = hostName;
+    m_port = port;
+    qDebug() << "📡 Connecting to state broker" << hostName << port;
+    m_socket->connectToHost(hostName, quint16(port));
+}
+
+void StateBrokerClient::disconnectFromBroker()
+{
+    m_port = 0;
+    m_reconnectTimer.stop();
+    if (m_socket->state() != QAbstractSocket::UnconnectedState) {
+        m_socket->abort();
+    }
+}
+
+void StateBrokerClient::onConnected()
+{
+    m_buffer.clear();
+
+    // Resume point: the broker replays what we missed or sends a snapshot
+    QByteArray hello;
+    StationWire::appendVarint(&hello, StateProtocol::kVersion);
+    StationWire::appendVarint(&hello, m_epoch);
+    StationWire::appendVarint(&hello, m_sequence);
+    m_socket->write(StateProtocol::encode(StateProtocol::Hello, hello));
+    m_awaitingSnapshot = false;
+
+    // Held state stays usable while the broker brings it up to date
+    setSynchronized(m_epoch != 0);
+
+    qDebug() << "📡 Connected to state broker (resuming epoch" << m_epoch << "seq" << m_sequence << ")";
+    emit connectedChanged();
+}
+
+void StateBrokerClient::onDisconnected()
+{
+    qWarning() << "📡 State broker connection lost";
+    setSynchronized(false);
+    emit connectedChanged();
+
+    if (m_port > 0) {
+        m_reconnectTimer.start();
+    }
+}
+
+void StateBrokerClient::onReadyRead()
+{
+    m_buffer.append(m_socket->readAll());
+
+    StateProtocol::Kind kind;
+    QByteArray payload;
+    for (;;) {
+        const StateProtocol::TakeResult result = StateProtocol::take(&m_buffer, &kind, &payload);
+        if (result == StateProtocol::TakeResult::NeedMore) break;
+        if (result == StateProtocol::TakeResult::Malformed) {
+            qWarning() << "❌ Malformed frame from state broker, reconnecting";
+            m_socket->abort();
+            return;
+        }
+        onMessage(kind, payload);
+    }
+}
+
+void StateBrokerClient::onMessage(StateProtocol::Kind kind, const QByteArray& payload)
+{
+    if (kind == StateProtocol::Snapshot) {
+        StationWire::Reader reader(payload);
+        const quint64 epoch = reader.varint();
+        const quint64 sequence = reader.varint();
+        const QByteArrayView blob = QByteArrayView(payload).sliced(reader.position() - payload.constData());
+        if (!reader.ok() || !StationWire::decodeSnapshot(blob, &m_store)) {
+            qWarning() << "❌ Undecodable snapshot from state broker, reconnecting";
+            m_socket->abort();
+            return;
+        }
+        m_epoch = epoch;
+        m_sequence = sequence;
+        ++m_snapshots;
+
+        m_awaitingSnapshot = false;
+        setSynchronized(true);
+        emit snapshotApplied();
+        emit statisticsChanged();
+    } else if (kind == StateProtocol::Delta) {
+        if (m_awaitingSnapshot) return;
+
+        StationWire::Delta delta;
+        if (!StationWire::decodeDelta(payload, &delta)) {
+            requestResync();
+            return;
+        }
+        if (delta.sequence <= m_sequence) return;   // already applied (replay overlap)
+        if (delta.sequence != m_sequence + 1) {
+            qWarning() << "📡 State broker sequence gap:" << m_sequence << "->" << delta.sequence << ", resyncing";
+            requestResync();
+            return;
+        }
+
+        QVariantMap row = m_store.rowAt(delta.table, delta.row);
+        if (row.isEmpty()) {
+            requestResync();
+            return;
+        }
+
+        StationWire::applyDelta(delta, &row);
+        m_sequence = delta.sequence;
+        ++m_deltas;
+        if (m_store.apply(delta.table, row)) {
+            emit rowUpdated(delta.table, row.value("id").toString());
+        }
+        emit statisticsChanged();
+    }
+}
+
+void StateBrokerClient::requestResync()
+{
+    m_awaitingSnapshot = true;
+    setSynchronized(false);
+    ++m_resyncs;
+
+    m_socket->write(StateProtocol::encode(StateProtocol::Resync));
+    emit statisticsChanged();
+}
+
+void StateBrokerClient::setSynchronized(bool synchronized)
+{
+    if (m_synchronized == synchronized) return;
+    m_synchronized = synchronized;
+    emit synchronizedChanged();
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <QByteArray>
+#include <QObject>
+#include <QString>
+#include <QTimer>
+
+#include "broker/stateprotocol.h"
+#include "broker/statestore.h"
+
+class QTcpSocket;
+
+// Workstation side of StateBroker: mirrors the broker's station state so the
+// HMI never subscribes to or polls the database itself.
+//
+// On (re)connect the client says which epoch/sequence it holds; the broker
+// answers with the missed deltas or a snapshot. Deltas must arrive with
+// contiguous sequence numbers - on a gap the client stops applying them and
+// asks for a snapshot. Lost connections are retried every kReconnectMs.
+class StateBrokerClient : public QObject {
+    Q_OBJECT
+    Q_PROPERTY(bool connected READ isConnected NOTIFY connectedChanged)
+    Q_PROPERTY(bool synchronized READ isSynchronized NOTIFY synchronizedChanged)
+    Q_PROPERTY(QString station READ station NOTIFY snapshotApplied)
+    Q_PROPERTY(qint64 sequence READ sequence NOTIFY statisticsChanged)
+    Q_PROPERTY(qint64 snapshotCount READ snapshotCount NOTIFY statisticsChanged)
+    Q_PROPERTY(qint64 deltaCount READ deltaCount NOTIFY statisticsChanged)
+    Q_PROPERTY(qint64 resyncCount READ resyncCount NOTIFY statisticsChanged)
+
+public:
+    explicit StateBrokerClient(QObject* parent = nullptr);
+    ~StateBrokerClient() override;
+
+    bool isConnected() const;
+    bool isSynchronized() const { return m_synchronized; }
+    QString station() const { return m_store.stationId(); }
+    qint64 sequence() const { return qint64(m_sequence); }
+    qint64 snapshotCount() const { return m_snapshots; }
+    qint64 deltaCount() const { return m_deltas; }
+    qint64 resyncCount() const { return m_resyncs; }
+
+    const StationStateStore& store() const { return m_store; }
+
+    // ===== QML API =====
+    Q_INVOKABLE void connectToBroker(const QString& hostName, int port);
+    Q_INVOKABLE void disconnectFromBroker();
+
+signals:
+    void connectedChanged();
+    void synchronizedChanged();
+    // Whole state replaced (first sync, broker station switch, resync)
+    void snapshotApplied();
+    void rowUpdated(StationStateStore::Table table, const QString& id);
+    void statisticsChanged();
+
+private slots:
+    void onConnected();
+    void onReadyRead();
+    void onDisconnected();
+
+private:
+    static constexpr int kReconnectMs = 2000;
+
+    void onMessage(StateProtocol::Kind kind, const QByteArray& payload);
+    void requestResync();
+    void setSynchronized(bool synchronized);
+
+    QTcpSocket* m_socket = nullptr;
+    QString m_hostName;
+    int m_port = 0;
+    QByteArray m_buffer;
+    QTimer m_reconnectTimer;
+
+    StationStateStore m_store;
+    quint64 m_epoch = 0;
+    quint64 m_sequence = 0;
+    bool m_synchronized = false;
+    bool m_awaitingSnapshot = false;   // gap seen: deltas are void until the snapshot
+
+    qint64 m_snapshots = 0;
+    qint64 m_deltas = 0;
+    qint64 m_resyncs = 0;
+};
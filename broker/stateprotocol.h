@@ -0,0 +1,63 @@
+#pragma once
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QtEndian>
+#include <QtGlobal>
+
+// Framing between StateBroker and StateBrokerClient.
+//
+//   offset  size  field
+//   0       4     body length n, big endian
+//   4       1     message kind
+//   5       n-1   payload (varints are StationWire::appendVarint coded)
+//
+// Client -> broker:
+//   Hello    varint version, epoch, seq   last state the client holds (0/0 = none)
+//   Resync   -                            client detected a gap; wants a snapshot
+// Broker -> client:
+//   Snapshot varint epoch, seq, then a StationWire snapshot blob
+//   Delta    a StationWire delta record; seq is contiguous
+//
+// The epoch changes whenever the broker rebuilds its state (restart, station
+// switch, layout edit), so a client never splices deltas onto an unrelated
+// snapshot - deltas address rows by snapshot index.
+namespace StateProtocol {
+
+constexpr int kVersion = 3;   // 3: StationWire v2 point records
+constexpr int kLengthSize = 4;
+constexpr quint32 kMaxFrameSize = 64 * 1024 * 1024;
+
+enum Kind : quint8 { Hello = 1, Resync, Snapshot, Delta };
+
+inline QByteArray encode(Kind kind, QByteArrayView payload = QByteArrayView())
+{
+    QByteArray frame(kLengthSize, Qt::Uninitialized);
+    qToBigEndian<quint32>(quint32(payload.size() + 1), frame.data());
+    frame.reserve(kLengthSize + 1 + payload.size());
+    frame.append(char(kind));
+    frame.append(payload);
+    return frame;
+}
+
+enum class TakeResult {
+    Ok,          // *kind / *payload hold the next frame, removed from the buffer
+    NeedMore,    // incomplete frame
+    Malformed    // oversized or empty frame; drop the connection
+};
+
+inline TakeResult take(QByteArray* buffer, Kind* kind, QByteArray* payload)
+{
+    if (buffer->size() < kLengthSize) return TakeResult::NeedMore;
+
+    const quint32 length = qFromBigEndian<quint32>(buffer->constData());
+    if (length == 0 || length > kMaxFrameSize) return TakeResult::Malformed;
+    if (buffer->size() < kLengthSize + qsizetype(length)) return TakeResult::NeedMore;
+
+    *kind = Kind(quint8(buffer->at(kLengthSize)));
+    *payload = buffer->mid(kLengthSize + 1, length - 1);
+    buffer->remove(0, kLengthSize + length);
+    return TakeResult::Ok;
+}
+
+} // namespace StateProtocol
@@ -0,0 +1,179 @@
+#pragma once
+
+#include <QHash>
+#include <QString>
+#include <QVariantList>
+#include <QVariantMap>
+
+// One station's layout and state as served by StateBroker and mirrored by
+// every StateBrokerClient. Rows keep snapshot order (the order the database
+// list queries return) and are indexed by element ID, so a delta replaces its
+// row in place. Rows have exactly the shape of the DatabaseManager list
+// queries, which lets DatabaseManager hand them out unchanged.
+class StationStateStore {
+public:
+    enum Table { TrackSegments, Signals, PointMachines, TableCount };
+
+    // Status bar counts with the definitions of railway_control.get_system_status(),
+    // kept current by reset() and apply() so reading them never walks the rows
+    struct StatusCounters {
+        int tracks = 0;
+        int tracksOccupied = 0;
+        int tracksAssigned = 0;
+        int signalsTotal = 0;
+        int signalsActive = 0;
+        int points = 0;
+        int pointsConnected = 0;
+        int pointsInTransition = 0;
+
+        bool operator==(const StatusCounters& other) const
+        {
+            return tracks == other.tracks && tracksOccupied == other.tracksOccupied
+                && tracksAssigned == other.tracksAssigned && signalsTotal == other.signalsTotal
+                && signalsActive == other.signalsActive && points == other.points
+                && pointsConnected == other.pointsConnected && pointsInTransition == other.pointsInTransition;
+        }
+        bool operator!=(const StatusCounters& other) const { return !(*this == other); }
+
+        // Same shape as the get_system_status() JSON
+        QVariantMap toVariantMap() const
+        {
+            return {
+                {QStringLiteral("tracks"), QVariantMap{
+                    {QStringLiteral("total"), tracks},
+                    {QStringLiteral("occupied"), tracksOccupied},
+                    {QStringLiteral("assigned"), tracksAssigned},
+                    {QStringLiteral("available"), tracks - tracksOccupied - tracksAssigned}}},
+                {QStringLiteral("signals"), QVariantMap{
+                    {QStringLiteral("total"), signalsTotal},
+                    {QStringLiteral("active"), signalsActive}}},
+                {QStringLiteral("point_machines"), QVariantMap{
+                    {QStringLiteral("total"), points},
+                    {QStringLiteral("connected"), pointsConnected},
+                    {QStringLiteral("in_transition"), pointsInTransition}}},
+            };
+        }
+    };
+
+    // Names match the `table` member of database notifications
+    static QString tableName(Table table)
+    {
+        switch (table) {
+        case TrackSegments: return QStringLiteral("track_segments");
+        case Signals: return QStringLiteral("signals");
+        case PointMachines: return QStringLiteral("point_machines");
+        default: return QString();
+        }
+    }
+
+    static bool tableFromName(const QString& name, Table* table)
+    {
+        for (int t = 0; t < TableCount; ++t) {
+            if (name == tableName(Table(t))) {
+                *table = Table(t);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void reset(const QString& stationId, const QVariantList& tracks, const QVariantList& signalList,
+               const QVariantList& points, const QVariantList& labels)
+    {
+        m_stationId = stationId;
+        m_rows[TrackSegments] = tracks;
+        m_rows[Signals] = signalList;
+        m_rows[PointMachines] = points;
+        m_textLabels = labels;
+        m_counters = StatusCounters();
+        for (int t = 0; t < TableCount; ++t) {
+            reindex(Table(t));
+            for (const QVariant& row : m_rows[t]) {
+                count(Table(t), row.toMap(), 1);
+            }
+        }
+    }
+
+    void clear() { reset(QString(), {}, {}, {}, {}); }
+
+    const QString& stationId() const { return m_stationId; }
+    const QVariantList& rows(Table table) const { return m_rows[table]; }
+    const QVariantList& textLabels() const { return m_textLabels; }
+    const StatusCounters& counters() const { return m_counters; }
+
+    QVariantMap row(Table table, const QString& id) const
+    {
+        return rowAt(table, indexOf(table, id));
+    }
+
+    // Snapshot position of an element (the index the wire format addresses)
+    int indexOf(Table table, const QString& id) const { return m_index[table].value(id, -1); }
+
+    QVariantMap rowAt(Table table, int index) const
+    {
+        return index >= 0 && index < m_rows[table].size() ? m_rows[table].at(index).toMap() : QVariantMap();
+    }
+
+    // Replaces the row with the same "id" (appends unknown IDs); false when unchanged
+    bool apply(Table table, const QVariantMap& row)
+    {
+        const QString id = row.value(QStringLiteral("id")).toString();
+        if (id.isEmpty()) return false;
+
+        const int index = m_index[table].value(id, -1);
+        if (index < 0) {
+            m_index[table].insert(id, m_rows[table].size());
+            m_rows[table].append(row);
+            count(table, row, 1);
+            return true;
+        }
+        const QVariantMap previous = m_rows[table].at(index).toMap();
+        if (previous == row) return false;
+
+        count(table, previous, -1);
+        count(table, row, 1);
+        m_rows[table][index] = row;
+        return true;
+    }
+
+private:
+    void count(Table table, const QVariantMap& row, int sign)
+    {
+        switch (table) {
+        case TrackSegments:
+            if (!row.value(QStringLiteral("isActive"), true).toBool()) return;
+            m_counters.tracks += sign;
+            if (row.value(QStringLiteral("occupied")).toBool()) m_counters.tracksOccupied += sign;
+            if (row.value(QStringLiteral("assigned")).toBool()) m_counters.tracksAssigned += sign;
+            break;
+        case Signals:
+            m_counters.signalsTotal += sign;
+            if (row.value(QStringLiteral("isActive"), true).toBool()) m_counters.signalsActive += sign;
+            break;
+        case PointMachines: {
+            m_counters.points += sign;
+            const QString status = row.value(QStringLiteral("operatingStatus")).toString();
+            if (status == QLatin1String("CONNECTED")) m_counters.pointsConnected += sign;
+            if (status == QLatin1String("IN_TRANSITION")) m_counters.pointsInTransition += sign;
+            break;
+        }
+        default:
+            break;
+        }
+    }
+
+    void reindex(Table table)
+    {
+        m_index[table].clear();
+        m_index[table].reserve(m_rows[table].size());
+        for (int i = 0; i < m_rows[table].size(); ++i) {
+            m_index[table].insert(m_rows[table].at(i).toMap().value(QStringLiteral("id")).toString(), i);
+        }
+    }
+
+    QString m_stationId;
+    QVariantList m_rows[TableCount];
+    QHash<QString, int> m_index[TableCount];
+    QVariantList m_textLabels;
+    StatusCounters m_counters;
+};
@@ -0,0 +1,736 @@
+#include "stationwire.h"
+
+#include <QHash>
+#include <QStringList>
+#include <QVariantList>
+#include <QtEndian>
+#include <cmath>
+#include <cstring>
+
+namespace StationWire {
+
+namespace {
+
+constexpr char kMagic[3] = {'R', 'F', 'S'};
+constexpr int kTextEntrySize = 11;     // u8 table, u32 row, u32 offset, u16 length
+constexpr int kMaxValueDepth = 8;
+constexpr quint32 kMaxRows = 1u << 24;
+
+// Layout section value tags
+enum ValueTag : quint8 {
+    TagAbsent = 0, TagFalse, TagTrue, TagInteger, TagCenti, TagDouble, TagString, TagList, TagMap
+};
+
+// Record bits
+constexpr quint8 kTrackOccupied = 0x01;
+constexpr quint8 kTrackAssigned = 0x02;
+constexpr quint8 kTrackActive = 0x04;
+constexpr quint8 kHasText = 0x08;          // track delta record
+constexpr quint8 kPointLocked = 0x20;
+constexpr quint8 kPointHasText = 0x40;     // point delta record
+constexpr quint8 kSignalActive = 0x10;
+
+void appendU16(QByteArray* out, quint16 value)
+{
+    char bytes[2];
+    qToBigEndian<quint16>(value, bytes);
+    out->append(bytes, 2);
+}
+
+void appendU32(QByteArray* out, quint32 value)
+{
+    char bytes[4];
+    qToBigEndian<quint32>(value, bytes);
+    out->append(bytes, 4);
+}
+
+void appendText(QByteArray* out, const QString& text)
+{
+    const QByteArray utf8 = text.toUtf8();
+    appendVarint(out, quint64(utf8.size()));
+    out->append(utf8);
+}
+
+quint64 zigzag(qint64 value) { return (quint64(value) << 1) ^ quint64(value >> 63); }
+qint64 unzigzag(quint64 value) { return qint64(value >> 1) ^ -qint64(value & 1); }
+
+// Magic and version
+bool readHeader(Reader& reader)
+{
+    const QByteArrayView magic = reader.bytes(3);
+    const quint8 version = reader.byte();
+    return reader.ok() && std::memcmp(magic.data(), kMagic, 3) == 0 && version == kVersion;
+}
+
+bool bit(const uchar* bits, int index) { return bits[index >> 3] & (1u << (index & 7)); }
+
+class StringTable {
+public:
+    quint64 intern(const QString& value)
+    {
+        auto it = m_index.constFind(value);
+        if (it != m_index.constEnd()) return it.value();
+        const int index = m_strings.size();
+        m_index.insert(value, index);
+        m_strings.append(value);
+        return quint64(index);
+    }
+
+    void write(QByteArray* out) const
+    {
+        appendVarint(out, quint64(m_strings.size()));
+        for (const QString& value : m_strings) appendText(out, value);
+    }
+
+private:
+    QHash<QString, int> m_index;
+    QStringList m_strings;
+};
+
+void encodeValue(QByteArray* out, const QVariant& value, StringTable* strings)
+{
+    switch (value.typeId()) {
+    case QMetaType::UnknownType:
+        out->append(char(TagAbsent));
+        return;
+    case QMetaType::Bool:
+        out->append(char(value.toBool() ? TagTrue : TagFalse));
+        return;
+    case QMetaType::Int:
+    case QMetaType::UInt:
+    case QMetaType::Long:
+    case QMetaType::LongLong:
+    case QMetaType::ULongLong:
+    case QMetaType::Short:
+        out->append(char(TagInteger));
+        appendVarint(out, zigzag(value.toLongLong()));
+        return;
+    case QMetaType::Double:
+    case QMetaType::Float: {
+        // Layout coordinates are NUMERIC(10,2): hundredths as a varint
+        const double number = value.toDouble();
+        const double centi = std::round(number * 100.0);
+        if (std::fabs(centi) < 1e15 && centi / 100.0 == number) {
+            out->append(char(TagCenti));
+            appendVarint(out, zigzag(qint64(centi)));
+        } else {
+            out->append(char(TagDouble));
+            quint64 bits;
+            std::memcpy(&bits, &number, sizeof bits);
+            char bytes[8];
+            qToBigEndian<quint64>(bits, bytes);
+            out->append(bytes, 8);
+        }
+        return;
+    }
+    case QMetaType::QVariantList:
+    case QMetaType::QStringList: {
+        const QVariantList list = value.toList();
+        out->append(char(TagList));
+        appendVarint(out, quint64(list.size()));
+        for (const QVariant& item : list) encodeValue(out, item, strings);
+        return;
+    }
+    case QMetaType::QVariantMap: {
+        const QVariantMap map = value.toMap();
+        out->append(char(TagMap));
+        appendVarint(out, quint64(map.size()));
+        for (auto it = map.cbegin(); it != map.cend(); ++it) {
+            appendVarint(out, strings->intern(it.key()));
+            encodeValue(out, it.value(), strings);
+        }
+        return;
+    }
+    default:
+        out->append(char(TagString));
+        appendVarint(out, strings->intern(value.toString()));
+        return;
+    }
+}
+
+QVariant decodeValue(Reader& reader, const QStringList& strings, int depth)
+{
+    if (depth > kMaxValueDepth) {
+        reader.bytes(-1);   // poisons the reader
+        return QVariant();
+    }
+
+    auto string = [&](quint64 index) {
+        if (index >= quint64(strings.size())) {
+            reader.bytes(-1);
+            return QString();
+        }
+        return strings.at(int(index));
+    };
+
+    switch (reader.byte()) {
+    case TagAbsent: return QVariant();
+    case TagFalse: return false;
+    case TagTrue: return true;
+    case TagInteger: {
+        const qint64 number = unzigzag(reader.varint());
+        return number == qint64(int(number)) ? QVariant(int(number)) : QVariant(number);
+    }
+    case TagCenti: return double(unzigzag(reader.varint())) / 100.0;
+    case TagDouble: {
+        const QByteArrayView bytes = reader.bytes(8);
+        if (!reader.ok()) return QVariant();
+        const quint64 bits = qFromBigEndian<quint64>(bytes.data());
+        double number;
+        std::memcpy(&number, &bits, sizeof number);
+        return number;
+    }
+    case TagString: return string(reader.varint());
+    case TagList: {
+        const quint64 count = reader.varint();
+        QVariantList list;
+        for (quint64 i = 0; i < count && reader.ok(); ++i) list.append(decodeValue(reader, strings, depth + 1));
+        return list;
+    }
+    case TagMap: {
+        const quint64 count = reader.varint();
+        QVariantMap map;
+        for (quint64 i = 0; i < count && reader.ok(); ++i) {
+            const QString key = string(reader.varint());
+            map.insert(key, decodeValue(reader, strings, depth + 1));
+        }
+        return map;
+    }
+    default:
+        reader.bytes(-1);
+        return QVariant();
+    }
+}
+
+// ===== Row <-> state =====
+quint8 trackFlags(const QVariantMap& row)
+{
+    quint8 flags = 0;
+    if (row.value("occupied").toBool()) flags |= kTrackOccupied;
+    if (row.value("assigned").toBool()) flags |= kTrackAssigned;
+    if (row.value("isActive", true).toBool()) flags |= kTrackActive;
+    return flags;
+}
+
+void signalRecord(const QVariantMap& row, char* out)
+{
+    out[0] = char(ElementCodes::aspectFromCode(row.value("currentAspect").toString())
+                  | ElementCodes::aspectFromCode(row.value("callingOnAspect").toString()) << 4);
+    out[1] = char(ElementCodes::aspectFromCode(row.value("loopAspect").toString())
+                  | (row.value("isActive", true).toBool() ? kSignalActive : 0));
+}
+
+quint8 pointRecord(const QVariantMap& row)
+{
+    return quint8(ElementCodes::positionFromCode(row.value("position").toString())
+                  | ElementCodes::statusFromCode(row.value("operatingStatus").toString()) << 2
+                  | (row.value("isLocked").toBool() ? kPointLocked : 0));
+}
+
+SignalState signalFromRecord(const uchar* record)
+{
+    SignalState state;
+    state.aspect = Aspect(record[0] & 0x0F);
+    state.callingOn = Aspect(record[0] >> 4);
+    state.loop = Aspect(record[1] & 0x0F);
+    state.active = record[1] & kSignalActive;
+    return state;
+}
+
+PointState pointFromRecord(quint8 record)
+{
+    PointState state;
+    state.position = PointPosition(record & 0x03);
+    state.status = OperatingStatus((record >> 2) & 0x07);
+    state.locked = record & kPointLocked;
+    return state;
+}
+
+void applyTrackState(const TrackState& state, QVariantMap* row)
+{
+    row->insert("occupied", state.occupied);
+    row->insert("assigned", state.assigned);
+    row->insert("isActive", state.active);
+    row->insert("occupiedBy", QString::fromUtf8(state.occupiedBy));
+}
+
+void applySignalState(const SignalState& state, QVariantMap* row)
+{
+    row->insert("currentAspect", ElementCodes::aspectCode(state.aspect));
+    row->insert("callingOnAspect", ElementCodes::aspectCode(state.callingOn));
+    row->insert("loopAspect", ElementCodes::aspectCode(state.loop));
+    row->insert("isActive", state.active);
+}
+
+void applyPointState(const PointState& state, QVariantMap* row)
+{
+    row->insert("position", ElementCodes::positionCode(state.position));
+    row->insert("operatingStatus", ElementCodes::statusCode(state.status));
+    row->insert("isLocked", state.locked);
+    row->insert("lockReason", QString::fromUtf8(state.lockReason));
+}
+
+QString rowText(StationStateStore::Table table, const QVariantMap& row)
+{
+    if (table == StationStateStore::TrackSegments) return row.value("occupiedBy").toString();
+    if (table == StationStateStore::PointMachines) return row.value("lockReason").toString();
+    return QString();
+}
+
+// Tables in snapshot order; text labels carry no live state
+constexpr int kLayoutTables = StationStateStore::TableCount + 1;
+
+const QVariantList& layoutRows(const StationStateStore& store, int table)
+{
+    return table < StationStateStore::TableCount ? store.rows(StationStateStore::Table(table)) : store.textLabels();
+}
+
+bool isLayoutKey(int table, const QString& key)
+{
+    return table >= StationStateStore::TableCount || !isStateKey(StationStateStore::Table(table), key);
+}
+
+} // namespace
+
+// ============================================================================
+// KEYS
+// ============================================================================
+
+bool isStateKey(StationStateStore::Table table, const QString& key)
+{
+    switch (table) {
+    case StationStateStore::TrackSegments:
+        return key == "occupied" || key == "assigned" || key == "isActive" || key == "occupiedBy";
+    case StationStateStore::Signals:
+        return key == "currentAspect" || key == "callingOnAspect" || key == "loopAspect" || key == "isActive";
+    case StationStateStore::PointMachines:
+        return key == "position" || key == "operatingStatus" || key == "isLocked" || key == "lockReason";
+    default:
+        return false;
+    }
+}
+
+bool sameLayout(StationStateStore::Table table, const QVariantMap& a, const QVariantMap& b)
+{
+    for (auto it = a.cbegin(); it != a.cend(); ++it) {
+        if (!isStateKey(table, it.key()) && b.value(it.key()) != it.value()) return false;
+    }
+    for (auto it = b.cbegin(); it != b.cend(); ++it) {
+        if (!isStateKey(table, it.key()) && !a.contains(it.key())) return false;
+    }
+    return true;
+}
+
+// ============================================================================
+// SNAPSHOTS
+// ============================================================================
+
+QByteArray encodeSnapshot(const StationStateStore& store)
+{
+    // Layout: rows first (interning as we go), string table in front of them
+    StringTable strings;
+    const quint64 stationIndex = strings.intern(store.stationId());
+
+    QByteArray tables;
+    for (int table = 0; table < kLayoutTables; ++table) {
+        const QVariantList& rows = layoutRows(store, table);
+
+        QStringList keys;
+        for (const QVariant& row : rows) {
+            const QVariantMap map = row.toMap();
+            for (auto it = map.cbegin(); it != map.cend(); ++it) {
+                if (isLayoutKey(table, it.key()) && !keys.contains(it.key())) keys.append(it.key());
+            }
+        }
+
+        appendVarint(&tables, quint64(rows.size()));
+        appendVarint(&tables, quint64(keys.size()));
+        for (const QString& key : std::as_const(keys)) appendVarint(&tables, strings.intern(key));
+        for (const QVariant& row : rows) {
+            const QVariantMap map = row.toMap();
+            for (const QString& key : std::as_const(keys)) encodeValue(&tables, map.value(key), &strings);
+        }
+    }
+
+    QByteArray layout;
+    strings.write(&layout);
+    appendVarint(&layout, stationIndex);
+    layout += tables;
+
+    QByteArray out;
+    out.append(kMagic, 3);
+    out.append(char(kVersion));
+    appendU32(&out, quint32(layout.size()));
+    out += layout;
+
+    // State
+    const QVariantList& tracks = store.rows(StationStateStore::TrackSegments);
+    const QVariantList& signalRows = store.rows(StationStateStore::Signals);
+    const QVariantList& points = store.rows(StationStateStore::PointMachines);
+    appendU32(&out, quint32(tracks.size()));
+    appendU32(&out, quint32(signalRows.size()));
+    appendU32(&out, quint32(points.size()));
+
+    const int bitsetSize = (tracks.size() + 7) / 8;
+    QByteArray occupied(bitsetSize, '\0');
+    QByteArray assigned(bitsetSize, '\0');
+    QByteArray active(bitsetSize, '\0');
+    for (int i = 0; i < tracks.size(); ++i) {
+        const quint8 flags = trackFlags(tracks.at(i).toMap());
+        if (flags & kTrackOccupied) occupied[i >> 3] = char(occupied[i >> 3] | (1 << (i & 7)));
+        if (flags & kTrackAssigned) assigned[i >> 3] = char(assigned[i >> 3] | (1 << (i & 7)));
+        if (flags & kTrackActive) active[i >> 3] = char(active[i >> 3] | (1 << (i & 7)));
+    }
+    out += occupied;
+    out += assigned;
+    out += active;
+
+    for (const QVariant& row : signalRows) {
+        char record[2];
+        signalRecord(row.toMap(), record);
+        out.append(record, 2);
+    }
+    for (const QVariant& row : points) {
+        out.append(char(pointRecord(row.toMap())));
+    }
+
+    // Free text is rare (train IDs, lock reasons): sparse entries plus a heap
+    QByteArray entries;
+    QByteArray heap;
+    quint32 textCount = 0;
+    for (StationStateStore::Table table : {StationStateStore::TrackSegments, StationStateStore::PointMachines}) {
+        const QVariantList& rows = store.rows(table);
+        for (int i = 0; i < rows.size(); ++i) {
+            const QByteArray text = rowText(table, rows.at(i).toMap()).toUtf8().left(0xFFFF);
+            if (text.isEmpty()) continue;
+            entries.append(char(table));
+            appendU32(&entries, quint32(i));
+            appendU32(&entries, quint32(heap.size()));
+            appendU16(&entries, quint16(text.size()));
+            heap += text;
+            ++textCount;
+        }
+    }
+    appendU32(&out, textCount);
+    out += entries;
+    out += heap;
+    return out;
+}
+
+bool decodeSnapshot(QByteArrayView data, StationStateStore* store)
+{
+    Reader reader(data);
+    const bool header = readHeader(reader);
+    const QByteArrayView layout = reader.bytes(reader.u32());
+    if (!header || !reader.ok()) return false;
+
+    Reader layoutReader(layout);
+    const quint64 stringCount = layoutReader.varint();
+    if (stringCount > quint64(layout.size())) return false;
+    QStringList strings;
+    strings.reserve(int(stringCount));
+    for (quint64 i = 0; i < stringCount && layoutReader.ok(); ++i) {
+        strings.append(QString::fromUtf8(layoutReader.bytes(qsizetype(layoutReader.varint()))));
+    }
+    const quint64 stationIndex = layoutReader.varint();
+    if (!layoutReader.ok() || stationIndex >= quint64(strings.size())) return false;
+
+    QVariantList tables[kLayoutTables];
+    for (int table = 0; table < kLayoutTables; ++table) {
+        const quint64 rowCount = layoutReader.varint();
+        const quint64 keyCount = layoutReader.varint();
+        if (!layoutReader.ok() || rowCount > kMaxRows || keyCount > quint64(strings.size())) return false;
+
+        QStringList keys;
+        for (quint64 k = 0; k < keyCount; ++k) {
+            const quint64 keyIndex = layoutReader.varint();
+            if (keyIndex >= quint64(strings.size())) return false;
+            keys.append(strings.at(int(keyIndex)));
+        }
+
+        tables[table].reserve(int(rowCount));
+        for (quint64 r = 0; r < rowCount && layoutReader.ok(); ++r) {
+            QVariantMap row;
+            for (const QString& key : std::as_const(keys)) {
+                const QVariant value = decodeValue(layoutReader, strings, 0);
+                if (value.isValid()) row.insert(key, value);
+            }
+            tables[table].append(row);
+        }
+    }
+    if (!layoutReader.ok()) return false;
+
+    StateView state;
+    if (!state.parse(data) || state.trackCount() != tables[StationStateStore::TrackSegments].size()
+        || state.signalCount() != tables[StationStateStore::Signals].size()
+        || state.pointCount() != tables[StationStateStore::PointMachines].size()) {
+        return false;
+    }
+
+    for (int i = 0; i < state.trackCount(); ++i) {
+        QVariantMap row = tables[StationStateStore::TrackSegments].at(i).toMap();
+        applyTrackState(state.track(i), &row);
+        tables[StationStateStore::TrackSegments][i] = row;
+    }
+    for (int i = 0; i < state.signalCount(); ++i) {
+        QVariantMap row = tables[StationStateStore::Signals].at(i).toMap();
+        applySignalState(state.signal(i), &row);
+        tables[StationStateStore::Signals][i] = row;
+    }
+    for (int i = 0; i < state.pointCount(); ++i) {
+        QVariantMap row = tables[StationStateStore::PointMachines].at(i).toMap();
+        applyPointState(state.point(i), &row);
+        tables[StationStateStore::PointMachines][i] = row;
+    }
+
+    store->reset(strings.at(int(stationIndex)), tables[StationStateStore::TrackSegments],
+                 tables[StationStateStore::Signals], tables[StationStateStore::PointMachines],
+                 tables[StationStateStore::TableCount]);
+    return true;
+}
+
+// ============================================================================
+// STATE VIEW
+// ============================================================================
+
+bool StateView::parse(QByteArrayView snapshot)
+{
+    *this = StateView();
+
+    Reader reader(snapshot);
+    if (!readHeader(reader)) return false;
+    reader.bytes(reader.u32());   // layout section
+
+    const quint32 tracks = reader.u32();
+    const quint32 signalCount = reader.u32();
+    const quint32 points = reader.u32();
+    if (!reader.ok() || tracks > kMaxRows || signalCount > kMaxRows || points > kMaxRows) return false;
+
+    const qsizetype bitsetSize = (qsizetype(tracks) + 7) / 8;
+    m_occupied = reinterpret_cast<const uchar*>(reader.bytes(bitsetSize).data());
+    m_assigned = reinterpret_cast<const uchar*>(reader.bytes(bitsetSize).data());
+    m_active = reinterpret_cast<const uchar*>(reader.bytes(bitsetSize).data());
+    m_signals = reinterpret_cast<const uchar*>(reader.bytes(2 * qsizetype(signalCount)).data());
+    m_points = reinterpret_cast<const uchar*>(reader.bytes(points).data());
+
+    const quint32 textCount = reader.u32();
+    if (!reader.ok() || textCount > kMaxRows) return false;
+    m_textEntries = reinterpret_cast<const uchar*>(reader.bytes(kTextEntrySize * qsizetype(textCount)).data());
+    m_textHeap = reader.position();
+    m_textHeapSize = snapshot.data() + snapshot.size() - reader.position();
+    if (!reader.ok()) {
+        *this = StateView();
+        return false;
+    }
+
+    // A cut-off heap is refused here instead of reading back as missing text
+    for (quint32 i = 0; i < textCount; ++i) {
+        const uchar* entry = m_textEntries + kTextEntrySize * qsizetype(i);
+        if (qsizetype(qFromBigEndian<quint32>(entry + 5)) + qFromBigEndian<quint16>(entry + 9) > m_textHeapSize) {
+            *this = StateView();
+            return false;
+        }
+    }
+
+    m_trackCount = int(tracks);
+    m_signalCount = int(signalCount);
+    m_pointCount = int(points);
+    m_textCount = int(textCount);
+    return true;
+}
+
+TrackState StateView::track(int row) const
+{
+    TrackState state;
+    if (row < 0 || row >= m_trackCount) return state;
+    state.occupied = bit(m_occupied, row);
+    state.assigned = bit(m_assigned, row);
+    state.active = bit(m_active, row);
+    state.occupiedBy = text(StationStateStore::TrackSegments, row);
+    return state;
+}
+
+SignalState StateView::signal(int row) const
+{
+    if (row < 0 || row >= m_signalCount) return SignalState();
+    return signalFromRecord(m_signals + 2 * row);
+}
+
+PointState StateView::point(int row) const
+{
+    if (row < 0 || row >= m_pointCount) return PointState();
+    PointState state = pointFromRecord(m_points[row]);
+    state.lockReason = text(StationStateStore::PointMachines, row);
+    return state;
+}
+
+QByteArrayView StateView::text(StationStateStore::Table table, int row) const
+{
+    // Entries are sorted by (table, row)
+    const quint64 key = quint64(table) << 32 | quint32(row);
+    int low = 0;
+    int high = m_textCount;
+    while (low < high) {
+        const int middle = (low + high) / 2;
+        const uchar* entry = m_textEntries + kTextEntrySize * middle;
+        const quint64 entryKey = quint64(entry[0]) << 32 | qFromBigEndian<quint32>(entry + 1);
+        if (entryKey == key) {
+            const quint32 offset = qFromBigEndian<quint32>(entry + 5);
+            const quint16 length = qFromBigEndian<quint16>(entry + 9);
+            if (qsizetype(offset) + length > m_textHeapSize) return QByteArrayView();
+            return QByteArrayView(m_textHeap + offset, length);
+        }
+        if (entryKey < key) low = middle + 1;
+        else high = middle;
+    }
+    return QByteArrayView();
+}
+
+// ============================================================================
+// DELTAS
+// ============================================================================
+
+QByteArray encodeDelta(quint64 sequence, StationStateStore::Table table, int row, const QVariantMap& state)
+{
+    QByteArray out;
+    appendVarint(&out, sequence);
+    out.append(char(table));
+    appendVarint(&out, quint64(row));
+
+    const QString text = rowText(table, state);
+    switch (table) {
+    case StationStateStore::TrackSegments:
+        out.append(char(trackFlags(state) | (text.isEmpty() ? 0 : kHasText)));
+        break;
+    case StationStateStore::Signals: {
+        char record[2];
+        signalRecord(state, record);
+        out.append(record, 2);
+        break;
+    }
+    case StationStateStore::PointMachines:
+        out.append(char(pointRecord(state) | (text.isEmpty() ? 0 : kPointHasText)));
+        break;
+    default:
+        break;
+    }
+    if (!text.isEmpty()) appendText(&out, text);
+    return out;
+}
+
+bool decodeDelta(QByteArrayView data, Delta* delta)
+{
+    Reader reader(data);
+    delta->sequence = reader.varint();
+    const quint8 table = reader.byte();
+    const quint64 row = reader.varint();
+    if (!reader.ok() || table >= StationStateStore::TableCount || row >= kMaxRows) return false;
+
+    delta->table = StationStateStore::Table(table);
+    delta->row = int(row);
+    delta->track = TrackState();
+    delta->signal = SignalState();
+    delta->point = PointState();
+
+    switch (delta->table) {
+    case StationStateStore::TrackSegments: {
+        const quint8 flags = reader.byte();
+        delta->track.occupied = flags & kTrackOccupied;
+        delta->track.assigned = flags & kTrackAssigned;
+        delta->track.active = flags & kTrackActive;
+        if (flags & kHasText) delta->track.occupiedBy = reader.bytes(qsizetype(reader.varint()));
+        break;
+    }
+    case StationStateStore::Signals: {
+        const QByteArrayView record = reader.bytes(2);
+        if (reader.ok()) delta->signal = signalFromRecord(reinterpret_cast<const uchar*>(record.data()));
+        break;
+    }
+    case StationStateStore::PointMachines: {
+        const quint8 record = reader.byte();
+        delta->point = pointFromRecord(record);
+        if (record & kPointHasText) delta->point.lockReason = reader.bytes(qsizetype(reader.varint()));
+        break;
+    }
+    default:
+        return false;
+    }
+    return reader.ok();
+}
+
+void applyDelta(const Delta& delta, QVariantMap* row)
+{
+    switch (delta.table) {
+    case StationStateStore::TrackSegments: applyTrackState(delta.track, row); break;
+    case StationStateStore::Signals: applySignalState(delta.signal, row); break;
+    case StationStateStore::PointMachines: applyPointState(delta.point, row); break;
+    default: break;
+    }
+}
+
+// ============================================================================
+// PRIMITIVES
+// ============================================================================
+
+void appendVarint(QByteArray* out, quint64 value)
+{
+    while (value >= 0x80) {
+        out->append(char(value | 0x80));
+        value >>= 7;
+    }
+    out->append(char(value));
+}
+
+bool Reader::need(qsizetype size)
+{
+    if (!m_ok || size < 0 || m_end - m_pos < size) {
+        m_ok = false;
+        return false;
+    }
+    return true;
+}
+
+quint64 Reader::varint()
+{
+    quint64 value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (!need(1)) return 0;
+        const quint8 byte = quint8(*m_pos++);
+        value |= quint64(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return value;
+    }
+    m_ok = false;
+    return 0;
+}
+
+quint8 Reader::byte()
+{
+    if (!need(1)) return 0;
+    return quint8(*m_pos++);
+}
+
+quint16 Reader::u16()
+{
+    if (!need(2)) return 0;
+    const quint16 value = qFromBigEndian<quint16>(m_pos);
+    m_pos += 2;
+    return value;
+}
+
+quint32 Reader::u32()
+{
+    if (!need(4)) return 0;
+    const quint32 value = qFromBigEndian<quint32>(m_pos);
+    m_pos += 4;
+    return value;
+}
+
+QByteArrayView Reader::bytes(qsizetype size)
+{
+    if (!need(size)) return QByteArrayView();
+    const QByteArrayView view(m_pos, size);
+    m_pos += size;
+    return view;
+}
+
+} // namespace StationWire
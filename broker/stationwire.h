@@ -0,0 +1,153 @@
+#pragma once
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QString>
+#include <QVariantMap>
+#include <QtGlobal>
+
+#include "broker/statestore.h"
+#include "database/elementcodes.h"
+
+// Compact binary encoding of a station's layout and live state, shared by
+// the broker transport and anything that keeps a snapshot on disk.
+//
+// Snapshot blob (self-contained):
+//   offset  size  field
+//   0       3     magic "RFS"
+//   3       1     version (kVersion)
+//   4       4     layout section size L, big endian
+//   8       L     layout section
+//   8+L     ...   state section
+//
+// Layout section: station ID, a string table holding every distinct string
+// once (IDs, names, keys, enum-like text), then per table a key list and the
+// rows' static fields as tagged varint-coded values. Coordinates travel as
+// hundredths (the database's NUMERIC(10,2) precision). It only changes when
+// the layout does.
+//
+// State section (fixed offsets, read in place by StateView):
+//   u32 track, signal, point counts (big endian)
+//   track occupied / assigned / active bitsets, ceil(tracks / 8) bytes each
+//   signal records, 2 bytes each: aspect | calling-on << 4, loop | active << 4
+//   point records, 1 byte each: position | status << 2 | locked << 5
+//   u32 text count, text entries {u8 table, u32 row, u32 offset, u16 length}
+//   sorted by (table, row), then the UTF-8 text heap (occupiedBy, lockReason)
+//
+// Entities are addressed by row index (snapshot order) everywhere after the
+// layout section. A delta is a varint sequence number, the table, a varint
+// row index and that row's state record.
+namespace StationWire {
+
+constexpr quint8 kVersion = 2;
+
+// Record values are the shared element codes
+using Aspect = ElementCodes::Aspect;
+using PointPosition = ElementCodes::Position;
+using OperatingStatus = ElementCodes::Status;
+
+// Live state; text members view the decoded buffer (UTF-8) and never own it
+struct TrackState {
+    bool occupied = false;
+    bool assigned = false;
+    bool active = true;
+    QByteArrayView occupiedBy;
+};
+
+struct SignalState {
+    Aspect aspect = ElementCodes::AspectUnknown;
+    Aspect callingOn = ElementCodes::AspectUnknown;
+    Aspect loop = ElementCodes::AspectUnknown;
+    bool active = true;
+};
+
+struct PointState {
+    PointPosition position = ElementCodes::PositionUnknown;
+    OperatingStatus status = ElementCodes::StatusUnknown;
+    bool locked = false;
+    QByteArrayView lockReason;
+};
+
+// Row keys that are live state (everything else is layout)
+bool isStateKey(StationStateStore::Table table, const QString& key);
+// True when two rows differ at most in live state
+bool sameLayout(StationStateStore::Table table, const QVariantMap& a, const QVariantMap& b);
+
+// ===== Snapshots =====
+QByteArray encodeSnapshot(const StationStateStore& store);
+// Rebuilds full rows (layout + state); false on a malformed or foreign blob
+bool decodeSnapshot(QByteArrayView data, StationStateStore* store);
+
+// Zero-copy typed access to a snapshot's state section
+class StateView {
+public:
+    bool parse(QByteArrayView snapshot);
+
+    int trackCount() const { return m_trackCount; }
+    int signalCount() const { return m_signalCount; }
+    int pointCount() const { return m_pointCount; }
+
+    TrackState track(int row) const;
+    SignalState signal(int row) const;
+    PointState point(int row) const;
+
+private:
+    QByteArrayView text(StationStateStore::Table table, int row) const;
+
+    const uchar* m_occupied = nullptr;
+    const uchar* m_assigned = nullptr;
+    const uchar* m_active = nullptr;
+    const uchar* m_signals = nullptr;
+    const uchar* m_points = nullptr;
+    const uchar* m_textEntries = nullptr;
+    const char* m_textHeap = nullptr;
+    qsizetype m_textHeapSize = 0;
+    int m_trackCount = 0;
+    int m_signalCount = 0;
+    int m_pointCount = 0;
+    int m_textCount = 0;
+};
+
+// ===== Deltas =====
+struct Delta {
+    quint64 sequence = 0;
+    StationStateStore::Table table = StationStateStore::TrackSegments;
+    int row = 0;
+    TrackState track;
+    SignalState signal;
+    PointState point;
+};
+
+QByteArray encodeDelta(quint64 sequence, StationStateStore::Table table, int row, const QVariantMap& state);
+bool decodeDelta(QByteArrayView data, Delta* delta);
+
+// Writes the delta's state into a full row
+void applyDelta(const Delta& delta, QVariantMap* row);
+
+// ===== Primitives (also used by the broker protocol) =====
+void appendVarint(QByteArray* out, quint64 value);
+
+class Reader {
+public:
+    explicit Reader(QByteArrayView data)
+        : m_pos(data.data()), m_end(data.data() + data.size()) {}
+
+    bool ok() const { return m_ok; }
+    bool atEnd() const { return m_pos >= m_end; }
+    const char* position() const { return m_pos; }
+
+    quint64 varint();
+    quint8 byte();
+    quint16 u16();
+    quint32 u32();
+    QByteArrayView bytes(qsizetype size);
+
+private:
+    bool need(qsizetype size);
+
+    const char* m_pos;
+    const char* m_end;
+    bool m_ok = true;
+};
+
+} // namespace StationWire
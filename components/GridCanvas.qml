@@ -1,4 +1,5 @@
 import QtQuick
+import RailFlux.Rendering
 
 Item {
     id: canvas
@@ -12,64 +13,31 @@ Item {
     property color gridColorPrimary: "#cc0000"     // Every 20th line (red)
     property real gridOpacity: 0.4
 
-    // VERTICAL GRID LINES
-    Repeater {
-        model: showGrid ? Math.ceil(canvas.width / gridSize) + 1 : 0
-
-        Rectangle {
-            x: index * gridSize
-            y: 0
-            width: getLineWidth(index)
-            height: canvas.height
-            color: getGridColor(index)
-            opacity: canvas.gridOpacity
-        }
-    }
-
-    // HORIZONTAL GRID LINES
-    Repeater {
-        model: showGrid ? Math.ceil(canvas.height / gridSize) + 1 : 0
-
-        Rectangle {
-            x: 0
-            y: index * gridSize
-            width: canvas.width
-            height: getLineWidth(index)
-            color: getGridColor(index)
-            opacity: canvas.gridOpacity
-        }
-    }
-
-    // GRID LINE STYLING FUNCTIONS
-    function getGridColor(lineIndex) {
-        if (lineIndex % 20 === 0) {
-            return gridColorPrimary    // Every 20th = RED
-        } else if (lineIndex % 10 === 0) {
-            return gridColorMajor      // Every 10th = WHITE-ISH
-        } else {
-            return gridColorNormal     // Regular = SUBTLE
-        }
-    }
-
-    function getLineWidth(lineIndex) {
-        if (lineIndex % 20 === 0) {
-            return 2    // Primary grid lines = 2px wide
-        } else if (lineIndex % 10 === 0) {
-            return 1    // Major grid lines = 1px wide
-        } else {
-            return 1    // Normal grid lines = 1px wide
-        }
+    // Visible part of the canvas in pixels; only labels inside it are created
+    property rect viewRect: Qt.rect(0, 0, width, height)
+    readonly property int firstCol: Math.max(0, Math.floor(viewRect.x / gridSize))
+    readonly property int firstRow: Math.max(0, Math.floor(viewRect.y / gridSize))
+
+    // GRID LINES: one scene-graph node, one draw call
+    GridRenderer {
+        anchors.fill: parent
+        visible: canvas.showGrid
+        gridSize: canvas.gridSize
+        gridColorNormal: canvas.gridColorNormal
+        gridColorMajor: canvas.gridColorMajor
+        gridColorPrimary: canvas.gridColorPrimary
+        gridOpacity: canvas.gridOpacity
     }
 
     // GRID LABELS (Optional - like CAD software)
     // Row numbers on left side
     Repeater {
-        model: showGrid ? Math.floor(canvas.height / gridSize / 10) : 0
+        model: showGrid ? Math.floor(viewRect.height / gridSize / 10) + 1 : 0
 
         Text {
-            x: 2
-            y: (index * 10 * gridSize) + 2
-            text: (index * 10).toString()
+            x: viewRect.x + 2
+            y: ((Math.ceil(canvas.firstRow / 10) + index) * 10 * gridSize) + 2
+            text: ((Math.ceil(canvas.firstRow / 10) + index) * 10).toString()
             color: "#999999"
             font.pixelSize: 8
             font.family: "monospace"
@@ -78,12 +46,12 @@ Item {
 
     // Column numbers on top
     Repeater {
-        model: showGrid ? Math.floor(canvas.width / gridSize / 10) : 0
+        model: showGrid ? Math.floor(viewRect.width / gridSize / 10) + 1 : 0
 
         Text {
-            x: (index * 10 * gridSize) + 2
-            y: 2
-            text: (index * 10).toString()
+            x: ((Math.ceil(canvas.firstCol / 10) + index) * 10 * gridSize) + 2
+            y: viewRect.y + 2
+            text: ((Math.ceil(canvas.firstCol / 10) + index) * 10).toString()
             color: "#999999"
             font.pixelSize: 8
             font.family: "monospace"
@@ -0,0 +1,256 @@
+// components/LatencyDiagnosticsPanel.qml
+import QtQuick
+
+Rectangle {
+    id: latencyPanel
+
+    // ============================================================================
+    // COMPONENT PROPERTIES
+    // ============================================================================
+    property var tracer: null                           // CommandTracer (globalCommandTracer)
+    property var simulator: null                        // TrainSimulator (globalTrainSimulator)
+    property int simulatedTrains: 20
+    property string lastDumpPath: ""
+
+    width: 460
+    height: Math.min(420, headerRow.height + tableHeader.height + summaryList.contentHeight + simulatorRow.height + footer.height + 48)
+
+    color: "#2d3748"
+    border.color: "#3182ce"
+    border.width: 2
+    radius: 6
+
+    function formatMs(value) {
+        return value < 10 ? value.toFixed(2) : value.toFixed(1)
+    }
+
+    Row {
+        id: headerRow
+        anchors.top: parent.top
+        anchors.left: parent.left
+        anchors.right: parent.right
+        anchors.margins: 8
+        height: 24
+
+        Text {
+            width: parent.width - closeButton.width
+            text: "⏱ Command Latency"
+            color: "#ffffff"
+            font.pixelSize: 14
+            font.weight: Font.Bold
+            verticalAlignment: Text.AlignVCenter
+            height: parent.height
+        }
+
+        Rectangle {
+            id: closeButton
+            width: 24
+            height: 24
+            radius: 4
+            color: closeMouse.containsMouse ? "#4a90c2" : "#5a6478"
+
+            Text {
+                anchors.centerIn: parent
+                text: "✕"
+                color: "#ffffff"
+                font.pixelSize: 12
+            }
+
+            MouseArea {
+                id: closeMouse
+                anchors.fill: parent
+                hoverEnabled: true
+                cursorShape: Qt.PointingHandCursor
+                onClicked: latencyPanel.visible = false
+            }
+        }
+    }
+
+    Row {
+        id: tableHeader
+        anchors.top: headerRow.bottom
+        anchors.left: parent.left
+        anchors.right: parent.right
+        anchors.margins: 8
+        height: 18
+
+        Repeater {
+            model: [
+                { title: "Command", width: 130 },
+                { title: "Stage", width: 120 },
+                { title: "n", width: 40 },
+                { title: "p50 ms", width: 55 },
+                { title: "p99 ms", width: 55 },
+                { title: "max ms", width: 55 }
+            ]
+
+            Text {
+                width: modelData.width
+                text: modelData.title
+                color: "#a0aec0"
+                font.pixelSize: 10
+                font.weight: Font.Bold
+            }
+        }
+    }
+
+    ListView {
+        id: summaryList
+        anchors.top: tableHeader.bottom
+        anchors.left: parent.left
+        anchors.right: parent.right
+        anchors.bottom: simulatorRow.top
+        anchors.margins: 8
+        clip: true
+        model: tracer ? tracer.summary : []
+
+        delegate: Row {
+            height: 16
+
+            // end_to_end is the number operators feel; highlight it
+            property bool headline: modelData.stage === "end_to_end"
+
+            Text { width: 130; text: modelData.commandType; color: "#ffffff"; font.pixelSize: 10; font.weight: headline ? Font.Bold : Font.Normal }
+            Text { width: 120; text: modelData.stage; color: headline ? "#38a169" : "#a0aec0"; font.pixelSize: 10 }
+            Text { width: 40; text: modelData.count; color: "#a0aec0"; font.pixelSize: 10 }
+            Text { width: 55; text: latencyPanel.formatMs(modelData.p50Ms); color: "#ffffff"; font.pixelSize: 10 }
+            Text { width: 55; text: latencyPanel.formatMs(modelData.p99Ms); color: "#d69e2e"; font.pixelSize: 10 }
+            Text { width: 55; text: latencyPanel.formatMs(modelData.maxMs); color: "#e53e3e"; font.pixelSize: 10 }
+        }
+
+        Text {
+            anchors.centerIn: parent
+            visible: summaryList.count === 0
+            text: "No completed commands yet"
+            color: "#a0aec0"
+            font.pixelSize: 10
+            font.italic: true
+        }
+    }
+
+    // Synthetic traffic: drives occupancy through the normal update path
+    Row {
+        id: simulatorRow
+        anchors.bottom: footer.top
+        anchors.left: parent.left
+        anchors.right: parent.right
+        anchors.leftMargin: 8
+        anchors.rightMargin: 8
+        anchors.bottomMargin: 4
+        height: simulator ? 22 : 0
+        visible: simulator !== null
+        spacing: 8
+
+        Text {
+            width: parent.width - trainsButton.width - parent.spacing
+            height: parent.height
+            verticalAlignment: Text.AlignVCenter
+            elide: Text.ElideRight
+            text: !simulator ? ""
+                  : simulator.running ? "🚆 " + simulator.trainCount + " trains, " + simulator.updatesPerSecond.toFixed(1)
+                                        + " updates/s, " + simulator.waitingTrains + " waiting"
+                                      : "🚆 Train simulation idle (" + simulator.stepIntervalMs + " ms/step)"
+            color: "#a0aec0"
+            font.pixelSize: 9
+        }
+
+        Rectangle {
+            id: trainsButton
+            width: 80
+            height: parent.height
+            radius: 3
+            color: trainsMouse.pressed ? "#2c5aa0" : (simulator && simulator.running ? "#c53030" : "#38a169")
+
+            Text {
+                anchors.centerIn: parent
+                text: simulator && simulator.running ? "Stop trains" : "Run trains"
+                color: "#ffffff"
+                font.pixelSize: 9
+                font.weight: Font.Bold
+            }
+
+            MouseArea {
+                id: trainsMouse
+                anchors.fill: parent
+                onClicked: {
+                    if (!simulator) return
+                    if (simulator.running) simulator.stop()
+                    else simulator.start(latencyPanel.simulatedTrains)
+                }
+            }
+        }
+    }
+
+    Row {
+        id: footer
+        anchors.bottom: parent.bottom
+        anchors.left: parent.left
+        anchors.right: parent.right
+        anchors.margins: 8
+        height: 22
+        spacing: 8
+
+        Text {
+            width: parent.width - resetButton.width - dumpButton.width - 2 * parent.spacing
+            height: parent.height
+            verticalAlignment: Text.AlignVCenter
+            elide: Text.ElideMiddle
+            text: lastDumpPath !== "" ? "Saved: " + lastDumpPath
+                                      : (tracer ? tracer.completedCount + " completed, " + tracer.pendingCount + " in flight" : "")
+            color: "#a0aec0"
+            font.pixelSize: 9
+        }
+
+        Rectangle {
+            id: resetButton
+            width: 60
+            height: parent.height
+            radius: 3
+            color: resetMouse.pressed ? "#2c5aa0" : "#4a5568"
+
+            Text {
+                anchors.centerIn: parent
+                text: "Reset"
+                color: "#ffffff"
+                font.pixelSize: 9
+                font.weight: Font.Bold
+            }
+
+            MouseArea {
+                id: resetMouse
+                anchors.fill: parent
+                onClicked: {
+                    if (tracer) tracer.reset()
+                    latencyPanel.lastDumpPath = ""
+                }
+            }
+        }
+
+        Rectangle {
+            id: dumpButton
+            width: 80
+            height: parent.height
+            radius: 3
+            color: dumpMouse.pressed ? "#2c5aa0" : "#3182ce"
+
+            Text {
+                anchors.centerIn: parent
+                text: "💾 Dump"
+                color: "#ffffff"
+                font.pixelSize: 9
+                font.weight: Font.Bold
+            }
+
+            MouseArea {
+                id: dumpMouse
+                anchors.fill: parent
+                onClicked: {
+                    if (!tracer) return
+                    var path = tracer.dumpToFile("")
+                    latencyPanel.lastDumpPath = path
+                    console.log("Latency dump:", path !== "" ? path : "failed")
+                }
+            }
+        }
+    }
+}
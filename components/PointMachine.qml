@@ -20,8 +20,8 @@ Item {
     property bool isLocked: false                       // ✅ NEW
     property string lockReason: ""                      // ✅ NEW
 
-    // ✅ NEW: Track data lookup function (passed from parent)
-    property var trackDataLookup: null
+    // Track topology graph (globalTrackTopology) for O(1) endpoint lookups
+    property var topology: null
 
     // ============================================================================
     // VISUAL CONFIGURATION CONSTANTS (unchanged)
@@ -88,20 +88,16 @@ Item {
     // ✅ UPDATED: HELPER FUNCTIONS (database-aware)
     // ============================================================================
 
-    function getRootTrackData() {
-        if (!trackDataLookup || !rootTrack.trackId) return null;
-        return trackDataLookup(rootTrack.trackId);
+    function getTrackEndpoint(trackInfo) {
+        if (!topology || !trackInfo.trackId) return { row: 0, col: 0 };
+        if (topology.layoutVersion < 1) return { row: 0, col: 0 };   // also re-evaluates on rebuild
+
+        var endpoint = topology.trackEndpoint(trackInfo.trackId, trackInfo.connectionEnd);
+        return endpoint.row !== undefined ? endpoint : { row: 0, col: 0 };
     }
 
     function getRootEndpoint() {
-        var trackData = getRootTrackData();
-        if (!trackData) return { row: 0, col: 0 };
-
-        if (rootTrack.connectionEnd === "START") {
-            return { row: trackData.startRow, col: trackData.startCol };
-        } else {
-            return { row: trackData.endRow, col: trackData.endCol };
-        }
+        return getTrackEndpoint(rootTrack);
     }
 
     function getJunctionPixel() {
@@ -125,22 +121,8 @@ Item {
         return (position === "NORMAL") ? normalTrack : reverseTrack;
     }
 
-    function getActiveTrackData() {
-        var activeInfo = getActiveTrackInfo();
-        if (!trackDataLookup || !activeInfo.trackId) return null;
-        return trackDataLookup(activeInfo.trackId);
-    }
-
     function getActiveEndpoint() {
-        var trackData = getActiveTrackData();
-        var activeInfo = getActiveTrackInfo();
-        if (!trackData) return { row: 0, col: 0 };
-
-        if (activeInfo.connectionEnd === "START") {
-            return { row: trackData.startRow, col: trackData.startCol };
-        } else {
-            return { row: trackData.endRow, col: trackData.endCol };
-        }
+        return getTrackEndpoint(getActiveTrackInfo());
     }
 
     function getActivePixel() {
@@ -0,0 +1,77 @@
+#include "connectionsupervisor.h"
+#include "database/portprobe.h"
+
+#include <QDebug>
+#include <QRandomGenerator>
+
+ConnectionSupervisor::ConnectionSupervisor(QObject* parent)
+    : QObject(parent)
+{
+    m_retryTimer.setSingleShot(true);
+    connect(&m_retryTimer, &QTimer::timeout, this, &ConnectionSupervisor::probe);
+}
+
+void ConnectionSupervisor::setEndpoint(const QString& hostName, int port)
+{
+    m_hostName = hostName;
+    m_port = port;
+}
+
+void ConnectionSupervisor::connectionLost(bool immediate)
+{
+    if (m_reconnecting && !immediate) return;
+
+    m_reconnecting = true;
+    if (immediate) {
+        m_retryTimer.start(0);
+        return;
+    }
+    scheduleAttempt();
+}
+
+void ConnectionSupervisor::attemptFailed()
+{
+    if (m_reconnecting) scheduleAttempt();
+}
+
+void ConnectionSupervisor::connectionRestored()
+{
+    if (m_attempt > 0) {
+        qDebug() << "🔌 Database reachable again after" << m_attempt << "attempt(s)";
+    }
+    m_reconnecting = false;
+    m_attempt = 0;
+    ++m_probeGeneration;
+    m_retryTimer.stop();
+}
+
+void ConnectionSupervisor::scheduleAttempt()
+{
+    const int delay = nextDelayMs();
+    ++m_attempt;
+    qDebug() << "🔌 Database reconnect attempt" << m_attempt << "in" << delay << "ms";
+    emit reconnectScheduled(m_attempt, delay);
+    m_retryTimer.start(delay);
+}
+
+void ConnectionSupervisor::probe()
+{
+    if (!m_reconnecting) return;
+
+    const int generation = ++m_probeGeneration;
+    PortProbe::probe(this, m_hostName, m_port, kProbeTimeoutMs, [this, generation](bool reachable) {
+        if (!m_reconnecting || generation != m_probeGeneration) return;
+        if (reachable) {
+            emit serverReachable();
+        } else if (!m_retryTimer.isActive()) {
+            scheduleAttempt();
+        }
+    });
+}
+
+int ConnectionSupervisor::nextDelayMs() const
+{
+    const int shift = qMin(m_attempt, 16);
+    const int cap = int(qMin<qint64>(kMaxBackoffMs, qint64(kInitialBackoffMs) << shift));
+    return cap / 2 + int(QRandomGenerator::global()->bounded(cap / 2 + 1));
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <QObject>
+#include <QString>
+#include <QTimer>
+
+// Reconnect loop for DatabaseManager after a lost session.
+//
+// Nothing here blocks: each attempt is an asynchronous TCP probe of the
+// server port, and only once the port accepts does serverReachable() ask
+// the manager to reopen its session (bounded by connect_timeout). Between
+// attempts the delay grows exponentially from kInitialBackoffMs up to
+// kMaxBackoffMs with "equal jitter" (a random point in the upper half), so
+// a fleet of HMIs does not hammer a restarting server in lockstep.
+class ConnectionSupervisor : public QObject {
+    Q_OBJECT
+
+public:
+    explicit ConnectionSupervisor(QObject* parent = nullptr);
+
+    void setEndpoint(const QString& hostName, int port);
+    QString hostName() const { return m_hostName; }
+    int port() const { return m_port; }
+
+    // Starts (or keeps) retrying; immediate = first probe without delay
+    void connectionLost(bool immediate = false);
+    // The reopen after serverReachable() failed: back off and probe again
+    void attemptFailed();
+    // Session is back: stop retrying and reset the backoff
+    void connectionRestored();
+
+    bool isReconnecting() const { return m_reconnecting; }
+    int attempts() const { return m_attempt; }
+
+signals:
+    void serverReachable();
+    void reconnectScheduled(int attempt, int delayMs);
+
+private:
+    static constexpr int kInitialBackoffMs = 250;
+    static constexpr int kMaxBackoffMs = 30000;
+    static constexpr int kProbeTimeoutMs = 2000;
+
+    void scheduleAttempt();
+    void probe();
+    int nextDelayMs() const;
+
+    QTimer m_retryTimer;
+    int m_probeGeneration = 0;   // probes started before connectionRestored() are ignored
+    QString m_hostName = QStringLiteral("localhost");
+    int m_port = 5432;
+    int m_attempt = 0;
+    bool m_reconnecting = false;
+};
@@ -1,8 +1,10 @@
-#include "DatabaseInitializer.h"
+#include "databaseinitializer.h"
+#include "diagnostics/tracebuffer.h"
 #include <QStandardPaths>
 #include <QDir>
 #include <QCoreApplication>
 #include <QThread>
+#include <QHash>
 
 DatabaseInitializer::DatabaseInitializer(QObject* parent)
     : QObject(parent)
@@ -48,7 +50,7 @@ bool DatabaseInitializer::connectToSystemPostgreSQL() {
         }
 
         db = QSqlDatabase::addDatabase("QPSQL", "initializer_system_connection");
-        db.setHostName("localhost");
+        db.setHostName(m_systemHost);
         db.setPort(m_systemPort);  // ✅ Same intentionally wrong port as DatabaseManager
         db.setDatabaseName("railway_control_system");
         db.setUserName("postgres");
@@ -102,6 +104,21 @@ void DatabaseInitializer::resetDatabaseAsync() {
         return;
     }
 
+    m_syntheticScale = 0;
+    startReset();
+}
+
+void DatabaseInitializer::resetDatabaseWithSyntheticStationAsync(int scaleFactor) {
+    if (m_isRunning) {
+        qWarning() << "Database reset already in progress";
+        return;
+    }
+
+    m_syntheticScale = qMax(1, scaleFactor);
+    startReset();
+}
+
+void DatabaseInitializer::startReset() {
     m_isRunning = true;
     emit isRunningChanged();
 
@@ -131,6 +148,28 @@ void DatabaseInitializer::performReset() {
             throw std::runtime_error("Failed to create schemas");
         }
 
+        updateProgress(35, "Preparing station data...");
+        if (m_syntheticScale > 0) {
+            StationGenerator::Parameters parameters = StationGenerator::Parameters::forScale(m_syntheticScale);
+            m_station = StationGenerator::generate(parameters);
+
+            QString validationError;
+            if (!StationGenerator::validate(m_station, &validationError)) {
+                throw std::runtime_error(QString("Generated station is invalid: %1").arg(validationError).toStdString());
+            }
+            qDebug() << "🏗️ Synthetic station" << m_syntheticScale << "x:"
+                     << m_station.trackSegments.size() << "segments,"
+                     << m_station.signalList.size() << "signals,"
+                     << m_station.pointMachines.size() << "point machines";
+        } else {
+            m_station = getBuiltInStationData();
+        }
+
+        // One transaction for all rows: per-row autocommit dominates large stations
+        if (!db.transaction()) {
+            throw std::runtime_error("Failed to start population transaction");
+        }
+
         updateProgress(40, "Populating configuration data...");
         if (!populateConfigurationData()) {
             throw std::runtime_error("Failed to populate configuration data");
@@ -156,6 +195,10 @@ void DatabaseInitializer::performReset() {
             throw std::runtime_error("Failed to populate text labels");
         }
 
+        if (!db.commit()) {
+            throw std::runtime_error("Failed to commit station data");
+        }
+
         updateProgress(95, "Validating database...");
         if (!validateDatabase()) {
             throw std::runtime_error("Database validation failed");
@@ -168,8 +211,10 @@ void DatabaseInitializer::performReset() {
     } catch (const std::exception& e) {
         resultMessage = QString("Database reset failed: %1").arg(e.what());
         setError(resultMessage);
+        db.rollback();
     }
 
+    m_station = StationData();
     m_isRunning = false;
     emit isRunningChanged();
     emit resetCompleted(success, resultMessage);
@@ -270,6 +315,14 @@ bool DatabaseInitializer::executeSchemaScript() {
 
     // Step 3: Create configuration tables first (they're referenced by main tables)
     QStringList configTables = {
+        R"(CREATE TABLE railway_config.stations (
+            id SERIAL PRIMARY KEY,
+            station_id VARCHAR(20) NOT NULL UNIQUE,
+            station_name VARCHAR(100) NOT NULL,
+            is_active BOOLEAN DEFAULT TRUE,
+            created_at TIMESTAMP WITH TIME ZONE DEFAULT CURRENT_TIMESTAMP
+        ))",
+
         R"(CREATE TABLE railway_config.signal_types (
             id SERIAL PRIMARY KEY,
             type_code VARCHAR(20) NOT NULL UNIQUE,
@@ -314,6 +367,7 @@ bool DatabaseInitializer::executeSchemaScript() {
         R"(CREATE TABLE railway_control.track_segments (
             id SERIAL PRIMARY KEY,
             segment_id VARCHAR(20) NOT NULL UNIQUE,
+            station_id VARCHAR(20) NOT NULL DEFAULT 'MAIN' REFERENCES railway_config.stations(station_id),
             segment_name VARCHAR(100),
             start_row NUMERIC(10,2) NOT NULL,
             start_col NUMERIC(10,2) NOT NULL,
@@ -338,6 +392,7 @@ bool DatabaseInitializer::executeSchemaScript() {
         R"(CREATE TABLE railway_control.signals (
             id SERIAL PRIMARY KEY,
             signal_id VARCHAR(20) NOT NULL UNIQUE,
+            station_id VARCHAR(20) NOT NULL DEFAULT 'MAIN' REFERENCES railway_config.stations(station_id),
             signal_name VARCHAR(100) NOT NULL,
             signal_type_id INTEGER NOT NULL REFERENCES railway_config.signal_types(id),
             location_row NUMERIC(10,2) NOT NULL,
@@ -363,6 +418,7 @@ bool DatabaseInitializer::executeSchemaScript() {
         R"(CREATE TABLE railway_control.point_machines (
             id SERIAL PRIMARY KEY,
             machine_id VARCHAR(20) NOT NULL UNIQUE,
+            station_id VARCHAR(20) NOT NULL DEFAULT 'MAIN' REFERENCES railway_config.stations(station_id),
             machine_name VARCHAR(100) NOT NULL,
             junction_row NUMERIC(10,2) NOT NULL,
             junction_col NUMERIC(10,2) NOT NULL,
@@ -387,6 +443,7 @@ bool DatabaseInitializer::executeSchemaScript() {
 
         R"(CREATE TABLE railway_control.text_labels (
             id SERIAL PRIMARY KEY,
+            station_id VARCHAR(20) NOT NULL DEFAULT 'MAIN' REFERENCES railway_config.stations(station_id),
             label_text VARCHAR(200) NOT NULL,
             position_row NUMERIC(10,2) NOT NULL,
             position_col NUMERIC(10,2) NOT NULL,
@@ -407,6 +464,23 @@ bool DatabaseInitializer::executeSchemaScript() {
             description TEXT,
             last_updated TIMESTAMP WITH TIME ZONE DEFAULT CURRENT_TIMESTAMP,
             updated_by VARCHAR(100)
+        ))",
+
+        // Live per-station status counters (maintained by the *_status triggers)
+        // and layout_version (bumped by the *_layout triggers, starts at creation ms)
+        R"(CREATE TABLE railway_control.station_status (
+            station_id VARCHAR(20) PRIMARY KEY REFERENCES railway_config.stations(station_id) ON DELETE CASCADE,
+            tracks_total INTEGER NOT NULL DEFAULT 0,
+            tracks_occupied INTEGER NOT NULL DEFAULT 0,
+            tracks_assigned INTEGER NOT NULL DEFAULT 0,
+            signals_total INTEGER NOT NULL DEFAULT 0,
+            signals_active INTEGER NOT NULL DEFAULT 0,
+            points_total INTEGER NOT NULL DEFAULT 0,
+            points_connected INTEGER NOT NULL DEFAULT 0,
+            points_in_transition INTEGER NOT NULL DEFAULT 0,
+            layout_version BIGINT NOT NULL DEFAULT (extract(epoch from clock_timestamp()) * 1000)::BIGINT,
+            layout_txid BIGINT,
+            last_updated TIMESTAMP WITH TIME ZONE DEFAULT CURRENT_TIMESTAMP
         ))"
     };
 
@@ -441,6 +515,7 @@ bool DatabaseInitializer::executeSchemaScript() {
             comments TEXT,
             replay_data JSONB,
             sequence_number BIGINT,
+            transaction_id BIGINT DEFAULT txid_current(),
             event_date DATE
         ))",
 
@@ -592,29 +667,37 @@ bool DatabaseInitializer::executeSchemaScript() {
         "CREATE INDEX idx_track_segments_segment_id ON railway_control.track_segments(segment_id)",
         "CREATE INDEX idx_signals_signal_id ON railway_control.signals(signal_id)",
         "CREATE INDEX idx_point_machines_machine_id ON railway_control.point_machines(machine_id)",
+        "CREATE INDEX idx_track_segments_station ON railway_control.track_segments(station_id)",
+        "CREATE INDEX idx_signals_station ON railway_control.signals(station_id)",
+        "CREATE INDEX idx_point_machines_station ON railway_control.point_machines(station_id)",
+        "CREATE INDEX idx_text_labels_station ON railway_control.text_labels(station_id)",
         "CREATE INDEX idx_event_log_timestamp ON railway_audit.event_log(event_timestamp)",
 
         // Performance indexes for track segments
         "CREATE INDEX idx_track_segments_occupied ON railway_control.track_segments(is_occupied) WHERE is_occupied = TRUE",
         "CREATE INDEX idx_track_segments_assigned ON railway_control.track_segments(is_assigned) WHERE is_assigned = TRUE",
-        "CREATE INDEX idx_track_segments_location ON railway_control.track_segments USING btree(start_row, start_col, end_row, end_col)",
+        "CREATE INDEX idx_track_segments_location ON railway_control.track_segments USING gist(box(point(start_col, start_row), point(end_col, end_row)))",
 
         // Performance indexes for signals
         "CREATE INDEX idx_signals_type ON railway_control.signals(signal_type_id)",
-        "CREATE INDEX idx_signals_location ON railway_control.signals USING btree(location_row, location_col)",
+        "CREATE INDEX idx_signals_location ON railway_control.signals USING gist(box(point(location_col, location_row), point(location_col, location_row)))",
         "CREATE INDEX idx_signals_active ON railway_control.signals(is_active) WHERE is_active = TRUE",
         "CREATE INDEX idx_signals_last_changed ON railway_control.signals(last_changed_at)",
 
         // Performance indexes for point machines
         "CREATE INDEX idx_point_machines_position ON railway_control.point_machines(current_position_id)",
         "CREATE INDEX idx_point_machines_status ON railway_control.point_machines(operating_status)",
-        "CREATE INDEX idx_point_machines_junction ON railway_control.point_machines USING btree(junction_row, junction_col)",
+        "CREATE INDEX idx_point_machines_junction ON railway_control.point_machines USING gist(box(point(junction_col, junction_row), point(junction_col, junction_row)))",
+
+        // Spatial index for text labels
+        "CREATE INDEX idx_text_labels_location ON railway_control.text_labels USING gist(box(point(position_col, position_row), point(position_col, position_row)))",
 
         // Performance indexes for event log
         "CREATE INDEX idx_event_log_entity ON railway_audit.event_log(entity_type, entity_id)",
         "CREATE INDEX idx_event_log_operator ON railway_audit.event_log(operator_id)",
         "CREATE INDEX idx_event_log_safety ON railway_audit.event_log(safety_critical) WHERE safety_critical = TRUE",
         "CREATE INDEX idx_event_log_sequence ON railway_audit.event_log(sequence_number)",
+        "CREATE INDEX idx_event_log_transaction ON railway_audit.event_log(transaction_id)",
         "CREATE INDEX idx_event_log_date ON railway_audit.event_log(event_date)"
     };
 
@@ -669,6 +752,11 @@ bool DatabaseInitializer::executeSchemaScript() {
     return true;
 }
 bool DatabaseInitializer::populateConfigurationData() {
+    // Layout rows default to the MAIN station
+    if (!executeQuery("INSERT INTO railway_config.stations (station_id, station_name) VALUES ('MAIN', 'Main Station')")) {
+        return false;
+    }
+
     // Insert signal types
     int starterTypeId = insertSignalType("STARTER", "Starter Signal", 3);
     int homeTypeId = insertSignalType("HOME", "Home Signal", 3);
@@ -696,15 +784,14 @@ bool DatabaseInitializer::populateConfigurationData() {
 }
 
 bool DatabaseInitializer::populateTrackSegments() {
-    QJsonArray trackData = getTrackSegmentsData();
-
-    QString insertQuery = R"(
+    QSqlQuery insertQuery(db);
+    insertQuery.prepare(R"(
         INSERT INTO railway_control.track_segments
         (segment_id, start_row, start_col, end_row, end_col, is_occupied, is_assigned)
         VALUES (?, ?, ?, ?, ?, ?, ?)
-    )";
+    )");
 
-    for (const auto& trackValue : trackData) {
+    for (const auto& trackValue : m_station.trackSegments) {
         QJsonObject track = trackValue.toObject();
 
         QVariantList params = {
@@ -717,7 +804,7 @@ bool DatabaseInitializer::populateTrackSegments() {
             track["assigned"].toBool()
         };
 
-        if (!executeQuery(insertQuery, params)) {
+        if (!executePrepared(insertQuery, params)) {
             return false;
         }
     }
@@ -726,45 +813,45 @@ bool DatabaseInitializer::populateTrackSegments() {
 }
 
 bool DatabaseInitializer::populateSignals() {
-    // Combine all signal types
-    QJsonArray allSignals;
-
-    QJsonArray outerSignals = getOuterSignalsData();
-    QJsonArray homeSignals = getHomeSignalsData();
-    QJsonArray starterSignals = getStarterSignalsData();
-    QJsonArray advancedSignals = getAdvancedStarterSignalsData();
-
-    // Merge all signal arrays
-    for (const auto& signal : outerSignals) allSignals.append(signal);
-    for (const auto& signal : homeSignals) allSignals.append(signal);
-    for (const auto& signal : starterSignals) allSignals.append(signal);
-    for (const auto& signal : advancedSignals) allSignals.append(signal);
+    // Lookup tables are tiny; resolve each code once instead of once per signal
+    QHash<QString, int> typeIds;
+    QHash<QString, int> aspectIds;
+
+    QSqlQuery lookupQuery(db);
+    if (lookupQuery.exec("SELECT type_code, id FROM railway_config.signal_types")) {
+        while (lookupQuery.next()) {
+            typeIds.insert(lookupQuery.value(0).toString(), lookupQuery.value(1).toInt());
+        }
+    }
+    if (lookupQuery.exec("SELECT aspect_code, id FROM railway_config.signal_aspects")) {
+        while (lookupQuery.next()) {
+            aspectIds.insert(lookupQuery.value(0).toString(), lookupQuery.value(1).toInt());
+        }
+    }
 
-    for (const auto& signalValue : allSignals) {
+    QSqlQuery insertQuery(db);
+    insertQuery.prepare(R"(
+        INSERT INTO railway_control.signals
+        (signal_id, signal_name, signal_type_id, location_row, location_col,
+         direction, current_aspect_id, calling_on_aspect, loop_aspect,
+         loop_signal_configuration, aspect_count, possible_aspects,
+         is_active, location_description)
+        VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)
+    )");
+
+    for (const auto& signalValue : m_station.signalList) {
         QJsonObject signal = signalValue.toObject();
         QString signalType = signal["type"].toString();
 
         // Get type ID
-        QSqlQuery typeQuery(db);
-        typeQuery.prepare("SELECT id FROM railway_config.signal_types WHERE type_code = ?");
-        typeQuery.addBindValue(signalType);
-
-        if (!typeQuery.exec() || !typeQuery.next()) {
+        if (!typeIds.contains(signalType)) {
             setError(QString("Signal type not found: %1").arg(signalType));
             return false;
         }
-        int typeId = typeQuery.value(0).toInt();
+        int typeId = typeIds.value(signalType);
 
         // Get aspect ID
-        QString currentAspect = signal["currentAspect"].toString();
-        QSqlQuery aspectQuery(db);
-        aspectQuery.prepare("SELECT id FROM railway_config.signal_aspects WHERE aspect_code = ?");
-        aspectQuery.addBindValue(currentAspect);
-
-        int aspectId = 1; // Default to RED
-        if (aspectQuery.exec() && aspectQuery.next()) {
-            aspectId = aspectQuery.value(0).toInt();
-        }
+        int aspectId = aspectIds.value(signal["currentAspect"].toString(), 1); // Default to RED
 
         // Convert possible aspects array to PostgreSQL array format
         QJsonArray possibleAspects = signal["possibleAspects"].toArray();
@@ -774,15 +861,6 @@ bool DatabaseInitializer::populateSignals() {
         }
         QString aspectsArrayStr = "{" + aspectsList.join(",") + "}";
 
-        QString insertQuery = R"(
-            INSERT INTO railway_control.signals
-            (signal_id, signal_name, signal_type_id, location_row, location_col,
-             direction, current_aspect_id, calling_on_aspect, loop_aspect,
-             loop_signal_configuration, aspect_count, possible_aspects,
-             is_active, location_description)
-            VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)
-        )";
-
         QVariantList params = {
             signal["id"].toString(),
             signal["name"].toString(),
@@ -800,7 +878,7 @@ bool DatabaseInitializer::populateSignals() {
             signal["location"].toString()
         };
 
-        if (!executeQuery(insertQuery, params)) {
+        if (!executePrepared(insertQuery, params)) {
             return false;
         }
     }
@@ -809,21 +887,28 @@ bool DatabaseInitializer::populateSignals() {
 }
 
 bool DatabaseInitializer::populatePointMachines() {
-    QJsonArray pointsData = getPointMachinesData();
+    QHash<QString, int> positionIds;
+    QSqlQuery positionQuery(db);
+    if (positionQuery.exec("SELECT position_code, id FROM railway_config.point_positions")) {
+        while (positionQuery.next()) {
+            positionIds.insert(positionQuery.value(0).toString(), positionQuery.value(1).toInt());
+        }
+    }
 
-    for (const auto& pointValue : pointsData) {
+    QSqlQuery insertQuery(db);
+    insertQuery.prepare(R"(
+        INSERT INTO railway_control.point_machines
+        (machine_id, machine_name, junction_row, junction_col,
+         root_track_connection, normal_track_connection, reverse_track_connection,
+         current_position_id, operating_status, transition_time_ms)
+        VALUES (?, ?, ?, ?, ?::jsonb, ?::jsonb, ?::jsonb, ?, ?, ?)
+    )");
+
+    for (const auto& pointValue : m_station.pointMachines) {
         QJsonObject point = pointValue.toObject();
 
         // Get position ID
-        QString currentPosition = point["position"].toString();
-        QSqlQuery positionQuery(db);
-        positionQuery.prepare("SELECT id FROM railway_config.point_positions WHERE position_code = ?");
-        positionQuery.addBindValue(currentPosition);
-
-        int positionId = 1; // Default to NORMAL
-        if (positionQuery.exec() && positionQuery.next()) {
-            positionId = positionQuery.value(0).toInt();
-        }
+        int positionId = positionIds.value(point["position"].toString(), 1); // Default to NORMAL
 
         // Convert track connections to properly formatted JSON strings
         QJsonObject rootTrack = point["rootTrack"].toObject();
@@ -835,16 +920,7 @@ bool DatabaseInitializer::populatePointMachines() {
         QString normalTrackJson = QString::fromUtf8(QJsonDocument(normalTrack).toJson(QJsonDocument::Compact));
         QString reverseTrackJson = QString::fromUtf8(QJsonDocument(reverseTrack).toJson(QJsonDocument::Compact));
 
-        qDebug() << "Inserting point machine:" << point["id"].toString();
-        qDebug() << "Root track JSON:" << rootTrackJson;
-
-        QString insertQuery = R"(
-            INSERT INTO railway_control.point_machines
-            (machine_id, machine_name, junction_row, junction_col,
-             root_track_connection, normal_track_connection, reverse_track_connection,
-             current_position_id, operating_status, transition_time_ms)
-            VALUES (?, ?, ?, ?, ?::jsonb, ?::jsonb, ?::jsonb, ?, ?, ?)
-        )";
+        RF_TRACE(Populate, PopulateRow, point["id"].toString(), TraceTable::PointMachines);
 
         QVariantList params = {
             point["id"].toString(),
@@ -859,7 +935,7 @@ bool DatabaseInitializer::populatePointMachines() {
             3000 // Default transition time
         };
 
-        if (!executeQuery(insertQuery, params)) {
+        if (!executePrepared(insertQuery, params)) {
             setError(QString("Failed to insert point machine: %1").arg(point["id"].toString()));
             return false;
         }
@@ -869,15 +945,14 @@ bool DatabaseInitializer::populatePointMachines() {
 }
 
 bool DatabaseInitializer::populateTextLabels() {
-    QJsonArray labelsData = getTextLabelsData();
-
-    QString insertQuery = R"(
+    QSqlQuery insertQuery(db);
+    insertQuery.prepare(R"(
         INSERT INTO railway_control.text_labels
         (label_text, position_row, position_col, font_size)
         VALUES (?, ?, ?, ?)
-    )";
+    )");
 
-    for (const auto& labelValue : labelsData) {
+    for (const auto& labelValue : m_station.textLabels) {
         QJsonObject label = labelValue.toObject();
 
         QVariantList params = {
@@ -887,7 +962,7 @@ bool DatabaseInitializer::populateTextLabels() {
             label["fontSize"].toInt(12)
         };
 
-        if (!executeQuery(insertQuery, params)) {
+        if (!executePrepared(insertQuery, params)) {
             return false;
         }
     }
@@ -941,6 +1016,20 @@ bool DatabaseInitializer::executeQuery(const QString& query, const QVariantList&
     return true;
 }
 
+// Re-executes a statement prepared once by the caller with a fresh set of binds
+bool DatabaseInitializer::executePrepared(QSqlQuery& query, const QVariantList& params) {
+    for (int i = 0; i < params.size(); ++i) {
+        query.bindValue(i, params[i]);
+    }
+
+    if (!query.exec()) {
+        setError(QString("Query failed: %1 - Error: %2").arg(query.lastQuery().simplified().left(50), query.lastError().text()));
+        return false;
+    }
+
+    return true;
+}
+
 void DatabaseInitializer::setError(const QString& error) {
     m_lastError = error;
     emit lastErrorChanged();
@@ -1047,10 +1136,14 @@ bool DatabaseInitializer::createAdvancedFunctions() {
                 'operation', TG_OP,
                 'id', COALESCE(NEW.id, OLD.id),
                 'entity_id', COALESCE(NEW.segment_id, OLD.segment_id),
-                'timestamp', extract(epoch from now())
+                'station_id', COALESCE(NEW.station_id, OLD.station_id),
+                'timestamp', extract(epoch from now()),
+                'command_id', NULLIF(current_setting('railway.command_id', true), ''),
+                'server_time', extract(epoch from clock_timestamp())
             );
 
-            PERFORM pg_notify('railway_changes', payload::TEXT);
+            -- One channel per station: clients only LISTEN to the stations they show
+            PERFORM pg_notify('railway_changes_' || COALESCE(NEW.station_id, OLD.station_id), payload::TEXT);
             RETURN COALESCE(NEW, OLD);
         END;
         $$ LANGUAGE plpgsql)",
@@ -1066,10 +1159,13 @@ bool DatabaseInitializer::createAdvancedFunctions() {
                 'operation', TG_OP,
                 'id', COALESCE(NEW.id, OLD.id),
                 'entity_id', COALESCE(NEW.signal_id, OLD.signal_id),
-                'timestamp', extract(epoch from now())
+                'station_id', COALESCE(NEW.station_id, OLD.station_id),
+                'timestamp', extract(epoch from now()),
+                'command_id', NULLIF(current_setting('railway.command_id', true), ''),
+                'server_time', extract(epoch from clock_timestamp())
             );
 
-            PERFORM pg_notify('railway_changes', payload::TEXT);
+            PERFORM pg_notify('railway_changes_' || COALESCE(NEW.station_id, OLD.station_id), payload::TEXT);
             RETURN COALESCE(NEW, OLD);
         END;
         $$ LANGUAGE plpgsql)",
@@ -1085,14 +1181,242 @@ bool DatabaseInitializer::createAdvancedFunctions() {
                 'operation', TG_OP,
                 'id', COALESCE(NEW.id, OLD.id),
                 'entity_id', COALESCE(NEW.machine_id, OLD.machine_id),
-                'timestamp', extract(epoch from now())
+                'station_id', COALESCE(NEW.station_id, OLD.station_id),
+                'timestamp', extract(epoch from now()),
+                'command_id', NULLIF(current_setting('railway.command_id', true), ''),
+                'server_time', extract(epoch from clock_timestamp())
             );
 
-            PERFORM pg_notify('railway_changes', payload::TEXT);
+            PERFORM pg_notify('railway_changes_' || COALESCE(NEW.station_id, OLD.station_id), payload::TEXT);
             RETURN COALESCE(NEW, OLD);
         END;
         $$ LANGUAGE plpgsql)",
 
+        // Status counters: apply deltas to the station row and push the new counts
+        R"(CREATE OR REPLACE FUNCTION railway_control.adjust_station_status(
+            station_id_param VARCHAR,
+            tracks_delta INTEGER, occupied_delta INTEGER, assigned_delta INTEGER,
+            signals_delta INTEGER, active_delta INTEGER,
+            points_delta INTEGER, connected_delta INTEGER, in_transition_delta INTEGER
+        ) RETURNS VOID AS $$
+        DECLARE
+            counts railway_control.station_status%ROWTYPE;
+        BEGIN
+            IF station_id_param IS NULL OR (tracks_delta = 0 AND occupied_delta = 0 AND assigned_delta = 0
+                AND signals_delta = 0 AND active_delta = 0
+                AND points_delta = 0 AND connected_delta = 0 AND in_transition_delta = 0) THEN
+                RETURN;
+            END IF;
+
+            INSERT INTO railway_control.station_status AS ss (
+                station_id, tracks_total, tracks_occupied, tracks_assigned,
+                signals_total, signals_active, points_total, points_connected, points_in_transition
+            ) VALUES (
+                station_id_param, tracks_delta, occupied_delta, assigned_delta,
+                signals_delta, active_delta, points_delta, connected_delta, in_transition_delta
+            )
+            ON CONFLICT (station_id) DO UPDATE SET
+                tracks_total = ss.tracks_total + EXCLUDED.tracks_total,
+                tracks_occupied = ss.tracks_occupied + EXCLUDED.tracks_occupied,
+                tracks_assigned = ss.tracks_assigned + EXCLUDED.tracks_assigned,
+                signals_total = ss.signals_total + EXCLUDED.signals_total,
+                signals_active = ss.signals_active + EXCLUDED.signals_active,
+                points_total = ss.points_total + EXCLUDED.points_total,
+                points_connected = ss.points_connected + EXCLUDED.points_connected,
+                points_in_transition = ss.points_in_transition + EXCLUDED.points_in_transition,
+                last_updated = CURRENT_TIMESTAMP
+            RETURNING * INTO counts;
+
+            PERFORM pg_notify('railway_changes_' || station_id_param, json_build_object(
+                'table', 'station_status',
+                'operation', 'UPDATE',
+                'station_id', station_id_param,
+                'tracks', json_build_object(
+                    'total', counts.tracks_total,
+                    'occupied', counts.tracks_occupied,
+                    'assigned', counts.tracks_assigned,
+                    'available', counts.tracks_total - counts.tracks_occupied - counts.tracks_assigned
+                ),
+                'signals', json_build_object(
+                    'total', counts.signals_total,
+                    'active', counts.signals_active
+                ),
+                'point_machines', json_build_object(
+                    'total', counts.points_total,
+                    'connected', counts.points_connected,
+                    'in_transition', counts.points_in_transition
+                )
+            )::TEXT);
+        END;
+        $$ LANGUAGE plpgsql)",
+
+        // Counter deltas of one statement's rows (old rows count negative), applied
+        // once per station: a batch of any size costs one upsert and one push
+        R"(CREATE OR REPLACE FUNCTION railway_control.adjust_track_counts(
+            old_rows_param railway_control.track_segments[],
+            new_rows_param railway_control.track_segments[]
+        ) RETURNS VOID AS $$
+        DECLARE
+            delta RECORD;
+        BEGIN
+            FOR delta IN
+                SELECT r.station_id,
+                       sum(r.sign * (r.is_active IS TRUE)::INTEGER)::INTEGER AS total,
+                       sum(r.sign * (r.is_active IS TRUE AND r.is_occupied IS TRUE)::INTEGER)::INTEGER AS occupied,
+                       sum(r.sign * (r.is_active IS TRUE AND r.is_assigned IS TRUE)::INTEGER)::INTEGER AS assigned
+                FROM (
+                    SELECT -1 AS sign, o.station_id, o.is_active, o.is_occupied, o.is_assigned FROM unnest(old_rows_param) o
+                    UNION ALL
+                    SELECT 1, n.station_id, n.is_active, n.is_occupied, n.is_assigned FROM unnest(new_rows_param) n
+                ) r
+                GROUP BY r.station_id
+            LOOP
+                PERFORM railway_control.adjust_station_status(delta.station_id,
+                    delta.total, delta.occupied, delta.assigned, 0, 0, 0, 0, 0);
+            END LOOP;
+        END;
+        $$ LANGUAGE plpgsql)",
+
+        R"(CREATE OR REPLACE FUNCTION railway_control.adjust_signal_counts(
+            old_rows_param railway_control.signals[],
+            new_rows_param railway_control.signals[]
+        ) RETURNS VOID AS $$
+        DECLARE
+            delta RECORD;
+        BEGIN
+            FOR delta IN
+                SELECT r.station_id,
+                       sum(r.sign)::INTEGER AS total,
+                       sum(r.sign * (r.is_active IS TRUE)::INTEGER)::INTEGER AS active
+                FROM (
+                    SELECT -1 AS sign, o.station_id, o.is_active FROM unnest(old_rows_param) o
+                    UNION ALL
+                    SELECT 1, n.station_id, n.is_active FROM unnest(new_rows_param) n
+                ) r
+                GROUP BY r.station_id
+            LOOP
+                PERFORM railway_control.adjust_station_status(delta.station_id,
+                    0, 0, 0, delta.total, delta.active, 0, 0, 0);
+            END LOOP;
+        END;
+        $$ LANGUAGE plpgsql)",
+
+        R"(CREATE OR REPLACE FUNCTION railway_control.adjust_point_counts(
+            old_rows_param railway_control.point_machines[],
+            new_rows_param railway_control.point_machines[]
+        ) RETURNS VOID AS $$
+        DECLARE
+            delta RECORD;
+        BEGIN
+            FOR delta IN
+                SELECT r.station_id,
+                       sum(r.sign)::INTEGER AS total,
+                       sum(r.sign * ((r.operating_status = 'CONNECTED') IS TRUE)::INTEGER)::INTEGER AS connected,
+                       sum(r.sign * ((r.operating_status = 'IN_TRANSITION') IS TRUE)::INTEGER)::INTEGER AS in_transition
+                FROM (
+                    SELECT -1 AS sign, o.station_id, o.operating_status FROM unnest(old_rows_param) o
+                    UNION ALL
+                    SELECT 1, n.station_id, n.operating_status FROM unnest(new_rows_param) n
+                ) r
+                GROUP BY r.station_id
+            LOOP
+                PERFORM railway_control.adjust_station_status(delta.station_id,
+                    0, 0, 0, 0, 0, delta.total, delta.connected, delta.in_transition);
+            END LOOP;
+        END;
+        $$ LANGUAGE plpgsql)",
+
+        // Statement-level counter triggers over the transition tables; each event
+        // only declares the tables it has, so the branches pass NULL for the other
+        R"(CREATE OR REPLACE FUNCTION railway_control.count_track_changes()
+        RETURNS TRIGGER AS $$
+        BEGIN
+            IF TG_OP = 'INSERT' THEN
+                PERFORM railway_control.adjust_track_counts(NULL,
+                    ARRAY(SELECT ROW(n.*)::railway_control.track_segments FROM new_rows n));
+            ELSIF TG_OP = 'DELETE' THEN
+                PERFORM railway_control.adjust_track_counts(
+                    ARRAY(SELECT ROW(o.*)::railway_control.track_segments FROM old_rows o), NULL);
+            ELSE
+                PERFORM railway_control.adjust_track_counts(
+                    ARRAY(SELECT ROW(o.*)::railway_control.track_segments FROM old_rows o),
+                    ARRAY(SELECT ROW(n.*)::railway_control.track_segments FROM new_rows n));
+            END IF;
+            RETURN NULL;
+        END;
+        $$ LANGUAGE plpgsql)",
+
+        R"(CREATE OR REPLACE FUNCTION railway_control.count_signal_changes()
+        RETURNS TRIGGER AS $$
+        BEGIN
+            IF TG_OP = 'INSERT' THEN
+                PERFORM railway_control.adjust_signal_counts(NULL,
+                    ARRAY(SELECT ROW(n.*)::railway_control.signals FROM new_rows n));
+            ELSIF TG_OP = 'DELETE' THEN
+                PERFORM railway_control.adjust_signal_counts(
+                    ARRAY(SELECT ROW(o.*)::railway_control.signals FROM old_rows o), NULL);
+            ELSE
+                PERFORM railway_control.adjust_signal_counts(
+                    ARRAY(SELECT ROW(o.*)::railway_control.signals FROM old_rows o),
+                    ARRAY(SELECT ROW(n.*)::railway_control.signals FROM new_rows n));
+            END IF;
+            RETURN NULL;
+        END;
+        $$ LANGUAGE plpgsql)",
+
+        R"(CREATE OR REPLACE FUNCTION railway_control.count_point_changes()
+        RETURNS TRIGGER AS $$
+        BEGIN
+            IF TG_OP = 'INSERT' THEN
+                PERFORM railway_control.adjust_point_counts(NULL,
+                    ARRAY(SELECT ROW(n.*)::railway_control.point_machines FROM new_rows n));
+            ELSIF TG_OP = 'DELETE' THEN
+                PERFORM railway_control.adjust_point_counts(
+                    ARRAY(SELECT ROW(o.*)::railway_control.point_machines FROM old_rows o), NULL);
+            ELSE
+                PERFORM railway_control.adjust_point_counts(
+                    ARRAY(SELECT ROW(o.*)::railway_control.point_machines FROM old_rows o),
+                    ARRAY(SELECT ROW(n.*)::railway_control.point_machines FROM new_rows n));
+            END IF;
+            RETURN NULL;
+        END;
+        $$ LANGUAGE plpgsql)",
+
+        // Layout version: one bump and one notification per transaction and station
+        R"(CREATE OR REPLACE FUNCTION railway_control.bump_layout_version()
+        RETURNS TRIGGER AS $$
+        DECLARE
+            station VARCHAR;
+            version BIGINT;
+        BEGIN
+            FOR station IN
+                SELECT DISTINCT s FROM unnest(ARRAY[OLD.station_id, NEW.station_id]::VARCHAR[]) AS s WHERE s IS NOT NULL
+            LOOP
+                version := NULL;
+                INSERT INTO railway_control.station_status AS ss (station_id, layout_txid)
+                VALUES (station, txid_current())
+                ON CONFLICT (station_id) DO UPDATE SET
+                    layout_version = ss.layout_version + 1,
+                    layout_txid = EXCLUDED.layout_txid,
+                    last_updated = CURRENT_TIMESTAMP
+                WHERE ss.layout_txid IS DISTINCT FROM EXCLUDED.layout_txid
+                RETURNING layout_version INTO version;
+
+                -- Later rows of the same transaction share the version (and the notification)
+                IF version IS NOT NULL THEN
+                    PERFORM pg_notify('railway_changes_' || station, json_build_object(
+                        'table', 'layout',
+                        'operation', TG_OP,
+                        'station_id', station,
+                        'source_table', TG_TABLE_NAME,
+                        'layout_version', version
+                    )::TEXT);
+                END IF;
+            END LOOP;
+            RETURN NULL;
+        END;
+        $$ LANGUAGE plpgsql)",
+
         // Safe signal aspect update function
         R"(CREATE OR REPLACE FUNCTION railway_control.update_signal_aspect(
             signal_id_param VARCHAR,
@@ -1157,6 +1481,129 @@ bool DatabaseInitializer::createAdvancedFunctions() {
         END;
         $$ LANGUAGE plpgsql)",
 
+        // Timed point throw, step 1: CONNECTED -> IN_TRANSITION. Returns the
+        // machine's transit time, or NULL when it is missing or not CONNECTED
+        R"(CREATE OR REPLACE FUNCTION railway_control.begin_point_transition(
+            machine_id_param VARCHAR,
+            operator_id_param VARCHAR DEFAULT 'system'
+        )
+        RETURNS INTEGER AS $$
+        DECLARE
+            transition_ms INTEGER;
+        BEGIN
+            PERFORM set_config('railway.operator_id', operator_id_param, true);
+
+            UPDATE railway_control.point_machines
+            SET operating_status = 'IN_TRANSITION'
+            WHERE machine_id = machine_id_param
+              AND operating_status = 'CONNECTED'
+            RETURNING transition_time_ms INTO transition_ms;
+
+            RETURN transition_ms;
+        END;
+        $$ LANGUAGE plpgsql)",
+
+        // Timed point throw, step 2 (batched): commit final positions and reconnect
+        R"(CREATE OR REPLACE FUNCTION railway_control.complete_point_transitions(
+            machine_ids_param VARCHAR[],
+            position_codes_param VARCHAR[],
+            operator_id_param VARCHAR DEFAULT 'system'
+        )
+        RETURNS INTEGER AS $$
+        DECLARE
+            rows_affected INTEGER;
+        BEGIN
+            PERFORM set_config('railway.operator_id', operator_id_param, true);
+
+            UPDATE railway_control.point_machines pm
+            SET
+                current_position_id = railway_config.get_position_id(t.position_code),
+                operating_status = 'CONNECTED',
+                last_operated_at = CURRENT_TIMESTAMP,
+                last_operated_by = operator_id_param,
+                operation_count = pm.operation_count + 1
+            FROM unnest(machine_ids_param, position_codes_param) AS t(machine_id, position_code)
+            WHERE pm.machine_id = t.machine_id
+              AND pm.operating_status = 'IN_TRANSITION';
+
+            GET DIAGNOSTICS rows_affected = ROW_COUNT;
+            RETURN rows_affected;
+        END;
+        $$ LANGUAGE plpgsql)",
+
+        // Timed point throw, recovery: reconnect machines a previous run left moving.
+        // Only rows untouched for longer than their transition time plus the grace
+        // period qualify, so transitions another client is still timing are kept.
+        R"(CREATE OR REPLACE FUNCTION railway_control.reconcile_point_transitions(
+            grace_ms_param INTEGER DEFAULT 5000,
+            operator_id_param VARCHAR DEFAULT 'system'
+        )
+        RETURNS SETOF VARCHAR AS $$
+            SELECT set_config('railway.operator_id', operator_id_param, true);
+
+            UPDATE railway_control.point_machines pm
+            SET operating_status = 'CONNECTED'
+            WHERE pm.operating_status = 'IN_TRANSITION'
+              AND pm.updated_at < CURRENT_TIMESTAMP
+                  - make_interval(secs => (COALESCE(pm.transition_time_ms, 0) + grace_ms_param) / 1000.0)
+            RETURNING pm.machine_id;
+        $$ LANGUAGE sql)",
+
+        // Field input (batched): track circuit states from the telegram gateway.
+        // Unchanged circuits are skipped so they fire no audit/notify triggers;
+        // the circuits that did change are returned with their new state
+        R"(CREATE OR REPLACE FUNCTION railway_control.apply_track_circuits(
+            segment_ids_param VARCHAR[],
+            occupied_param BOOLEAN[],
+            operator_id_param VARCHAR DEFAULT 'system'
+        )
+        RETURNS TABLE(segment_id VARCHAR, is_occupied BOOLEAN) AS $$
+            SELECT set_config('railway.operator_id', operator_id_param, true);
+
+            UPDATE railway_control.track_segments ts
+            SET
+                is_occupied = t.is_occupied,
+                occupied_by = CASE WHEN t.is_occupied THEN ts.occupied_by ELSE NULL END
+            FROM unnest(segment_ids_param, occupied_param) AS t(segment_id, is_occupied)
+            WHERE ts.segment_id = t.segment_id
+              AND ts.is_occupied IS DISTINCT FROM t.is_occupied
+            RETURNING ts.segment_id, ts.is_occupied;
+        $$ LANGUAGE sql)",
+
+        // Field input (batched): point detection; an unknown position code means
+        // detection was lost and the machine is marked FAILED. Returns the machines
+        // whose position or status changed, with their new state
+        R"(CREATE OR REPLACE FUNCTION railway_control.apply_point_detections(
+            machine_ids_param VARCHAR[],
+            position_codes_param VARCHAR[],
+            operator_id_param VARCHAR DEFAULT 'system'
+        )
+        RETURNS TABLE(machine_id VARCHAR, position_code VARCHAR, operating_status VARCHAR, is_locked BOOLEAN) AS $$
+            SELECT set_config('railway.operator_id', operator_id_param, true);
+
+            UPDATE railway_control.point_machines pm
+            SET
+                current_position_id = COALESCE(d.position_id, pm.current_position_id),
+                operating_status = d.status
+            FROM (
+                SELECT
+                    t.machine_id,
+                    railway_config.get_position_id(t.position_code) AS position_id,
+                    CASE WHEN railway_config.get_position_id(t.position_code) IS NULL
+                         THEN 'FAILED' ELSE 'CONNECTED' END AS status
+                FROM unnest(machine_ids_param, position_codes_param) AS t(machine_id, position_code)
+            ) d
+            WHERE pm.machine_id = d.machine_id
+              AND pm.operating_status <> 'LOCKED_OUT'
+              -- Detection is expected to drop while the blades move
+              AND NOT (d.position_id IS NULL AND pm.operating_status = 'IN_TRANSITION')
+              AND (pm.operating_status <> d.status
+                   OR pm.current_position_id IS DISTINCT FROM COALESCE(d.position_id, pm.current_position_id))
+            RETURNING pm.machine_id,
+                      (SELECT pp.position_code FROM railway_config.point_positions pp WHERE pp.id = pm.current_position_id),
+                      pm.operating_status, pm.is_locked;
+        $$ LANGUAGE sql)",
+
         // Track occupancy update function
         R"(CREATE OR REPLACE FUNCTION railway_control.update_track_occupancy(
             segment_id_param VARCHAR,
@@ -1209,62 +1656,60 @@ bool DatabaseInitializer::createAdvancedFunctions() {
         END;
         $$ LANGUAGE plpgsql)",
 
-        // System status function
-        R"(CREATE OR REPLACE FUNCTION railway_control.get_system_status()
+        // System status from the maintained counters (NULL station = all stations)
+        R"(CREATE OR REPLACE FUNCTION railway_control.get_system_status(station_id_param VARCHAR DEFAULT NULL)
         RETURNS JSON AS $$
-        DECLARE
-            result JSON;
-            track_stats RECORD;
-            signal_stats RECORD;
-            point_stats RECORD;
-        BEGIN
-            -- Get track statistics
-            SELECT
-                COUNT(*) as total,
-                COUNT(*) FILTER (WHERE is_occupied) as occupied,
-                COUNT(*) FILTER (WHERE is_assigned) as assigned
-            INTO track_stats
-            FROM railway_control.track_segments
-            WHERE is_active = TRUE;
-
-            -- Get signal statistics
-            SELECT
-                COUNT(*) as total,
-                COUNT(*) FILTER (WHERE is_active) as active
-            INTO signal_stats
-            FROM railway_control.signals;
-
-            -- Get point machine statistics
-            SELECT
-                COUNT(*) as total,
-                COUNT(*) FILTER (WHERE operating_status = 'CONNECTED') as connected,
-                COUNT(*) FILTER (WHERE operating_status = 'IN_TRANSITION') as in_transition
-            INTO point_stats
-            FROM railway_control.point_machines;
-
-            -- Build result JSON
-            result := json_build_object(
+            SELECT json_build_object(
                 'timestamp', extract(epoch from now()),
                 'tracks', json_build_object(
-                    'total', track_stats.total,
-                    'occupied', track_stats.occupied,
-                    'assigned', track_stats.assigned,
-                    'available', track_stats.total - track_stats.occupied - track_stats.assigned
+                    'total', COALESCE(SUM(tracks_total), 0),
+                    'occupied', COALESCE(SUM(tracks_occupied), 0),
+                    'assigned', COALESCE(SUM(tracks_assigned), 0),
+                    'available', COALESCE(SUM(tracks_total - tracks_occupied - tracks_assigned), 0)
                 ),
                 'signals', json_build_object(
-                    'total', signal_stats.total,
-                    'active', signal_stats.active
+                    'total', COALESCE(SUM(signals_total), 0),
+                    'active', COALESCE(SUM(signals_active), 0)
                 ),
                 'point_machines', json_build_object(
-                    'total', point_stats.total,
-                    'connected', point_stats.connected,
-                    'in_transition', point_stats.in_transition
+                    'total', COALESCE(SUM(points_total), 0),
+                    'connected', COALESCE(SUM(points_connected), 0),
+                    'in_transition', COALESCE(SUM(points_in_transition), 0)
                 )
-            );
-
-            RETURN result;
-        END;
-        $$ LANGUAGE plpgsql)"
+            )
+            FROM railway_control.station_status
+            WHERE station_id_param IS NULL OR station_id = station_id_param;
+        $$ LANGUAGE sql STABLE)",
+
+        // Elements whose bounding box meets a grid rectangle (GiST box indexes, no PostGIS)
+        R"(CREATE OR REPLACE FUNCTION railway_control.elements_in_box(
+            min_row_param NUMERIC, min_col_param NUMERIC,
+            max_row_param NUMERIC, max_col_param NUMERIC,
+            station_id_param VARCHAR DEFAULT NULL
+        ) RETURNS TABLE(element_type VARCHAR, element_id VARCHAR) AS $$
+            WITH area AS (
+                SELECT box(point(min_col_param, min_row_param), point(max_col_param, max_row_param)) AS b
+            )
+            SELECT 'TRACK_SEGMENT'::VARCHAR, ts.segment_id
+            FROM railway_control.track_segments ts, area
+            WHERE box(point(ts.start_col, ts.start_row), point(ts.end_col, ts.end_row)) && area.b
+              AND (station_id_param IS NULL OR ts.station_id = station_id_param)
+            UNION ALL
+            SELECT 'SIGNAL'::VARCHAR, s.signal_id
+            FROM railway_control.signals s, area
+            WHERE box(point(s.location_col, s.location_row), point(s.location_col, s.location_row)) && area.b
+              AND (station_id_param IS NULL OR s.station_id = station_id_param)
+            UNION ALL
+            SELECT 'POINT_MACHINE'::VARCHAR, pm.machine_id
+            FROM railway_control.point_machines pm, area
+            WHERE box(point(pm.junction_col, pm.junction_row), point(pm.junction_col, pm.junction_row)) && area.b
+              AND (station_id_param IS NULL OR pm.station_id = station_id_param)
+            UNION ALL
+            SELECT 'TEXT_LABEL'::VARCHAR, tl.id::VARCHAR
+            FROM railway_control.text_labels tl, area
+            WHERE box(point(tl.position_col, tl.position_row), point(tl.position_col, tl.position_row)) && area.b
+              AND (station_id_param IS NULL OR tl.station_id = station_id_param)
+        $$ LANGUAGE sql STABLE)"
     };
 
     qDebug() << "Creating advanced functions...";
@@ -1304,7 +1749,76 @@ bool DatabaseInitializer::createAdvancedTriggers() {
 
         R"(CREATE TRIGGER trg_point_machines_notify
             AFTER INSERT OR UPDATE OR DELETE ON railway_control.point_machines
-            FOR EACH ROW EXECUTE FUNCTION railway_control.notify_point_changes())"
+            FOR EACH ROW EXECUTE FUNCTION railway_control.notify_point_changes())",
+
+        // Transition tables rule out UPDATE OF column lists: statements that move no
+        // counter net out to zero deltas and push nothing
+        R"(CREATE TRIGGER trg_track_segments_status_insert
+            AFTER INSERT ON railway_control.track_segments
+            REFERENCING NEW TABLE AS new_rows
+            FOR EACH STATEMENT EXECUTE FUNCTION railway_control.count_track_changes())",
+
+        R"(CREATE TRIGGER trg_track_segments_status_update
+            AFTER UPDATE ON railway_control.track_segments
+            REFERENCING OLD TABLE AS old_rows NEW TABLE AS new_rows
+            FOR EACH STATEMENT EXECUTE FUNCTION railway_control.count_track_changes())",
+
+        R"(CREATE TRIGGER trg_track_segments_status_delete
+            AFTER DELETE ON railway_control.track_segments
+            REFERENCING OLD TABLE AS old_rows
+            FOR EACH STATEMENT EXECUTE FUNCTION railway_control.count_track_changes())",
+
+        R"(CREATE TRIGGER trg_signals_status_insert
+            AFTER INSERT ON railway_control.signals
+            REFERENCING NEW TABLE AS new_rows
+            FOR EACH STATEMENT EXECUTE FUNCTION railway_control.count_signal_changes())",
+
+        R"(CREATE TRIGGER trg_signals_status_update
+            AFTER UPDATE ON railway_control.signals
+            REFERENCING OLD TABLE AS old_rows NEW TABLE AS new_rows
+            FOR EACH STATEMENT EXECUTE FUNCTION railway_control.count_signal_changes())",
+
+        R"(CREATE TRIGGER trg_signals_status_delete
+            AFTER DELETE ON railway_control.signals
+            REFERENCING OLD TABLE AS old_rows
+            FOR EACH STATEMENT EXECUTE FUNCTION railway_control.count_signal_changes())",
+
+        R"(CREATE TRIGGER trg_point_machines_status_insert
+            AFTER INSERT ON railway_control.point_machines
+            REFERENCING NEW TABLE AS new_rows
+            FOR EACH STATEMENT EXECUTE FUNCTION railway_control.count_point_changes())",
+
+        R"(CREATE TRIGGER trg_point_machines_status_update
+            AFTER UPDATE ON railway_control.point_machines
+            REFERENCING OLD TABLE AS old_rows NEW TABLE AS new_rows
+            FOR EACH STATEMENT EXECUTE FUNCTION railway_control.count_point_changes())",
+
+        R"(CREATE TRIGGER trg_point_machines_status_delete
+            AFTER DELETE ON railway_control.point_machines
+            REFERENCING OLD TABLE AS old_rows
+            FOR EACH STATEMENT EXECUTE FUNCTION railway_control.count_point_changes())",
+
+        // Layout version; geometry columns only, so state updates never bump it
+        R"(CREATE TRIGGER trg_track_segments_layout
+            AFTER INSERT OR DELETE OR UPDATE OF station_id, segment_name, start_row, start_col, end_row, end_col, track_type
+            ON railway_control.track_segments
+            FOR EACH ROW EXECUTE FUNCTION railway_control.bump_layout_version())",
+
+        R"(CREATE TRIGGER trg_signals_layout
+            AFTER INSERT OR DELETE OR UPDATE OF station_id, signal_name, signal_type_id, location_row, location_col,
+                direction, loop_signal_configuration, aspect_count, possible_aspects, location_description, interlocked_with
+            ON railway_control.signals
+            FOR EACH ROW EXECUTE FUNCTION railway_control.bump_layout_version())",
+
+        R"(CREATE TRIGGER trg_point_machines_layout
+            AFTER INSERT OR DELETE OR UPDATE OF station_id, machine_name, junction_row, junction_col, root_track_connection,
+                normal_track_connection, reverse_track_connection, transition_time_ms, safety_interlocks
+            ON railway_control.point_machines
+            FOR EACH ROW EXECUTE FUNCTION railway_control.bump_layout_version())",
+
+        R"(CREATE TRIGGER trg_text_labels_layout
+            AFTER INSERT OR UPDATE OR DELETE ON railway_control.text_labels
+            FOR EACH ROW EXECUTE FUNCTION railway_control.bump_layout_version())"
     };
 
     qDebug() << "Creating advanced triggers...";
@@ -1574,6 +2088,11 @@ QVariantMap DatabaseInitializer::getDatabaseStatus() {
     return status;
 }
 
+void DatabaseInitializer::setSystemServer(const QString& hostName, int port) {
+    m_systemHost = hostName;
+    m_systemPort = port;
+}
+
 void DatabaseInitializer::testConnection() {
     bool success = connectToDatabase();
     QString message = success ? "Database connection successful" : m_lastError;
@@ -1581,6 +2100,23 @@ void DatabaseInitializer::testConnection() {
 }
 
 // StationData.js conversion methods
+StationData DatabaseInitializer::getBuiltInStationData() {
+    StationData station;
+    station.trackSegments = getTrackSegmentsData();
+    station.pointMachines = getPointMachinesData();
+    station.textLabels = getTextLabelsData();
+
+    // Combine all signal types
+    for (const QJsonArray& signalGroup : {getOuterSignalsData(), getHomeSignalsData(),
+                                          getStarterSignalsData(), getAdvancedStarterSignalsData()}) {
+        for (const auto& signal : signalGroup) {
+            station.signalList.append(signal);
+        }
+    }
+
+    return station;
+}
+
 QJsonArray DatabaseInitializer::getTrackSegmentsData() {
     return QJsonArray {
         QJsonObject{{"id", "T1S1"}, {"startRow", 110}, {"startCol", 0}, {"endRow", 110}, {"endCol", 12}, {"occupied", false}, {"assigned", false}},
@@ -13,6 +13,7 @@
 #include <QTextStream>
 #include <QTimer>
 #include <memory>
+#include "stationgenerator.h"
 
 class DatabaseInitializer : public QObject {
     Q_OBJECT
@@ -33,10 +34,15 @@ public:
 
     // Main operations callable from QML
     Q_INVOKABLE void resetDatabaseAsync();
+    // Same reset, but populated with a generated station ~scaleFactor × the built-in one
+    Q_INVOKABLE void resetDatabaseWithSyntheticStationAsync(int scaleFactor);
     Q_INVOKABLE bool isDatabaseConnected();
     Q_INVOKABLE QVariantMap getDatabaseStatus();
     Q_INVOKABLE void testConnection();
 
+    // Overrides the system server endpoint (benchmarks and tooling run against throwaway servers)
+    void setSystemServer(const QString& hostName, int port);
+
 public slots:
     // ✅ ADD: Test connection method
     Q_INVOKABLE void testConnectionAsync();
@@ -58,14 +64,18 @@ private:
     int m_progress = 0;
     int m_portablePort = 5433;
     int m_systemPort = 5432;
+    QString m_systemHost = "localhost";
     QString m_currentOperation;
     QString m_lastError;
+    int m_syntheticScale = 0;   // 0 = built-in StationData.js layout
+    StationData m_station;
 
     // Database connection
     QSqlDatabase db;
     QTimer* resetTimer;
 
     // Core operations
+    void startReset();
     bool connectToDatabase();
     bool connectToSystemPostgreSQL();
     bool connectToPortablePostgreSQL();
@@ -88,6 +98,7 @@ private:
 
     // Helper methods
     bool executeQuery(const QString& query, const QVariantList& params = QVariantList());
+    bool executePrepared(QSqlQuery& query, const QVariantList& params);
     bool executeSchemaScript();
     void setError(const QString& error);
     void updateProgress(int value, const QString& operation);
@@ -98,6 +109,7 @@ private:
     int insertPointPosition(const QString& positionCode, const QString& positionName);
 
     // StationData.js conversion functions
+    StationData getBuiltInStationData();
     QJsonArray getTrackSegmentsData();
     QJsonArray getOuterSignalsData();
     QJsonArray getHomeSignalsData();
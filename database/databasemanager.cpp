@@ -1,11 +1,87 @@
-#include "DatabaseManager.h"
+#include "databasemanager.h"
+#include "database/connectionsupervisor.h"
+#include "database/portableserver.h"
+#include "database/portprobe.h"
+#include "diagnostics/commandtracer.h"
+#include "diagnostics/tracebuffer.h"
+#include "interlocking/interlockingengine.h"
+#include "broker/statebrokerclient.h"
 #include <QStandardPaths>
 #include <QDir>
 #include <QCoreApplication>
+#include <QEventLoop>
 #include <QThread>
 #include <QProcess>
 #include <QFile>
 #include <QFileInfo>
+#include <QRegularExpression>
+#include <QSet>
+
+namespace {
+// Bounds every (re)open and lets the kernel notice a dead peer; QPSQL hands
+// these to libpq as conninfo keywords
+const QString kConnectOptions = QStringLiteral(
+    "connect_timeout=3;keepalives=1;keepalives_idle=10;keepalives_interval=5;keepalives_count=3");
+
+// PostgreSQL INTEGER[] as text ("{1,2,3}") to a list of ints
+QVariantList parseIntegerArray(const QString& text) {
+    QVariantList values;
+    const QString body = text.mid(1, text.length() - 2);
+    for (const QString& item : body.split(',', Qt::SkipEmptyParts)) {
+        bool ok = false;
+        const int value = item.trimmed().toInt(&ok);
+        if (ok) values.append(value);
+    }
+    return values;
+}
+
+// Notification fields as trace argument codes (no strings in the ring buffer)
+std::int64_t traceTableCode(const QString& table) {
+    if (table == "track_segments") return TraceTable::TrackSegments;
+    if (table == "signals") return TraceTable::Signals;
+    if (table == "point_machines") return TraceTable::PointMachines;
+    if (table == "text_labels") return TraceTable::TextLabels;
+    return TraceTable::Unknown;
+}
+
+std::int64_t traceOperationCode(const QString& operation) {
+    if (operation == "INSERT") return TraceOperation::Insert;
+    if (operation == "UPDATE") return TraceOperation::Update;
+    if (operation == "DELETE") return TraceOperation::Delete;
+    return TraceOperation::Unknown;
+}
+
+std::int64_t traceUpdateKindCode(const QString& commandType) {
+    if (commandType == "SIGNAL_ASPECT") return TraceUpdateKind::SignalAspect;
+    if (commandType == "POINT_POSITION") return TraceUpdateKind::PointPosition;
+    if (commandType == "TRACK_OCCUPANCY") return TraceUpdateKind::TrackOccupancy;
+    if (commandType == "TRACK_ASSIGNMENT") return TraceUpdateKind::TrackAssignment;
+    if (commandType == "POINT_TRANSITION") return TraceUpdateKind::PointTransition;
+    return TraceUpdateKind::Unknown;
+}
+
+// QStringList as a PostgreSQL array literal ({"a","b"}) for ?::varchar[] binds
+QString toPostgresTextArray(const QStringList& values) {
+    QStringList quoted;
+    quoted.reserve(values.size());
+    for (QString value : values) {
+        value.replace('\\', "\\\\").replace('"', "\\\"");
+        quoted.append(QStringLiteral("\"%1\"").arg(value));
+    }
+    return QStringLiteral("{%1}").arg(quoted.join(','));
+}
+
+QString toPostgresBoolArray(const QList<bool>& values) {
+    QString literal(QLatin1Char('{'));
+    literal.reserve(2 * values.size() + 2);
+    for (int i = 0; i < values.size(); ++i) {
+        if (i > 0) literal += QLatin1Char(',');
+        literal += values[i] ? QLatin1Char('t') : QLatin1Char('f');
+    }
+    literal += QLatin1Char('}');
+    return literal;
+}
+}
 
 DatabaseManager::DatabaseManager(QObject* parent)
     : QObject(parent)
@@ -13,16 +89,41 @@ DatabaseManager::DatabaseManager(QObject* parent)
     , connected(false)
     , m_connectionTimer(std::make_unique<QTimer>(this))
     , m_statePollingTimer(std::make_unique<QTimer>(this))
+    , m_stationSweepTimer(std::make_unique<QTimer>(this))
 {
     connect(pollingTimer.get(), &QTimer::timeout, this, &DatabaseManager::pollDatabase);
     pollingTimer->setInterval(POLLING_INTERVAL_MS);
 
-    m_connectionTimer->setInterval(5000);  // Check every 5 seconds
+    m_connectionTimer->setInterval(HEARTBEAT_INTERVAL_MS);
+    connect(m_connectionTimer.get(), &QTimer::timeout, this, &DatabaseManager::checkConnection);
     m_statePollingTimer->setInterval(200); // Poll every 200ms
+
+    m_stations.insert(m_activeStation, StationSubscription());
+    m_stationClock.start();
+    connect(m_stationSweepTimer.get(), &QTimer::timeout, this, &DatabaseManager::sweepIdleStations);
+    m_stationSweepTimer->start(STATION_SWEEP_INTERVAL_MS);
+
+    m_supervisor = new ConnectionSupervisor(this);
+    connect(m_supervisor, &ConnectionSupervisor::serverReachable, this, &DatabaseManager::onServerReachable);
+    connect(m_supervisor, &ConnectionSupervisor::reconnectScheduled, this, [this](int attempt, int delayMs) {
+        emit reconnectAttemptsChanged();
+        emit reconnectScheduled(attempt, delayMs);
+    });
+
+    m_portableServer = new PortableServer(this);
+    connect(m_portableServer, &PortableServer::ready, this, [this]() {
+        m_startupTimings.insert(m_portableServer->phaseTimings());
+        if (m_connecting) openPortableConnection(0);
+    });
+    connect(m_portableServer, &PortableServer::failed, this, [this]() {
+        m_startupTimings.insert(m_portableServer->phaseTimings());
+        if (m_connecting) finishStartup(false);
+    });
 }
 
 DatabaseManager::~DatabaseManager() {
     stopPolling();
+    m_binaryReader.close();
     if (db.isOpen()) {
         db.close();
     }
@@ -32,28 +133,71 @@ DatabaseManager::~DatabaseManager() {
 
 bool DatabaseManager::connectToDatabase()
 {
-    // Try system PostgreSQL first
-    if (connectToSystemPostgreSQL()) {
-        qDebug() << "✅ Connected to system PostgreSQL";
-        enableRealTimeUpdates();  // ✅ Enable LISTEN/NOTIFY
-        return true;
-    }
+    if (connected) return true;
+
+    QEventLoop loop;
+    connect(this, &DatabaseManager::startupFinished, &loop, &QEventLoop::quit);
+    connectToDatabaseAsync();
+    if (m_connecting) loop.exec();
+    return connected;
+}
+
+void DatabaseManager::connectToDatabaseAsync()
+{
+    if (connected || m_connecting) return;
+
+    m_connecting = true;
+    emit connectingChanged();
+    m_startupTimings.clear();
+    m_startupClock.start();
+
+    // A missing portable cluster gets its initdb now, in parallel with the
+    // probe below and with QML loading, in case the portable server is needed
+    m_portableServer->setRoot(getApplicationDirectory());
+    m_portableServer->setPort(m_portablePort);
+    m_portableServer->prepare();
+
+    // Non-blocking probe first: a refused or silent system port costs at most
+    // SYSTEM_PROBE_TIMEOUT_MS instead of a blocking open attempt
+    PortProbe::probe(this, m_systemHost, m_systemPort, SYSTEM_PROBE_TIMEOUT_MS, [this](bool reachable) {
+        m_startupTimings["system_probe_ms"] = m_startupClock.elapsed();
+        if (reachable && connectToSystemPostgreSQL()) {
+            qDebug() << "✅ Connected to system PostgreSQL";
+            finishStartup(true);
+            return;
+        }
+
+        qDebug() << "🔄 System PostgreSQL unavailable, starting portable mode...";
+        startPortableServer();
+    });
+}
 
-    qDebug() << "🔄 System PostgreSQL unavailable, starting portable mode...";
+void DatabaseManager::finishStartup(bool ok)
+{
+    m_startupTimings["total_ms"] = m_startupClock.elapsed();
+    qDebug() << "⏱️ Database startup" << (ok ? "completed" : "failed") << m_startupTimings;
+    m_connecting = false;
+    emit connectingChanged();
 
-    // Fall back to portable PostgreSQL
-    if (startPortableMode()) {
-        qDebug() << "✅ Connected to portable PostgreSQL";
+    if (ok) {
         enableRealTimeUpdates();  // ✅ Enable LISTEN/NOTIFY
-        return true;
+        refreshSystemStatus();
+        superviseConnection();
+    } else {
+        // ✅ Set disconnected state and emit signal
+        connected = false;
+        m_isConnected = false;
+        emit connectionStateChanged(connected);
+        emit errorOccurred("Failed to connect to any PostgreSQL instance");
+
+        // Keep trying the last configured server in the background
+        if (db.isValid() && !m_stateSource) {
+            m_supervisor->setEndpoint(db.hostName(), db.port());
+            m_supervisor->connectionLost();
+        }
     }
 
-    // ✅ Set disconnected state and emit signal
-    connected = false;
-    m_isConnected = false;
-    emit connectionStateChanged(connected);
-    emit errorOccurred("Failed to connect to any PostgreSQL instance");
-    return false;
+    emit startupFinished(ok, m_startupTimings);
 }
 
 bool DatabaseManager::connectToSystemPostgreSQL()
@@ -65,15 +209,17 @@ bool DatabaseManager::connectToSystemPostgreSQL()
         }
 
         db = QSqlDatabase::addDatabase("QPSQL", "system_connection");
-        db.setHostName("localhost");
+        db.setHostName(m_systemHost);
         db.setPort(m_systemPort);
         db.setDatabaseName("railway_control_system");
         db.setUserName("postgres");
         db.setPassword("qwerty");
+        db.setConnectOptions(kConnectOptions);
 
         if (db.open()) {
             connected = true;
             m_isConnected = true;
+            openBinaryReader();
             emit connectionStateChanged(connected);
             qDebug() << "✅ Connected to system PostgreSQL (postgres/qwerty)";
             return true;
@@ -85,6 +231,7 @@ bool DatabaseManager::connectToSystemPostgreSQL()
     if (db.isOpen()) {
         db.close();
     }
+    m_binaryReader.close();
 
     connected = false;
     m_isConnected = false;
@@ -94,206 +241,478 @@ bool DatabaseManager::connectToSystemPostgreSQL()
 
 bool DatabaseManager::startPortableMode()
 {
-    m_appDirectory = getApplicationDirectory();
-    m_postgresPath = m_appDirectory + "/database/postgresql";
-    m_dataPath = m_appDirectory + "/database/data";
+    if (connected) return true;
+    if (m_connecting) return false;
+
+    QEventLoop loop;
+    connect(this, &DatabaseManager::startupFinished, &loop, &QEventLoop::quit);
+    m_connecting = true;
+    emit connectingChanged();
+    m_startupTimings.clear();
+    m_startupClock.start();
+    startPortableServer();
+    if (m_connecting) loop.exec();
+    return connected;
+}
 
-    // Initialize database if needed
-    if (!QDir(m_dataPath).exists()) {
-        if (!initializePortableDatabase()) {
-            return false;
-        }
-    }
+void DatabaseManager::startPortableServer()
+{
+    // ready()/failed() continue in openPortableConnection()/finishStartup()
+    m_portableServer->setRoot(getApplicationDirectory());
+    m_portableServer->setPort(m_portablePort);
+    m_portableServer->start();
+}
 
-    // ✅ Check if server is already running before starting
-    if (!isPortableServerRunning()) {
-        if (!startPortablePostgreSQL()) {
-            return false;
+void DatabaseManager::openPortableConnection(int attempt)
+{
+    if (attempt == 0) {
+        // ✅ Remove existing connection if it exists
+        if (QSqlDatabase::contains("portable_connection")) {
+            QSqlDatabase::removeDatabase("portable_connection");
         }
-        // Wait for server to start
-        // QThread::sleep(1);
-    } else {
-        qDebug() << "✅ Portable PostgreSQL server already running";
-    }
-
-    // ✅ Remove existing connection if it exists
-    if (QSqlDatabase::contains("portable_connection")) {
-        QSqlDatabase::removeDatabase("portable_connection");
-    }
 
-    try {
         db = QSqlDatabase::addDatabase("QPSQL", "portable_connection");
         db.setHostName("localhost");
         db.setPort(m_portablePort);
         db.setDatabaseName("railway_control_system");
         db.setUserName("postgres");
         db.setPassword("qwerty");
+        db.setConnectOptions(kConnectOptions);
+    }
 
-        if (db.open()) {
-            connected = true;
-            m_isConnected = true;
-            m_connectionStatus = "Connected to Portable PostgreSQL";
+    if (db.open()) {
+        m_startupTimings["open_ms"] = m_startupClock.elapsed();
+        connected = true;
+        m_isConnected = true;
+        m_connectionStatus = "Connected to Portable PostgreSQL";
+
+        setupDatabase();  // ✅ This will create the schema/tables
+        openBinaryReader();
+        emit connectionStateChanged(connected);
+        qDebug() << "✅ Portable PostgreSQL connected with schema created";
+        finishStartup(true);
+        return;
+    }
 
-            setupDatabase();  // ✅ This will create the schema/tables
-            emit connectionStateChanged(connected);
-            qDebug() << "✅ Portable PostgreSQL connected with schema created";
-            return true;
-        }
-    } catch (const std::exception& e) {
-        qDebug() << "❌ Portable PostgreSQL connection failed:" << e.what();
+    // The port opens before recovery finishes ("the database system is starting up")
+    if (attempt < PORTABLE_OPEN_RETRIES) {
+        QTimer::singleShot(PORTABLE_OPEN_RETRY_MS, this, [this, attempt]() { openPortableConnection(attempt + 1); });
+        return;
     }
 
-    connected = false;
-    m_isConnected = false;
-    emit connectionStateChanged(connected);
-    return false;
+    qDebug() << "❌ Portable PostgreSQL connection failed:" << db.lastError().text();
+    finishStartup(false);
+}
+
+void DatabaseManager::setCommandTracer(CommandTracer* tracer)
+{
+    m_commandTracer = tracer;
 }
 
-bool DatabaseManager::initializePortableDatabase()
+void DatabaseManager::setInterlockingEngine(InterlockingEngine* engine)
 {
-    QString initdbPath = m_postgresPath + "/bin/initdb.exe";
+    m_interlocking = engine;
+}
 
-    if (!QFile::exists(initdbPath)) {
-        qDebug() << "❌ PostgreSQL binaries not found at:" << m_postgresPath;
-        return false;
+void DatabaseManager::setStateSource(StateBrokerClient* source)
+{
+    if (m_stateSource) {
+        disconnect(m_stateSource, nullptr, this, nullptr);
     }
 
-    QProcess initProcess;
-    QStringList arguments;
-    arguments << "-D" << m_dataPath
-              << "-U" << "postgres"      // ✅ CHANGED: Use postgres user
-              << "-A" << "trust"         // ✅ Start with trust, convert later
-              << "-E" << "UTF8";
+    m_stateSource = source;
+    if (!m_stateSource) return;
+
+    // The broker's station is this workstation's station
+    connect(m_stateSource, &StateBrokerClient::snapshotApplied, this, [this]() {
+        if (m_stateSource->station() != m_activeStation) {
+            m_stations.remove(m_activeStation);
+            m_activeStation = m_stateSource->station();
+            m_stations.insert(m_activeStation, StationSubscription());
+            emit activeStationChanged();
+            emit openStationsChanged();
+        }
+        emit trackSegmentsChanged();
+        emit signalsChanged();
+        emit pointMachinesChanged();
+        emit textLabelsChanged();
+        emit dataUpdated();
+        refreshSystemStatus();
+    });
+    connect(m_stateSource, &StateBrokerClient::rowUpdated, this,
+            [this](StationStateStore::Table table, const QString& id) {
+        switch (table) {
+        case StationStateStore::TrackSegments:
+            emit trackSegmentsChanged();
+            emit trackSegmentUpdated(id);
+            break;
+        case StationStateStore::Signals:
+            emit signalsChanged();
+            emit signalUpdated(id);
+            break;
+        case StationStateStore::PointMachines:
+            emit pointMachinesChanged();
+            emit pointMachineUpdated(id);
+            break;
+        default:
+            break;
+        }
+        emit dataUpdated();
+        refreshSystemStatus();
+    });
+}
 
-    qDebug() << "🔧 Initializing portable database with postgres user...";
-    initProcess.start(initdbPath, arguments);
+bool DatabaseManager::servedByStateSource(const QString& stationId) const
+{
+    return m_stateSource && m_stateSource->isSynchronized() && stationScope(stationId) == m_stateSource->station();
+}
 
-    if (!initProcess.waitForFinished(100)) {
-        qDebug() << "❌ Database initialization timed out";
-        return false;
-    }
+void DatabaseManager::setSystemServer(const QString& hostName, int port)
+{
+    m_systemHost = hostName;
+    m_systemPort = port;
+}
 
-    if (initProcess.exitCode() != 0) {
-        qDebug() << "❌ Database initialization failed:" << initProcess.readAllStandardError();
-        return false;
+void DatabaseManager::openBinaryReader()
+{
+    if (!PgBinaryReader::isAvailable()) return;
+
+    // Second session with the same credentials; QtSql stays the write path
+    if (m_binaryReader.open(db.hostName(), db.port(), db.databaseName(), db.userName(), db.password())) {
+        qDebug() << "⚡ Binary-format list queries enabled (libpq)";
+    } else {
+        qWarning() << "⚠️ libpq binary reads unavailable, using QtSql:" << m_binaryReader.lastError();
     }
+}
 
-    qDebug() << "✅ Portable database initialized with postgres user";
-    return true;
+void DatabaseManager::disableBinaryReader(const char* query)
+{
+    // Fall back for the rest of the session; the next connect retries
+    qWarning() << "⚠️ Binary" << query << "query failed, falling back to QtSql:" << m_binaryReader.lastError();
+    m_binaryReader.close();
+}
+
+// ===== Connection supervision =====
+// A lost session is noticed by the heartbeat (which doubles as the change-log
+// watermark read). The UI keeps showing the last known state, flagged stale,
+// while ConnectionSupervisor probes the server without blocking. Once it is
+// reachable the session is reopened, LISTEN re-established, and only the
+// rows the audit change log records since the watermark are re-announced.
+
+void DatabaseManager::superviseConnection()
+{
+    m_supervisor->setEndpoint(db.hostName(), db.port());
+    m_supervisor->connectionRestored();
+    emit reconnectAttemptsChanged();
+    checkConnection();   // first watermark
+    m_connectionTimer->start();
 }
 
-bool DatabaseManager::startPortablePostgreSQL()
+int DatabaseManager::reconnectAttempts() const
 {
-    QString pgCtlPath = m_postgresPath + "/bin/pg_ctl.exe";
-    QString logPath = m_appDirectory + "/database/logs/postgresql.log";
+    return m_supervisor->attempts();
+}
 
-    // Ensure logs directory exists
-    QDir().mkpath(QFileInfo(logPath).path());
+void DatabaseManager::setStale(bool stale)
+{
+    if (m_stale == stale) return;
+    m_stale = stale;
+    emit staleChanged();
+}
 
-    if (m_postgresProcess) {
-        delete m_postgresProcess;
+bool DatabaseManager::readChangeWatermark(qint64* watermark, qint64* changeLogOid)
+{
+    // Transactions in progress now have txids >= xmin, whatever order they commit in
+    QSqlQuery query(db);
+    if (!query.exec("SELECT pg_snapshot_xmin(pg_current_snapshot())::text::bigint, "
+                    "'railway_audit.event_log'::regclass::oid::bigint") || !query.next()) {
+        return false;
     }
+    *watermark = query.value(0).toLongLong();
+    *changeLogOid = query.value(1).toLongLong();
+    return true;
+}
 
-    m_postgresProcess = new QProcess(this);
+void DatabaseManager::checkConnection()
+{
+    if (!connected || m_stateSource) return;
 
-    QStringList arguments;
-    arguments << "-D" << m_dataPath
-              << "-l" << logPath
-              << "start";  // ✅ REMOVED: -o port argument (port is in postgresql.conf)
+    if (readChangeWatermark(&m_changeWatermark, &m_changeLogOid)) {
+        return;
+    }
 
-    qDebug() << "🚀 Starting portable PostgreSQL server...";
-    qDebug() << "Command:" << pgCtlPath << arguments.join(" ");
+    // Failed: a dead session, or no change log / PostgreSQL before 13
+    QSqlQuery probe(db);
+    if (!probe.exec("SELECT 1")) {
+        handleConnectionLost(probe.lastError().text());
+        return;
+    }
+    m_changeWatermark = -1;   // unknown: the next reconnect reloads everything
+}
 
-    m_postgresProcess->start(pgCtlPath, arguments);
+void DatabaseManager::handleConnectionLost(const QString& reason)
+{
+    if (!connected) return;
 
-    if (!m_postgresProcess->waitForFinished(100)) {  // ✅ Increased timeout
-        qDebug() << "❌ Failed to start PostgreSQL server (timeout)";
-        return false;
-    }
+    qWarning() << "❌ Database connection lost:" << reason;
+    m_connectionTimer->stop();
 
-    if (m_postgresProcess->exitCode() != 0) {
-        QString errorOutput = m_postgresProcess->readAllStandardError();
-        QString standardOutput = m_postgresProcess->readAllStandardOutput();
-        qDebug() << "❌ PostgreSQL server start failed with exit code:" << m_postgresProcess->exitCode();
-        qDebug() << "Error output:" << errorOutput;
-        qDebug() << "Standard output:" << standardOutput;
-        return false;
+    // LISTEN registrations die with the session (and with them the announced layout versions)
+    for (auto it = m_stations.begin(); it != m_stations.end(); ++it) {
+        it->subscribed = false;
+        it->layoutVersion = -1;
     }
+    m_binaryReader.close();
+    db.close();
+    m_fieldInputEchoes.clear();   // their notifications died with the session
 
-    qDebug() << "✅ Portable PostgreSQL server started on port" << m_portablePort;
-    return true;
+    connected = false;
+    m_isConnected = false;
+    setStale(true);
+    emit connectionStateChanged(connected);
+
+    m_supervisor->setEndpoint(db.hostName(), db.port());
+    m_supervisor->connectionLost();
 }
 
-QString DatabaseManager::getApplicationDirectory()
+void DatabaseManager::reconnect()
 {
-    // Go up one level from app/ to get to the root project directory
-    QDir appDir(QCoreApplication::applicationDirPath());
-    appDir.cdUp();  // Go from "app/" to root directory
-    return appDir.absolutePath();
+    if (m_stateSource || m_connecting) return;
+
+    if (connected) {
+        handleConnectionLost(QStringLiteral("reconnect requested"));
+    } else if (!db.isValid()) {
+        connectToDatabaseAsync();
+        return;
+    }
+    m_supervisor->connectionLost(true);
 }
 
-void DatabaseManager::cleanup()
+void DatabaseManager::onServerReachable()
 {
-    if (m_postgresProcess) {
-        stopPortablePostgreSQL();
-        delete m_postgresProcess;
-        m_postgresProcess = nullptr;
+    if (connected) {
+        m_supervisor->connectionRestored();
+        return;
+    }
+
+    // Port accepts: the reopen itself is bounded by connect_timeout. It stays on
+    // this thread because a QSqlDatabase connection is bound to the thread
+    // that opened it; the resync after it is two indexed queries
+    if (!db.open()) {
+        qWarning() << "⚠️ Database reopen failed:" << db.lastError().text();
+        m_supervisor->attemptFailed();
+        return;
     }
+
+    qDebug() << "✅ Database session reopened on" << db.hostName() << db.port();
+    m_supervisor->connectionRestored();
+    emit reconnectAttemptsChanged();
+    connected = true;
+    m_isConnected = true;
+    openBinaryReader();
+
+    // LISTEN before reading the change log, so nothing falls in between
+    enableRealTimeUpdates();
+    refreshSystemStatus();
+    resynchronize();
+    m_connectionTimer->start();
 }
 
-bool DatabaseManager::stopPortablePostgreSQL()
+void DatabaseManager::resynchronize()
 {
-    if (!m_postgresProcess) return true;
+    // Watermark -1 (never connected, or no change log) means reload everything
+    const qint64 since = m_changeWatermark;
+    bool fullReload = since < 0;
+
+    // Read the next watermark first: whatever commits from here on is >= it
+    qint64 latest = -1;
+    qint64 changeLogOid = -1;
+    if (readChangeWatermark(&latest, &changeLogOid)) {
+        // A recreated change log or a different cluster: the database was reset or restored
+        if (changeLogOid != m_changeLogOid || latest < since) fullReload = true;
+    } else {
+        fullReload = true;
+    }
 
-    QString pgCtlPath = m_postgresPath + "/bin/pg_ctl.exe";
+    struct Change { QString table; QString stationId; QString entityId; };
+    QList<Change> changes;
+    if (!fullReload) {
+        QSqlQuery changeQuery(db);
+        changeQuery.prepare(R"(
+            SELECT DISTINCT entity_type, replay_data->>'station_id',
+                   COALESCE(replay_data->>'segment_id', replay_data->>'signal_id', replay_data->>'machine_id')
+            FROM railway_audit.event_log
+            WHERE transaction_id >= ?
+            LIMIT ?
+        )");
+        changeQuery.addBindValue(since);
+        changeQuery.addBindValue(RESYNC_MAX_CHANGES + 1);
+
+        if (changeQuery.exec()) {
+            while (changeQuery.next()) {
+                changes.append({changeQuery.value(0).toString(), changeQuery.value(1).toString(),
+                                changeQuery.value(2).toString()});
+            }
+            fullReload = changes.size() > RESYNC_MAX_CHANGES;
+        } else {
+            qWarning() << "⚠️ Change log unreadable, reloading everything:" << changeQuery.lastError().text();
+            fullReload = true;
+        }
+    }
+
+    m_changeWatermark = latest;
+    m_changeLogOid = changeLogOid;
 
-    QProcess stopProcess;
-    QStringList arguments;
-    arguments << "-D" << m_dataPath << "stop";
+    if (fullReload) {
+        qDebug() << "🔄 Resync after reconnect: full reload";
+        setStale(false);
+        emit connectionStateChanged(connected);
+        emit resynchronized(-1, true);
+        return;
+    }
 
-    qDebug() << "🛑 Stopping portable PostgreSQL server...";
-    stopProcess.start(pgCtlPath, arguments);
+    // Consumers see isStale() here and keep their state instead of reloading
+    emit connectionStateChanged(connected);
 
-    if (stopProcess.waitForFinished(5000)) {
-        qDebug() << "✅ PostgreSQL server stopped successfully";
-        return true;
+    QSet<QString> tables;
+    for (const Change& change : changes) {
+        if (change.stationId != m_activeStation) {
+            if (m_stations.contains(change.stationId)) {
+                emit stationDataChanged(change.stationId, change.table, change.entityId);
+            }
+            continue;
+        }
+
+        tables.insert(change.table);
+        if (change.table == "signals") {
+            emit signalUpdated(change.entityId);
+        } else if (change.table == "point_machines") {
+            emit pointMachineUpdated(change.entityId);
+        } else if (change.table == "track_segments") {
+            emit trackSegmentUpdated(change.entityId);
+        }
+    }
+    if (tables.contains("signals")) emit signalsChanged();
+    if (tables.contains("point_machines")) emit pointMachinesChanged();
+    if (tables.contains("track_segments")) emit trackSegmentsChanged();
+
+    // Layout edits (labels above all) are not in the change log: compare versions instead
+    const LayoutCache* cache = layoutCache(m_activeStation);
+    if (cache && !cache->isEmpty() && !layoutCached(m_activeStation)) {
+        handleLayoutChange(m_activeStation, layoutVersion(m_activeStation));
     }
 
-    qDebug() << "⚠️ PostgreSQL server stop timed out";
-    return false;
+    qDebug() << "🔄 Resync after reconnect:" << changes.size() << "changed rows since transaction" << since;
+    setStale(false);
+    emit resynchronized(changes.size(), false);
+}
+
+QString DatabaseManager::getApplicationDirectory()
+{
+    // Go up one level from app/ to get to the root project directory
+    QDir appDir(QCoreApplication::applicationDirPath());
+    appDir.cdUp();  // Go from "app/" to root directory
+    return appDir.absolutePath();
+}
+
+void DatabaseManager::cleanup()
+{
+    m_portableServer->stop();
 }
 
 void DatabaseManager::enableRealTimeUpdates() {
+    if (m_stateSource) {
+        qDebug() << "Real-time updates come from the state broker - no LISTEN";
+        return;
+    }
     if (!connected) {
         qDebug() << "Cannot enable real-time updates - database not connected";
         return;
     }
 
-    // Try to enable PostgreSQL notifications
-    QSqlQuery query(db);
-    if (query.exec("LISTEN railway_changes")) {
-        qDebug() << "PostgreSQL LISTEN enabled for real-time updates";
-
+    // The driver only reports channels registered through subscribeToNotification()
+    if (!m_realTimeEnabled) {
         QObject::connect(db.driver(), &QSqlDriver::notification,
-                         this, [this](const QString& name, QSqlDriver::NotificationSource /*source*/, const QVariant& payload) {
-                             this->handleDatabaseNotification(name, payload);
+                         this, [this](const QString& name, QSqlDriver::NotificationSource source, const QVariant& payload) {
+                             this->handleDatabaseNotification(name, payload, source == QSqlDriver::SelfSource);
                          });
+        m_realTimeEnabled = true;
+    }
+
+    for (auto it = m_stations.cbegin(); it != m_stations.cend(); ++it) {
+        subscribeStation(it.key());
+    }
+}
+
+void DatabaseManager::subscribeStation(const QString& stationId) {
+    auto it = m_stations.find(stationId);
+    if (!m_realTimeEnabled || !connected || it == m_stations.end() || it->subscribed) return;
+
+    const QString channel = QStringLiteral("railway_changes_") + stationId;
+    if (db.driver()->subscribeToNotification(channel)) {
+        it->subscribed = true;
+        qDebug() << "📡 LISTEN" << channel;
     } else {
-        qWarning() << "Failed to enable PostgreSQL LISTEN - using polling only";
-        qWarning() << "Error:" << query.lastError().text();
+        qWarning() << "❌ Failed to LISTEN on" << channel << "- using polling only:" << db.driver()->lastError().text();
+    }
+}
+
+void DatabaseManager::unsubscribeStation(const QString& stationId) {
+    auto it = m_stations.find(stationId);
+    if (it == m_stations.end() || !it->subscribed) return;
+
+    if (connected) {
+        db.driver()->unsubscribeFromNotification(QStringLiteral("railway_changes_") + stationId);
     }
+    it->subscribed = false;
+    it->layoutVersion = -1;
 }
 
-void DatabaseManager::handleDatabaseNotification(const QString& name, const QVariant& payload) {
-    if (name == "railway_changes") {
+void DatabaseManager::handleDatabaseNotification(const QString& name, const QVariant& payload, bool ownSession) {
+    if (name.startsWith(QLatin1String("railway_changes"))) {
         QJsonDocument doc = QJsonDocument::fromJson(payload.toString().toUtf8());
         QJsonObject obj = doc.object();
 
         QString table = obj["table"].toString();
         QString operation = obj["operation"].toString();
         QString entityId = obj["entity_id"].toString();
+        QString commandId = obj["command_id"].toString();
+        QString stationId = obj["station_id"].toString();
+
+        // Counter push from the status triggers: replaces the held copy, no query
+        if (table == QLatin1String("station_status")) {
+            if (stationId == m_activeStation) {
+                setSystemStatus({{"tracks", obj["tracks"].toObject().toVariantMap()},
+                                 {"signals", obj["signals"].toObject().toVariantMap()},
+                                 {"point_machines", obj["point_machines"].toObject().toVariantMap()}});
+            }
+            return;
+        }
+        // Geometry or labels edited: cached layout rows are void from this version on
+        if (table == QLatin1String("layout")) {
+            handleLayoutChange(stationId, obj["layout_version"].toVariant().toLongLong());
+            return;
+        }
+
+        RF_TRACE(Notify, NotificationReceived, entityId, traceTableCode(table), traceOperationCode(operation));
+
+        // Field inputs were announced with their values when written
+        if (ownSession && commandId.isEmpty() && consumeFieldInputEcho(table, entityId)) {
+            return;
+        }
+
+        // Stations other than the active one never touch the layout signals
+        if (!stationId.isEmpty() && stationId != m_activeStation) {
+            if (m_stations.contains(stationId)) {
+                emit stationDataChanged(stationId, table, entityId);
+            }
+            return;
+        }
 
-        qDebug() << "🔔 REAL-TIME notification:" << table << operation << entityId;
+        if (m_commandTracer && !commandId.isEmpty()) {
+            m_commandTracer->recordServerTime(commandId, obj["server_time"].toDouble());
+            m_commandTracer->recordHop(commandId, CommandTracer::NotifyReceived);
+        }
 
         // ✅ SAFETY: No cache refreshing - just emit signals for UI updates
         if (table == "signals") {
@@ -308,11 +727,15 @@ void DatabaseManager::handleDatabaseNotification(const QString& name, const QVar
         }
 
         emit dataUpdated();
+
+        if (m_commandTracer && !commandId.isEmpty()) {
+            m_commandTracer->recordHop(commandId, CommandTracer::NotifyRefreshed);
+        }
     }
 }
 
 void DatabaseManager::startPolling() {
-    if (connected) {
+    if (connected && !m_stateSource) {
         pollingTimer->start();
         qDebug() << "🔍 SAFETY: Database polling started (interval:" << POLLING_INTERVAL_MS << "ms) - DIRECT QUERIES ONLY";
     }
@@ -330,14 +753,17 @@ bool DatabaseManager::isConnected() const {
 void DatabaseManager::pollDatabase() {
     if (!connected) return;
 
-    qDebug() << "🔍 SAFETY POLLING: Direct database state check";
+    RF_TRACE(Poll, PollCycle, {});
     detectAndEmitChanges();
     emit dataUpdated(); // Trigger QML property updates
 }
 
 void DatabaseManager::detectAndEmitChanges() {
     // Poll signals
-    QSqlQuery query("SELECT signal_id, current_aspect_id FROM railway_control.signals", db);
+    QSqlQuery query(db);
+    query.prepare("SELECT signal_id, current_aspect_id FROM railway_control.signals WHERE station_id = ?");
+    query.addBindValue(m_activeStation);
+    query.exec();
     while (query.next()) {
         QString signalId = query.value(0).toString();
         int aspectId = query.value(1).toInt();
@@ -349,7 +775,10 @@ void DatabaseManager::detectAndEmitChanges() {
     }
 
     // Poll track circuits
-    QSqlQuery trackQuery("SELECT segment_id, is_occupied FROM railway_control.track_segments", db);
+    QSqlQuery trackQuery(db);
+    trackQuery.prepare("SELECT segment_id, is_occupied FROM railway_control.track_segments WHERE station_id = ?");
+    trackQuery.addBindValue(m_activeStation);
+    trackQuery.exec();
     while (trackQuery.next()) {
         QString segmentId = trackQuery.value(0).toString();
         bool isOccupied = trackQuery.value(1).toBool();
@@ -361,128 +790,420 @@ void DatabaseManager::detectAndEmitChanges() {
     }
 }
 
-bool DatabaseManager::isPortableServerRunning()
-{
-    QString pgCtlPath = m_postgresPath + "/bin/pg_ctl.exe";
-
-    QProcess checkProcess;
-    QStringList arguments;
-    arguments << "-D" << m_dataPath << "status";
+// Row getters: live state is always read from the database (or the state
+// source); only the static layout columns come from the per-station layout cache
+QVariantList DatabaseManager::getTrackSegmentsList(const QString& stationId) {
+    if (servedByStateSource(stationId)) return m_stateSource->store().rows(StationStateStore::TrackSegments);
 
-    checkProcess.start(pgCtlPath, arguments);
-    checkProcess.waitForFinished(100);
+    QVariantList tracks;
+    const QList<TrackSegmentInfo> rows = queryTrackSegments(stationId);
+    tracks.reserve(rows.size());
+    for (const TrackSegmentInfo& track : rows) {
+        tracks.append(track.toVariantMap());
+    }
+    return tracks;
+}
 
-    // If exit code is 0, server is running
-    bool isRunning = (checkProcess.exitCode() == 0);
-    qDebug() << "🔍 Portable PostgreSQL server running check:" << isRunning;
+QVariantList DatabaseManager::getAllSignalsList(const QString& stationId) {
+    if (servedByStateSource(stationId)) return m_stateSource->store().rows(StationStateStore::Signals);
 
-    return isRunning;
+    // ✅ FIXED: Changed from 'signals' to 'signalsList' (signals is a Qt keyword)
+    QVariantList signalsList;
+    const QList<SignalInfo> rows = querySignals(stationId);
+    signalsList.reserve(rows.size());
+    for (const SignalInfo& signal : rows) {
+        signalsList.append(signal.toVariantMap());
+    }
+    return signalsList;
 }
 
-// ✅ SAFETY: Direct database queries - NO CACHING
-QVariantList DatabaseManager::getTrackSegmentsList() {
-    if (!connected) return QVariantList();
+QVariantList DatabaseManager::getAllPointMachinesList(const QString& stationId) {
+    if (servedByStateSource(stationId)) return m_stateSource->store().rows(StationStateStore::PointMachines);
 
-    qDebug() << "🔍 SAFETY: getTrackSegmentsList() - DIRECT DATABASE QUERY";
+    QVariantList points;
+    const QList<PointMachineInfo> rows = queryPointMachines(stationId);
+    points.reserve(rows.size());
+    for (const PointMachineInfo& pm : rows) {
+        points.append(pm.toVariantMap());
+    }
+    return points;
+}
 
+QVariantList DatabaseManager::getTrackSegmentInfos(const QString& stationId) {
     QVariantList tracks;
-    QSqlQuery trackQuery(db);
-    QString trackSql = "SELECT segment_id, segment_name, start_row, start_col, end_row, end_col, track_type, is_occupied, is_assigned, occupied_by, is_active FROM railway_control.track_segments ORDER BY segment_id";
-
-    if (trackQuery.exec(trackSql)) {
-        while (trackQuery.next()) {
-            tracks.append(convertTrackRowToVariant(trackQuery));
+    if (servedByStateSource(stationId)) {
+        for (const QVariant& row : m_stateSource->store().rows(StationStateStore::TrackSegments)) {
+            tracks.append(QVariant::fromValue(TrackSegmentInfo::fromVariant(row)));
         }
-    } else {
-        qWarning() << "❌ SAFETY CRITICAL: Track query failed:" << trackQuery.lastError().text();
+        return tracks;
     }
 
+    const QList<TrackSegmentInfo> rows = queryTrackSegments(stationId);
+    tracks.reserve(rows.size());
+    for (const TrackSegmentInfo& track : rows) {
+        tracks.append(QVariant::fromValue(track));
+    }
     return tracks;
 }
 
-QVariantList DatabaseManager::getAllSignalsList() {
-    if (!connected) return QVariantList();
-
-    qDebug() << "🔍 SAFETY: getAllSignalsList() - DIRECT DATABASE QUERY";
-
-    // ✅ FIXED: Changed from 'signals' to 'signalsList' (signals is a Qt keyword)
+QVariantList DatabaseManager::getSignalInfos(const QString& stationId) {
     QVariantList signalsList;
-
-    QSqlQuery signalQuery(db);
-    QString signalSql = R"(
-        SELECT s.signal_id, s.signal_name, st.type_code as signal_type,
-               s.location_row as row, s.location_col as col, s.direction,
-               sa.aspect_code as current_aspect, s.calling_on_aspect, s.loop_aspect,
-               s.loop_signal_configuration, s.aspect_count, s.possible_aspects,
-               s.is_active, s.location_description as location
-        FROM railway_control.signals s
-        JOIN railway_config.signal_types st ON s.signal_type_id = st.id
-        LEFT JOIN railway_config.signal_aspects sa ON s.current_aspect_id = sa.id
-        ORDER BY s.signal_id
-    )";
-
-    if (signalQuery.exec(signalSql)) {
-        qDebug() << "📊 SAFETY: REAL-TIME signal query executed successfully";
-        while (signalQuery.next()) {
-            QString signalId = signalQuery.value("signal_id").toString();
-            QString currentAspect = signalQuery.value("current_aspect").toString();
-
-            // ✅ SAFETY: Log every signal state from database
-            qDebug() << "🚦 REAL-TIME:" << signalId << "=" << currentAspect;
-
-            // ✅ FIXED: Use signalsList instead of signals
-            signalsList.append(convertSignalRowToVariant(signalQuery));
+    if (servedByStateSource(stationId)) {
+        for (const QVariant& row : m_stateSource->store().rows(StationStateStore::Signals)) {
+            signalsList.append(QVariant::fromValue(SignalInfo::fromVariant(row)));
         }
-    } else {
-        qWarning() << "❌ SAFETY CRITICAL: Signal query failed:" << signalQuery.lastError().text();
+        return signalsList;
     }
 
-    // ✅ FIXED: Use signalsList instead of signals
-    qDebug() << "✅ SAFETY: Returning" << signalsList.size() << "signals from DIRECT database query";
+    const QList<SignalInfo> rows = querySignals(stationId);
+    signalsList.reserve(rows.size());
+    for (const SignalInfo& signal : rows) {
+        signalsList.append(QVariant::fromValue(signal));
+    }
     return signalsList;
 }
 
-QVariantList DatabaseManager::getAllPointMachinesList() {
-    if (!connected) return QVariantList();
-
-    qDebug() << "🔍 SAFETY: getAllPointMachinesList() - DIRECT DATABASE QUERY";
-
+QVariantList DatabaseManager::getPointMachineInfos(const QString& stationId) {
     QVariantList points;
-    QSqlQuery pointQuery(db);
-    QString pointSql = R"(
-        SELECT pm.machine_id, pm.machine_name, pm.junction_row, pm.junction_col,
-               pm.root_track_connection, pm.normal_track_connection, pm.reverse_track_connection,
-               pp.position_code as position, pm.operating_status, pm.transition_time_ms
-        FROM railway_control.point_machines pm
-        LEFT JOIN railway_config.point_positions pp ON pm.current_position_id = pp.id
-        ORDER BY pm.machine_id
-    )";
-
-    if (pointQuery.exec(pointSql)) {
-        while (pointQuery.next()) {
-            points.append(convertPointMachineRowToVariant(pointQuery));
+    if (servedByStateSource(stationId)) {
+        for (const QVariant& row : m_stateSource->store().rows(StationStateStore::PointMachines)) {
+            points.append(QVariant::fromValue(PointMachineInfo::fromVariant(row)));
         }
-    } else {
-        qWarning() << "❌ SAFETY CRITICAL: Point machine query failed:" << pointQuery.lastError().text();
+        return points;
     }
 
+    const QList<PointMachineInfo> rows = queryPointMachines(stationId);
+    points.reserve(rows.size());
+    for (const PointMachineInfo& pm : rows) {
+        points.append(QVariant::fromValue(pm));
+    }
     return points;
 }
 
-QVariantList DatabaseManager::getTextLabelsList() {
-    if (!connected) return QVariantList();
+namespace {
 
-    qDebug() << "🔍 SAFETY: getTextLabelsList() - DIRECT DATABASE QUERY";
+template <typename Info>
+QVariantList infoList(const QList<Info>& rows)
+{
+    QVariantList list;
+    list.reserve(rows.size());
+    for (const Info& row : rows) {
+        list.append(QVariant::fromValue(row));
+    }
+    return list;
+}
 
-    QVariantList labels;
-    QSqlQuery labelQuery(db);
-    QString labelSql = "SELECT label_text, position_row, position_col, font_size, color, font_family, is_visible, label_type FROM railway_control.text_labels ORDER BY id";
+} // namespace
+
+QVariantMap DatabaseManager::getStationSnapshot(const QString& stationId) {
+    QVariantMap snapshot;
+    if (servedByStateSource(stationId)) {
+        // The broker store is already one consistent state
+        snapshot["tracks"] = getTrackSegmentInfos(stationId);
+        snapshot["signals"] = getSignalInfos(stationId);
+        snapshot["pointMachines"] = getPointMachineInfos(stationId);
+        snapshot["textLabels"] = getTextLabelsList(stationId);
+        return snapshot;
+    }
+    if (!connected) return snapshot;
+
+    // One pipelined REPEATABLE READ round trip: with the layout cached only the
+    // state columns travel and are merged into the cached rows, otherwise
+    // everything is read (the version is taken before the rows, so a
+    // concurrent edit only costs one more full read later)
+    const QString station = stationScope(stationId);
+    if (m_binaryReader.isOpen()) {
+        PgBinaryReader::StationRows rows;
+        LayoutCache* cache = layoutCache(station);
+        bool read = false;
+
+        if (layoutCached(station)) {
+            rows.tracks = cache->tracks;
+            rows.signalList = cache->signalList;
+            rows.points = cache->points;
+            rows.labels = cache->labels;
+            bool aligned = false;
+            if (m_binaryReader.queryStationStates(station, &rows, &aligned)) {
+                read = aligned;
+                if (aligned) {
+                    cache->tracks = rows.tracks;
+                    cache->signalList = rows.signalList;
+                    cache->points = rows.points;
+                }
+            } else {
+                disableBinaryReader("station state snapshot");
+            }
+        }
 
-    if (labelQuery.exec(labelSql)) {
-        while (labelQuery.next()) {
-            QVariantMap label;
-            label["text"] = labelQuery.value("label_text").toString();
-            label["row"] = labelQuery.value("position_row").toDouble();
+        if (!read && m_binaryReader.isOpen()) {
+            const qint64 version = layoutVersion(station);
+            read = m_binaryReader.queryStation(station, &rows);
+            if (read && cache && version >= 0) {
+                cache->tracks = rows.tracks;
+                cache->signalList = rows.signalList;
+                cache->points = rows.points;
+                cache->labels = rows.labels;
+                cache->tracksVersion = cache->signalsVersion = cache->pointsVersion = cache->labelsVersion = version;
+            } else if (!read) {
+                disableBinaryReader("station snapshot");
+            }
+        }
+
+        if (read) {
+            // Row is muted by default: skip the walk rather than discard each record
+            if (TraceBuffer::isCategoryEnabled(TraceCategory::Row)) {
+                for (int i = 0; i < rows.signalList.size(); ++i) {
+                    RF_TRACE(Row, SignalRow, rows.signalList[i].id, rows.aspectIds[i]);
+                }
+            }
+            RF_TRACE(Query, QueryTrackSegments, {}, rows.tracks.size());
+            RF_TRACE(Query, QueryAllSignals, {}, rows.signalList.size());
+            RF_TRACE(Query, QueryPointMachines, {}, rows.points.size());
+            RF_TRACE(Query, QueryTextLabels, {}, rows.labels.size());
+
+            snapshot["tracks"] = infoList(rows.tracks);
+            snapshot["signals"] = infoList(rows.signalList);
+            snapshot["pointMachines"] = infoList(rows.points);
+            snapshot["textLabels"] = rows.labels;
+            return snapshot;
+        }
+    }
+
+    // Same snapshot over QtSql (no binary reader): one round trip per table, and with
+    // the layout cached only state columns (labels come from the cache)
+    const bool inTransaction = db.transaction();
+    if (inTransaction) {
+        QSqlQuery isolation(db);
+        if (!isolation.exec("SET TRANSACTION ISOLATION LEVEL REPEATABLE READ READ ONLY")) {
+            qWarning() << "⚠️ Station snapshot isolation not applied:" << isolation.lastError().text();
+        }
+    } else {
+        qWarning() << "⚠️ Station snapshot without transaction:" << db.lastError().text();
+    }
+
+    snapshot["tracks"] = infoList(queryTrackSegments(stationId));
+    snapshot["signals"] = infoList(querySignals(stationId));
+    snapshot["pointMachines"] = infoList(queryPointMachines(stationId));
+    snapshot["textLabels"] = getTextLabelsList(stationId);
+
+    if (inTransaction) db.commit();
+    return snapshot;
+}
+
+QList<TrackSegmentInfo> DatabaseManager::queryTrackSegments(const QString& stationId) {
+    QList<TrackSegmentInfo> tracks;
+    if (!connected) return tracks;
+
+    // Layout unchanged since the last full read: only the state columns travel
+    const QString station = stationScope(stationId);
+    const qint64 version = layoutVersion(station);
+    LayoutCache* cache = layoutCache(station);
+    if (cache && version >= 0 && cache->tracksVersion == version) {
+        tracks = cache->tracks;
+        if (mergeTrackStates(station, &tracks)) {
+            cache->tracks = tracks;
+            RF_TRACE(Query, QueryTrackSegments, {}, tracks.size());
+            return tracks;
+        }
+        tracks.clear();
+    }
+
+    bool loaded = false;
+    if (m_binaryReader.isOpen()) {
+        loaded = m_binaryReader.queryTrackSegments(station, &tracks);
+        if (!loaded) {
+            disableBinaryReader("track");
+            tracks.clear();
+        }
+    }
+
+    if (!loaded) {
+        QSqlQuery trackQuery(db);
+        trackQuery.prepare("SELECT segment_id, segment_name, start_row, start_col, end_row, end_col, track_type, is_occupied, is_assigned, occupied_by, is_active FROM railway_control.track_segments WHERE station_id = ? ORDER BY segment_id");
+        trackQuery.addBindValue(station);
+
+        if (trackQuery.exec()) {
+            while (trackQuery.next()) {
+                tracks.append(convertTrackRow(trackQuery));
+            }
+            loaded = true;
+        } else {
+            qWarning() << "❌ SAFETY CRITICAL: Track query failed:" << trackQuery.lastError().text();
+        }
+    }
+
+    if (loaded && cache && version >= 0) {
+        cache->tracks = tracks;
+        cache->tracksVersion = version;
+    }
+
+    RF_TRACE(Query, QueryTrackSegments, {}, tracks.size());
+    return tracks;
+}
+
+QList<SignalInfo> DatabaseManager::querySignals(const QString& stationId) {
+    QList<SignalInfo> signalsList;
+    if (!connected) return signalsList;
+
+    const QString station = stationScope(stationId);
+    const qint64 version = layoutVersion(station);
+    LayoutCache* cache = layoutCache(station);
+    if (cache && version >= 0 && cache->signalsVersion == version) {
+        signalsList = cache->signalList;
+        if (mergeSignalStates(station, &signalsList)) {
+            cache->signalList = signalsList;
+            RF_TRACE(Query, QueryAllSignals, {}, signalsList.size());
+            return signalsList;
+        }
+        signalsList.clear();
+    }
+
+    bool loaded = false;
+    if (m_binaryReader.isOpen()) {
+        QList<qint64> aspectIds;
+        loaded = m_binaryReader.querySignals(station, &signalsList, &aspectIds);
+        if (loaded) {
+            // ✅ SAFETY: Trace every signal state from database
+            if (TraceBuffer::isCategoryEnabled(TraceCategory::Row)) {
+                for (int i = 0; i < signalsList.size(); ++i) {
+                    RF_TRACE(Row, SignalRow, signalsList[i].id, aspectIds[i]);
+                }
+            }
+        } else {
+            disableBinaryReader("signal");
+            signalsList.clear();
+        }
+    }
+
+    if (!loaded) {
+        QSqlQuery signalQuery(db);
+        QString signalSql = R"(
+            SELECT s.signal_id, s.signal_name, st.type_code as signal_type,
+                   s.location_row as row, s.location_col as col, s.direction,
+                   sa.aspect_code as current_aspect, s.calling_on_aspect, s.loop_aspect,
+                   s.loop_signal_configuration, s.aspect_count, s.possible_aspects,
+                   s.is_active, s.location_description as location, s.current_aspect_id,
+                   s.id as db_id, s.interlocked_with
+            FROM railway_control.signals s
+            JOIN railway_config.signal_types st ON s.signal_type_id = st.id
+            LEFT JOIN railway_config.signal_aspects sa ON s.current_aspect_id = sa.id
+            WHERE s.station_id = ?
+            ORDER BY s.signal_id
+        )";
+        signalQuery.prepare(signalSql);
+        signalQuery.addBindValue(station);
+
+        if (signalQuery.exec()) {
+            const bool traceRows = TraceBuffer::isCategoryEnabled(TraceCategory::Row);
+            while (signalQuery.next()) {
+                SignalInfo signal = convertSignalRow(signalQuery);
+
+                // ✅ SAFETY: Trace every signal state from database
+                if (traceRows) {
+                    RF_TRACE(Row, SignalRow, signal.id, signalQuery.value("current_aspect_id").toLongLong());
+                }
+
+                signalsList.append(std::move(signal));
+            }
+            loaded = true;
+        } else {
+            qWarning() << "❌ SAFETY CRITICAL: Signal query failed:" << signalQuery.lastError().text();
+        }
+    }
+
+    if (loaded && cache && version >= 0) {
+        cache->signalList = signalsList;
+        cache->signalsVersion = version;
+    }
+
+    RF_TRACE(Query, QueryAllSignals, {}, signalsList.size());
+    return signalsList;
+}
+
+QList<PointMachineInfo> DatabaseManager::queryPointMachines(const QString& stationId) {
+    QList<PointMachineInfo> points;
+    if (!connected) return points;
+
+    const QString station = stationScope(stationId);
+    const qint64 version = layoutVersion(station);
+    LayoutCache* cache = layoutCache(station);
+    if (cache && version >= 0 && cache->pointsVersion == version) {
+        points = cache->points;
+        if (mergePointMachineStates(station, &points)) {
+            cache->points = points;
+            RF_TRACE(Query, QueryPointMachines, {}, points.size());
+            return points;
+        }
+        points.clear();
+    }
+
+    bool loaded = false;
+    if (m_binaryReader.isOpen()) {
+        loaded = m_binaryReader.queryPointMachines(station, &points);
+        if (!loaded) {
+            disableBinaryReader("point machine");
+            points.clear();
+        }
+    }
+
+    if (!loaded) {
+        QSqlQuery pointQuery(db);
+        QString pointSql = R"(
+            SELECT pm.machine_id, pm.machine_name, pm.junction_row, pm.junction_col,
+                   pm.root_track_connection, pm.normal_track_connection, pm.reverse_track_connection,
+                   pp.position_code as position, pm.operating_status, pm.transition_time_ms,
+                   pm.id as db_id, pm.safety_interlocks, pm.is_locked, pm.lock_reason
+            FROM railway_control.point_machines pm
+            LEFT JOIN railway_config.point_positions pp ON pm.current_position_id = pp.id
+            WHERE pm.station_id = ?
+            ORDER BY pm.machine_id
+        )";
+        pointQuery.prepare(pointSql);
+        pointQuery.addBindValue(station);
+
+        if (pointQuery.exec()) {
+            while (pointQuery.next()) {
+                points.append(convertPointMachineRow(pointQuery));
+            }
+            loaded = true;
+        } else {
+            qWarning() << "❌ SAFETY CRITICAL: Point machine query failed:" << pointQuery.lastError().text();
+        }
+    }
+
+    if (loaded && cache && version >= 0) {
+        cache->points = points;
+        cache->pointsVersion = version;
+    }
+
+    RF_TRACE(Query, QueryPointMachines, {}, points.size());
+    return points;
+}
+
+QVariantList DatabaseManager::getTextLabelsList(const QString& stationId) {
+    if (servedByStateSource(stationId)) return m_stateSource->store().textLabels();
+    if (!connected) return QVariantList();
+
+    // Labels are pure layout: at an unchanged version nothing is read at all
+    const QString station = stationScope(stationId);
+    const qint64 version = layoutVersion(station);
+    LayoutCache* cache = layoutCache(station);
+    if (cache && version >= 0 && cache->labelsVersion == version) {
+        RF_TRACE(Query, QueryTextLabels, {}, cache->labels.size());
+        return cache->labels;
+    }
+
+    QVariantList labels;
+    QSqlQuery labelQuery(db);
+    labelQuery.prepare("SELECT id, label_text, position_row, position_col, font_size, color, font_family, is_visible, label_type FROM railway_control.text_labels WHERE station_id = ? ORDER BY id");
+    labelQuery.addBindValue(station);
+
+    if (labelQuery.exec()) {
+        while (labelQuery.next()) {
+            QVariantMap label;
+            label["id"] = labelQuery.value("id").toString();
+            label["text"] = labelQuery.value("label_text").toString();
+            label["row"] = labelQuery.value("position_row").toDouble();
             label["col"] = labelQuery.value("position_col").toDouble();
             label["fontSize"] = labelQuery.value("font_size").toInt();
             label["color"] = labelQuery.value("color").toString();
@@ -491,13 +1212,347 @@ QVariantList DatabaseManager::getTextLabelsList() {
             label["type"] = labelQuery.value("label_type").toString();
             labels.append(label);
         }
+        if (cache && version >= 0) {
+            cache->labels = labels;
+            cache->labelsVersion = version;
+        }
     } else {
         qWarning() << "❌ SAFETY CRITICAL: Text label query failed:" << labelQuery.lastError().text();
     }
 
+    RF_TRACE(Query, QueryTextLabels, {}, labels.size());
     return labels;
 }
 
+// ===== Layout cache =====
+qint64 DatabaseManager::layoutVersion(const QString& stationId) {
+    auto it = m_stations.find(stationId);
+    if (it == m_stations.end()) return -1;
+    if (it->subscribed && it->layoutVersion >= 0) return it->layoutVersion;
+
+    // Not announced yet (or not listening): one status row
+    QSqlQuery query(db);
+    query.prepare("SELECT layout_version FROM railway_control.station_status WHERE station_id = ?");
+    query.addBindValue(stationId);
+    if (!query.exec()) {
+        qWarning() << "⚠️ Layout version unreadable, geometry not cached:" << query.lastError().text();
+        return -1;
+    }
+    // No status row yet: the station has no elements (the first insert creates it)
+    const qint64 version = query.next() ? query.value(0).toLongLong() : 0;
+    if (it->subscribed) it->layoutVersion = version;
+    return version;
+}
+
+DatabaseManager::LayoutCache* DatabaseManager::layoutCache(const QString& stationId) {
+    auto it = m_stations.find(stationId);
+    return it == m_stations.end() ? nullptr : &it->layout;
+}
+
+bool DatabaseManager::layoutCached(const QString& stationId) {
+    const qint64 version = layoutVersion(stationId);
+    const LayoutCache* cache = layoutCache(stationId);
+    return cache && version >= 0 && cache->tracksVersion == version && cache->signalsVersion == version
+        && cache->pointsVersion == version && cache->labelsVersion == version;
+}
+
+void DatabaseManager::handleLayoutChange(const QString& stationId, qint64 version) {
+    auto it = m_stations.find(stationId);
+    if (it == m_stations.end()) return;
+    it->layoutVersion = it->subscribed ? version : -1;
+
+    qDebug() << "📐 Layout of station" << stationId << "changed (version" << version << ")";
+    if (stationId != m_activeStation) {
+        emit stationDataChanged(stationId, QStringLiteral("layout"), QString());
+        return;
+    }
+
+    emit layoutChanged();
+    emit trackSegmentsChanged();
+    emit signalsChanged();
+    emit pointMachinesChanged();
+    emit textLabelsChanged();
+}
+
+bool DatabaseManager::mergeTrackStates(const QString& stationId, QList<TrackSegmentInfo>* tracks) {
+    QSqlQuery query(db);
+    query.prepare("SELECT segment_id, is_occupied, is_assigned, occupied_by, is_active FROM railway_control.track_segments WHERE station_id = ? ORDER BY segment_id");
+    query.addBindValue(stationId);
+    if (!query.exec()) {
+        qWarning() << "❌ SAFETY CRITICAL: Track state query failed:" << query.lastError().text();
+        return false;
+    }
+
+    // Same version, so the same rows in the same order
+    int index = 0;
+    while (query.next()) {
+        if (index >= tracks->size() || (*tracks)[index].id != query.value(0).toString()) return false;
+        TrackSegmentInfo& track = (*tracks)[index++];
+        track.occupied = query.value(1).toBool();
+        track.assigned = query.value(2).toBool();
+        track.occupiedBy = query.value(3).toString();
+        track.isActive = query.value(4).toBool();
+    }
+    return index == tracks->size();
+}
+
+bool DatabaseManager::mergeSignalStates(const QString& stationId, QList<SignalInfo>* signalList) {
+    QSqlQuery query(db);
+    query.prepare(R"(
+        SELECT s.signal_id, sa.aspect_code, s.calling_on_aspect, s.loop_aspect, s.is_active, s.current_aspect_id
+        FROM railway_control.signals s
+        LEFT JOIN railway_config.signal_aspects sa ON s.current_aspect_id = sa.id
+        WHERE s.station_id = ?
+        ORDER BY s.signal_id
+    )");
+    query.addBindValue(stationId);
+    if (!query.exec()) {
+        qWarning() << "❌ SAFETY CRITICAL: Signal state query failed:" << query.lastError().text();
+        return false;
+    }
+
+    const bool traceRows = TraceBuffer::isCategoryEnabled(TraceCategory::Row);
+    int index = 0;
+    while (query.next()) {
+        if (index >= signalList->size() || (*signalList)[index].id != query.value(0).toString()) return false;
+        SignalInfo& signal = (*signalList)[index++];
+        signal.aspect = SignalInfo::aspectFromCode(query.value(1).toString());
+        signal.callingOn = SignalInfo::aspectFromCode(query.value(2).toString());
+        signal.loop = SignalInfo::aspectFromCode(query.value(3).toString());
+        signal.isActive = query.value(4).toBool();
+
+        // ✅ SAFETY: Trace every signal state from database
+        if (traceRows) {
+            RF_TRACE(Row, SignalRow, signal.id, query.value(5).toLongLong());
+        }
+    }
+    return index == signalList->size();
+}
+
+bool DatabaseManager::mergePointMachineStates(const QString& stationId, QList<PointMachineInfo>* points) {
+    QSqlQuery query(db);
+    query.prepare(R"(
+        SELECT pm.machine_id, pp.position_code, pm.operating_status, pm.is_locked, pm.lock_reason
+        FROM railway_control.point_machines pm
+        LEFT JOIN railway_config.point_positions pp ON pm.current_position_id = pp.id
+        WHERE pm.station_id = ?
+        ORDER BY pm.machine_id
+    )");
+    query.addBindValue(stationId);
+    if (!query.exec()) {
+        qWarning() << "❌ SAFETY CRITICAL: Point machine state query failed:" << query.lastError().text();
+        return false;
+    }
+
+    int index = 0;
+    while (query.next()) {
+        if (index >= points->size() || (*points)[index].id != query.value(0).toString()) return false;
+        PointMachineInfo& pm = (*points)[index++];
+        pm.pointPosition = PointMachineInfo::positionFromCode(query.value(1).toString());
+        pm.status = PointMachineInfo::statusFromCode(query.value(2).toString());
+        pm.isLocked = query.value(3).toBool();
+        pm.lockReason = query.value(4).toString();
+    }
+    return index == points->size();
+}
+
+QVariantList DatabaseManager::getElementsInRegion(double minRow, double minCol, double maxRow, double maxCol) {
+    if (!connected) return QVariantList();
+
+    QVariantList elements;
+    QSqlQuery query(db);
+    query.prepare("SELECT element_type, element_id FROM railway_control.elements_in_box(?, ?, ?, ?, ?)");
+    query.addBindValue(minRow);
+    query.addBindValue(minCol);
+    query.addBindValue(maxRow);
+    query.addBindValue(maxCol);
+    query.addBindValue(m_activeStation);
+
+    if (query.exec()) {
+        while (query.next()) {
+            QVariantMap element;
+            element["type"] = query.value(0).toString();
+            element["id"] = query.value(1).toString();
+            elements.append(element);
+        }
+    } else {
+        qWarning() << "❌ Region query failed:" << query.lastError().text();
+    }
+
+    return elements;
+}
+
+QVariantMap DatabaseManager::getSystemStatus(const QString& stationId) {
+    const QString station = stationScope(stationId);
+    if (servedByStateSource(station)) return m_stateSource->store().counters().toVariantMap();
+    if (station == m_activeStation && !m_systemStatus.isEmpty()) return m_systemStatus;
+    return querySystemStatus(station);
+}
+
+QVariantMap DatabaseManager::querySystemStatus(const QString& stationId) {
+    if (!connected) return QVariantMap();
+
+    // One counter row: the cost does not grow with the station
+    QSqlQuery query(db);
+    query.prepare("SELECT railway_control.get_system_status(?)");
+    query.addBindValue(stationId);
+    if (!query.exec() || !query.next()) {
+        qWarning() << "❌ System status query failed:" << query.lastError().text();
+        return QVariantMap();
+    }
+    QVariantMap status = QJsonDocument::fromJson(query.value(0).toString().toUtf8()).object().toVariantMap();
+    status.remove("timestamp");
+    return status;
+}
+
+void DatabaseManager::refreshSystemStatus() {
+    if (m_stateSource) {
+        setSystemStatus(m_stateSource->store().counters().toVariantMap());
+    } else if (connected) {
+        setSystemStatus(querySystemStatus(m_activeStation));
+    }
+}
+
+void DatabaseManager::setSystemStatus(const QVariantMap& status) {
+    if (status == m_systemStatus) return;
+    m_systemStatus = status;
+    emit systemStatusChanged();
+}
+
+// ===== Stations =====
+QStringList DatabaseManager::openStations() const {
+    QStringList stations = m_stations.keys();
+    stations.sort();
+    return stations;
+}
+
+bool DatabaseManager::stationExists(const QString& stationId) {
+    // Station IDs become channel names: keep them to plain identifiers
+    static const QRegularExpression validId(QStringLiteral("^[A-Za-z0-9_]{1,20}$"));
+    if (!validId.match(stationId).hasMatch()) return false;
+    if (!connected) return false;
+
+    QSqlQuery query(db);
+    query.prepare("SELECT 1 FROM railway_config.stations WHERE station_id = ?");
+    query.addBindValue(stationId);
+    return query.exec() && query.next();
+}
+
+void DatabaseManager::setActiveStation(const QString& stationId) {
+    if (stationId == m_activeStation) return;
+    if (m_stateSource) {
+        qWarning() << "❌ Station is chosen by the state broker:" << m_activeStation;
+        return;
+    }
+    if (!stationExists(stationId)) {
+        qWarning() << "❌ Unknown station:" << stationId;
+        return;
+    }
+
+    // The previous station lingers (subscribed) until the idle sweep drops it
+    auto previous = m_stations.find(m_activeStation);
+    if (previous != m_stations.end() && !previous->pinned) {
+        previous->idleSinceMs = m_stationClock.elapsed();
+    }
+
+    const bool added = !m_stations.contains(stationId);
+    m_activeStation = stationId;
+    m_stations[stationId].idleSinceMs = -1;
+    subscribeStation(stationId);
+    refreshSystemStatus();
+
+    lastSignalStates.clear();
+    lastTrackStates.clear();
+    lastPointStates.clear();
+
+    qDebug() << "🚉 Active station:" << stationId;
+    emit activeStationChanged();
+    if (added) emit openStationsChanged();
+    emit trackSegmentsChanged();
+    emit signalsChanged();
+    emit pointMachinesChanged();
+    emit textLabelsChanged();
+}
+
+bool DatabaseManager::openStation(const QString& stationId) {
+    if (!stationExists(stationId)) {
+        qWarning() << "❌ Cannot open unknown station:" << stationId;
+        return false;
+    }
+
+    const bool added = !m_stations.contains(stationId);
+    StationSubscription& station = m_stations[stationId];
+    station.pinned = true;
+    station.idleSinceMs = -1;
+    subscribeStation(stationId);
+
+    if (added) emit openStationsChanged();
+    return true;
+}
+
+void DatabaseManager::closeStation(const QString& stationId) {
+    auto it = m_stations.find(stationId);
+    if (it == m_stations.end() || !it->pinned) return;
+
+    it->pinned = false;
+    if (stationId != m_activeStation) {
+        it->idleSinceMs = m_stationClock.elapsed();
+    }
+}
+
+void DatabaseManager::sweepIdleStations() {
+    const qint64 now = m_stationClock.elapsed();
+    QStringList unloaded;
+    for (auto it = m_stations.cbegin(); it != m_stations.cend(); ++it) {
+        if (it.key() != m_activeStation && !it->pinned && it->idleSinceMs >= 0
+            && now - it->idleSinceMs >= STATION_IDLE_UNLOAD_MS) {
+            unloaded.append(it.key());
+        }
+    }
+
+    for (const QString& stationId : unloaded) {
+        unsubscribeStation(stationId);
+        m_stations.remove(stationId);
+        qDebug() << "💤 Unloaded idle station:" << stationId;
+        emit stationUnloaded(stationId);
+    }
+    if (!unloaded.isEmpty()) emit openStationsChanged();
+}
+
+QVariantList DatabaseManager::getStationsList() {
+    if (!connected) return QVariantList();
+
+    QVariantList stations;
+    QSqlQuery query(db);
+    QString stationSql = R"(
+        SELECT st.station_id, st.station_name, st.is_active,
+               (SELECT COUNT(*) FROM railway_control.track_segments ts WHERE ts.station_id = st.station_id) AS track_count,
+               (SELECT COUNT(*) FROM railway_control.signals s WHERE s.station_id = st.station_id) AS signal_count,
+               (SELECT COUNT(*) FROM railway_control.point_machines pm WHERE pm.station_id = st.station_id) AS point_count
+        FROM railway_config.stations st
+        ORDER BY st.station_id
+    )";
+
+    if (query.exec(stationSql)) {
+        while (query.next()) {
+            QVariantMap station;
+            const QString stationId = query.value("station_id").toString();
+            station["id"] = stationId;
+            station["name"] = query.value("station_name").toString();
+            station["isActive"] = query.value("is_active").toBool();
+            station["trackCount"] = query.value("track_count").toInt();
+            station["signalCount"] = query.value("signal_count").toInt();
+            station["pointCount"] = query.value("point_count").toInt();
+            station["isOpen"] = m_stations.contains(stationId);
+            stations.append(station);
+        }
+    } else {
+        qWarning() << "❌ Station query failed:" << query.lastError().text();
+    }
+
+    return stations;
+}
+
 QVariantList DatabaseManager::getOuterSignalsList() {
     QVariantList result;
     QVariantList allSignals = getAllSignalsList();  // This is fine
@@ -556,9 +1611,58 @@ QVariantList DatabaseManager::getAdvanceStarterSignalsList() {
 
 // ✅ SAFETY: Individual object queries - DIRECT DATABASE
 QVariantMap DatabaseManager::getSignalById(const QString& signalId) {
-    if (!connected) return QVariantMap();
+    if (servedByStateSource()) return m_stateSource->store().row(StationStateStore::Signals, signalId);
+
+    SignalInfo signal;
+    return querySignalById(signalId, &signal) ? signal.toVariantMap() : QVariantMap();
+}
+
+QVariantMap DatabaseManager::getTrackSegmentById(const QString& segmentId) {
+    if (servedByStateSource()) return m_stateSource->store().row(StationStateStore::TrackSegments, segmentId);
+
+    TrackSegmentInfo track;
+    return queryTrackSegmentById(segmentId, &track) ? track.toVariantMap() : QVariantMap();
+}
+
+QVariantMap DatabaseManager::getPointMachineById(const QString& machineId) {
+    if (servedByStateSource()) return m_stateSource->store().row(StationStateStore::PointMachines, machineId);
+
+    PointMachineInfo pm;
+    return queryPointMachineById(machineId, &pm) ? pm.toVariantMap() : QVariantMap();
+}
+
+SignalInfo DatabaseManager::getSignalInfo(const QString& signalId) {
+    if (servedByStateSource()) {
+        return SignalInfo::fromVariant(m_stateSource->store().row(StationStateStore::Signals, signalId));
+    }
+
+    SignalInfo signal;
+    querySignalById(signalId, &signal);
+    return signal;
+}
 
-    qDebug() << "🔍 SAFETY: getSignalById(" << signalId << ") - DIRECT DATABASE QUERY";
+TrackSegmentInfo DatabaseManager::getTrackSegmentInfo(const QString& segmentId) {
+    if (servedByStateSource()) {
+        return TrackSegmentInfo::fromVariant(m_stateSource->store().row(StationStateStore::TrackSegments, segmentId));
+    }
+
+    TrackSegmentInfo track;
+    queryTrackSegmentById(segmentId, &track);
+    return track;
+}
+
+PointMachineInfo DatabaseManager::getPointMachineInfo(const QString& machineId) {
+    if (servedByStateSource()) {
+        return PointMachineInfo::fromVariant(m_stateSource->store().row(StationStateStore::PointMachines, machineId));
+    }
+
+    PointMachineInfo pm;
+    queryPointMachineById(machineId, &pm);
+    return pm;
+}
+
+bool DatabaseManager::querySignalById(const QString& signalId, SignalInfo* signal) {
+    if (!connected) return false;
 
     QSqlQuery query(db);
     query.prepare(R"(
@@ -566,7 +1670,8 @@ QVariantMap DatabaseManager::getSignalById(const QString& signalId) {
                s.location_row as row, s.location_col as col, s.direction,
                sa.aspect_code as current_aspect, s.calling_on_aspect, s.loop_aspect,
                s.loop_signal_configuration, s.aspect_count, s.possible_aspects,
-               s.is_active, s.location_description as location
+               s.is_active, s.location_description as location,
+               s.id as db_id, s.interlocked_with
         FROM railway_control.signals s
         JOIN railway_config.signal_types st ON s.signal_type_id = st.id
         LEFT JOIN railway_config.signal_aspects sa ON s.current_aspect_id = sa.id
@@ -575,17 +1680,18 @@ QVariantMap DatabaseManager::getSignalById(const QString& signalId) {
     query.addBindValue(signalId);
 
     if (query.exec() && query.next()) {
-        return convertSignalRowToVariant(query);
+        RF_TRACE(Query, QuerySignalById, signalId, 1);
+        *signal = convertSignalRow(query);
+        return true;
     }
 
+    RF_TRACE(Query, QuerySignalById, signalId, 0);
     qWarning() << "❌ SAFETY: Signal" << signalId << "not found in database";
-    return QVariantMap();
+    return false;
 }
 
-QVariantMap DatabaseManager::getTrackSegmentById(const QString& segmentId) {
-    if (!connected) return QVariantMap();
-
-    qDebug() << "🔍 SAFETY: getTrackSegmentById(" << segmentId << ") - DIRECT DATABASE QUERY";
+bool DatabaseManager::queryTrackSegmentById(const QString& segmentId, TrackSegmentInfo* track) {
+    if (!connected) return false;
 
     QSqlQuery query(db);
     query.prepare(R"(
@@ -597,23 +1703,25 @@ QVariantMap DatabaseManager::getTrackSegmentById(const QString& segmentId) {
     query.addBindValue(segmentId);
 
     if (query.exec() && query.next()) {
-        return convertTrackRowToVariant(query);
+        RF_TRACE(Query, QueryTrackById, segmentId, 1);
+        *track = convertTrackRow(query);
+        return true;
     }
 
+    RF_TRACE(Query, QueryTrackById, segmentId, 0);
     qWarning() << "❌ SAFETY: Track segment" << segmentId << "not found in database";
-    return QVariantMap();
+    return false;
 }
 
-QVariantMap DatabaseManager::getPointMachineById(const QString& machineId) {
-    if (!connected) return QVariantMap();
-
-    qDebug() << "🔍 SAFETY: getPointMachineById(" << machineId << ") - DIRECT DATABASE QUERY";
+bool DatabaseManager::queryPointMachineById(const QString& machineId, PointMachineInfo* pm) {
+    if (!connected) return false;
 
     QSqlQuery query(db);
     query.prepare(R"(
         SELECT pm.machine_id, pm.machine_name, pm.junction_row, pm.junction_col,
                pm.root_track_connection, pm.normal_track_connection, pm.reverse_track_connection,
-               pp.position_code as position, pm.operating_status, pm.transition_time_ms
+               pp.position_code as position, pm.operating_status, pm.transition_time_ms,
+               pm.id as db_id, pm.safety_interlocks, pm.is_locked, pm.lock_reason
         FROM railway_control.point_machines pm
         LEFT JOIN railway_config.point_positions pp ON pm.current_position_id = pp.id
         WHERE pm.machine_id = ?
@@ -621,11 +1729,14 @@ QVariantMap DatabaseManager::getPointMachineById(const QString& machineId) {
     query.addBindValue(machineId);
 
     if (query.exec() && query.next()) {
-        return convertPointMachineRowToVariant(query);
+        RF_TRACE(Query, QueryPointById, machineId, 1);
+        *pm = convertPointMachineRow(query);
+        return true;
     }
 
+    RF_TRACE(Query, QueryPointById, machineId, 0);
     qWarning() << "❌ SAFETY: Point machine" << machineId << "not found in database";
-    return QVariantMap();
+    return false;
 }
 
 // ✅ SAFETY: Update operations - NO CACHE INVALIDATION
@@ -634,35 +1745,29 @@ bool DatabaseManager::updateSignalAspect(const QString& signalId, const QString&
 
     qDebug() << "🔄 SAFETY: Updating signal:" << signalId << "to aspect:" << newAspect;
 
-    QSqlQuery query(db);
-    query.prepare("SELECT railway_control.update_signal_aspect(?, ?, 'HMI_USER')");
-    query.addBindValue(signalId);
-    query.addBindValue(newAspect);
-
-    if (query.exec() && query.next()) {
-        bool success = query.value(0).toBool();
-        qDebug() << "✅ SAFETY: Database function returned:" << success;
-
-        if (success) {
-            // ✅ SAFETY: Verify the change actually happened
-            QSqlQuery verifyQuery(db);
-            verifyQuery.prepare("SELECT current_aspect_id FROM railway_control.signals WHERE signal_id = ?");
-            verifyQuery.addBindValue(signalId);
-            if (verifyQuery.exec() && verifyQuery.next()) {
-                int currentAspectId = verifyQuery.value(0).toInt();
-                qDebug() << "🔍 SAFETY: Signal" << signalId << "now has aspect_id:" << currentAspectId;
-            }
+    QString reason;
+    if (m_interlocking && newAspect != "RED" && !m_interlocking->canClearSignal(signalId, &reason)) {
+        qWarning() << "🔒 INTERLOCKING: Signal" << signalId << "cannot clear:" << reason;
+        emit errorOccurred(QString("Signal %1 cannot clear: %2").arg(signalId, reason));
+        return false;
+    }
 
-            // ✅ SAFETY: No cache invalidation - just emit signals
-            emit signalUpdated(signalId);
-            emit signalsChanged();
+    return executeTracedUpdate("SIGNAL_ASPECT", signalId,
+                               "railway_control.update_signal_aspect(?, ?, 'HMI_USER')",
+                               {signalId, newAspect}, [this, signalId]() {
+        // ✅ SAFETY: Verify the change actually happened
+        QSqlQuery verifyQuery(db);
+        verifyQuery.prepare("SELECT current_aspect_id FROM railway_control.signals WHERE signal_id = ?");
+        verifyQuery.addBindValue(signalId);
+        if (verifyQuery.exec() && verifyQuery.next()) {
+            int currentAspectId = verifyQuery.value(0).toInt();
+            qDebug() << "🔍 SAFETY: Signal" << signalId << "now has aspect_id:" << currentAspectId;
         }
-        return success;
-    } else {
-        qDebug() << "❌ SAFETY CRITICAL: Database query failed:" << query.lastError().text();
-    }
 
-    return false;
+        // ✅ SAFETY: No cache invalidation - just emit signals
+        emit signalUpdated(signalId);
+        emit signalsChanged();
+    });
 }
 
 bool DatabaseManager::updatePointMachinePosition(const QString& machineId, const QString& newPosition) {
@@ -670,47 +1775,163 @@ bool DatabaseManager::updatePointMachinePosition(const QString& machineId, const
 
     qDebug() << "🔄 SAFETY: Updating point machine:" << machineId << "to position:" << newPosition;
 
+    QString reason;
+    if (m_interlocking && !m_interlocking->canThrowPoint(machineId, &reason)) {
+        qWarning() << "🔒 INTERLOCKING: Point machine" << machineId << "cannot move:" << reason;
+        emit errorOccurred(QString("Point machine %1 cannot move: %2").arg(machineId, reason));
+        return false;
+    }
+
+    return executeTracedUpdate("POINT_POSITION", machineId,
+                               "railway_control.update_point_position(?, ?, 'HMI_USER')",
+                               {machineId, newPosition}, [this, machineId]() {
+        // ✅ SAFETY: No cache invalidation - just emit signals
+        emit pointMachineUpdated(machineId);
+        emit pointMachinesChanged();
+    });
+}
+
+int DatabaseManager::beginPointTransition(const QString& machineId) {
+    if (!connected) return -1;
+
+    qDebug() << "🔄 SAFETY: Starting point machine transition:" << machineId;
+
+    QString reason;
+    if (m_interlocking && !m_interlocking->canThrowPoint(machineId, &reason)) {
+        qWarning() << "🔒 INTERLOCKING: Point machine" << machineId << "cannot move:" << reason;
+        emit errorOccurred(QString("Point machine %1 cannot move: %2").arg(machineId, reason));
+        return -1;
+    }
+
+    QVariant transitionTime;
+    const bool started = executeTracedUpdate("POINT_TRANSITION", machineId,
+                                             "railway_control.begin_point_transition(?, 'HMI_USER')",
+                                             {machineId}, [this, machineId]() {
+        emit pointMachineUpdated(machineId);
+        emit pointMachinesChanged();
+    }, &transitionTime);
+
+    if (!started) {
+        qWarning() << "⏳ Point machine" << machineId << "is not CONNECTED - transition refused";
+        return -1;
+    }
+    return transitionTime.toInt();
+}
+
+bool DatabaseManager::completePointTransitions(const QStringList& machineIds, const QStringList& positions) {
+    if (!connected || machineIds.isEmpty()) return false;
+
     QSqlQuery query(db);
-    query.prepare("SELECT railway_control.update_point_position(?, ?, 'HMI_USER')");
-    query.addBindValue(machineId);
-    query.addBindValue(newPosition);
+    query.prepare("SELECT railway_control.complete_point_transitions(?::varchar[], ?::varchar[], 'SIMULATOR')");
+    query.addBindValue(toPostgresTextArray(machineIds));
+    query.addBindValue(toPostgresTextArray(positions));
 
-    if (query.exec() && query.next()) {
-        bool success = query.value(0).toBool();
-        if (success) {
-            // ✅ SAFETY: No cache invalidation - just emit signals
-            emit pointMachineUpdated(machineId);
-            emit pointMachinesChanged();
-        }
-        return success;
+    if (!query.exec() || !query.next()) {
+        qWarning() << "❌ SAFETY CRITICAL: completing" << machineIds.size() << "point transitions failed:"
+                   << query.lastError().text();
+        return false;
     }
 
-    qWarning() << "❌ SAFETY CRITICAL: Point machine update failed:" << query.lastError().text();
-    return false;
+    for (const QString& machineId : machineIds) {
+        emit pointMachineUpdated(machineId);
+    }
+    emit pointMachinesChanged();
+    return true;
 }
 
-bool DatabaseManager::updateTrackOccupancy(const QString& segmentId, bool isOccupied) {
+bool DatabaseManager::reconcilePointTransitions(QStringList* machineIds, int graceMs) {
     if (!connected) return false;
 
-    qDebug() << "🔄 SAFETY: Updating track occupancy:" << segmentId << "to" << isOccupied;
+    QSqlQuery query(db);
+    query.prepare("SELECT railway_control.reconcile_point_transitions(?, 'SIMULATOR')");
+    query.addBindValue(graceMs);
+
+    if (!query.exec()) {
+        qWarning() << "❌ SAFETY CRITICAL: reconciling stale point transitions failed:" << query.lastError().text();
+        return false;
+    }
+
+    bool reconciled = false;
+    while (query.next()) {
+        const QString machineId = query.value(0).toString();
+        qWarning() << "⚠️ Point machine" << machineId << "was left IN_TRANSITION - reconnected at its recorded position";
+        emit pointMachineUpdated(machineId);
+        if (machineIds) machineIds->append(machineId);
+        reconciled = true;
+    }
+    if (reconciled) {
+        emit pointMachinesChanged();
+    }
+    return true;
+}
+
+bool DatabaseManager::applyFieldInputs(const QStringList& segmentIds, const QList<bool>& occupied,
+                                       const QStringList& machineIds, const QStringList& positions) {
+    if (!connected) return false;
+    if (segmentIds.isEmpty() && machineIds.isEmpty()) return true;
 
+    // Only rows that actually changed come back, with their new state
     QSqlQuery query(db);
-    query.prepare("SELECT railway_control.update_track_occupancy(?, ?, NULL, 'HMI_USER')");
-    query.addBindValue(segmentId);
-    query.addBindValue(isOccupied);
+    query.prepare(R"(
+        SELECT 'track_segments', segment_id, is_occupied, NULL::varchar, NULL::varchar
+        FROM railway_control.apply_track_circuits(?::varchar[], ?::boolean[], 'FIELD')
+        UNION ALL
+        SELECT 'point_machines', machine_id, is_locked, position_code, operating_status
+        FROM railway_control.apply_point_detections(?::varchar[], ?::varchar[], 'FIELD')
+    )");
+    query.addBindValue(toPostgresTextArray(segmentIds));
+    query.addBindValue(toPostgresBoolArray(occupied));
+    query.addBindValue(toPostgresTextArray(machineIds));
+    query.addBindValue(toPostgresTextArray(positions));
+
+    if (!query.exec()) {
+        qWarning() << "❌ SAFETY CRITICAL: applying" << segmentIds.size() << "track circuit and"
+                   << machineIds.size() << "point detection inputs failed:" << query.lastError().text();
+        return false;
+    }
 
-    if (query.exec() && query.next()) {
-        bool success = query.value(0).toBool();
-        if (success) {
-            // ✅ SAFETY: No cache invalidation - just emit signals
-            emit trackSegmentUpdated(segmentId);
-            emit trackSegmentsChanged();
+    QVariantList tracks;
+    QVariantList pointMachines;
+    while (query.next()) {
+        const QString table = query.value(0).toString();
+        const QString id = query.value(1).toString();
+        if (table == QLatin1String("track_segments")) {
+            tracks.append(QVariantMap{{"id", id}, {"occupied", query.value(2).toBool()}});
+        } else {
+            pointMachines.append(QVariantMap{{"id", id}, {"position", query.value(3).toString()},
+                                             {"operatingStatus", query.value(4).toString()},
+                                             {"isLocked", query.value(2).toBool()}});
         }
-        return success;
+        // Each changed row also fires one notification back to this session
+        ++m_fieldInputEchoes[table + QLatin1Char('/') + id];
     }
+    if (tracks.isEmpty() && pointMachines.isEmpty()) return true;
 
-    qWarning() << "❌ SAFETY CRITICAL: Track occupancy update failed:" << query.lastError().text();
-    return false;
+    emit fieldInputsApplied(tracks, pointMachines);
+    if (!tracks.isEmpty()) emit trackSegmentsChanged();
+    if (!pointMachines.isEmpty()) emit pointMachinesChanged();
+    return true;
+}
+
+bool DatabaseManager::consumeFieldInputEcho(const QString& table, const QString& entityId) {
+    const auto it = m_fieldInputEchoes.find(table + QLatin1Char('/') + entityId);
+    if (it == m_fieldInputEchoes.end()) return false;
+    if (--it.value() == 0) m_fieldInputEchoes.erase(it);
+    return true;
+}
+
+bool DatabaseManager::updateTrackOccupancy(const QString& segmentId, bool isOccupied) {
+    if (!connected) return false;
+
+    // No qDebug: the train simulator comes through here on every step. The
+    // result is recorded by RF_TRACE(Update, UpdateResult) in executeTracedUpdate.
+    return executeTracedUpdate("TRACK_OCCUPANCY", segmentId,
+                               "railway_control.update_track_occupancy(?, ?, NULL, 'HMI_USER')",
+                               {segmentId, isOccupied}, [this, segmentId]() {
+        // ✅ SAFETY: No cache invalidation - just emit signals
+        emit trackSegmentUpdated(segmentId);
+        emit trackSegmentsChanged();
+    });
 }
 
 bool DatabaseManager::updateTrackAssignment(const QString& segmentId, bool isAssigned) {
@@ -718,84 +1939,119 @@ bool DatabaseManager::updateTrackAssignment(const QString& segmentId, bool isAss
 
     qDebug() << "🔄 SAFETY: Updating track assignment:" << segmentId << "to" << isAssigned;
 
+    return executeTracedUpdate("TRACK_ASSIGNMENT", segmentId,
+                               "railway_control.update_track_assignment(?, ?, 'HMI_USER')",
+                               {segmentId, isAssigned}, [this, segmentId]() {
+        // ✅ SAFETY: No cache invalidation - just emit signals
+        emit trackSegmentUpdated(segmentId);
+        emit trackSegmentsChanged();
+    });
+}
+
+// Runs one of the railway_control.update_* functions. The command ID travels in
+// a transaction-local setting (evaluated in FROM, i.e. before the call) so the
+// notify trigger can echo it back for end-to-end latency tracing.
+bool DatabaseManager::executeTracedUpdate(const QString& commandType, const QString& entityId,
+                                          const QString& functionCall, const QVariantList& params,
+                                          const std::function<void()>& emitLocalChanges, QVariant* result) {
+    const QString commandId = m_commandTracer ? m_commandTracer->beginCommand(commandType, entityId) : QString();
+
     QSqlQuery query(db);
-    query.prepare("SELECT railway_control.update_track_assignment(?, ?, 'HMI_USER')");
-    query.addBindValue(segmentId);
-    query.addBindValue(isAssigned);
+    query.prepare(QString("SELECT %1 FROM (SELECT set_config('railway.command_id', ?, true)) AS trace").arg(functionCall));
+    for (const QVariant& param : params) {
+        query.addBindValue(param);
+    }
+    query.addBindValue(commandId);
 
-    if (query.exec() && query.next()) {
-        bool success = query.value(0).toBool();
-        if (success) {
-            // ✅ SAFETY: No cache invalidation - just emit signals
-            emit trackSegmentUpdated(segmentId);
-            emit trackSegmentsChanged();
-        }
-        return success;
+    if (!query.exec() || !query.next()) {
+        qWarning() << "❌ SAFETY CRITICAL:" << commandType << "update failed for" << entityId << ":" << query.lastError().text();
+        RF_TRACE(Update, UpdateResult, entityId, traceUpdateKindCode(commandType), 0);
+        if (m_commandTracer) m_commandTracer->failCommand(commandId);
+        return false;
     }
 
-    qWarning() << "❌ SAFETY CRITICAL: Track assignment update failed:" << query.lastError().text();
-    return false;
+    // Functions with a non-boolean result report refusal as NULL
+    const QVariant value = query.value(0);
+    if (result) *result = value;
+    bool success = result ? !value.isNull() : value.toBool();
+    RF_TRACE(Update, UpdateResult, entityId, traceUpdateKindCode(commandType), success);
+    if (m_commandTracer) m_commandTracer->recordHop(commandId, CommandTracer::SqlReturned);
+
+    if (!success) {
+        if (m_commandTracer) m_commandTracer->failCommand(commandId);
+        return false;
+    }
+
+    // QML handlers run synchronously inside these emits, so the hop covers the model refresh
+    emitLocalChanges();
+    if (m_commandTracer) m_commandTracer->recordHop(commandId, CommandTracer::LocalRefreshed);
+
+    return true;
 }
 
 // ✅ SAFETY: Row conversion helpers (unchanged)
-QVariantMap DatabaseManager::convertSignalRowToVariant(const QSqlQuery& query) {
-    QVariantMap signal;
-    signal["id"] = query.value("signal_id").toString();
-    signal["name"] = query.value("signal_name").toString();
-    signal["type"] = query.value("signal_type").toString();
-    signal["row"] = query.value("row").toDouble();
-    signal["col"] = query.value("col").toDouble();
-    signal["direction"] = query.value("direction").toString();
-    signal["currentAspect"] = query.value("current_aspect").toString();
-    signal["callingOnAspect"] = query.value("calling_on_aspect").toString();
-    signal["loopAspect"] = query.value("loop_aspect").toString();
-    signal["loopSignalConfiguration"] = query.value("loop_signal_configuration").toString();
-    signal["aspectCount"] = query.value("aspect_count").toInt();
-    signal["isActive"] = query.value("is_active").toBool();
-    signal["location"] = query.value("location").toString();
+SignalInfo DatabaseManager::convertSignalRow(const QSqlQuery& query) {
+    SignalInfo signal;
+    signal.id = query.value("signal_id").toString();
+    signal.name = query.value("signal_name").toString();
+    signal.type = query.value("signal_type").toString();
+    signal.row = query.value("row").toDouble();
+    signal.col = query.value("col").toDouble();
+    signal.direction = query.value("direction").toString();
+    signal.aspect = SignalInfo::aspectFromCode(query.value("current_aspect").toString());
+    signal.callingOn = SignalInfo::aspectFromCode(query.value("calling_on_aspect").toString());
+    signal.loop = SignalInfo::aspectFromCode(query.value("loop_aspect").toString());
+    signal.loopSignalConfiguration = query.value("loop_signal_configuration").toString();
+    signal.aspectCount = query.value("aspect_count").toInt();
+    signal.isActive = query.value("is_active").toBool();
+    signal.location = query.value("location").toString();
 
     // Convert PostgreSQL array to QStringList
     QString aspectsStr = query.value("possible_aspects").toString();
     if (!aspectsStr.isEmpty()) {
         aspectsStr = aspectsStr.mid(1, aspectsStr.length() - 2); // Remove { }
-        signal["possibleAspects"] = aspectsStr.split(",");
-    } else {
-        signal["possibleAspects"] = QStringList();
+        signal.possibleAspects = aspectsStr.split(",");
     }
 
+    // Interlocking: database IDs of signals that must be RED for this one to clear
+    signal.dbId = query.value("db_id").toInt();
+    signal.interlockedWith = parseIntegerArray(query.value("interlocked_with").toString());
+
     return signal;
 }
 
-QVariantMap DatabaseManager::convertTrackRowToVariant(const QSqlQuery& query) {
-    QVariantMap track;
-    track["id"] = query.value("segment_id").toString();
-    track["name"] = query.value("segment_name").toString();
-    track["startRow"] = query.value("start_row").toDouble();
-    track["startCol"] = query.value("start_col").toDouble();
-    track["endRow"] = query.value("end_row").toDouble();
-    track["endCol"] = query.value("end_col").toDouble();
-    track["trackType"] = query.value("track_type").toString();
-    track["occupied"] = query.value("is_occupied").toBool();
-    track["assigned"] = query.value("is_assigned").toBool();
-    track["occupiedBy"] = query.value("occupied_by").toString();
-    track["isActive"] = query.value("is_active").toBool();
+TrackSegmentInfo DatabaseManager::convertTrackRow(const QSqlQuery& query) {
+    TrackSegmentInfo track;
+    track.id = query.value("segment_id").toString();
+    track.name = query.value("segment_name").toString();
+    track.startRow = query.value("start_row").toDouble();
+    track.startCol = query.value("start_col").toDouble();
+    track.endRow = query.value("end_row").toDouble();
+    track.endCol = query.value("end_col").toDouble();
+    track.trackType = query.value("track_type").toString();
+    track.occupied = query.value("is_occupied").toBool();
+    track.assigned = query.value("is_assigned").toBool();
+    track.occupiedBy = query.value("occupied_by").toString();
+    track.isActive = query.value("is_active").toBool();
 
     return track;
 }
 
-QVariantMap DatabaseManager::convertPointMachineRowToVariant(const QSqlQuery& query) {
-    QVariantMap pm;
-    pm["id"] = query.value("machine_id").toString();
-    pm["name"] = query.value("machine_name").toString();
-    pm["position"] = query.value("position").toString();
-    pm["operatingStatus"] = query.value("operating_status").toString();
-    pm["transitionTime"] = query.value("transition_time_ms").toInt();
+PointMachineInfo DatabaseManager::convertPointMachineRow(const QSqlQuery& query) {
+    PointMachineInfo pm;
+    pm.id = query.value("machine_id").toString();
+    pm.name = query.value("machine_name").toString();
+    pm.pointPosition = PointMachineInfo::positionFromCode(query.value("position").toString());
+    pm.status = PointMachineInfo::statusFromCode(query.value("operating_status").toString());
+    pm.transitionTime = query.value("transition_time_ms").toInt();
+    pm.dbId = query.value("db_id").toInt();
+    pm.safetyInterlocks = parseIntegerArray(query.value("safety_interlocks").toString());
+    pm.isLocked = query.value("is_locked").toBool();
+    pm.lockReason = query.value("lock_reason").toString();
 
     // Junction point
-    QVariantMap junctionPoint;
-    junctionPoint["row"] = query.value("junction_row").toDouble();
-    junctionPoint["col"] = query.value("junction_col").toDouble();
-    pm["junctionPoint"] = junctionPoint;
+    pm.junctionPoint["row"] = query.value("junction_row").toDouble();
+    pm.junctionPoint["col"] = query.value("junction_col").toDouble();
 
     // Track connections (parse JSON)
     QString rootConnStr = query.value("root_track_connection").toString();
@@ -803,18 +2059,15 @@ QVariantMap DatabaseManager::convertPointMachineRowToVariant(const QSqlQuery& qu
     QString reverseConnStr = query.value("reverse_track_connection").toString();
 
     if (!rootConnStr.isEmpty()) {
-        QJsonDocument rootDoc = QJsonDocument::fromJson(rootConnStr.toUtf8());
-        pm["rootTrack"] = rootDoc.object().toVariantMap();
+        pm.rootTrack = QJsonDocument::fromJson(rootConnStr.toUtf8()).object().toVariantMap();
     }
 
     if (!normalConnStr.isEmpty()) {
-        QJsonDocument normalDoc = QJsonDocument::fromJson(normalConnStr.toUtf8());
-        pm["normalTrack"] = normalDoc.object().toVariantMap();
+        pm.normalTrack = QJsonDocument::fromJson(normalConnStr.toUtf8()).object().toVariantMap();
     }
 
     if (!reverseConnStr.isEmpty()) {
-        QJsonDocument reverseDoc = QJsonDocument::fromJson(reverseConnStr.toUtf8());
-        pm["reverseTrack"] = reverseDoc.object().toVariantMap();
+        pm.reverseTrack = QJsonDocument::fromJson(reverseConnStr.toUtf8()).object().toVariantMap();
     }
 
     return pm;
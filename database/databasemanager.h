@@ -5,6 +5,7 @@
 #include <QSqlError>
 #include <QSqlDriver>
 #include <QTimer>
+#include <QElapsedTimer>
 #include <QHash>
 #include <QVariantMap>
 #include <QVariantList>
@@ -13,13 +14,28 @@
 #include <QJsonObject>
 #include <QJsonArray>
 #include <memory>
+#include <functional>
 #include <QProcess>
 #include <QFile>
 #include <QFileInfo>
 
+#include "database/elementinfo.h"
+#include "database/pgbinaryreader.h"
+
+class CommandTracer;
+class ConnectionSupervisor;
+class PortableServer;
+class InterlockingEngine;
+class StateBrokerClient;
+
 class DatabaseManager : public QObject {
     Q_OBJECT
     Q_PROPERTY(bool isConnected READ isConnected NOTIFY connectionStateChanged)
+    // Lost session: the data on screen is the last known state until the
+    // reconnect and its resync complete
+    Q_PROPERTY(bool isStale READ isStale NOTIFY staleChanged)
+    Q_PROPERTY(bool isConnecting READ isConnecting NOTIFY connectingChanged)
+    Q_PROPERTY(int reconnectAttempts READ reconnectAttempts NOTIFY reconnectAttemptsChanged)
 
     // ✅ NEW: Data model properties for QML binding
     Q_PROPERTY(QVariantList trackSegments READ getTrackSegmentsList NOTIFY trackSegmentsChanged)
@@ -27,15 +43,35 @@ class DatabaseManager : public QObject {
     Q_PROPERTY(QVariantList allPointMachines READ getAllPointMachinesList NOTIFY pointMachinesChanged)
     Q_PROPERTY(QVariantList textLabels READ getTextLabelsList NOTIFY textLabelsChanged)
 
+    // Station the layout properties and change signals are scoped to
+    Q_PROPERTY(QString activeStation READ activeStation WRITE setActiveStation NOTIFY activeStationChanged)
+    Q_PROPERTY(QStringList openStations READ openStations NOTIFY openStationsChanged)
+
+    // Active station counters ({tracks, signals, point_machines}); pushed by
+    // the server's status triggers, never recounted on the client
+    Q_PROPERTY(QVariantMap systemStatus READ systemStatus NOTIFY systemStatusChanged)
+
 public:
     explicit DatabaseManager(QObject* parent = nullptr);
     ~DatabaseManager();
 
+    // Waits for the same startup as connectToDatabaseAsync() (headless, tools)
     Q_INVOKABLE bool connectToDatabase();
+    // Non-blocking startup: probe the system server, else bring up the
+    // portable one; ends with startupFinished() (and connectionStateChanged)
+    Q_INVOKABLE void connectToDatabaseAsync();
+    bool isConnecting() const { return m_connecting; }
+    // Milliseconds per startup phase of the last connect (system_probe_ms, initdb_ms, ..., total_ms)
+    QVariantMap startupTimings() const { return m_startupTimings; }
     Q_INVOKABLE bool connectToSystemPostgreSQL();
     Q_INVOKABLE void startPolling();
     Q_INVOKABLE void stopPolling();
     Q_INVOKABLE bool isConnected() const;
+    bool isStale() const { return m_stale; }
+    int reconnectAttempts() const;
+    // Drops the session and lets the supervisor reopen it at once (after a
+    // database reset the resync sees a recreated change log and reloads all)
+    Q_INVOKABLE void reconnect();
 
     // ✅ EXISTING: Component state queries
     Q_INVOKABLE QVariantMap getAllSignalStates();
@@ -45,20 +81,41 @@ public:
     Q_INVOKABLE bool getTrackOccupancy(int circuitId);
     Q_INVOKABLE QString getPointPosition(int machineId);
 
-    // ✅ NEW: Complete data object queries
-    Q_INVOKABLE QVariantList getTrackSegmentsList();
-    Q_INVOKABLE QVariantList getAllSignalsList();
+    // ✅ NEW: Complete data object queries (empty station = active station)
+    Q_INVOKABLE QVariantList getTrackSegmentsList(const QString& stationId = QString());
+    Q_INVOKABLE QVariantList getAllSignalsList(const QString& stationId = QString());
     Q_INVOKABLE QVariantList getOuterSignalsList();
     Q_INVOKABLE QVariantList getHomeSignalsList();
     Q_INVOKABLE QVariantList getStarterSignalsList();
     Q_INVOKABLE QVariantList getAdvanceStarterSignalsList();
-    Q_INVOKABLE QVariantList getAllPointMachinesList();
-    Q_INVOKABLE QVariantList getTextLabelsList();
+    Q_INVOKABLE QVariantList getAllPointMachinesList(const QString& stationId = QString());
+    Q_INVOKABLE QVariantList getTextLabelsList(const QString& stationId = QString());
+
+    // Same rows as typed value types (SignalInfo etc.) for QML delegates
+    Q_INVOKABLE QVariantList getTrackSegmentInfos(const QString& stationId = QString());
+    Q_INVOKABLE QVariantList getSignalInfos(const QString& stationId = QString());
+    Q_INVOKABLE QVariantList getPointMachineInfos(const QString& stationId = QString());
+
+    // One consistent read of everything the station view draws:
+    // {tracks, signals, pointMachines} as value types plus textLabels maps,
+    // all taken from a single REPEATABLE READ snapshot
+    Q_INVOKABLE QVariantMap getStationSnapshot(const QString& stationId = QString());
+
+    // Status counters as get_system_status() returns them (empty station =
+    // active station, answered from the pushed copy without a query)
+    Q_INVOKABLE QVariantMap getSystemStatus(const QString& stationId = QString());
+    QVariantMap systemStatus() const { return m_systemStatus; }
+
+    // Server-side box query over the active station's layout ({type, id} per element)
+    Q_INVOKABLE QVariantList getElementsInRegion(double minRow, double minCol, double maxRow, double maxCol);
 
     // ✅ NEW: Individual object queries
     Q_INVOKABLE QVariantMap getSignalById(const QString& signalId);
     Q_INVOKABLE QVariantMap getTrackSegmentById(const QString& segmentId);
     Q_INVOKABLE QVariantMap getPointMachineById(const QString& machineId);
+    Q_INVOKABLE SignalInfo getSignalInfo(const QString& signalId);
+    Q_INVOKABLE TrackSegmentInfo getTrackSegmentInfo(const QString& segmentId);
+    Q_INVOKABLE PointMachineInfo getPointMachineInfo(const QString& machineId);
 
     // ✅ NEW: Update operations (for signal clicks, etc.)
     Q_INVOKABLE bool updateSignalAspect(const QString& signalId, const QString& newAspect);
@@ -66,17 +123,69 @@ public:
     Q_INVOKABLE bool updateTrackOccupancy(const QString& segmentId, bool isOccupied);
     Q_INVOKABLE bool updateTrackAssignment(const QString& segmentId, bool isAssigned);
 
+    // Timed point throws (PointTransitionEngine): begin returns the transit
+    // time in ms, or -1 when refused; completions are committed in one batch
+    int beginPointTransition(const QString& machineId);
+    bool completePointTransitions(const QStringList& machineIds, const QStringList& positions);
+    // Reconnects machines a previous run left IN_TRANSITION at their recorded
+    // position; their IDs are appended to machineIds
+    bool reconcilePointTransitions(QStringList* machineIds = nullptr, int graceMs = 5000);
+
+    // Field inputs (FieldGateway): track circuit and point detection states
+    // written set-based in one round trip; unchanged rows are skipped
+    bool applyFieldInputs(const QStringList& segmentIds, const QList<bool>& occupied,
+                          const QStringList& machineIds, const QStringList& positions);
+
+    // ===== Stations =====
+    // Layout and state are only ever read for stations in use: the active
+    // station plus any opened for monitoring. Each station notifies on its own
+    // channel (railway_changes_<station_id>) and is only LISTENed to while in
+    // use; a station the operator switched away from is dropped after
+    // STATION_IDLE_UNLOAD_MS. Element IDs are unique across stations, so the
+    // update methods need no station argument.
+    //
+    // Geometry and labels of a station in use are cached under the station's
+    // layout_version, which triggers bump on every geometry or label edit and
+    // announce on the station channel. While the version stands, list reads
+    // fetch only the state columns and merge them into the cached rows.
+    QString activeStation() const { return m_activeStation; }
+    void setActiveStation(const QString& stationId);
+    QStringList openStations() const;
+    Q_INVOKABLE QVariantList getStationsList();
+    // Keeps a non-active station subscribed (stationDataChanged) until closed
+    Q_INVOKABLE bool openStation(const QString& stationId);
+    Q_INVOKABLE void closeStation(const QString& stationId);
+
     // ✅ NEW: Real-time notification handling
     Q_INVOKABLE void enableRealTimeUpdates();
 
     Q_INVOKABLE bool startPortableMode();
     Q_INVOKABLE void cleanup();
 
+    // Overrides the system server endpoint (benchmarks and tooling run against throwaway servers)
+    void setSystemServer(const QString& hostName, int port);
+    // True while list queries go through the libpq binary path
+    bool usesBinaryReads() const { return m_binaryReader.isOpen(); }
+    // Optional: stamps every update command with an ID for latency tracing
+    void setCommandTracer(CommandTracer* tracer);
+    // Optional: rejects signal clears and point throws the interlocking forbids
+    void setInterlockingEngine(InterlockingEngine* engine);
+    // Optional: reads layout and state from a StateBroker instead of the
+    // database (no LISTEN, no polling); commands still go to the database
+    void setStateSource(StateBrokerClient* source);
+
 signals:
     void signalStateChanged(int signalId, const QString& newState);
     void trackCircuitStateChanged(int circuitId, bool isOccupied);
     void pointMachineStateChanged(int machineId, const QString& newPosition);
     void connectionStateChanged(bool connected);
+    void connectingChanged();
+    void startupFinished(bool connected, const QVariantMap& timings);
+    void staleChanged();
+    void reconnectAttemptsChanged();
+    void reconnectScheduled(int attempt, int delayMs);
+    // After a reconnect: changedRows replayed from the change log, or a full reload
+    void resynchronized(int changedRows, bool fullReload);
     void dataUpdated();
     void errorOccurred(const QString& error);
 
@@ -88,15 +197,42 @@ signals:
     void signalUpdated(const QString& signalId);
     void pointMachineUpdated(const QString& machineId);
     void trackSegmentUpdated(const QString& segmentId);
+    // Field inputs that changed a row, with the new state in hand (no per-row
+    // *Updated signal follows): tracks {id, occupied}, point machines {id,
+    // position, operatingStatus, isLocked}
+    void fieldInputsApplied(const QVariantList& tracks, const QVariantList& pointMachines);
+
+    // Stations
+    void activeStationChanged();
+    void openStationsChanged();
+    // Change in an opened, non-active station (the layout signals stay active-only)
+    void stationDataChanged(const QString& stationId, const QString& table, const QString& entityId);
+    void stationUnloaded(const QString& stationId);
+    // Active station geometry or labels edited (layout_version moved); the
+    // table-level *Changed signals follow
+    void layoutChanged();
+    void systemStatusChanged();
 
 private slots:
     void pollDatabase();
+    void sweepIdleStations();
+    void checkConnection();
+    void onServerReachable();
     // ✅ FIXED: Simplified notification handler signature
-    void handleDatabaseNotification(const QString& name, const QVariant& payload);
+    void handleDatabaseNotification(const QString& name, const QVariant& payload, bool ownSession = false);
 
 private:
     // ✅ FIXED: Added missing constant
     static constexpr int POLLING_INTERVAL_MS = 50000;  // 50 second polling interval
+    static constexpr int STATION_IDLE_UNLOAD_MS = 60000;
+    static constexpr int STATION_SWEEP_INTERVAL_MS = 10000;
+    static constexpr int HEARTBEAT_INTERVAL_MS = 5000;
+    static constexpr int SYSTEM_PROBE_TIMEOUT_MS = 500;
+    // The portable port accepts before recovery ends ("starting up"): retry the open
+    static constexpr int PORTABLE_OPEN_RETRIES = 50;
+    static constexpr int PORTABLE_OPEN_RETRY_MS = 100;
+    // Resync falls back to a full reload above this many changed rows
+    static constexpr int RESYNC_MAX_CHANGES = 1000;
 
     // ✅ Database connection
     QSqlDatabase db;
@@ -108,30 +244,118 @@ private:
     std::unique_ptr<QTimer> m_connectionTimer;
     std::unique_ptr<QTimer> m_statePollingTimer;
 
-    QProcess* m_postgresProcess = nullptr;
-    QString m_appDirectory;
-    QString m_postgresPath;
-    QString m_dataPath;
+    PortableServer* m_portableServer = nullptr;
     int m_portablePort = 5433;
     int m_systemPort = 5432;
+    QString m_systemHost = "localhost";
+    CommandTracer* m_commandTracer = nullptr;
+    InterlockingEngine* m_interlocking = nullptr;
+    StateBrokerClient* m_stateSource = nullptr;
+    PgBinaryReader m_binaryReader;
+
+    // ===== Connection supervision =====
+    ConnectionSupervisor* m_supervisor = nullptr;
+    bool m_stale = false;
+    bool m_connecting = false;
+    QElapsedTimer m_startupClock;
+    QVariantMap m_startupTimings;
+    // Snapshot xmin at the last heartbeat: every change-log row written by a
+    // transaction not yet visible then has transaction_id >= it; -1 unknown
+    qint64 m_changeWatermark = -1;
+    qint64 m_changeLogOid = -1;      // event_log table identity (a reset recreates it)
+
+    // ===== Stations in use =====
+    // Rows as last fully read, each tagged with the layout_version it was read at (-1 = none)
+    struct LayoutCache {
+        qint64 tracksVersion = -1;
+        qint64 signalsVersion = -1;
+        qint64 pointsVersion = -1;
+        qint64 labelsVersion = -1;
+        QList<TrackSegmentInfo> tracks;
+        QList<SignalInfo> signalList;
+        QList<PointMachineInfo> points;
+        QVariantList labels;
+
+        bool isEmpty() const
+        {
+            return tracksVersion < 0 && signalsVersion < 0 && pointsVersion < 0 && labelsVersion < 0;
+        }
+    };
+    struct StationSubscription {
+        bool pinned = false;        // opened explicitly (openStation)
+        bool subscribed = false;    // LISTEN active on its channel
+        qint64 idleSinceMs = -1;    // -1 = in use
+        qint64 layoutVersion = -1;  // as announced while subscribed; -1 = read it
+        LayoutCache layout;
+    };
+    QString m_activeStation = QStringLiteral("MAIN");
+    QHash<QString, StationSubscription> m_stations;
+    bool m_realTimeEnabled = false;
+    QElapsedTimer m_stationClock;
+    std::unique_ptr<QTimer> m_stationSweepTimer;
+    QVariantMap m_systemStatus;   // active station, kept by station_status notifications
+    // NOTIFY echoes still due for rows applyFieldInputs() announced itself ("table/id" -> count)
+    QHash<QString, int> m_fieldInputEchoes;
+    bool consumeFieldInputEcho(const QString& table, const QString& entityId);
 
     // ✅ FIXED: Added missing state tracking variables
     QHash<int, QString> lastSignalStates;
     QHash<int, bool> lastTrackStates;
     QHash<int, QString> lastPointStates;
 
+    QString stationScope(const QString& stationId) const { return stationId.isEmpty() ? m_activeStation : stationId; }
+    bool servedByStateSource(const QString& stationId = QString()) const;
+    bool stationExists(const QString& stationId);
+    void subscribeStation(const QString& stationId);
+    void unsubscribeStation(const QString& stationId);
+    // One status row read (connect, reconnect, station switch); notifications keep it current
+    void refreshSystemStatus();
+    QVariantMap querySystemStatus(const QString& stationId);
+
+    // Layout cache (stations in use only; nullptr / -1 = no caching)
+    qint64 layoutVersion(const QString& stationId);
+    LayoutCache* layoutCache(const QString& stationId);
+    bool layoutCached(const QString& stationId);
+    void handleLayoutChange(const QString& stationId, qint64 version);
+    // State columns merged into cached rows; false = rows no longer line up (full read)
+    bool mergeTrackStates(const QString& stationId, QList<TrackSegmentInfo>* tracks);
+    bool mergeSignalStates(const QString& stationId, QList<SignalInfo>* signalList);
+    bool mergePointMachineStates(const QString& stationId, QList<PointMachineInfo>* points);
+    void setSystemStatus(const QVariantMap& status);
+
     // ✅ FIXED: Added missing private method declarations
     void detectAndEmitChanges();
     bool setupDatabase();
     void logError(const QString& operation, const QSqlError& error);
-    bool startPortablePostgreSQL();
-    bool stopPortablePostgreSQL();
-    bool initializePortableDatabase();
-    bool isPortableServerRunning();
+    void startPortableServer();
+    void openPortableConnection(int attempt);
+    void finishStartup(bool ok);
     QString getApplicationDirectory();
+    bool executeTracedUpdate(const QString& commandType, const QString& entityId,
+                             const QString& functionCall, const QVariantList& params,
+                             const std::function<void()>& emitLocalChanges, QVariant* result = nullptr);
+
+    // libpq binary-format reads for the list queries (QtSql when unavailable)
+    void openBinaryReader();
+    void disableBinaryReader(const char* query);
+
+    // Heartbeat, loss handling and change-log resync after reconnect
+    void superviseConnection();
+    void handleConnectionLost(const QString& reason);
+    void resynchronize();
+    bool readChangeWatermark(qint64* watermark, qint64* changeLogOid);
+    void setStale(bool stale);
+
+    // ✅ Row queries: every row is parsed once, into its value type
+    QList<TrackSegmentInfo> queryTrackSegments(const QString& stationId);
+    QList<SignalInfo> querySignals(const QString& stationId);
+    QList<PointMachineInfo> queryPointMachines(const QString& stationId);
+    bool querySignalById(const QString& signalId, SignalInfo* signal);
+    bool queryTrackSegmentById(const QString& segmentId, TrackSegmentInfo* track);
+    bool queryPointMachineById(const QString& machineId, PointMachineInfo* pm);
 
     // ✅ Row conversion helpers
-    QVariantMap convertSignalRowToVariant(const QSqlQuery& query);
-    QVariantMap convertTrackRowToVariant(const QSqlQuery& query);
-    QVariantMap convertPointMachineRowToVariant(const QSqlQuery& query);
+    SignalInfo convertSignalRow(const QSqlQuery& query);
+    TrackSegmentInfo convertTrackRow(const QSqlQuery& query);
+    PointMachineInfo convertPointMachineRow(const QSqlQuery& query);
 };
@@ -0,0 +1,44 @@
+#include "elementcodes.h"
+
+#include <iterator>
+
+namespace ElementCodes {
+
+namespace {
+
+const char* const kAspectCodes[] = {
+    "", "RED", "YELLOW", "GREEN", "SINGLE_YELLOW", "DOUBLE_YELLOW", "WHITE", "BLUE", "OFF", "DARK", "INACTIVE"
+};
+const char* const kPositionCodes[] = {"", "NORMAL", "REVERSE"};
+const char* const kStatusCodes[] = {"", "CONNECTED", "IN_TRANSITION", "FAILED", "LOCKED_OUT"};
+
+static_assert(std::size(kAspectCodes) == Inactive + 1, "one code per aspect");
+static_assert(std::size(kPositionCodes) == Reverse + 1, "one code per position");
+static_assert(std::size(kStatusCodes) == LockedOut + 1, "one code per status");
+
+// Index 0 (unknown) for codes not in the table
+template <std::size_t N>
+int codeIndex(const char* const (&codes)[N], const QString& code)
+{
+    for (std::size_t i = 1; i < N; ++i) {
+        if (code == QLatin1String(codes[i])) return int(i);
+    }
+    return 0;
+}
+
+template <std::size_t N>
+QString codeAt(const char* const (&codes)[N], int index)
+{
+    return QLatin1String(codes[index >= 0 && index < int(N) ? index : 0]);
+}
+
+} // namespace
+
+Aspect aspectFromCode(const QString& code) { return Aspect(codeIndex(kAspectCodes, code)); }
+QString aspectCode(Aspect aspect) { return codeAt(kAspectCodes, aspect); }
+Position positionFromCode(const QString& code) { return Position(codeIndex(kPositionCodes, code)); }
+QString positionCode(Position position) { return codeAt(kPositionCodes, position); }
+Status statusFromCode(const QString& code) { return Status(codeIndex(kStatusCodes, code)); }
+QString statusCode(Status status) { return codeAt(kStatusCodes, status); }
+
+} // namespace ElementCodes
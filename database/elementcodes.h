@@ -0,0 +1,29 @@
+#pragma once
+
+#include <QString>
+#include <QtGlobal>
+
+// Codes of the enum-like text columns (signal aspects, point positions and
+// operating statuses) and their numeric values. Shared by the typed QML rows
+// (elementinfo.h) and the broker wire format (stationwire.h), so both map a
+// code to the same value. Value 0 is "unknown": it is what unrecognised or
+// NULL codes parse to, and it reads back as "".
+namespace ElementCodes {
+
+enum Aspect : quint8 {
+    AspectUnknown = 0, Red, Yellow, Green, SingleYellow, DoubleYellow, White, Blue, Off, Dark,
+    Inactive    // loop_aspect of a home signal without a loop arm
+};
+
+enum Position : quint8 { PositionUnknown = 0, Normal, Reverse };
+
+enum Status : quint8 { StatusUnknown = 0, Connected, InTransition, Failed, LockedOut };
+
+Aspect aspectFromCode(const QString& code);
+QString aspectCode(Aspect aspect);
+Position positionFromCode(const QString& code);
+QString positionCode(Position position);
+Status statusFromCode(const QString& code);
+QString statusCode(Status status);
+
+} // namespace ElementCodes
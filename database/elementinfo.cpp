@@ -0,0 +1,193 @@
+#include "elementinfo.h"
+
+// ============================================================================
+// SIGNAL
+// ============================================================================
+
+SignalInfo::Aspect SignalInfo::aspectFromCode(const QString& code)
+{
+    return Aspect(ElementCodes::aspectFromCode(code));
+}
+
+QString SignalInfo::aspectCode(Aspect aspect)
+{
+    return ElementCodes::aspectCode(ElementCodes::Aspect(aspect));
+}
+
+QVariantMap SignalInfo::toVariantMap() const
+{
+    QVariantMap signal;
+    signal["id"] = id;
+    signal["name"] = name;
+    signal["type"] = type;
+    signal["row"] = row;
+    signal["col"] = col;
+    signal["direction"] = direction;
+    signal["currentAspect"] = currentAspect();
+    signal["callingOnAspect"] = callingOnAspect();
+    signal["loopAspect"] = loopAspect();
+    signal["loopSignalConfiguration"] = loopSignalConfiguration;
+    signal["aspectCount"] = aspectCount;
+    signal["isActive"] = isActive;
+    signal["location"] = location;
+    signal["possibleAspects"] = possibleAspects;
+    signal["dbId"] = dbId;
+    signal["interlockedWith"] = interlockedWith;
+    return signal;
+}
+
+SignalInfo SignalInfo::fromVariant(const QVariant& value)
+{
+    if (value.metaType() == QMetaType::fromType<SignalInfo>()) return value.value<SignalInfo>();
+
+    const QVariantMap map = value.toMap();
+    SignalInfo signal;
+    signal.id = map.value("id").toString();
+    signal.name = map.value("name").toString();
+    signal.type = map.value("type").toString();
+    signal.row = map.value("row").toDouble();
+    signal.col = map.value("col").toDouble();
+    signal.direction = map.value("direction").toString();
+    signal.aspect = aspectFromCode(map.value("currentAspect").toString());
+    signal.callingOn = aspectFromCode(map.value("callingOnAspect", "OFF").toString());
+    signal.loop = aspectFromCode(map.value("loopAspect", "OFF").toString());
+    signal.loopSignalConfiguration = map.value("loopSignalConfiguration").toString();
+    signal.aspectCount = map.value("aspectCount").toInt();
+    signal.isActive = map.value("isActive", true).toBool();
+    signal.location = map.value("location").toString();
+    signal.possibleAspects = map.value("possibleAspects").toStringList();
+    signal.dbId = map.value("dbId").toInt();
+    signal.interlockedWith = map.value("interlockedWith").toList();
+    return signal;
+}
+
+bool operator==(const SignalInfo& a, const SignalInfo& b)
+{
+    return a.id == b.id && a.name == b.name && a.type == b.type && a.row == b.row && a.col == b.col
+        && a.direction == b.direction && a.aspect == b.aspect && a.callingOn == b.callingOn
+        && a.loop == b.loop && a.loopSignalConfiguration == b.loopSignalConfiguration
+        && a.aspectCount == b.aspectCount && a.isActive == b.isActive && a.location == b.location
+        && a.possibleAspects == b.possibleAspects && a.dbId == b.dbId && a.interlockedWith == b.interlockedWith;
+}
+
+// ============================================================================
+// TRACK SEGMENT
+// ============================================================================
+
+QVariantMap TrackSegmentInfo::toVariantMap() const
+{
+    QVariantMap track;
+    track["id"] = id;
+    track["name"] = name;
+    track["startRow"] = startRow;
+    track["startCol"] = startCol;
+    track["endRow"] = endRow;
+    track["endCol"] = endCol;
+    track["trackType"] = trackType;
+    track["occupied"] = occupied;
+    track["assigned"] = assigned;
+    track["occupiedBy"] = occupiedBy;
+    track["isActive"] = isActive;
+    return track;
+}
+
+TrackSegmentInfo TrackSegmentInfo::fromVariant(const QVariant& value)
+{
+    if (value.metaType() == QMetaType::fromType<TrackSegmentInfo>()) return value.value<TrackSegmentInfo>();
+
+    const QVariantMap map = value.toMap();
+    TrackSegmentInfo track;
+    track.id = map.value("id").toString();
+    track.name = map.value("name").toString();
+    track.startRow = map.value("startRow").toDouble();
+    track.startCol = map.value("startCol").toDouble();
+    track.endRow = map.value("endRow").toDouble();
+    track.endCol = map.value("endCol").toDouble();
+    track.trackType = map.value("trackType").toString();
+    track.occupied = map.value("occupied").toBool();
+    track.assigned = map.value("assigned").toBool();
+    track.occupiedBy = map.value("occupiedBy").toString();
+    track.isActive = map.value("isActive", true).toBool();
+    return track;
+}
+
+bool operator==(const TrackSegmentInfo& a, const TrackSegmentInfo& b)
+{
+    return a.id == b.id && a.name == b.name && a.startRow == b.startRow && a.startCol == b.startCol
+        && a.endRow == b.endRow && a.endCol == b.endCol && a.trackType == b.trackType
+        && a.occupied == b.occupied && a.assigned == b.assigned && a.occupiedBy == b.occupiedBy
+        && a.isActive == b.isActive;
+}
+
+// ============================================================================
+// POINT MACHINE
+// ============================================================================
+
+PointMachineInfo::Position PointMachineInfo::positionFromCode(const QString& code)
+{
+    return Position(ElementCodes::positionFromCode(code));
+}
+
+QString PointMachineInfo::positionCode(Position position)
+{
+    return ElementCodes::positionCode(ElementCodes::Position(position));
+}
+
+PointMachineInfo::Status PointMachineInfo::statusFromCode(const QString& code)
+{
+    return Status(ElementCodes::statusFromCode(code));
+}
+
+QString PointMachineInfo::statusCode(Status status)
+{
+    return ElementCodes::statusCode(ElementCodes::Status(status));
+}
+
+QVariantMap PointMachineInfo::toVariantMap() const
+{
+    QVariantMap pm;
+    pm["id"] = id;
+    pm["name"] = name;
+    pm["position"] = position();
+    pm["operatingStatus"] = operatingStatus();
+    pm["transitionTime"] = transitionTime;
+    pm["dbId"] = dbId;
+    pm["safetyInterlocks"] = safetyInterlocks;
+    pm["isLocked"] = isLocked;
+    pm["lockReason"] = lockReason;
+    pm["junctionPoint"] = junctionPoint;
+    if (!rootTrack.isEmpty()) pm["rootTrack"] = rootTrack;
+    if (!normalTrack.isEmpty()) pm["normalTrack"] = normalTrack;
+    if (!reverseTrack.isEmpty()) pm["reverseTrack"] = reverseTrack;
+    return pm;
+}
+
+PointMachineInfo PointMachineInfo::fromVariant(const QVariant& value)
+{
+    if (value.metaType() == QMetaType::fromType<PointMachineInfo>()) return value.value<PointMachineInfo>();
+
+    const QVariantMap map = value.toMap();
+    PointMachineInfo pm;
+    pm.id = map.value("id").toString();
+    pm.name = map.value("name").toString();
+    pm.pointPosition = positionFromCode(map.value("position").toString());
+    pm.status = statusFromCode(map.value("operatingStatus").toString());
+    pm.transitionTime = map.value("transitionTime").toInt();
+    pm.dbId = map.value("dbId").toInt();
+    pm.safetyInterlocks = map.value("safetyInterlocks").toList();
+    pm.isLocked = map.value("isLocked").toBool();
+    pm.lockReason = map.value("lockReason").toString();
+    pm.junctionPoint = map.value("junctionPoint").toMap();
+    pm.rootTrack = map.value("rootTrack").toMap();
+    pm.normalTrack = map.value("normalTrack").toMap();
+    pm.reverseTrack = map.value("reverseTrack").toMap();
+    return pm;
+}
+
+bool operator==(const PointMachineInfo& a, const PointMachineInfo& b)
+{
+    return a.id == b.id && a.name == b.name && a.pointPosition == b.pointPosition && a.status == b.status
+        && a.transitionTime == b.transitionTime && a.dbId == b.dbId && a.safetyInterlocks == b.safetyInterlocks
+        && a.isLocked == b.isLocked && a.lockReason == b.lockReason && a.junctionPoint == b.junctionPoint
+        && a.rootTrack == b.rootTrack && a.normalTrack == b.normalTrack && a.reverseTrack == b.reverseTrack;
+}
@@ -0,0 +1,195 @@
+#pragma once
+
+#include <QMetaType>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+#include <QVariantList>
+#include <QVariantMap>
+
+#include "database/elementcodes.h"
+
+// Typed rows handed to QML. QML resolves `modelData.x` through the static
+// metaobject instead of a string hash. Property names match the keys of the QVariantMap rows that the
+// C++ consumers (interlocking, topology, broker) still use, so delegates
+// bind the same way to either form; toVariantMap()/fromVariant() convert.
+//
+// Aspects, positions and statuses are stored as enums whose values are the
+// ElementCodes ones. The string properties (currentAspect, position, ...)
+// are derived from them; unknown or NULL codes parse to the *Unknown value
+// and read back as "", never as a default such as CONNECTED.
+
+class SignalInfo {
+    Q_GADGET
+    Q_PROPERTY(QString id MEMBER id)
+    Q_PROPERTY(QString name MEMBER name)
+    Q_PROPERTY(QString type MEMBER type)
+    Q_PROPERTY(double row MEMBER row)
+    Q_PROPERTY(double col MEMBER col)
+    Q_PROPERTY(QString direction MEMBER direction)
+    Q_PROPERTY(Aspect aspect MEMBER aspect)
+    Q_PROPERTY(Aspect callingOn MEMBER callingOn)
+    Q_PROPERTY(Aspect loop MEMBER loop)
+    Q_PROPERTY(QString currentAspect READ currentAspect STORED false)
+    Q_PROPERTY(QString callingOnAspect READ callingOnAspect STORED false)
+    Q_PROPERTY(QString loopAspect READ loopAspect STORED false)
+    Q_PROPERTY(QString loopSignalConfiguration MEMBER loopSignalConfiguration)
+    Q_PROPERTY(int aspectCount MEMBER aspectCount)
+    Q_PROPERTY(bool isActive MEMBER isActive)
+    Q_PROPERTY(QString location MEMBER location)
+    Q_PROPERTY(QStringList possibleAspects MEMBER possibleAspects)
+    Q_PROPERTY(int dbId MEMBER dbId)
+    Q_PROPERTY(QVariantList interlockedWith MEMBER interlockedWith)
+
+public:
+    enum Aspect {
+        AspectUnknown = ElementCodes::AspectUnknown, Red = ElementCodes::Red, Yellow = ElementCodes::Yellow,
+        Green = ElementCodes::Green, SingleYellow = ElementCodes::SingleYellow,
+        DoubleYellow = ElementCodes::DoubleYellow, White = ElementCodes::White, Blue = ElementCodes::Blue,
+        Off = ElementCodes::Off, Dark = ElementCodes::Dark, Inactive = ElementCodes::Inactive
+    };
+    Q_ENUM(Aspect)
+
+    static Aspect aspectFromCode(const QString& code);
+    static QString aspectCode(Aspect aspect);
+
+    QString currentAspect() const { return aspectCode(aspect); }
+    QString callingOnAspect() const { return aspectCode(callingOn); }
+    QString loopAspect() const { return aspectCode(loop); }
+
+    QVariantMap toVariantMap() const;
+    // Accepts a SignalInfo or a signal row map
+    static SignalInfo fromVariant(const QVariant& value);
+
+    friend bool operator==(const SignalInfo& a, const SignalInfo& b);
+    friend bool operator!=(const SignalInfo& a, const SignalInfo& b) { return !(a == b); }
+
+    QString id;
+    QString name;
+    QString type;
+    double row = 0.0;
+    double col = 0.0;
+    QString direction;
+    Aspect aspect = AspectUnknown;
+    Aspect callingOn = Off;
+    Aspect loop = Off;
+    QString loopSignalConfiguration;
+    int aspectCount = 0;
+    bool isActive = true;
+    QString location;
+    QStringList possibleAspects;
+    int dbId = 0;
+    QVariantList interlockedWith;
+};
+
+class TrackSegmentInfo {
+    Q_GADGET
+    Q_PROPERTY(QString id MEMBER id)
+    Q_PROPERTY(QString name MEMBER name)
+    Q_PROPERTY(double startRow MEMBER startRow)
+    Q_PROPERTY(double startCol MEMBER startCol)
+    Q_PROPERTY(double endRow MEMBER endRow)
+    Q_PROPERTY(double endCol MEMBER endCol)
+    Q_PROPERTY(QString trackType MEMBER trackType)
+    Q_PROPERTY(bool occupied MEMBER occupied)
+    Q_PROPERTY(bool assigned MEMBER assigned)
+    Q_PROPERTY(QString occupiedBy MEMBER occupiedBy)
+    Q_PROPERTY(bool isActive MEMBER isActive)
+
+public:
+    QVariantMap toVariantMap() const;
+    // Accepts a TrackSegmentInfo or a track row map
+    static TrackSegmentInfo fromVariant(const QVariant& value);
+
+    friend bool operator==(const TrackSegmentInfo& a, const TrackSegmentInfo& b);
+    friend bool operator!=(const TrackSegmentInfo& a, const TrackSegmentInfo& b) { return !(a == b); }
+
+    QString id;
+    QString name;
+    double startRow = 0.0;
+    double startCol = 0.0;
+    double endRow = 0.0;
+    double endCol = 0.0;
+    QString trackType;
+    bool occupied = false;
+    bool assigned = false;
+    QString occupiedBy;
+    bool isActive = true;
+};
+
+class PointMachineInfo {
+    Q_GADGET
+    Q_PROPERTY(QString id MEMBER id)
+    Q_PROPERTY(QString name MEMBER name)
+    Q_PROPERTY(Position pointPosition MEMBER pointPosition)
+    Q_PROPERTY(Status status MEMBER status)
+    Q_PROPERTY(QString position READ position STORED false)
+    Q_PROPERTY(QString operatingStatus READ operatingStatus STORED false)
+    Q_PROPERTY(int transitionTime MEMBER transitionTime)
+    Q_PROPERTY(int dbId MEMBER dbId)
+    Q_PROPERTY(QVariantList safetyInterlocks MEMBER safetyInterlocks)
+    Q_PROPERTY(bool isLocked MEMBER isLocked)
+    Q_PROPERTY(QString lockReason MEMBER lockReason)
+    Q_PROPERTY(QVariantMap junctionPoint MEMBER junctionPoint)
+    Q_PROPERTY(QVariantMap rootTrack MEMBER rootTrack)
+    Q_PROPERTY(QVariantMap normalTrack MEMBER normalTrack)
+    Q_PROPERTY(QVariantMap reverseTrack MEMBER reverseTrack)
+
+public:
+    enum Position {
+        PositionUnknown = ElementCodes::PositionUnknown, Normal = ElementCodes::Normal, Reverse = ElementCodes::Reverse
+    };
+    Q_ENUM(Position)
+    enum Status {
+        StatusUnknown = ElementCodes::StatusUnknown, Connected = ElementCodes::Connected,
+        InTransition = ElementCodes::InTransition, Failed = ElementCodes::Failed, LockedOut = ElementCodes::LockedOut
+    };
+    Q_ENUM(Status)
+
+    static Position positionFromCode(const QString& code);
+    static QString positionCode(Position position);
+    static Status statusFromCode(const QString& code);
+    static QString statusCode(Status status);
+
+    QString position() const { return positionCode(pointPosition); }
+    QString operatingStatus() const { return statusCode(status); }
+
+    QVariantMap toVariantMap() const;
+    // Accepts a PointMachineInfo or a point machine row map
+    static PointMachineInfo fromVariant(const QVariant& value);
+
+    friend bool operator==(const PointMachineInfo& a, const PointMachineInfo& b);
+    friend bool operator!=(const PointMachineInfo& a, const PointMachineInfo& b) { return !(a == b); }
+
+    QString id;
+    QString name;
+    Position pointPosition = PositionUnknown;
+    Status status = StatusUnknown;
+    int transitionTime = 0;
+    int dbId = 0;
+    QVariantList safetyInterlocks;
+    bool isLocked = false;
+    QString lockReason;
+    QVariantMap junctionPoint;
+    QVariantMap rootTrack;
+    QVariantMap normalTrack;
+    QVariantMap reverseTrack;
+};
+
+// Row maps from a list of value types (or maps), e.g. getStationSnapshot()'s
+// lists for consumers that index rows by key
+template <typename Info>
+QVariantList toVariantMaps(const QVariantList& values)
+{
+    QVariantList rows;
+    rows.reserve(values.size());
+    for (const QVariant& value : values) {
+        rows.append(Info::fromVariant(value).toVariantMap());
+    }
+    return rows;
+}
+
+Q_DECLARE_METATYPE(SignalInfo)
+Q_DECLARE_METATYPE(TrackSegmentInfo)
+Q_DECLARE_METATYPE(PointMachineInfo)
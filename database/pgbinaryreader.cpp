@@ -0,0 +1,715 @@
+#include "pgbinaryreader.h"
+
+#ifdef RAILFLUX_HAVE_LIBPQ
+
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QtEndian>
+#include <cstring>
+#include <iterator>
+#include <libpq-fe.h>
+
+namespace {
+
+// pg_type OIDs of the casts used below
+constexpr Oid kBoolOid = 16;
+constexpr Oid kInt8Oid = 20;
+constexpr Oid kInt4Oid = 23;
+constexpr Oid kTextOid = 25;
+constexpr Oid kFloat8Oid = 701;
+constexpr Oid kInt4ArrayOid = 1007;
+constexpr Oid kTextArrayOid = 1009;
+constexpr Oid kJsonbOid = 3802;
+
+constexpr char kTracksStatement[] = "rf_tracks";
+constexpr char kSignalsStatement[] = "rf_signals";
+constexpr char kPointsStatement[] = "rf_points";
+constexpr char kLabelsStatement[] = "rf_labels";
+constexpr char kTrackStatesStatement[] = "rf_track_states";
+constexpr char kSignalStatesStatement[] = "rf_signal_states";
+constexpr char kPointStatesStatement[] = "rf_point_states";
+
+// Column order is the decode order: keep the SELECT lists and the Column enums in step
+constexpr char kTracksSql[] = R"(
+    SELECT segment_id::text, segment_name::text, start_row::float8, start_col::float8,
+           end_row::float8, end_col::float8, track_type::text, is_occupied::bool,
+           is_assigned::bool, occupied_by::text, is_active::bool
+    FROM railway_control.track_segments
+    WHERE station_id = $1
+    ORDER BY segment_id
+)";
+enum TrackColumn {
+    TrackId, TrackName, TrackStartRow, TrackStartCol, TrackEndRow, TrackEndCol, TrackType,
+    TrackOccupied, TrackAssigned, TrackOccupiedBy, TrackActive, TrackColumnCount
+};
+constexpr Oid kTrackTypes[TrackColumnCount] = {
+    kTextOid, kTextOid, kFloat8Oid, kFloat8Oid, kFloat8Oid, kFloat8Oid, kTextOid,
+    kBoolOid, kBoolOid, kTextOid, kBoolOid
+};
+
+constexpr char kSignalsSql[] = R"(
+    SELECT s.signal_id::text, s.signal_name::text, st.type_code::text,
+           s.location_row::float8, s.location_col::float8, s.direction::text,
+           sa.aspect_code::text, s.calling_on_aspect::text, s.loop_aspect::text,
+           s.loop_signal_configuration::text, s.aspect_count::int4, s.possible_aspects::text[],
+           s.is_active::bool, s.location_description::text, s.current_aspect_id::int8,
+           s.id::int4, s.interlocked_with::int4[]
+    FROM railway_control.signals s
+    JOIN railway_config.signal_types st ON s.signal_type_id = st.id
+    LEFT JOIN railway_config.signal_aspects sa ON s.current_aspect_id = sa.id
+    WHERE s.station_id = $1
+    ORDER BY s.signal_id
+)";
+enum SignalColumn {
+    SignalId, SignalName, SignalType, SignalRow, SignalCol, SignalDirection, SignalAspect,
+    SignalCallingOn, SignalLoop, SignalLoopConfiguration, SignalAspectCount, SignalPossibleAspects,
+    SignalActive, SignalLocation, SignalAspectId, SignalDbId, SignalInterlockedWith, SignalColumnCount
+};
+constexpr Oid kSignalTypes[SignalColumnCount] = {
+    kTextOid, kTextOid, kTextOid, kFloat8Oid, kFloat8Oid, kTextOid, kTextOid, kTextOid, kTextOid,
+    kTextOid, kInt4Oid, kTextArrayOid, kBoolOid, kTextOid, kInt8Oid, kInt4Oid, kInt4ArrayOid
+};
+
+constexpr char kPointsSql[] = R"(
+    SELECT pm.machine_id::text, pm.machine_name::text, pm.junction_row::float8, pm.junction_col::float8,
+           pm.root_track_connection::jsonb, pm.normal_track_connection::jsonb,
+           pm.reverse_track_connection::jsonb, pp.position_code::text, pm.operating_status::text,
+           pm.transition_time_ms::int4, pm.id::int4, pm.safety_interlocks::int4[],
+           pm.is_locked::bool, pm.lock_reason::text
+    FROM railway_control.point_machines pm
+    LEFT JOIN railway_config.point_positions pp ON pm.current_position_id = pp.id
+    WHERE pm.station_id = $1
+    ORDER BY pm.machine_id
+)";
+enum PointColumn {
+    PointId, PointName, PointJunctionRow, PointJunctionCol, PointRootTrack, PointNormalTrack,
+    PointReverseTrack, PointPosition, PointStatus, PointTransitionTime, PointDbId,
+    PointSafetyInterlocks, PointLocked, PointLockReason, PointColumnCount
+};
+constexpr Oid kPointTypes[PointColumnCount] = {
+    kTextOid, kTextOid, kFloat8Oid, kFloat8Oid, kJsonbOid, kJsonbOid, kJsonbOid, kTextOid,
+    kTextOid, kInt4Oid, kInt4Oid, kInt4ArrayOid, kBoolOid, kTextOid
+};
+
+constexpr char kLabelsSql[] = R"(
+    SELECT id::text, label_text::text, position_row::float8, position_col::float8,
+           font_size::int4, color::text, font_family::text, is_visible::bool, label_type::text
+    FROM railway_control.text_labels
+    WHERE station_id = $1
+    ORDER BY id
+)";
+enum LabelColumn {
+    LabelId, LabelText, LabelRow, LabelCol, LabelFontSize, LabelColor, LabelFontFamily,
+    LabelVisible, LabelType, LabelColumnCount
+};
+constexpr Oid kLabelTypes[LabelColumnCount] = {
+    kTextOid, kTextOid, kFloat8Oid, kFloat8Oid, kInt4Oid, kTextOid, kTextOid, kBoolOid, kTextOid
+};
+
+// State columns only, in the same row order as the full reads (cached layout)
+constexpr char kTrackStatesSql[] = R"(
+    SELECT segment_id::text, is_occupied::bool, is_assigned::bool, occupied_by::text, is_active::bool
+    FROM railway_control.track_segments
+    WHERE station_id = $1
+    ORDER BY segment_id
+)";
+enum TrackStateColumn {
+    TrackStateId, TrackStateOccupied, TrackStateAssigned, TrackStateOccupiedBy, TrackStateActive,
+    TrackStateColumnCount
+};
+constexpr Oid kTrackStateTypes[TrackStateColumnCount] = {kTextOid, kBoolOid, kBoolOid, kTextOid, kBoolOid};
+
+constexpr char kSignalStatesSql[] = R"(
+    SELECT s.signal_id::text, sa.aspect_code::text, s.calling_on_aspect::text, s.loop_aspect::text,
+           s.is_active::bool, s.current_aspect_id::int8
+    FROM railway_control.signals s
+    LEFT JOIN railway_config.signal_aspects sa ON s.current_aspect_id = sa.id
+    WHERE s.station_id = $1
+    ORDER BY s.signal_id
+)";
+enum SignalStateColumn {
+    SignalStateId, SignalStateAspect, SignalStateCallingOn, SignalStateLoop, SignalStateActive,
+    SignalStateAspectId, SignalStateColumnCount
+};
+constexpr Oid kSignalStateTypes[SignalStateColumnCount] = {kTextOid, kTextOid, kTextOid, kTextOid, kBoolOid, kInt8Oid};
+
+constexpr char kPointStatesSql[] = R"(
+    SELECT pm.machine_id::text, pp.position_code::text, pm.operating_status::text,
+           pm.is_locked::bool, pm.lock_reason::text
+    FROM railway_control.point_machines pm
+    LEFT JOIN railway_config.point_positions pp ON pm.current_position_id = pp.id
+    WHERE pm.station_id = $1
+    ORDER BY pm.machine_id
+)";
+enum PointStateColumn {
+    PointStateId, PointStatePosition, PointStateStatus, PointStateLocked, PointStateLockReason,
+    PointStateColumnCount
+};
+constexpr Oid kPointStateTypes[PointStateColumnCount] = {kTextOid, kTextOid, kTextOid, kBoolOid, kTextOid};
+
+// ===== Binary field decoding (NULL reads as the type's zero value) =====
+class Row {
+public:
+    Row(const PGresult* result, int row) : m_result(result), m_row(row) {}
+
+    bool isNull(int column) const { return PQgetisnull(m_result, m_row, column); }
+    const char* data(int column) const { return PQgetvalue(m_result, m_row, column); }
+    int length(int column) const { return PQgetlength(m_result, m_row, column); }
+
+    QString text(int column) const
+    {
+        return isNull(column) ? QString() : QString::fromUtf8(data(column), length(column));
+    }
+
+    bool boolean(int column) const { return !isNull(column) && length(column) == 1 && data(column)[0] != 0; }
+
+    qint32 int4(int column) const
+    {
+        return isNull(column) || length(column) != 4 ? 0 : qFromBigEndian<qint32>(data(column));
+    }
+
+    qint64 int8(int column) const
+    {
+        return isNull(column) || length(column) != 8 ? 0 : qFromBigEndian<qint64>(data(column));
+    }
+
+    double float8(int column) const
+    {
+        if (isNull(column) || length(column) != 8) return 0.0;
+        const quint64 bits = qFromBigEndian<quint64>(data(column));
+        double value;
+        std::memcpy(&value, &bits, sizeof value);
+        return value;
+    }
+
+    // array_send layout: ndim, has-null flag, element OID, (size, lower bound) per
+    // dimension, then (length, bytes) per element; only 1-D arrays occur here
+    template <typename Element>
+    bool array(int column, Element element) const
+    {
+        if (isNull(column)) return true;
+        const char* p = data(column);
+        const char* end = p + length(column);
+        if (end - p < 12) return false;
+        const qint32 dimensions = qFromBigEndian<qint32>(p);
+        if (dimensions == 0) return true;
+        if (dimensions != 1 || end - p < 20) return false;
+        const qint32 count = qFromBigEndian<qint32>(p + 12);
+        p += 20;
+        for (qint32 i = 0; i < count; ++i) {
+            if (end - p < 4) return false;
+            const qint32 size = qFromBigEndian<qint32>(p);
+            p += 4;
+            if (size < 0) continue;   // NULL element
+            if (end - p < size) return false;
+            element(p, size);
+            p += size;
+        }
+        return true;
+    }
+
+    QVariantMap jsonb(int column) const
+    {
+        // jsonb_send: version byte (1) followed by the JSON text
+        if (isNull(column) || length(column) < 1 || data(column)[0] != 1) return QVariantMap();
+        return QJsonDocument::fromJson(QByteArray::fromRawData(data(column) + 1, length(column) - 1))
+            .object().toVariantMap();
+    }
+
+private:
+    const PGresult* m_result;
+    int m_row;
+};
+
+QVariantList int4Array(const Row& row, int column, bool* ok)
+{
+    QVariantList values;
+    *ok = row.array(column, [&](const char* data, qint32 size) {
+        if (size == 4) values.append(qFromBigEndian<qint32>(data));
+    }) && *ok;
+    return values;
+}
+
+QStringList textArray(const Row& row, int column, bool* ok)
+{
+    QStringList values;
+    *ok = row.array(column, [&](const char* data, qint32 size) {
+        values.append(QString::fromUtf8(data, size));
+    }) && *ok;
+    return values;
+}
+
+// Owns a PGresult
+struct Result {
+    explicit Result(PGresult* result) : result(result) {}
+    ~Result() { PQclear(result); }
+    Result(const Result&) = delete;
+    Result& operator=(const Result&) = delete;
+    PGresult* result;
+};
+
+} // namespace
+
+bool PgBinaryReader::isAvailable()
+{
+    return true;
+}
+
+PgBinaryReader::~PgBinaryReader()
+{
+    close();
+}
+
+bool PgBinaryReader::open(const QString& host, int port, const QString& database,
+                          const QString& user, const QString& password)
+{
+    close();
+
+    const QByteArray hostValue = host.toUtf8();
+    const QByteArray portValue = QByteArray::number(port);
+    const QByteArray databaseValue = database.toUtf8();
+    const QByteArray userValue = user.toUtf8();
+    const QByteArray passwordValue = password.toUtf8();
+    const char* keywords[] = {"host", "port", "dbname", "user", "password", "application_name", nullptr};
+    const char* values[] = {hostValue.constData(), portValue.constData(), databaseValue.constData(),
+                            userValue.constData(), passwordValue.constData(), "RailFlux binary reads", nullptr};
+
+    m_conn = PQconnectdbParams(keywords, values, 0);
+    if (PQstatus(m_conn) != CONNECTION_OK) {
+        m_lastError = QString::fromUtf8(PQerrorMessage(m_conn)).trimmed();
+        close();
+        return false;
+    }
+
+    const std::pair<const char*, const char*> statements[] = {
+        {kTracksStatement, kTracksSql}, {kSignalsStatement, kSignalsSql},
+        {kPointsStatement, kPointsSql}, {kLabelsStatement, kLabelsSql},
+        {kTrackStatesStatement, kTrackStatesSql}, {kSignalStatesStatement, kSignalStatesSql},
+        {kPointStatesStatement, kPointStatesSql}
+    };
+    for (const auto& [name, sql] : statements) {
+        Result prepared(PQprepare(m_conn, name, sql, 1, nullptr));
+        if (PQresultStatus(prepared.result) != PGRES_COMMAND_OK) {
+            m_lastError = QString::fromUtf8(PQresultErrorMessage(prepared.result)).trimmed();
+            close();
+            return false;
+        }
+    }
+
+    m_lastError.clear();
+    return true;
+}
+
+void PgBinaryReader::close()
+{
+    if (m_conn) {
+        PQfinish(m_conn);
+        m_conn = nullptr;
+    }
+}
+
+namespace {
+
+QString resultError(const PGresult* result)
+{
+    return QString::fromUtf8(PQresultErrorMessage(result)).trimmed();
+}
+
+// A binary tuple result with exactly the expected column types
+bool checkTuples(const PGresult* result, const char* statement, const Oid* types, int columnCount, QString* error)
+{
+    if (PQresultStatus(result) != PGRES_TUPLES_OK) {
+        *error = resultError(result);
+        return false;
+    }
+    if (PQnfields(result) != columnCount) {
+        *error = QStringLiteral("%1: unexpected column count %2").arg(QLatin1String(statement)).arg(PQnfields(result));
+        return false;
+    }
+    for (int column = 0; column < columnCount; ++column) {
+        if (PQftype(result, column) != types[column] || PQfformat(result, column) != 1) {
+            *error = QStringLiteral("%1: column %2 has type %3").arg(QLatin1String(statement)).arg(column).arg(PQftype(result, column));
+            return false;
+        }
+    }
+    return true;
+}
+
+void decodeTracks(const PGresult* result, QList<TrackSegmentInfo>* tracks)
+{
+    const int rowCount = PQntuples(result);
+    tracks->clear();
+    tracks->reserve(rowCount);
+    for (int r = 0; r < rowCount; ++r) {
+        const Row row(result, r);
+        TrackSegmentInfo track;
+        track.id = row.text(TrackId);
+        track.name = row.text(TrackName);
+        track.startRow = row.float8(TrackStartRow);
+        track.startCol = row.float8(TrackStartCol);
+        track.endRow = row.float8(TrackEndRow);
+        track.endCol = row.float8(TrackEndCol);
+        track.trackType = row.text(TrackType);
+        track.occupied = row.boolean(TrackOccupied);
+        track.assigned = row.boolean(TrackAssigned);
+        track.occupiedBy = row.text(TrackOccupiedBy);
+        track.isActive = row.boolean(TrackActive);
+        tracks->append(std::move(track));
+    }
+}
+
+bool decodeSignals(const PGresult* result, QList<SignalInfo>* signalList, QList<qint64>* aspectIds)
+{
+    const int rowCount = PQntuples(result);
+    bool ok = true;
+    signalList->clear();
+    signalList->reserve(rowCount);
+    aspectIds->clear();
+    aspectIds->reserve(rowCount);
+    for (int r = 0; r < rowCount; ++r) {
+        const Row row(result, r);
+        SignalInfo signal;
+        signal.id = row.text(SignalId);
+        signal.name = row.text(SignalName);
+        signal.type = row.text(SignalType);
+        signal.row = row.float8(SignalRow);
+        signal.col = row.float8(SignalCol);
+        signal.direction = row.text(SignalDirection);
+        signal.aspect = SignalInfo::aspectFromCode(row.text(SignalAspect));
+        signal.callingOn = SignalInfo::aspectFromCode(row.text(SignalCallingOn));
+        signal.loop = SignalInfo::aspectFromCode(row.text(SignalLoop));
+        signal.loopSignalConfiguration = row.text(SignalLoopConfiguration);
+        signal.aspectCount = row.int4(SignalAspectCount);
+        signal.possibleAspects = textArray(row, SignalPossibleAspects, &ok);
+        signal.isActive = row.boolean(SignalActive);
+        signal.location = row.text(SignalLocation);
+        signal.dbId = row.int4(SignalDbId);
+        signal.interlockedWith = int4Array(row, SignalInterlockedWith, &ok);
+        aspectIds->append(row.int8(SignalAspectId));
+        signalList->append(std::move(signal));
+    }
+    return ok;
+}
+
+bool decodePoints(const PGresult* result, QList<PointMachineInfo>* points)
+{
+    const int rowCount = PQntuples(result);
+    bool ok = true;
+    points->clear();
+    points->reserve(rowCount);
+    for (int r = 0; r < rowCount; ++r) {
+        const Row row(result, r);
+        PointMachineInfo pm;
+        pm.id = row.text(PointId);
+        pm.name = row.text(PointName);
+        pm.junctionPoint["row"] = row.float8(PointJunctionRow);
+        pm.junctionPoint["col"] = row.float8(PointJunctionCol);
+        pm.rootTrack = row.jsonb(PointRootTrack);
+        pm.normalTrack = row.jsonb(PointNormalTrack);
+        pm.reverseTrack = row.jsonb(PointReverseTrack);
+        pm.pointPosition = PointMachineInfo::positionFromCode(row.text(PointPosition));
+        pm.status = PointMachineInfo::statusFromCode(row.text(PointStatus));
+        pm.transitionTime = row.int4(PointTransitionTime);
+        pm.dbId = row.int4(PointDbId);
+        pm.safetyInterlocks = int4Array(row, PointSafetyInterlocks, &ok);
+        pm.isLocked = row.boolean(PointLocked);
+        pm.lockReason = row.text(PointLockReason);
+        points->append(std::move(pm));
+    }
+    return ok;
+}
+
+// Same keys as DatabaseManager::getTextLabelsList()
+void decodeLabels(const PGresult* result, QVariantList* labels)
+{
+    const int rowCount = PQntuples(result);
+    labels->clear();
+    labels->reserve(rowCount);
+    for (int r = 0; r < rowCount; ++r) {
+        const Row row(result, r);
+        QVariantMap label;
+        label["id"] = row.text(LabelId);
+        label["text"] = row.text(LabelText);
+        label["row"] = row.float8(LabelRow);
+        label["col"] = row.float8(LabelCol);
+        label["fontSize"] = row.int4(LabelFontSize);
+        label["color"] = row.text(LabelColor);
+        label["fontFamily"] = row.text(LabelFontFamily);
+        label["isVisible"] = row.boolean(LabelVisible);
+        label["type"] = row.text(LabelType);
+        labels->append(label);
+    }
+}
+
+// State merges: false when a row does not match the cached row at its index
+bool mergeTrackStates(const PGresult* result, QList<TrackSegmentInfo>* tracks)
+{
+    const int rowCount = PQntuples(result);
+    if (rowCount != tracks->size()) return false;
+    for (int r = 0; r < rowCount; ++r) {
+        const Row row(result, r);
+        TrackSegmentInfo& track = (*tracks)[r];
+        if (track.id != row.text(TrackStateId)) return false;
+        track.occupied = row.boolean(TrackStateOccupied);
+        track.assigned = row.boolean(TrackStateAssigned);
+        track.occupiedBy = row.text(TrackStateOccupiedBy);
+        track.isActive = row.boolean(TrackStateActive);
+    }
+    return true;
+}
+
+bool mergeSignalStates(const PGresult* result, QList<SignalInfo>* signalList, QList<qint64>* aspectIds)
+{
+    const int rowCount = PQntuples(result);
+    if (rowCount != signalList->size()) return false;
+    aspectIds->clear();
+    aspectIds->reserve(rowCount);
+    for (int r = 0; r < rowCount; ++r) {
+        const Row row(result, r);
+        SignalInfo& signal = (*signalList)[r];
+        if (signal.id != row.text(SignalStateId)) return false;
+        signal.aspect = SignalInfo::aspectFromCode(row.text(SignalStateAspect));
+        signal.callingOn = SignalInfo::aspectFromCode(row.text(SignalStateCallingOn));
+        signal.loop = SignalInfo::aspectFromCode(row.text(SignalStateLoop));
+        signal.isActive = row.boolean(SignalStateActive);
+        aspectIds->append(row.int8(SignalStateAspectId));
+    }
+    return true;
+}
+
+bool mergePointStates(const PGresult* result, QList<PointMachineInfo>* points)
+{
+    const int rowCount = PQntuples(result);
+    if (rowCount != points->size()) return false;
+    for (int r = 0; r < rowCount; ++r) {
+        const Row row(result, r);
+        PointMachineInfo& pm = (*points)[r];
+        if (pm.id != row.text(PointStateId)) return false;
+        pm.pointPosition = PointMachineInfo::positionFromCode(row.text(PointStatePosition));
+        pm.status = PointMachineInfo::statusFromCode(row.text(PointStateStatus));
+        pm.isLocked = row.boolean(PointStateLocked);
+        pm.lockReason = row.text(PointStateLockReason);
+    }
+    return true;
+}
+
+const char* const kStationStatements[] = {kTracksStatement, kSignalsStatement, kPointsStatement, kLabelsStatement};
+const char* const kStationStateStatements[] = {kTrackStatesStatement, kSignalStatesStatement, kPointStatesStatement};
+
+PGresult* execute(PGconn* conn, const char* statement, const QString& stationId)
+{
+    const QByteArray station = stationId.toUtf8();
+    const char* values[] = {station.constData()};
+    return PQexecPrepared(conn, statement, 1, values, nullptr, nullptr, 1);
+}
+
+} // namespace
+
+bool PgBinaryReader::queryTrackSegments(const QString& stationId, QList<TrackSegmentInfo>* tracks)
+{
+    if (!m_conn) return false;
+    Result result(execute(m_conn, kTracksStatement, stationId));
+    if (!checkTuples(result.result, kTracksStatement, kTrackTypes, TrackColumnCount, &m_lastError)) return false;
+
+    decodeTracks(result.result, tracks);
+    return true;
+}
+
+bool PgBinaryReader::querySignals(const QString& stationId, QList<SignalInfo>* signalList, QList<qint64>* aspectIds)
+{
+    if (!m_conn) return false;
+    Result result(execute(m_conn, kSignalsStatement, stationId));
+    if (!checkTuples(result.result, kSignalsStatement, kSignalTypes, SignalColumnCount, &m_lastError)) return false;
+
+    if (!decodeSignals(result.result, signalList, aspectIds)) {
+        m_lastError = QStringLiteral("malformed array in signal rows");
+        return false;
+    }
+    return true;
+}
+
+bool PgBinaryReader::queryPointMachines(const QString& stationId, QList<PointMachineInfo>* points)
+{
+    if (!m_conn) return false;
+    Result result(execute(m_conn, kPointsStatement, stationId));
+    if (!checkTuples(result.result, kPointsStatement, kPointTypes, PointColumnCount, &m_lastError)) return false;
+
+    if (!decodePoints(result.result, points)) {
+        m_lastError = QStringLiteral("malformed array in point machine rows");
+        return false;
+    }
+    return true;
+}
+
+bool PgBinaryReader::queryStation(const QString& stationId, StationRows* rows)
+{
+    return querySnapshot(stationId, kStationStatements, int(std::size(kStationStatements)), [&](int index, const PGresult* result) {
+        switch (index) {
+        case 0:
+            if (!checkTuples(result, kTracksStatement, kTrackTypes, TrackColumnCount, &m_lastError)) return false;
+            decodeTracks(result, &rows->tracks);
+            return true;
+        case 1:
+            if (!checkTuples(result, kSignalsStatement, kSignalTypes, SignalColumnCount, &m_lastError)) return false;
+            if (decodeSignals(result, &rows->signalList, &rows->aspectIds)) return true;
+            m_lastError = QStringLiteral("malformed array in signal rows");
+            return false;
+        case 2:
+            if (!checkTuples(result, kPointsStatement, kPointTypes, PointColumnCount, &m_lastError)) return false;
+            if (decodePoints(result, &rows->points)) return true;
+            m_lastError = QStringLiteral("malformed array in point machine rows");
+            return false;
+        default:
+            if (!checkTuples(result, kLabelsStatement, kLabelTypes, LabelColumnCount, &m_lastError)) return false;
+            decodeLabels(result, &rows->labels);
+            return true;
+        }
+    });
+}
+
+bool PgBinaryReader::queryStationStates(const QString& stationId, StationRows* rows, bool* aligned)
+{
+    *aligned = true;
+    return querySnapshot(stationId, kStationStateStatements, int(std::size(kStationStateStatements)), [&](int index, const PGresult* result) {
+        switch (index) {
+        case 0:
+            if (!checkTuples(result, kTrackStatesStatement, kTrackStateTypes, TrackStateColumnCount, &m_lastError)) return false;
+            *aligned = *aligned && mergeTrackStates(result, &rows->tracks);
+            return true;
+        case 1:
+            if (!checkTuples(result, kSignalStatesStatement, kSignalStateTypes, SignalStateColumnCount, &m_lastError)) return false;
+            *aligned = *aligned && mergeSignalStates(result, &rows->signalList, &rows->aspectIds);
+            return true;
+        default:
+            if (!checkTuples(result, kPointStatesStatement, kPointStateTypes, PointStateColumnCount, &m_lastError)) return false;
+            *aligned = *aligned && mergePointStates(result, &rows->points);
+            return true;
+        }
+    });
+}
+
+bool PgBinaryReader::querySnapshot(const QString& stationId, const char* const* statements, int count,
+                                   const std::function<bool(int, const pg_result*)>& read)
+{
+    if (!m_conn) return false;
+
+    const QByteArray station = stationId.toUtf8();
+    const char* values[] = {station.constData()};
+    constexpr char kBegin[] = "BEGIN ISOLATION LEVEL REPEATABLE READ READ ONLY";
+
+    // Results arrive as BEGIN, the statements in order, COMMIT
+    auto readCommand = [&](int command, const PGresult* result) {
+        if (command > 0 && command <= count) return read(command - 1, result);
+        if (PQresultStatus(result) == PGRES_COMMAND_OK) return true;
+        m_lastError = resultError(result);
+        return false;
+    };
+
+#ifdef LIBPQ_HAS_PIPELINING
+    // BEGIN, the selects and COMMIT go out back to back and the server
+    // answers them in order after the single sync: one round trip
+    bool sent = PQenterPipelineMode(m_conn)
+                && PQsendQueryParams(m_conn, kBegin, 0, nullptr, nullptr, nullptr, nullptr, 0);
+    for (int i = 0; i < count; ++i) {
+        sent = sent && PQsendQueryPrepared(m_conn, statements[i], 1, values, nullptr, nullptr, 1);
+    }
+    sent = sent && PQsendQueryParams(m_conn, "COMMIT", 0, nullptr, nullptr, nullptr, nullptr, 0)
+                && PQpipelineSync(m_conn);
+    if (!sent) {
+        m_lastError = QString::fromUtf8(PQerrorMessage(m_conn)).trimmed();
+        close();   // pipeline state unknown; the next connect starts clean
+        return false;
+    }
+
+    // Each command yields its result then NULL; after an error the rest
+    // come back PGRES_PIPELINE_ABORTED and are only drained
+    bool ok = true;
+    for (int command = 0; command < count + 2; ++command) {
+        Result result(PQgetResult(m_conn));
+        while (PGresult* extra = PQgetResult(m_conn)) {
+            PQclear(extra);
+        }
+        if (ok) ok = readCommand(command, result.result);
+    }
+
+    Result sync(PQgetResult(m_conn));
+    if (PQresultStatus(sync.result) != PGRES_PIPELINE_SYNC || !PQexitPipelineMode(m_conn)) {
+        m_lastError = QString::fromUtf8(PQerrorMessage(m_conn)).trimmed();
+        close();
+        return false;
+    }
+#else
+    // Older libpq: same transaction, one round trip per statement
+    bool ok = true;
+    for (int command = 0; command < count + 2 && ok; ++command) {
+        PGresult* result = nullptr;
+        if (command == 0) {
+            result = PQexec(m_conn, kBegin);
+        } else if (command == count + 1) {
+            result = PQexec(m_conn, "COMMIT");
+        } else {
+            result = PQexecPrepared(m_conn, statements[command - 1], 1, values, nullptr, nullptr, 1);
+        }
+        Result owned(result);
+        ok = readCommand(command, owned.result);
+    }
+#endif
+
+    if (!ok && PQtransactionStatus(m_conn) != PQTRANS_IDLE) {
+        Result rollback(PQexec(m_conn, "ROLLBACK"));
+    }
+    return ok;
+}
+
+#else // !RAILFLUX_HAVE_LIBPQ
+
+bool PgBinaryReader::isAvailable()
+{
+    return false;
+}
+
+PgBinaryReader::~PgBinaryReader() = default;
+
+bool PgBinaryReader::open(const QString&, int, const QString&, const QString&, const QString&)
+{
+    m_lastError = QStringLiteral("built without libpq");
+    return false;
+}
+
+void PgBinaryReader::close()
+{
+}
+
+bool PgBinaryReader::queryTrackSegments(const QString&, QList<TrackSegmentInfo>*)
+{
+    return false;
+}
+
+bool PgBinaryReader::querySignals(const QString&, QList<SignalInfo>*, QList<qint64>*)
+{
+    return false;
+}
+
+bool PgBinaryReader::queryPointMachines(const QString&, QList<PointMachineInfo>*)
+{
+    return false;
+}
+
+bool PgBinaryReader::queryStation(const QString&, StationRows*)
+{
+    return false;
+}
+
+bool PgBinaryReader::queryStationStates(const QString&, StationRows*, bool* aligned)
+{
+    *aligned = false;
+    return false;
+}
+
+bool PgBinaryReader::querySnapshot(const QString&, const char* const*, int,
+                                   const std::function<bool(int, const pg_result*)>&)
+{
+    return false;
+}
+
+#endif // RAILFLUX_HAVE_LIBPQ
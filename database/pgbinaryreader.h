@@ -0,0 +1,73 @@
+#pragma once
+
+#include <QList>
+#include <QString>
+#include <QVariantList>
+
+#include <functional>
+
+#include "database/elementinfo.h"
+
+struct pg_conn;
+struct pg_result;
+
+// Direct libpq path for the hot list queries (tracks, signals, points).
+//
+// QPSQL fetches every column as text and converts it through QVariant;
+// here the statements are prepared once and results are requested in
+// binary format, so integers, booleans, doubles and arrays are decoded
+// straight into the value types without any string parsing. NUMERIC
+// coordinates are cast to float8 server-side. JSONB connection objects
+// are still parsed as JSON (their binary form is version byte + text).
+//
+// Only built with libpq (RAILFLUX_HAVE_LIBPQ); otherwise open() fails and
+// DatabaseManager keeps using QtSql. Every query also validates the result
+// column types, so a schema mismatch fails the call instead of misreading.
+class PgBinaryReader {
+public:
+    struct StationRows {
+        QList<TrackSegmentInfo> tracks;
+        QList<SignalInfo> signalList;
+        QList<qint64> aspectIds;
+        QList<PointMachineInfo> points;
+        QVariantList labels;   // text label row maps
+    };
+
+    PgBinaryReader() = default;
+    ~PgBinaryReader();
+    PgBinaryReader(const PgBinaryReader&) = delete;
+    PgBinaryReader& operator=(const PgBinaryReader&) = delete;
+
+    static bool isAvailable();
+
+    bool open(const QString& host, int port, const QString& database,
+              const QString& user, const QString& password);
+    void close();
+    bool isOpen() const { return m_conn != nullptr; }
+    const QString& lastError() const { return m_lastError; }
+
+    // false on any error (caller falls back); rows are in segment/signal/machine ID order
+    bool queryTrackSegments(const QString& stationId, QList<TrackSegmentInfo>* tracks);
+    bool querySignals(const QString& stationId, QList<SignalInfo>* signalList, QList<qint64>* aspectIds);
+    bool queryPointMachines(const QString& stationId, QList<PointMachineInfo>* points);
+
+    // All four station tables (including text labels) read in one REPEATABLE
+    // READ transaction, sent as a single libpq pipeline: one round trip and
+    // one snapshot. Needs a libpq with pipeline mode (PostgreSQL 14+ client).
+    bool queryStation(const QString& stationId, StationRows* rows);
+
+    // The same pipelined snapshot for a cached layout: only the state columns
+    // of tracks, signals and points travel, merged into `rows` (which holds
+    // the cached rows; labels are left alone). *aligned is false when the
+    // rows no longer line up with the cache, and the caller reads in full.
+    bool queryStationStates(const QString& stationId, StationRows* rows, bool* aligned);
+
+private:
+    // BEGIN REPEATABLE READ, the prepared statements, COMMIT as one pipeline;
+    // read(index, result) checks and decodes the result of statements[index]
+    bool querySnapshot(const QString& stationId, const char* const* statements, int count,
+                       const std::function<bool(int, const pg_result*)>& read);
+
+    pg_conn* m_conn = nullptr;
+    QString m_lastError;
+};
@@ -0,0 +1,207 @@
+#include "portableserver.h"
+#include "database/portprobe.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QProcess>
+#include <QTimer>
+#include <memory>
+
+PortableServer::PortableServer(QObject* parent)
+    : QObject(parent)
+{
+}
+
+void PortableServer::setRoot(const QString& rootDirectory)
+{
+    m_binDirectory = rootDirectory + "/database/postgresql/bin";
+    m_dataDirectory = rootDirectory + "/database/data";
+    m_logPath = rootDirectory + "/database/logs/postgresql.log";
+}
+
+bool PortableServer::isStarting() const
+{
+    return m_phase == Probing || m_phase == Initializing || m_phase == Launching || m_phase == WaitingReady;
+}
+
+QString PortableServer::tool(const QString& name) const
+{
+    return m_binDirectory + "/" + name + ".exe";
+}
+
+void PortableServer::enterPhase(Phase phase)
+{
+    const char* key = m_phase == Probing      ? "probe_ms"
+                    : m_phase == Initializing ? "initdb_ms"
+                    : m_phase == Launching    ? "pg_ctl_ms"
+                    : m_phase == WaitingReady ? "ready_wait_ms"
+                                              : nullptr;
+    if (key) m_timings[key] = m_phaseClock.elapsed();
+    m_phaseClock.restart();
+    m_phase = phase;
+}
+
+void PortableServer::prepare()
+{
+    if (m_phase != Idle || QDir(m_dataDirectory).exists() || !QFile::exists(tool("initdb"))) return;
+
+    m_timings.clear();
+    m_phaseClock.start();
+    initialize();
+}
+
+void PortableServer::start()
+{
+    m_startRequested = true;
+    if (isStarting()) return;   // a prepare() initdb continues into launch()
+
+    if (m_phase != Idle) m_timings.clear();
+    m_phaseClock.start();
+    enterPhase(Probing);
+
+    // A server left running (earlier session, other instance) is simply reused
+    PortProbe::probe(this, QStringLiteral("localhost"), m_port, kProbeTimeoutMs, [this](bool reachable) {
+        if (reachable) {
+            qDebug() << "✅ Portable PostgreSQL server already running";
+            enterPhase(Ready);
+            m_startRequested = false;
+            emit ready();
+            return;
+        }
+        if (!QFile::exists(tool("pg_ctl"))) {
+            fail("PostgreSQL binaries not found at " + m_binDirectory);
+            return;
+        }
+        if (QDir(m_dataDirectory).exists()) {
+            launch();
+        } else {
+            initialize();
+        }
+    });
+}
+
+void PortableServer::initialize()
+{
+    enterPhase(Initializing);
+    qDebug() << "🔧 Initializing portable database with postgres user...";
+
+    const QStringList arguments = {
+        "-D", m_dataDirectory,
+        "-U", "postgres",      // ✅ CHANGED: Use postgres user
+        "-A", "trust",         // ✅ Start with trust, convert later
+        "-E", "UTF8"
+    };
+    runTool("initdb", arguments, kInitdbTimeoutMs, [this](bool ok, const QString& output) {
+        if (!ok) {
+            fail("Database initialization failed: " + output);
+            return;
+        }
+        qDebug() << "✅ Portable database initialized with postgres user";
+        if (m_startRequested) {
+            launch();
+        } else {
+            enterPhase(Idle);
+        }
+    });
+}
+
+void PortableServer::launch()
+{
+    enterPhase(Launching);
+    QDir().mkpath(QFileInfo(m_logPath).path());
+    qDebug() << "🚀 Starting portable PostgreSQL server...";
+
+    // -W: return at once; readiness is probed below instead of pg_ctl's own wait
+    const QStringList arguments = {"-D", m_dataDirectory, "-l", m_logPath, "-W", "start"};
+    runTool("pg_ctl", arguments, kLaunchTimeoutMs, [this](bool ok, const QString& output) {
+        if (!ok) {
+            fail("PostgreSQL server start failed: " + output);
+            return;
+        }
+        m_launched = true;
+        enterPhase(WaitingReady);
+        waitReady();
+    });
+}
+
+void PortableServer::waitReady()
+{
+    PortProbe::probe(this, QStringLiteral("localhost"), m_port, kProbeTimeoutMs, [this](bool reachable) {
+        if (m_phase != WaitingReady) return;
+        if (reachable) {
+            enterPhase(Ready);
+            qDebug() << "✅ Portable PostgreSQL server accepting connections on port" << m_port << m_timings;
+            m_startRequested = false;
+            emit ready();
+            return;
+        }
+        if (m_phaseClock.elapsed() > kReadyTimeoutMs) {
+            fail(QStringLiteral("server not accepting connections after %1 ms").arg(kReadyTimeoutMs));
+            return;
+        }
+        QTimer::singleShot(kProbeIntervalMs, this, &PortableServer::waitReady);
+    });
+}
+
+void PortableServer::fail(const QString& reason)
+{
+    enterPhase(Failed);
+    qWarning() << "❌ Portable PostgreSQL:" << reason << m_timings;
+    // A failed prepare() only surfaces once the server is actually wanted (start() retries)
+    if (m_startRequested) {
+        m_startRequested = false;
+        emit failed(reason);
+    }
+}
+
+void PortableServer::runTool(const QString& name, const QStringList& arguments, int timeoutMs,
+                             std::function<void(bool ok, const QString& output)> done)
+{
+    auto* process = new QProcess(this);
+    auto* deadline = new QTimer(process);
+    deadline->setSingleShot(true);
+
+    auto finished = std::make_shared<bool>(false);
+    auto finish = [process, finished, done = std::move(done)](bool ok, const QString& output) {
+        if (*finished) return;
+        *finished = true;
+        process->deleteLater();
+        done(ok, output);
+    };
+
+    connect(process, &QProcess::finished, this, [process, finish](int exitCode, QProcess::ExitStatus status) {
+        finish(status == QProcess::NormalExit && exitCode == 0,
+               QString::fromLocal8Bit(process->readAllStandardError()).trimmed());
+    });
+    connect(process, &QProcess::errorOccurred, this, [process, finish](QProcess::ProcessError error) {
+        if (error == QProcess::FailedToStart) finish(false, process->errorString());
+    });
+    connect(deadline, &QTimer::timeout, this, [process, finish, name, timeoutMs]() {
+        process->kill();
+        finish(false, QStringLiteral("%1 timed out after %2 ms").arg(name).arg(timeoutMs));
+    });
+
+    qDebug() << "Command:" << tool(name) << arguments.join(" ");
+    deadline->start(timeoutMs);
+    process->start(tool(name), arguments);
+}
+
+bool PortableServer::stop(int timeoutMs)
+{
+    if (!m_launched) return true;
+    m_launched = false;
+
+    QProcess stopProcess;
+    qDebug() << "🛑 Stopping portable PostgreSQL server...";
+    stopProcess.start(tool("pg_ctl"), {"-D", m_dataDirectory, "stop"});
+
+    if (stopProcess.waitForFinished(timeoutMs)) {
+        qDebug() << "✅ PostgreSQL server stopped successfully";
+        return true;
+    }
+
+    qDebug() << "⚠️ PostgreSQL server stop timed out";
+    return false;
+}
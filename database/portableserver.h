@@ -0,0 +1,73 @@
+#pragma once
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QVariantMap>
+#include <functional>
+
+// The bundled PostgreSQL under <app root>/database (postgresql/bin, data,
+// logs), brought up without blocking the GUI thread.
+//
+// start() first probes the port (a server left running is reused as is),
+// runs initdb only when the data directory is missing, launches the server
+// with `pg_ctl start -W` and then polls the port every kProbeIntervalMs
+// until it accepts. Every step is an asynchronous QProcess or socket.
+// prepare() starts the slow initdb up front, before it is known whether
+// the portable server is needed at all, so it overlaps with the system
+// server probe and QML engine loading. Each phase's duration lands in
+// phaseTimings() (initdb_ms, probe_ms, pg_ctl_ms, ready_wait_ms).
+class PortableServer : public QObject {
+    Q_OBJECT
+
+public:
+    explicit PortableServer(QObject* parent = nullptr);
+
+    void setRoot(const QString& rootDirectory);
+    void setPort(int port) { m_port = port; }
+    int port() const { return m_port; }
+
+    // Runs initdb now if the data directory is missing; no signals
+    void prepare();
+    // Emits ready() once the port accepts, or failed()
+    void start();
+    bool isStarting() const;
+    bool isReady() const { return m_phase == Ready; }
+    // Stops the server if start() launched it (shutdown path, blocks up to timeoutMs)
+    bool stop(int timeoutMs = 5000);
+
+    const QVariantMap& phaseTimings() const { return m_timings; }
+
+signals:
+    void ready();
+    void failed(const QString& reason);
+
+private:
+    enum Phase { Idle, Probing, Initializing, Launching, WaitingReady, Ready, Failed };
+
+    static constexpr int kProbeTimeoutMs = 250;
+    static constexpr int kProbeIntervalMs = 100;
+    static constexpr int kInitdbTimeoutMs = 120000;
+    static constexpr int kLaunchTimeoutMs = 15000;
+    static constexpr int kReadyTimeoutMs = 60000;
+
+    void enterPhase(Phase phase);
+    void initialize();
+    void launch();
+    void waitReady();
+    void fail(const QString& reason);
+    QString tool(const QString& name) const;
+    void runTool(const QString& name, const QStringList& arguments, int timeoutMs,
+                 std::function<void(bool ok, const QString& output)> done);
+
+    QString m_binDirectory;
+    QString m_dataDirectory;
+    QString m_logPath;
+    int m_port = 5433;
+    Phase m_phase = Idle;
+    QElapsedTimer m_phaseClock;
+    QVariantMap m_timings;
+    bool m_startRequested = false;
+    bool m_launched = false;   // this process started the server (stop() owns it)
+};
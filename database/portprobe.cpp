@@ -0,0 +1,35 @@
+#include "portprobe.h"
+
+#include <QTcpSocket>
+#include <QTimer>
+#include <memory>
+
+namespace PortProbe {
+
+void probe(QObject* context, const QString& hostName, int port, int timeoutMs,
+           std::function<void(bool reachable)> done)
+{
+    auto* socket = new QTcpSocket(context);
+    auto* timeout = new QTimer(socket);
+    timeout->setSingleShot(true);
+
+    auto finished = std::make_shared<bool>(false);
+    auto finish = [socket, finished, done = std::move(done)](bool reachable) {
+        if (*finished) return;
+        *finished = true;
+        socket->abort();
+        socket->deleteLater();
+        done(reachable);
+    };
+
+    QObject::connect(socket, &QTcpSocket::connected, socket, [finish]() { finish(true); });
+    QObject::connect(socket, &QTcpSocket::errorOccurred, socket, [finish](QAbstractSocket::SocketError) {
+        finish(false);
+    });
+    QObject::connect(timeout, &QTimer::timeout, socket, [finish]() { finish(false); });
+
+    timeout->start(timeoutMs);
+    socket->connectToHost(hostName, quint16(port));
+}
+
+} // namespace PortProbe
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <QString>
+#include <functional>
+
+class QObject;
+
+// One asynchronous TCP connect to host:port. `done` runs exactly once:
+// true as soon as the port accepts, false on refusal, error or after
+// timeoutMs. Nothing is reported if `context` is destroyed first.
+namespace PortProbe {
+
+void probe(QObject* context, const QString& hostName, int port, int timeoutMs,
+           std::function<void(bool reachable)> done);
+
+} // namespace PortProbe
@@ -0,0 +1,280 @@
+#include "stationgenerator.h"
+
+#include <QHash>
+#include <QJsonObject>
+#include <QSet>
+#include <QtMath>
+#include <algorithm>
+
+namespace {
+
+// Junction ends in the hand-written station sit 4-6 cells from the point
+const double kMaxJunctionDistance = 8.0;
+
+QString paddedId(const QString& prefix, int number)
+{
+    return QString("%1%2").arg(prefix).arg(number, 3, 10, QChar('0'));
+}
+
+QString lineSegmentId(int line, int segment)
+{
+    return QString("T%1S%2").arg(line + 1).arg(segment + 1);
+}
+
+QJsonObject trackConnection(const QString& trackId, const QString& connectionEnd)
+{
+    return QJsonObject{
+        {"trackId", trackId},
+        {"connectionEnd", connectionEnd},
+        {"offset", QJsonObject{{"row", 0}, {"col", 0}}}
+    };
+}
+
+QJsonObject signalObject(const QString& id, const QString& type, int row, int col, const QString& direction, const QString& location)
+{
+    QJsonObject signal{
+        {"id", id}, {"type", type},
+        {"row", row}, {"col", col}, {"direction", direction},
+        {"isActive", true}, {"location", location}
+    };
+
+    // Aspect configuration copied from the matching hand-written signals
+    if (type == "OUTER") {
+        signal["name"] = "Outer " + id;
+        signal["currentAspect"] = "DOUBLE_YELLOW";
+        signal["aspectCount"] = 4;
+        signal["possibleAspects"] = QJsonArray{"RED", "SINGLE_YELLOW", "DOUBLE_YELLOW", "GREEN"};
+    } else if (type == "HOME") {
+        signal["name"] = "Home " + id;
+        signal["currentAspect"] = "RED";
+        signal["aspectCount"] = 3;
+        signal["possibleAspects"] = QJsonArray{"RED", "YELLOW", "GREEN"};
+        signal["callingOnAspect"] = "DARK";
+        signal["loopAspect"] = "DARK";
+        signal["loopSignalConfiguration"] = "UR";
+    } else if (type == "STARTER") {
+        signal["name"] = "Starter " + id;
+        signal["currentAspect"] = "RED";
+        signal["aspectCount"] = 3;
+        signal["possibleAspects"] = QJsonArray{"RED", "YELLOW", "GREEN"};
+    } else {
+        signal["name"] = "Advanced Starter " + id;
+        signal["currentAspect"] = "RED";
+        signal["aspectCount"] = 2;
+        signal["possibleAspects"] = QJsonArray{"RED", "GREEN"};
+    }
+
+    return signal;
+}
+
+int crossoversPerLinePair(const StationGenerator::Parameters& parameters)
+{
+    // Crossovers start at even gaps j and need segment j+2 on the lower line
+    if (parameters.segmentsPerLine < 3) {
+        return 0;
+    }
+    return (parameters.segmentsPerLine - 3) / 2 + 1;
+}
+
+} // namespace
+
+StationGenerator::Parameters StationGenerator::Parameters::forScale(int factor)
+{
+    factor = std::max(1, factor);
+
+    Parameters parameters;
+    const int targetSegments = 16 * factor;
+
+    // Wider yards grow in both directions: ~2·√factor lines, the rest in length
+    parameters.lineCount = std::max(2, 2 * qCeil(qSqrt(factor)));
+    parameters.crossoverCount = std::max(1, targetSegments / 5);
+
+    const int lineSegments = targetSegments - parameters.crossoverCount;
+    parameters.segmentsPerLine = std::max(4, (lineSegments + parameters.lineCount - 1) / parameters.lineCount);
+    parameters.crossoverCount = std::min(parameters.crossoverCount, crossoverCapacity(parameters));
+
+    return parameters;
+}
+
+int StationGenerator::crossoverCapacity(const Parameters& parameters)
+{
+    return std::max(0, parameters.lineCount - 1) * crossoversPerLinePair(parameters);
+}
+
+StationData StationGenerator::generate(const Parameters& requested)
+{
+    Parameters parameters = requested;
+    parameters.lineCount = std::max(1, parameters.lineCount);
+    parameters.segmentsPerLine = std::max(4, parameters.segmentsPerLine);
+    parameters.crossoverCount = std::clamp(parameters.crossoverCount, 0, crossoverCapacity(parameters));
+
+    const int pitch = parameters.segmentLength + parameters.gapLength;
+    const int lastSegment = parameters.segmentsPerLine - 1;
+
+    auto lineRow = [&](int line) { return parameters.firstLineRow + line * parameters.lineSpacing; };
+    auto segmentStartCol = [&](int segment) { return segment * pitch; };
+    auto segmentEndCol = [&](int segment) { return segment * pitch + parameters.segmentLength; };
+    auto junctionCol = [&](int gap) { return segmentEndCol(gap) + parameters.gapLength / 2.0; };
+
+    StationData station;
+
+    // ===== Line segments and their labels =====
+    for (int line = 0; line < parameters.lineCount; ++line) {
+        const int row = lineRow(line);
+        for (int segment = 0; segment < parameters.segmentsPerLine; ++segment) {
+            const QString id = lineSegmentId(line, segment);
+            station.trackSegments.append(QJsonObject{
+                {"id", id},
+                {"startRow", row}, {"startCol", segmentStartCol(segment)},
+                {"endRow", row}, {"endCol", segmentEndCol(segment)},
+                {"occupied", false}, {"assigned", false}
+            });
+            station.textLabels.append(QJsonObject{
+                {"text", id}, {"row", row - 3},
+                {"col", segmentStartCol(segment) + parameters.segmentLength / 2 - 2}, {"fontSize", 12}
+            });
+        }
+    }
+
+    // ===== Crossovers =====
+    // Round-robin over line pairs so crossovers spread across the whole yard
+    int crossoverNumber = 0;
+    int pointNumber = 0;
+    const int perPair = crossoversPerLinePair(parameters);
+    for (int slot = 0; slot < perPair && crossoverNumber < parameters.crossoverCount; ++slot) {
+        for (int pair = 0; pair + 1 < parameters.lineCount && crossoverNumber < parameters.crossoverCount; ++pair) {
+            const int gap = slot * 2;
+            const int upperRow = lineRow(pair);
+            const int lowerRow = lineRow(pair + 1);
+            const double upperJunction = junctionCol(gap);
+            const double lowerJunction = junctionCol(gap + 1);
+
+            ++crossoverNumber;
+            const QString diagonalId = QString("X%1S1").arg(crossoverNumber);
+            station.trackSegments.append(QJsonObject{
+                {"id", diagonalId},
+                {"startRow", upperRow + 4}, {"startCol", upperJunction + 4},
+                {"endRow", lowerRow - 4}, {"endCol", lowerJunction - 4},
+                {"occupied", false}, {"assigned", false}
+            });
+
+            // Facing point on the upper line (PM001 pattern)
+            station.pointMachines.append(QJsonObject{
+                {"id", paddedId("PM", ++pointNumber)}, {"name", QString("Crossover %1 A").arg(crossoverNumber)},
+                {"position", "NORMAL"}, {"operatingStatus", "CONNECTED"},
+                {"junctionPoint", QJsonObject{{"row", upperRow}, {"col", upperJunction}}},
+                {"rootTrack", trackConnection(lineSegmentId(pair, gap), "END")},
+                {"normalTrack", trackConnection(lineSegmentId(pair, gap + 1), "START")},
+                {"reverseTrack", trackConnection(diagonalId, "START")}
+            });
+
+            // Trailing point on the lower line (PM002 pattern)
+            station.pointMachines.append(QJsonObject{
+                {"id", paddedId("PM", ++pointNumber)}, {"name", QString("Crossover %1 B").arg(crossoverNumber)},
+                {"position", "NORMAL"}, {"operatingStatus", "CONNECTED"},
+                {"junctionPoint", QJsonObject{{"row", lowerRow}, {"col", lowerJunction}}},
+                {"rootTrack", trackConnection(lineSegmentId(pair + 1, gap + 2), "START")},
+                {"normalTrack", trackConnection(lineSegmentId(pair + 1, gap + 1), "END")},
+                {"reverseTrack", trackConnection(diagonalId, "END")}
+            });
+        }
+    }
+
+    // ===== Signals =====
+    // UP signals sit above the line facing increasing columns, DOWN below it
+    int outerNumber = 0, homeNumber = 0, starterNumber = 0, advancedNumber = 0;
+    const int starterInterval = 4;
+    for (int line = 0; line < parameters.lineCount; ++line) {
+        const int upRow = lineRow(line) - 8;
+        const int downRow = lineRow(line) + 5;
+        const QString lineName = QString("Line_%1").arg(line + 1);
+
+        station.signalList.append(signalObject(paddedId("OT", ++outerNumber), "OUTER", upRow,
+                                               segmentStartCol(0) + parameters.segmentLength / 2, "UP", lineName + "_Approach_Up"));
+        station.signalList.append(signalObject(paddedId("HM", ++homeNumber), "HOME", upRow,
+                                               segmentEndCol(1) - 2, "UP", lineName + "_Entry_Up"));
+        station.signalList.append(signalObject(paddedId("AS", ++advancedNumber), "ADVANCED_STARTER", upRow,
+                                               segmentEndCol(lastSegment) - 2, "UP", lineName + "_Departure_Up"));
+
+        station.signalList.append(signalObject(paddedId("OT", ++outerNumber), "OUTER", downRow,
+                                               segmentStartCol(lastSegment) + parameters.segmentLength / 2, "DOWN", lineName + "_Approach_Down"));
+        station.signalList.append(signalObject(paddedId("HM", ++homeNumber), "HOME", downRow,
+                                               segmentStartCol(lastSegment - 1) + 2, "DOWN", lineName + "_Entry_Down"));
+        station.signalList.append(signalObject(paddedId("AS", ++advancedNumber), "ADVANCED_STARTER", downRow,
+                                               segmentStartCol(0) + 2, "DOWN", lineName + "_Departure_Down"));
+
+        // Intermediate starters protect every block of starterInterval segments
+        for (int segment = starterInterval; segment < lastSegment - 1; segment += starterInterval) {
+            station.signalList.append(signalObject(paddedId("ST", ++starterNumber), "STARTER", upRow,
+                                                   segmentEndCol(segment) - 2, "UP", QString("%1_Block_%2_Up").arg(lineName).arg(segment + 1)));
+            station.signalList.append(signalObject(paddedId("ST", ++starterNumber), "STARTER", downRow,
+                                                   segmentStartCol(segment) + 2, "DOWN", QString("%1_Block_%2_Down").arg(lineName).arg(segment + 1)));
+        }
+    }
+
+    // ===== Grid reference marks =====
+    const int totalCols = segmentEndCol(lastSegment);
+    for (int col = 50; col <= totalCols; col += 50) {
+        station.textLabels.append(QJsonObject{{"text", QString::number(col)}, {"row", 1}, {"col", col - 1}, {"fontSize", 12}});
+    }
+
+    return station;
+}
+
+bool StationGenerator::validate(const StationData& station, QString* error)
+{
+    auto fail = [error](const QString& message) {
+        if (error) *error = message;
+        return false;
+    };
+
+    QHash<QString, QJsonObject> tracks;
+    for (const auto& value : station.trackSegments) {
+        const QJsonObject track = value.toObject();
+        const QString id = track["id"].toString();
+        if (tracks.contains(id)) {
+            return fail(QString("Duplicate track segment: %1").arg(id));
+        }
+        tracks.insert(id, track);
+    }
+
+    QSet<QString> signalIds;
+    for (const auto& value : station.signalList) {
+        const QString id = value.toObject()["id"].toString();
+        if (signalIds.contains(id)) {
+            return fail(QString("Duplicate signal: %1").arg(id));
+        }
+        signalIds.insert(id);
+    }
+
+    QSet<QString> pointIds;
+    for (const auto& value : station.pointMachines) {
+        const QJsonObject point = value.toObject();
+        const QString id = point["id"].toString();
+        if (pointIds.contains(id)) {
+            return fail(QString("Duplicate point machine: %1").arg(id));
+        }
+        pointIds.insert(id);
+
+        const QJsonObject junction = point["junctionPoint"].toObject();
+        for (const char* key : {"rootTrack", "normalTrack", "reverseTrack"}) {
+            const QJsonObject connection = point[key].toObject();
+            const QString trackId = connection["trackId"].toString();
+            if (!tracks.contains(trackId)) {
+                return fail(QString("%1 %2 references unknown track %3").arg(id, QString::fromLatin1(key), trackId));
+            }
+
+            const QJsonObject track = tracks.value(trackId);
+            const bool atStart = connection["connectionEnd"].toString() == "START";
+            const double row = track[atStart ? "startRow" : "endRow"].toDouble();
+            const double col = track[atStart ? "startCol" : "endCol"].toDouble();
+            const double distance = qSqrt(qPow(row - junction["row"].toDouble(), 2) + qPow(col - junction["col"].toDouble(), 2));
+            if (distance > kMaxJunctionDistance) {
+                return fail(QString("%1 %2 end of %3 is %4 cells from the junction")
+                                .arg(id, atStart ? "START" : "END", trackId).arg(distance, 0, 'f', 1));
+            }
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <QJsonArray>
+#include <QString>
+
+// Station content in the same JSON shape as the StationData.js conversion
+// functions in DatabaseInitializer, so both sources share one loader.
+struct StationData {
+    QJsonArray trackSegments;
+    QJsonArray signalList;
+    QJsonArray pointMachines;
+    QJsonArray textLabels;
+};
+
+// Builds topologically valid synthetic stations for scaling tests.
+//
+// Layout: lineCount parallel lines, each split into segmentsPerLine segments
+// separated by short gaps. A crossover joins gap j of line i to gap j+1 of
+// line i+1 with a diagonal segment and two point machines wired exactly like
+// PM001/PM002 in the hand-written station (root/normal on the line, reverse on
+// the diagonal). Crossovers of neighbouring line pairs use disjoint gaps so no
+// gap ever carries two point machines.
+class StationGenerator {
+public:
+    struct Parameters {
+        int lineCount = 2;
+        int segmentsPerLine = 8;
+        int crossoverCount = 2;
+        int lineSpacing = 22;      // grid rows between neighbouring lines
+        int segmentLength = 20;    // grid columns per segment
+        int gapLength = 10;        // grid columns between segments (junction space)
+        int firstLineRow = 20;
+
+        // Roughly factor × the built-in station (16 segments, 4 points, 10 signals)
+        static Parameters forScale(int factor);
+    };
+
+    static StationData generate(const Parameters& parameters);
+
+    // Largest crossoverCount the layout can hold without sharing a gap
+    static int crossoverCapacity(const Parameters& parameters);
+
+    // Checks unique IDs and that every point machine references existing
+    // segments whose connecting ends coincide with the junction gap.
+    static bool validate(const StationData& station, QString* error = nullptr);
+};
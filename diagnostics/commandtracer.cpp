@@ -0,0 +1,372 @@
+#include "commandtracer.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QRandomGenerator>
+#include <QStandardPaths>
+#include <QTimer>
+#include <QDebug>
+#include <QtAlgorithms>
+#include <chrono>
+
+// ============================================================================
+// LatencyHistogram
+// ============================================================================
+
+int LatencyHistogram::bucketIndex(qint64 value)
+{
+    if (value < 16) {
+        return value < 0 ? 0 : static_cast<int>(value);
+    }
+
+    const int exponent = 63 - qCountLeadingZeroBits(static_cast<quint64>(value));
+    const int subBucket = static_cast<int>((value >> (exponent - 3)) & (kSubBuckets - 1));
+    const int index = 16 + (exponent - 4) * kSubBuckets + subBucket;
+    return qMin(index, kBucketCount - 1);
+}
+
+qint64 LatencyHistogram::bucketUpperBound(int index)
+{
+    if (index < 16) {
+        return index;
+    }
+
+    const int exponent = (index - 16) / kSubBuckets + 4;
+    const int subBucket = (index - 16) % kSubBuckets;
+    const qint64 width = qint64(1) << (exponent - 3);
+    return (kSubBuckets + subBucket) * width + width - 1;
+}
+
+void LatencyHistogram::record(qint64 microseconds)
+{
+    microseconds = qMax<qint64>(0, microseconds);
+    ++m_buckets[bucketIndex(microseconds)];
+    ++m_count;
+    m_max = qMax(m_max, microseconds);
+}
+
+void LatencyHistogram::clear()
+{
+    m_buckets.fill(0);
+    m_count = 0;
+    m_max = 0;
+}
+
+qint64 LatencyHistogram::percentile(double fraction) const
+{
+    if (m_count == 0) {
+        return 0;
+    }
+
+    const qint64 target = qMax<qint64>(1, qint64(fraction * m_count + 0.999999));
+    qint64 cumulative = 0;
+    for (int i = 0; i < kBucketCount; ++i) {
+        cumulative += m_buckets[i];
+        if (cumulative >= target) {
+            return qMin(bucketUpperBound(i), m_max);
+        }
+    }
+    return m_max;
+}
+
+QJsonObject LatencyHistogram::toJson() const
+{
+    QJsonArray buckets;
+    for (int i = 0; i < kBucketCount; ++i) {
+        if (m_buckets[i] > 0) {
+            buckets.append(QJsonArray{bucketUpperBound(i), qint64(m_buckets[i])});
+        }
+    }
+
+    return QJsonObject{
+        {"count", m_count},
+        {"p50_us", percentile(0.50)},
+        {"p99_us", percentile(0.99)},
+        {"max_us", m_max},
+        {"buckets", buckets}   // [upper bound µs, count]
+    };
+}
+
+// ============================================================================
+// CommandTracer
+// ============================================================================
+
+namespace {
+qint64 wallClockMicroseconds()
+{
+    using namespace std::chrono;
+    return duration_cast<microseconds>(system_clock::now().time_since_epoch()).count();
+}
+
+// Stage name -> (from hop, to hop)
+struct Stage {
+    const char* name;
+    CommandTracer::Hop from;
+    CommandTracer::Hop to;
+};
+
+const Stage kStages[] = {
+    {"end_to_end",        CommandTracer::Issued,          CommandTracer::FrameSwapped},
+    {"sql",               CommandTracer::Issued,          CommandTracer::SqlReturned},
+    {"local_refresh",     CommandTracer::SqlReturned,     CommandTracer::LocalRefreshed},
+    {"render",            CommandTracer::LocalRefreshed,  CommandTracer::FrameSwapped},
+    {"server_commit",     CommandTracer::Issued,          CommandTracer::ServerCommitted},
+    {"notify_delivery",   CommandTracer::ServerCommitted, CommandTracer::NotifyReceived},
+    {"notify_refresh",    CommandTracer::NotifyReceived,  CommandTracer::NotifyRefreshed},
+    {"notify_round_trip", CommandTracer::Issued,          CommandTracer::NotifyRefreshed},
+};
+}
+
+CommandTracer::CommandTracer(QObject* parent)
+    : QObject(parent)
+    , m_sessionTag(QString::number(QRandomGenerator::global()->generate(), 16))
+{
+    m_clock.start();
+
+    QTimer* expiryTimer = new QTimer(this);
+    expiryTimer->setInterval(500);
+    connect(expiryTimer, &QTimer::timeout, this, &CommandTracer::expireStaleTraces);
+    expiryTimer->start();
+}
+
+QString CommandTracer::beginCommand(const QString& commandType, const QString& entityId)
+{
+    Trace trace;
+    trace.commandId = QString("%1-%2").arg(m_sessionTag).arg(m_nextSequence++);
+    trace.commandType = commandType;
+    trace.entityId = entityId;
+    trace.wallClockUs = wallClockMicroseconds();
+    trace.hopNs.fill(-1);
+    trace.hopNs[Issued] = nowNs();
+
+    const QString commandId = trace.commandId;
+    m_pending.insert(commandId, trace);
+    emit summaryChanged();   // pendingCount
+    return commandId;
+}
+
+void CommandTracer::recordHop(const QString& commandId, Hop hop)
+{
+    auto it = m_pending.find(commandId);
+    if (it == m_pending.end() || it->hopNs[hop] >= 0) {
+        return;
+    }
+
+    it->hopNs[hop] = nowNs();
+    maybeComplete(commandId);
+}
+
+void CommandTracer::recordServerTime(const QString& commandId, double serverEpochSeconds)
+{
+    auto it = m_pending.find(commandId);
+    if (it == m_pending.end() || serverEpochSeconds <= 0) {
+        return;
+    }
+
+    // Project the server wall clock onto the monotonic timeline of this trace
+    const qint64 serverUs = qint64(serverEpochSeconds * 1e6);
+    it->hopNs[ServerCommitted] = it->hopNs[Issued] + (serverUs - it->wallClockUs) * 1000;
+}
+
+void CommandTracer::failCommand(const QString& commandId)
+{
+    auto it = m_pending.find(commandId);
+    if (it == m_pending.end()) {
+        return;
+    }
+
+    it->failed = true;
+    maybeComplete(commandId);
+}
+
+void CommandTracer::recordFrameSwapped()
+{
+    m_lastFrameNs.store(nowNs(), std::memory_order_release);
+    if (!m_frameQueued.exchange(true)) {
+        QMetaObject::invokeMethod(this, &CommandTracer::processFrameSwapped, Qt::QueuedConnection);
+    }
+}
+
+void CommandTracer::processFrameSwapped()
+{
+    m_frameQueued.store(false);
+    const qint64 frameNs = m_lastFrameNs.load(std::memory_order_acquire);
+
+    QStringList touched;
+    for (auto it = m_pending.begin(); it != m_pending.end(); ++it) {
+        const qint64 refreshedNs = it->hopNs[LocalRefreshed];
+        if (refreshedNs >= 0 && it->hopNs[FrameSwapped] < 0 && refreshedNs <= frameNs) {
+            it->hopNs[FrameSwapped] = frameNs;
+            touched.append(it.key());
+        }
+    }
+
+    for (const QString& commandId : touched) {
+        maybeComplete(commandId);
+    }
+}
+
+void CommandTracer::expireStaleTraces()
+{
+    const qint64 cutoffNs = nowNs() - kNotifyTimeoutMs * 1000000;
+
+    QStringList expired;
+    for (auto it = m_pending.cbegin(); it != m_pending.cend(); ++it) {
+        if (it->hopNs[Issued] < cutoffNs) {
+            expired.append(it.key());
+        }
+    }
+
+    for (const QString& commandId : expired) {
+        auto it = m_pending.find(commandId);
+        Trace trace = *it;
+        m_pending.erase(it);
+        complete(trace);
+    }
+}
+
+void CommandTracer::maybeComplete(const QString& commandId)
+{
+    auto it = m_pending.find(commandId);
+    if (it == m_pending.end()) {
+        return;
+    }
+
+    const bool rendered = it->hopNs[FrameSwapped] >= 0;
+    const bool notified = it->hopNs[NotifyRefreshed] >= 0;
+    if (it->failed || (rendered && notified)) {
+        Trace trace = *it;
+        m_pending.erase(it);
+        complete(trace);
+    }
+}
+
+void CommandTracer::complete(Trace& trace)
+{
+    if (!trace.failed) {
+        QMap<QString, LatencyHistogram>& stages = m_histograms[trace.commandType];
+        for (const Stage& stage : kStages) {
+            const qint64 fromNs = trace.hopNs[stage.from];
+            const qint64 toNs = trace.hopNs[stage.to];
+            if (fromNs >= 0 && toNs >= 0) {
+                stages[QString::fromLatin1(stage.name)].record((toNs - fromNs) / 1000);
+            }
+        }
+    }
+
+    m_recent.push_back(trace);
+    while (m_recent.size() > kMaxRecentTraces) {
+        m_recent.pop_front();
+    }
+
+    ++m_completedCount;
+    emit summaryChanged();
+}
+
+QVariantList CommandTracer::summary() const
+{
+    QVariantList rows;
+    for (auto typeIt = m_histograms.cbegin(); typeIt != m_histograms.cend(); ++typeIt) {
+        for (const Stage& stage : kStages) {
+            const QString stageName = QString::fromLatin1(stage.name);
+            auto stageIt = typeIt->constFind(stageName);
+            if (stageIt == typeIt->cend()) {
+                continue;
+            }
+
+            QVariantMap row;
+            row["commandType"] = typeIt.key();
+            row["stage"] = stageName;
+            row["count"] = stageIt->count();
+            row["p50Ms"] = stageIt->percentile(0.50) / 1000.0;
+            row["p99Ms"] = stageIt->percentile(0.99) / 1000.0;
+            row["maxMs"] = stageIt->maxValue() / 1000.0;
+            rows.append(row);
+        }
+    }
+    return rows;
+}
+
+void CommandTracer::reset()
+{
+    m_pending.clear();
+    m_recent.clear();
+    m_histograms.clear();
+    m_completedCount = 0;
+    emit summaryChanged();
+}
+
+QString CommandTracer::hopName(int hop)
+{
+    static const char* const names[HopCount] = {
+        "issued", "sql_returned", "local_refreshed", "frame_swapped",
+        "server_committed", "notify_received", "notify_refreshed"
+    };
+    return QString::fromLatin1(names[hop]);
+}
+
+QJsonObject CommandTracer::traceToJson(const Trace& trace)
+{
+    QJsonObject hops;
+    for (int hop = 0; hop < HopCount; ++hop) {
+        if (trace.hopNs[hop] >= 0) {
+            hops[hopName(hop)] = double(trace.hopNs[hop] - trace.hopNs[Issued]) / 1000.0;   // µs since issue
+        }
+    }
+
+    return QJsonObject{
+        {"command_id", trace.commandId},
+        {"command_type", trace.commandType},
+        {"entity_id", trace.entityId},
+        {"issued_at", QDateTime::fromMSecsSinceEpoch(trace.wallClockUs / 1000).toString(Qt::ISODateWithMs)},
+        {"failed", trace.failed},
+        {"hops_us", hops}
+    };
+}
+
+QString CommandTracer::dumpToFile(const QString& filePath)
+{
+    QString path = filePath;
+    if (path.isEmpty()) {
+        QDir directory(QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation));
+        directory.mkpath("diagnostics");
+        path = directory.filePath(QString("diagnostics/command-latency-%1.json")
+                                      .arg(QDateTime::currentDateTime().toString("yyyyMMdd-hhmmss")));
+    }
+
+    QJsonObject histograms;
+    for (auto typeIt = m_histograms.cbegin(); typeIt != m_histograms.cend(); ++typeIt) {
+        QJsonObject stages;
+        for (auto stageIt = typeIt->cbegin(); stageIt != typeIt->cend(); ++stageIt) {
+            stages[stageIt.key()] = stageIt->toJson();
+        }
+        histograms[typeIt.key()] = stages;
+    }
+
+    QJsonArray traces;
+    for (const Trace& trace : m_recent) {
+        traces.append(traceToJson(trace));
+    }
+
+    QJsonObject report{
+        {"generated_at", QDateTime::currentDateTime().toString(Qt::ISODateWithMs)},
+        {"session", m_sessionTag},
+        {"completed", m_completedCount},
+        {"pending", m_pending.size()},
+        {"histograms", histograms},
+        {"recent_traces", traces}
+    };
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "❌ Cannot write latency dump:" << path << file.errorString();
+        return QString();
+    }
+    file.write(QJsonDocument(report).toJson(QJsonDocument::Indented));
+
+    qDebug() << "📊 Command latency dump written to" << path;
+    return path;
+}
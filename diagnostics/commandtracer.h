@@ -0,0 +1,126 @@
+#pragma once
+
+#include <QObject>
+#include <QHash>
+#include <QMap>
+#include <QVariantList>
+#include <QVariantMap>
+#include <QElapsedTimer>
+#include <QJsonObject>
+#include <array>
+#include <atomic>
+#include <deque>
+
+// Log-linear latency histogram (8 sub-buckets per power of two, ~12% error).
+// Fixed size, no allocation on record().
+class LatencyHistogram {
+public:
+    void record(qint64 microseconds);
+    void clear();
+
+    qint64 count() const { return m_count; }
+    qint64 maxValue() const { return m_max; }
+    qint64 percentile(double fraction) const;   // upper bound of the bucket
+
+    QJsonObject toJson() const;
+
+private:
+    static constexpr int kSubBuckets = 8;
+    static constexpr int kBucketCount = 16 + 44 * kSubBuckets;
+
+    static int bucketIndex(qint64 value);
+    static qint64 bucketUpperBound(int index);
+
+    std::array<quint32, kBucketCount> m_buckets{};
+    qint64 m_count = 0;
+    qint64 m_max = 0;
+};
+
+// End-to-end command latency tracing.
+//
+// Every operator command gets an ID when DatabaseManager issues it. The ID is
+// handed to PostgreSQL (set_config('railway.command_id')) so the notify
+// trigger echoes it back together with the server clock. Hops recorded:
+//
+//   Issued -> SqlReturned -> LocalRefreshed -> FrameSwapped
+//          -> ServerCommitted (payload clock) -> NotifyReceived -> NotifyRefreshed
+//
+// A trace is closed once the first frame after the local refresh has been
+// presented and the notification round trip has finished (or timed out).
+class CommandTracer : public QObject {
+    Q_OBJECT
+    Q_PROPERTY(QVariantList summary READ summary NOTIFY summaryChanged)
+    Q_PROPERTY(int completedCount READ completedCount NOTIFY summaryChanged)
+    Q_PROPERTY(int pendingCount READ pendingCount NOTIFY summaryChanged)
+
+public:
+    enum Hop {
+        Issued = 0,
+        SqlReturned,
+        LocalRefreshed,
+        FrameSwapped,
+        ServerCommitted,
+        NotifyReceived,
+        NotifyRefreshed,
+        HopCount
+    };
+    Q_ENUM(Hop)
+
+    explicit CommandTracer(QObject* parent = nullptr);
+
+    // Returns the command ID to pass to the database ("" when disabled)
+    QString beginCommand(const QString& commandType, const QString& entityId);
+    void recordHop(const QString& commandId, Hop hop);
+    void recordServerTime(const QString& commandId, double serverEpochSeconds);
+    void failCommand(const QString& commandId);
+
+    // Thread-safe: QQuickWindow::frameSwapped is emitted on the render thread
+    void recordFrameSwapped();
+
+    QVariantList summary() const;
+    int completedCount() const { return m_completedCount; }
+    int pendingCount() const { return m_pending.size(); }
+
+    Q_INVOKABLE void reset();
+    // Writes histograms and recent traces as JSON; returns the path or "" on failure
+    Q_INVOKABLE QString dumpToFile(const QString& filePath = QString());
+
+signals:
+    void summaryChanged();
+
+private slots:
+    void processFrameSwapped();
+    void expireStaleTraces();
+
+private:
+    struct Trace {
+        QString commandId;
+        QString commandType;
+        QString entityId;
+        qint64 wallClockUs = 0;                    // Issued, for comparing with the server clock
+        std::array<qint64, HopCount> hopNs;        // monotonic, -1 = not reached
+        bool failed = false;
+    };
+
+    static constexpr int kMaxRecentTraces = 256;
+    static constexpr qint64 kNotifyTimeoutMs = 2000;
+
+    qint64 nowNs() const { return m_clock.nsecsElapsed(); }
+    void maybeComplete(const QString& commandId);
+    void complete(Trace& trace);
+    static QString hopName(int hop);
+    static QJsonObject traceToJson(const Trace& trace);
+
+    QElapsedTimer m_clock;
+    QString m_sessionTag;
+    quint64 m_nextSequence = 1;
+    int m_completedCount = 0;
+
+    QHash<QString, Trace> m_pending;
+    std::deque<Trace> m_recent;
+    // commandType -> stage -> histogram
+    QMap<QString, QMap<QString, LatencyHistogram>> m_histograms;
+
+    std::atomic<qint64> m_lastFrameNs{-1};
+    std::atomic<bool> m_frameQueued{false};
+};
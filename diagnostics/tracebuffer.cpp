@@ -0,0 +1,299 @@
+#include "tracebuffer.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QStandardPaths>
+#include <QDebug>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#ifdef _WIN32
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+
+static_assert((TraceBuffer::kRecordsPerThread & (TraceBuffer::kRecordsPerThread - 1)) == 0,
+              "ring capacity must be a power of two");
+
+struct ThreadRing {
+    std::uint32_t threadIndex = 0;
+    std::atomic<std::uint64_t> head{0};   // total records ever written by the owner
+    std::unique_ptr<TraceRecord[]> records{new TraceRecord[TraceBuffer::kRecordsPerThread]};
+};
+
+// Rings are kept after their thread exits so its history is still dumped
+struct RingRegistry {
+    std::mutex mutex;
+    std::vector<std::shared_ptr<ThreadRing>> rings;
+};
+
+RingRegistry& registry()
+{
+    static RingRegistry instance;
+    return instance;
+}
+
+// Row is opt-in (see tracebuffer.h)
+std::atomic<std::uint32_t> g_enabledCategories{0xFFFFFFFFu & ~(1u << static_cast<unsigned>(TraceCategory::Row))};
+
+thread_local ThreadRing* t_ring = nullptr;
+
+ThreadRing* currentRing()
+{
+    if (!t_ring) {
+        auto ring = std::make_shared<ThreadRing>();
+        RingRegistry& rings = registry();
+        std::lock_guard<std::mutex> lock(rings.mutex);
+        ring->threadIndex = static_cast<std::uint32_t>(rings.rings.size());
+        rings.rings.push_back(ring);
+        t_ring = ring.get();
+    }
+    return t_ring;
+}
+
+inline std::uint64_t steadyNowNs()
+{
+    using namespace std::chrono;
+    return static_cast<std::uint64_t>(duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
+}
+
+// ============================================================================
+// CRASH DUMP
+// ============================================================================
+// Runs inside a signal handler: no allocation, no Qt, no blocking locks. The
+// path and clock offset are prepared when the handler is installed.
+
+std::string g_crashDumpPath;
+std::int64_t g_crashWallClockAtZeroNs = 0;
+
+int crashOpen(const char* path)
+{
+#ifdef _WIN32
+    return _open(path, _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+    return ::open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+#endif
+}
+
+bool crashWrite(int fd, const void* data, std::size_t size)
+{
+    const char* bytes = static_cast<const char*>(data);
+    while (size > 0) {
+#ifdef _WIN32
+        const int written = _write(fd, bytes, static_cast<unsigned>(std::min<std::size_t>(size, 1u << 30)));
+#else
+        const ssize_t written = ::write(fd, bytes, size);
+#endif
+        if (written <= 0) {
+            return false;
+        }
+        bytes += written;
+        size -= static_cast<std::size_t>(written);
+    }
+    return true;
+}
+
+void crashRewriteHeader(int fd, const TraceFileHeader& header)
+{
+#ifdef _WIN32
+    if (_lseek(fd, 0, SEEK_SET) == 0) crashWrite(fd, &header, sizeof(header));
+    _close(fd);
+#else
+    if (::lseek(fd, 0, SEEK_SET) == 0) crashWrite(fd, &header, sizeof(header));
+    ::close(fd);
+#endif
+}
+
+void writeCrashDump()
+{
+    RingRegistry& rings = registry();
+    if (!rings.mutex.try_lock()) {
+        return;   // crashed while a thread was registering its ring
+    }
+
+    const int fd = crashOpen(g_crashDumpPath.c_str());
+    if (fd < 0) {
+        rings.mutex.unlock();
+        return;
+    }
+
+    TraceFileHeader header{};
+    std::memcpy(header.magic, "RFTRACE1", sizeof(header.magic));
+    header.version = 1;
+    header.recordSize = sizeof(TraceRecord);
+    header.wallClockAtZeroNs = g_crashWallClockAtZeroNs;
+    crashWrite(fd, &header, sizeof(header));
+
+    // Other threads may still be tracing; the count is whatever was written
+    for (const auto& ring : rings.rings) {
+        const std::uint64_t head = ring->head.load(std::memory_order_acquire);
+        const std::uint64_t count = std::min<std::uint64_t>(head, TraceBuffer::kRecordsPerThread);
+        const std::uint64_t start = (head - count) & (TraceBuffer::kRecordsPerThread - 1);
+        const std::uint64_t firstPart = std::min<std::uint64_t>(count, TraceBuffer::kRecordsPerThread - start);
+
+        if (!crashWrite(fd, &ring->records[start], firstPart * sizeof(TraceRecord))
+            || !crashWrite(fd, &ring->records[0], (count - firstPart) * sizeof(TraceRecord))) {
+            break;
+        }
+        header.recordCount += count;
+    }
+
+    crashRewriteHeader(fd, header);
+    rings.mutex.unlock();
+}
+
+void onFatalSignal(int signalNumber)
+{
+    static std::atomic_flag dumping = ATOMIC_FLAG_INIT;
+    if (!dumping.test_and_set()) {
+        writeCrashDump();
+    }
+
+    std::signal(signalNumber, SIG_DFL);
+    std::raise(signalNumber);
+}
+
+} // namespace
+
+void TraceBuffer::record(TraceCategory category, TraceEvent event, QStringView text,
+                         std::int64_t arg0, std::int64_t arg1, std::int64_t arg2)
+{
+    if (!(g_enabledCategories.load(std::memory_order_relaxed) & (1u << static_cast<unsigned>(category)))) {
+        return;
+    }
+
+    ThreadRing* ring = currentRing();
+    const std::uint64_t index = ring->head.load(std::memory_order_relaxed);
+    TraceRecord& slot = ring->records[index & (kRecordsPerThread - 1)];
+
+    slot.timestampNs = steadyNowNs();
+    slot.threadIndex = ring->threadIndex;
+    slot.event = static_cast<std::uint16_t>(event);
+    slot.category = static_cast<std::uint8_t>(category);
+    slot.reserved = 0;
+    slot.args[0] = arg0;
+    slot.args[1] = arg1;
+    slot.args[2] = arg2;
+
+    // Entity IDs are ASCII; anything else is replaced rather than encoded
+    const qsizetype length = std::min<qsizetype>(text.size(), sizeof(slot.text) - 1);
+    for (qsizetype i = 0; i < length; ++i) {
+        const char16_t ch = text[i].unicode();
+        slot.text[i] = ch < 0x80 ? static_cast<char>(ch) : '?';
+    }
+    std::memset(slot.text + length, 0, sizeof(slot.text) - length);
+
+    ring->head.store(index + 1, std::memory_order_release);
+}
+
+void TraceBuffer::setCategoryEnabled(TraceCategory category, bool enabled)
+{
+    const std::uint32_t bit = 1u << static_cast<unsigned>(category);
+    if (enabled) {
+        g_enabledCategories.fetch_or(bit, std::memory_order_relaxed);
+    } else {
+        g_enabledCategories.fetch_and(~bit, std::memory_order_relaxed);
+    }
+}
+
+bool TraceBuffer::isCategoryEnabled(TraceCategory category)
+{
+    return traceCategoryCompiledIn(category)
+           && (g_enabledCategories.load(std::memory_order_relaxed) & (1u << static_cast<unsigned>(category)));
+}
+
+bool TraceBuffer::dumpToFile(const QString& filePath)
+{
+    std::vector<std::shared_ptr<ThreadRing>> rings;
+    {
+        std::lock_guard<std::mutex> lock(registry().mutex);
+        rings = registry().rings;
+    }
+
+    std::vector<TraceRecord> merged;
+    for (const auto& ring : rings) {
+        const std::uint64_t head = ring->head.load(std::memory_order_acquire);
+        const std::uint64_t count = std::min<std::uint64_t>(head, kRecordsPerThread);
+        const std::uint64_t first = head - count;
+
+        std::vector<TraceRecord> copy;
+        copy.reserve(count);
+        for (std::uint64_t i = first; i < head; ++i) {
+            copy.push_back(ring->records[i & (kRecordsPerThread - 1)]);
+        }
+
+        // The owner kept writing while we copied: drop slots it may have reused
+        const std::uint64_t headAfter = ring->head.load(std::memory_order_acquire);
+        const std::uint64_t validFrom = headAfter + 1 > kRecordsPerThread ? headAfter + 1 - kRecordsPerThread : 0;
+        const std::uint64_t skip = validFrom > first ? std::min<std::uint64_t>(validFrom - first, copy.size()) : 0;
+        merged.insert(merged.end(), copy.begin() + skip, copy.end());
+    }
+
+    std::stable_sort(merged.begin(), merged.end(), [](const TraceRecord& a, const TraceRecord& b) {
+        return a.timestampNs < b.timestampNs;
+    });
+
+    TraceFileHeader header{};
+    std::memcpy(header.magic, "RFTRACE1", sizeof(header.magic));
+    header.version = 1;
+    header.recordSize = sizeof(TraceRecord);
+    header.recordCount = merged.size();
+    header.wallClockAtZeroNs = QDateTime::currentMSecsSinceEpoch() * 1000000LL - static_cast<std::int64_t>(steadyNowNs());
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "❌ Cannot write trace dump:" << filePath << file.errorString();
+        return false;
+    }
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(merged.data()), static_cast<qint64>(merged.size() * sizeof(TraceRecord)));
+
+    qDebug() << "📼 Trace dump written:" << filePath << "(" << merged.size() << "records )";
+    return true;
+}
+
+QString TraceBuffer::defaultDumpPath()
+{
+    QDir directory(QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation));
+    directory.mkpath("diagnostics");
+    return directory.filePath(QString("diagnostics/trace-%1.rftrace")
+                                  .arg(QDateTime::currentDateTime().toString("yyyyMMdd-hhmmss")));
+}
+
+QString TraceBuffer::rollingDumpPath()
+{
+    QDir directory(QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation));
+    directory.mkpath("diagnostics");
+    return directory.filePath("diagnostics/trace-latest.rftrace");
+}
+
+void TraceBuffer::installCrashHandler(const QString& filePath)
+{
+    g_crashDumpPath = QFile::encodeName(filePath).toStdString();
+    g_crashWallClockAtZeroNs = QDateTime::currentMSecsSinceEpoch() * 1000000LL - static_cast<std::int64_t>(steadyNowNs());
+    registry();   // constructed here rather than inside the handler
+
+    for (int signalNumber : {SIGSEGV, SIGABRT, SIGFPE, SIGILL}) {
+        std::signal(signalNumber, onFatalSignal);
+    }
+#ifdef SIGBUS
+    std::signal(SIGBUS, onFatalSignal);
+#endif
+
+    qDebug() << "📼 Trace crash dump armed:" << filePath;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "traceevents.h"
+
+#include <QString>
+#include <QStringView>
+
+// Low-overhead binary tracing for hot paths.
+//
+// Each thread writes fixed-size TraceRecords into its own ring buffer (single
+// producer, no locks, no allocation after the first event on that thread).
+// Rings are only read when dumping, which writes a .rftrace file that
+// tools/tracedecode turns back into text.
+//
+//     RF_TRACE(Row, SignalRow, signalId, aspectId);
+//
+// Categories outside RAILFLUX_TRACE_CATEGORIES are removed at compile time;
+// compiled-in categories can additionally be muted at runtime. Row starts
+// muted: it writes one record per signal row on every load and would evict
+// the Update/Notify history from the ring within a few refreshes.
+class TraceBuffer {
+public:
+    static constexpr std::uint32_t kRecordsPerThread = 16384;   // 1 MiB per thread
+
+    static void record(TraceCategory category, TraceEvent event, QStringView text,
+                       std::int64_t arg0 = 0, std::int64_t arg1 = 0, std::int64_t arg2 = 0);
+
+    static void setCategoryEnabled(TraceCategory category, bool enabled);
+    static bool isCategoryEnabled(TraceCategory category);
+
+    // Merges all rings in timestamp order; safe to call while threads keep tracing
+    static bool dumpToFile(const QString& filePath);
+    static QString defaultDumpPath();
+    static QString rollingDumpPath();
+
+    // Writes the rings to filePath on SIGSEGV/SIGABRT/SIGFPE/SIGILL (and SIGBUS),
+    // then re-raises. Records are written ring by ring, unsorted; the decoder
+    // orders them.
+    static void installCrashHandler(const QString& filePath);
+};
+
+// The text argument is mandatory (pass {} when unused) so the macro stays
+// portable without __VA_OPT__.
+#define RF_TRACE(category, event, ...)                                                          \
+    do {                                                                                        \
+        if constexpr (traceCategoryCompiledIn(TraceCategory::category)) {                       \
+            TraceBuffer::record(TraceCategory::category, TraceEvent::event, __VA_ARGS__);       \
+        }                                                                                       \
+    } while (0)
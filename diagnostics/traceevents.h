@@ -0,0 +1,119 @@
+#pragma once
+
+// Binary trace format shared by the runtime (tracebuffer.cpp) and the offline
+// decoder (tools/tracedecode.cpp). Plain C++ so the decoder builds without Qt.
+
+#include <cstdint>
+
+// ============================================================================
+// COMPILE-TIME CATEGORY SELECTION
+// ============================================================================
+// Bit mask of categories compiled into the binary. Disabled categories cost
+// nothing: RF_TRACE expands to a discarded `if constexpr` branch.
+#ifndef RAILFLUX_TRACE_CATEGORIES
+#define RAILFLUX_TRACE_CATEGORIES 0xFFu
+#endif
+
+enum class TraceCategory : std::uint8_t {
+    Query      = 0,   // getter calls and row counts
+    Row        = 1,   // per-row values (signal aspects, ...)
+    Update     = 2,   // operator commands (safety relevant)
+    Notify     = 3,   // pg_notify deliveries (safety relevant)
+    Poll       = 4,   // periodic polling
+    Populate   = 5,   // DatabaseInitializer data load
+    Count
+};
+
+constexpr bool traceCategoryCompiledIn(TraceCategory category)
+{
+    return (RAILFLUX_TRACE_CATEGORIES >> static_cast<unsigned>(category)) & 1u;
+}
+
+inline const char* traceCategoryName(std::uint8_t category)
+{
+    static const char* const names[] = {
+        "QUERY", "ROW", "UPDATE", "NOTIFY", "POLL", "POPULATE"
+    };
+    return category < static_cast<std::uint8_t>(TraceCategory::Count) ? names[category] : "?";
+}
+
+// ============================================================================
+// EVENTS
+// ============================================================================
+// X(name, format). In the format, {t} is the inline text and {0}..{2} the
+// integer arguments. Append new events at the end: IDs are stored in files.
+#define RAILFLUX_TRACE_EVENTS(X) \
+    X(QueryTrackSegments,     "getTrackSegmentsList rows={0}") \
+    X(QueryAllSignals,        "getAllSignalsList rows={0}") \
+    X(QueryPointMachines,     "getAllPointMachinesList rows={0}") \
+    X(QueryTextLabels,        "getTextLabelsList rows={0}") \
+    X(QuerySignalById,        "getSignalById {t} found={0}") \
+    X(QueryTrackById,         "getTrackSegmentById {t} found={0}") \
+    X(QueryPointById,         "getPointMachineById {t} found={0}") \
+    X(SignalRow,              "signal {t} aspect_id={0}") \
+    X(NotificationReceived,   "notify {t} table={0} op={1}") \
+    X(PollCycle,              "poll cycle") \
+    X(UpdateResult,           "update {t} kind={0} success={1}") \
+    X(PopulateRow,            "populate {t} table={0}")
+
+enum class TraceEvent : std::uint16_t {
+#define RAILFLUX_TRACE_ENUM(name, format) name,
+    RAILFLUX_TRACE_EVENTS(RAILFLUX_TRACE_ENUM)
+#undef RAILFLUX_TRACE_ENUM
+    Count
+};
+
+inline const char* traceEventName(std::uint16_t event)
+{
+    static const char* const names[] = {
+#define RAILFLUX_TRACE_NAME(name, format) #name,
+        RAILFLUX_TRACE_EVENTS(RAILFLUX_TRACE_NAME)
+#undef RAILFLUX_TRACE_NAME
+    };
+    return event < static_cast<std::uint16_t>(TraceEvent::Count) ? names[event] : "?";
+}
+
+inline const char* traceEventFormat(std::uint16_t event)
+{
+    static const char* const formats[] = {
+#define RAILFLUX_TRACE_FORMAT(name, format) format,
+        RAILFLUX_TRACE_EVENTS(RAILFLUX_TRACE_FORMAT)
+#undef RAILFLUX_TRACE_FORMAT
+    };
+    return event < static_cast<std::uint16_t>(TraceEvent::Count) ? formats[event] : "";
+}
+
+// Small integer codes used as arguments instead of strings
+namespace TraceTable {
+enum : std::int64_t { Unknown = 0, TrackSegments, Signals, PointMachines, TextLabels };
+}
+namespace TraceOperation {
+enum : std::int64_t { Unknown = 0, Insert, Update, Delete };
+}
+namespace TraceUpdateKind {
+enum : std::int64_t { Unknown = 0, SignalAspect, PointPosition, TrackOccupancy, TrackAssignment, PointTransition };
+}
+
+// ============================================================================
+// RECORD AND FILE LAYOUT
+// ============================================================================
+
+struct TraceRecord {
+    std::uint64_t timestampNs;   // steady clock
+    std::uint32_t threadIndex;   // registration order of the writing thread
+    std::uint16_t event;
+    std::uint8_t category;
+    std::uint8_t reserved;
+    std::int64_t args[3];
+    char text[24];               // NUL-padded, truncated ASCII (entity IDs)
+};
+static_assert(sizeof(TraceRecord) == 64, "TraceRecord must stay one cache line");
+
+struct TraceFileHeader {
+    char magic[8];               // "RFTRACE1"
+    std::uint32_t version;       // 1
+    std::uint32_t recordSize;    // sizeof(TraceRecord)
+    std::uint64_t recordCount;
+    std::int64_t wallClockAtZeroNs;   // Unix time in ns when the steady clock read 0
+};
+static_assert(sizeof(TraceFileHeader) == 32, "TraceFileHeader layout is part of the file format");
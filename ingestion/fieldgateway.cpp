@@ -0,0 +1,426 @@
+#include "fieldgateway.h"
+#include "database/databasemanager.h"
+#include "topology/tracktopology.h"
+
+#include <QDebug>
+#include <QFile>
+#include <QHostAddress>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QUdpSocket>
+
+FieldGateway::FieldGateway(QObject* parent)
+    : QObject(parent)
+{
+    m_flushTimer.setSingleShot(true);
+    m_flushTimer.setInterval(m_flushIntervalMs);
+    connect(&m_flushTimer, &QTimer::timeout, this, &FieldGateway::flush);
+
+    m_replayTimer.setInterval(kReplayTickMs);
+    m_replayTimer.setTimerType(Qt::PreciseTimer);
+    connect(&m_replayTimer, &QTimer::timeout, this, &FieldGateway::onReplayTick);
+
+    m_debouncer.setDefaults(m_clearDelayMs, m_minDwellMs);
+    m_debounceClock.start();
+    m_debounceTimer.setInterval(TrackCircuitDebouncer::kTickMs);
+    m_debounceTimer.setTimerType(Qt::PreciseTimer);
+    connect(&m_debounceTimer, &QTimer::timeout, this, &FieldGateway::onDebounceTick);
+
+    m_window.start();
+}
+
+FieldGateway::~FieldGateway()
+{
+    close();
+}
+
+void FieldGateway::setTopology(TrackTopology* topology)
+{
+    if (m_topology) {
+        disconnect(m_topology, nullptr, this, nullptr);
+    }
+    m_topology = topology;
+    if (m_topology) {
+        connect(m_topology, &TrackTopology::topologyChanged, this, &FieldGateway::rebuildLookup);
+    }
+    rebuildLookup();
+}
+
+void FieldGateway::setDatabaseManager(DatabaseManager* manager)
+{
+    m_dbManager = manager;
+}
+
+void FieldGateway::setFlushIntervalMs(int intervalMs)
+{
+    intervalMs = qMax(1, intervalMs);
+    if (m_flushIntervalMs == intervalMs) return;
+    m_flushIntervalMs = intervalMs;
+    m_flushTimer.setInterval(intervalMs);
+    emit flushIntervalMsChanged();
+}
+
+void FieldGateway::setClearDelayMs(int delayMs)
+{
+    delayMs = qMax(0, delayMs);
+    if (m_clearDelayMs == delayMs) return;
+    m_clearDelayMs = delayMs;
+    m_debouncer.setDefaults(m_clearDelayMs, m_minDwellMs);
+    emit debounceSettingsChanged();
+}
+
+void FieldGateway::setMinDwellMs(int dwellMs)
+{
+    dwellMs = qMax(0, dwellMs);
+    if (m_minDwellMs == dwellMs) return;
+    m_minDwellMs = dwellMs;
+    m_debouncer.setDefaults(m_clearDelayMs, m_minDwellMs);
+    emit debounceSettingsChanged();
+}
+
+bool FieldGateway::setSegmentDebounce(const QString& segmentId, int clearDelayMs, int minDwellMs)
+{
+    const int segment = m_segmentLookup.value(segmentId.toLatin1(), -1);
+    if (segment < 0) {
+        qWarning() << "❌ Field gateway: unknown segment for debounce override:" << segmentId;
+        return false;
+    }
+
+    // Kept by ID so the override survives layout rebuilds
+    m_debounceOverrides.insert(segmentId, qMakePair(clearDelayMs, minDwellMs));
+    m_debouncer.setOverride(segment, clearDelayMs, minDwellMs);
+    return true;
+}
+
+int FieldGateway::udpPort() const
+{
+    return m_udp ? m_udp->localPort() : 0;
+}
+
+int FieldGateway::tcpPort() const
+{
+    return m_tcp ? m_tcp->serverPort() : 0;
+}
+
+void FieldGateway::rebuildLookup()
+{
+    m_segmentLookup.clear();
+    m_pointLookup.clear();
+    m_segmentIds.clear();
+    m_pointIds.clear();
+
+    const int segmentCount = m_topology ? m_topology->segmentCount() : 0;
+    const int pointCount = m_topology ? m_topology->pointCount() : 0;
+
+    m_segmentLookup.reserve(segmentCount);
+    for (int segment = 0; segment < segmentCount; ++segment) {
+        const QString& id = m_topology->segment(segment).id;
+        m_segmentIds.append(id);
+        m_segmentLookup.insert(id.toLatin1(), segment);
+    }
+    m_pointLookup.reserve(pointCount);
+    for (int point = 0; point < pointCount; ++point) {
+        const QString& id = m_topology->point(point).id;
+        m_pointIds.append(id);
+        m_pointLookup.insert(id.toLatin1(), point);
+    }
+
+    // Pending inputs refer to the old layout's indices
+    if (!m_dirtyTracks.isEmpty() || !m_dirtyPoints.isEmpty()) {
+        qWarning() << "📡 Layout changed, dropping" << pendingCount() << "pending field inputs";
+    }
+    m_pendingTracks.fill(-1, segmentCount);
+    m_pendingPoints.fill(-1, pointCount);
+    m_dirtyTracks.clear();
+    m_dirtyPoints.clear();
+
+    m_debounceTimer.stop();
+    m_debouncer.reset(segmentCount);
+    for (auto it = m_debounceOverrides.cbegin(); it != m_debounceOverrides.cend(); ++it) {
+        m_debouncer.setOverride(m_segmentLookup.value(it.key().toLatin1(), -1), it.value().first, it.value().second);
+    }
+}
+
+qsizetype FieldGateway::ingest(const char* data, qsizetype size, int maxFrames)
+{
+    qsizetype offset = 0;
+    int frames = 0;
+
+    while (offset < size && (maxFrames < 0 || frames < maxFrames)) {
+        Telegram::Frame frame;
+        qsizetype consumed = 0;
+        const Telegram::DecodeResult result = Telegram::decode(data + offset, size - offset, &frame, &consumed);
+        if (result == Telegram::DecodeResult::NeedMore) break;
+
+        offset += consumed;
+        if (result == Telegram::DecodeResult::Malformed) {
+            ++m_rejected;
+            continue;
+        }
+        accept(frame);
+        ++frames;
+    }
+    return offset;
+}
+
+void FieldGateway::accept(const Telegram::Frame& frame)
+{
+    ++m_received;
+    ++m_windowReceived;
+
+    // fromRawData: hash lookup without copying the ID
+    const QByteArray key = QByteArray::fromRawData(frame.elementId.data(), frame.elementId.size());
+
+    if (frame.type == Telegram::TrackCircuit) {
+        const int segment = m_segmentLookup.value(key, -1);
+        if (segment < 0) {
+            ++m_rejected;
+            return;
+        }
+        // Occupied reports go straight through; clears wait for confirmation
+        const bool occupied = frame.state == Telegram::TrackOccupied;
+        if (m_debouncer.input(segment, occupied, m_debounceClock.elapsed())) {
+            queueTrack(segment, Telegram::TrackOccupied);
+        } else if (m_debouncer.hasPending() && !m_debounceTimer.isActive()) {
+            m_debounceTimer.start();
+        }
+    } else {
+        const int point = m_pointLookup.value(key, -1);
+        if (point < 0) {
+            ++m_rejected;
+            return;
+        }
+        if (m_pendingPoints[point] < 0) m_dirtyPoints.append(point);
+        m_pendingPoints[point] = qint8(frame.state);
+        startFlushTimer();
+    }
+}
+
+void FieldGateway::queueTrack(int segment, Telegram::TrackState state)
+{
+    if (m_pendingTracks[segment] < 0) m_dirtyTracks.append(segment);
+    m_pendingTracks[segment] = qint8(state);
+    startFlushTimer();
+}
+
+void FieldGateway::startFlushTimer()
+{
+    if (!m_flushTimer.isActive()) {
+        m_flushTimer.start();
+    }
+}
+
+void FieldGateway::onDebounceTick()
+{
+    m_debouncer.advance(m_debounceClock.elapsed(), [this](int segment) {
+        // A confirmed clear must not overwrite an occupation that is not
+        // written yet: if the write fails the occupation stays queued and the
+        // clear is confirmed again on the next clear report
+        if (m_pendingTracks[segment] == Telegram::TrackOccupied && !flush()) {
+            return false;
+        }
+        queueTrack(segment, Telegram::TrackClear);
+        return true;
+    });
+
+    if (!m_debouncer.hasPending()) {
+        m_debounceTimer.stop();
+    }
+}
+
+bool FieldGateway::flush()
+{
+    m_flushTimer.stop();
+
+    bool written = true;
+    if (!m_dirtyTracks.isEmpty() || !m_dirtyPoints.isEmpty()) {
+        QStringList segmentIds;
+        QList<bool> occupied;
+        segmentIds.reserve(m_dirtyTracks.size());
+        occupied.reserve(m_dirtyTracks.size());
+        for (int segment : std::as_const(m_dirtyTracks)) {
+            segmentIds.append(m_segmentIds[segment]);
+            occupied.append(m_pendingTracks[segment] == Telegram::TrackOccupied);
+        }
+
+        QStringList machineIds;
+        QStringList positions;
+        machineIds.reserve(m_dirtyPoints.size());
+        positions.reserve(m_dirtyPoints.size());
+        for (int point : std::as_const(m_dirtyPoints)) {
+            machineIds.append(m_pointIds[point]);
+            switch (m_pendingPoints[point]) {
+            case Telegram::DetectedNormal:  positions.append("NORMAL"); break;
+            case Telegram::DetectedReverse: positions.append("REVERSE"); break;
+            default:                        positions.append("NO_DETECTION"); break;
+            }
+        }
+
+        if (m_dbManager && m_dbManager->applyFieldInputs(segmentIds, occupied, machineIds, positions)) {
+            m_applied += segmentIds.size() + machineIds.size();
+            for (int segment : std::as_const(m_dirtyTracks)) m_pendingTracks[segment] = -1;
+            for (int point : std::as_const(m_dirtyPoints)) m_pendingPoints[point] = -1;
+            m_dirtyTracks.clear();
+            m_dirtyPoints.clear();
+        } else {
+            // Keep the coalesced state and retry on the next interval
+            m_flushTimer.start();
+            written = false;
+        }
+    }
+
+    if (m_window.elapsed() >= 1000) {
+        m_inputsPerSecond = m_windowReceived * 1000.0 / m_window.restart();
+        m_windowReceived = 0;
+    }
+    emit statisticsChanged();
+    return written;
+}
+
+bool FieldGateway::listen(int udpPort, int tcpPort)
+{
+    close();
+
+    bool ok = true;
+    if (udpPort > 0) {
+        m_udp = new QUdpSocket(this);
+        if (m_udp->bind(QHostAddress::LocalHost, quint16(udpPort))) {
+            connect(m_udp, &QUdpSocket::readyRead, this, &FieldGateway::onUdpReadyRead);
+        } else {
+            qWarning() << "❌ Field gateway: UDP bind on port" << udpPort << "failed:" << m_udp->errorString();
+            delete m_udp;
+            m_udp = nullptr;
+            ok = false;
+        }
+    }
+    if (tcpPort > 0) {
+        m_tcp = new QTcpServer(this);
+        if (m_tcp->listen(QHostAddress::LocalHost, quint16(tcpPort))) {
+            connect(m_tcp, &QTcpServer::newConnection, this, &FieldGateway::onNewTcpConnection);
+        } else {
+            qWarning() << "❌ Field gateway: TCP listen on port" << tcpPort << "failed:" << m_tcp->errorString();
+            delete m_tcp;
+            m_tcp = nullptr;
+            ok = false;
+        }
+    }
+
+    if (isListening()) {
+        qDebug() << "📡 Field gateway listening: UDP" << this->udpPort() << "TCP" << this->tcpPort();
+    }
+    emit listeningChanged();
+    return ok;
+}
+
+void FieldGateway::close()
+{
+    if (!isListening()) return;
+
+    for (auto it = m_streams.cbegin(); it != m_streams.cend(); ++it) {
+        it.key()->disconnect(this);
+        it.key()->abort();
+        it.key()->deleteLater();
+    }
+    m_streams.clear();
+
+    delete m_udp;
+    m_udp = nullptr;
+    delete m_tcp;
+    m_tcp = nullptr;
+
+    flush();
+    emit listeningChanged();
+}
+
+void FieldGateway::onUdpReadyRead()
+{
+    while (m_udp && m_udp->hasPendingDatagrams()) {
+        const qint64 size = m_udp->pendingDatagramSize();
+        if (size < 0) break;
+        m_datagram.resize(size);
+        const qint64 read = m_udp->readDatagram(m_datagram.data(), size);
+        if (read <= 0) continue;
+
+        // A datagram holds whole frames; a truncated tail is garbage
+        if (ingest(m_datagram.constData(), read) < read) {
+            ++m_rejected;
+        }
+    }
+}
+
+void FieldGateway::onNewTcpConnection()
+{
+    while (QTcpSocket* socket = m_tcp->nextPendingConnection()) {
+        m_streams.insert(socket, QByteArray());
+
+        connect(socket, &QTcpSocket::readyRead, this, [this, socket]() {
+            QByteArray& buffer = m_streams[socket];
+            buffer.append(socket->readAll());
+            const qsizetype consumed = ingest(buffer.constData(), buffer.size());
+            buffer.remove(0, consumed);
+        });
+        connect(socket, &QTcpSocket::disconnected, this, [this, socket]() {
+            m_streams.remove(socket);
+            socket->deleteLater();
+        });
+
+        qDebug() << "📡 Field gateway: equipment connected from" << socket->peerAddress().toString();
+    }
+}
+
+bool FieldGateway::replayFile(const QString& path, int telegramsPerSecond)
+{
+    stopReplay();
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "❌ Field gateway: cannot open replay file" << path << ":" << file.errorString();
+        return false;
+    }
+
+    m_replayData = file.readAll();
+    m_replayOffset = 0;
+    m_replayRate = qMax(0, telegramsPerSecond);
+    m_replayedFrames = 0;
+    m_replayClock.start();
+    m_replayTimer.start();
+
+    qDebug() << "📼 Replaying" << m_replayData.size() << "bytes of field telegrams from" << path
+             << (m_replayRate > 0 ? QString("at %1/s").arg(m_replayRate) : QString("unthrottled"));
+    emit replayingChanged();
+    return true;
+}
+
+void FieldGateway::stopReplay()
+{
+    if (!m_replayTimer.isActive()) return;
+
+    m_replayTimer.stop();
+    m_replayData.clear();
+    m_replayOffset = 0;
+    flush();
+    emit replayingChanged();
+}
+
+void FieldGateway::onReplayTick()
+{
+    int budget = kReplayBurstFrames;
+    if (m_replayRate > 0) {
+        const qint64 due = m_replayClock.elapsed() * m_replayRate / 1000;
+        budget = int(qMin<qint64>(due - m_replayedFrames, kReplayBurstFrames));
+    }
+
+    if (budget > 0) {
+        const qint64 receivedBefore = m_received;
+        const qsizetype consumed = ingest(m_replayData.constData() + m_replayOffset,
+                                          m_replayData.size() - m_replayOffset, budget);
+        m_replayOffset += consumed;
+        m_replayedFrames += m_received - receivedBefore;
+
+        // Nothing decodable left (end of file or a truncated final frame)
+        if (consumed == 0) {
+            qDebug() << "📼 Replay finished:" << m_replayedFrames << "telegrams";
+            stopReplay();
+        }
+    }
+}
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QPointer>
+#include <QString>
+#include <QStringList>
+#include <QTimer>
+
+#include "ingestion/telegram.h"
+#include "ingestion/trackcircuitdebouncer.h"
+
+class DatabaseManager;
+class TrackTopology;
+class QTcpServer;
+class QTcpSocket;
+class QUdpSocket;
+
+// Ingests track-circuit and point-detection telegrams from field equipment.
+//
+// Sources are a local UDP socket (one or more frames per datagram), a local
+// TCP server (framed byte stream per connection) and a capture file replayed
+// at a chosen rate as a stand-in for real equipment. Every frame is decoded
+// in place and validated against the current layout (unknown elements and
+// malformed frames are counted and dropped). Track circuit inputs then pass a
+// safety-biased debounce (TrackCircuitDebouncer: occupied immediately, clear
+// only once confirmed), so bobbing circuits do not turn into write storms.
+// Inputs are coalesced per element - only the latest state survives - and
+// written every flushIntervalMs through DatabaseManager::applyFieldInputs(),
+// one set-based round trip per flush however many telegrams arrived.
+class FieldGateway : public QObject {
+    Q_OBJECT
+    Q_PROPERTY(bool listening READ isListening NOTIFY listeningChanged)
+    Q_PROPERTY(int udpPort READ udpPort NOTIFY listeningChanged)
+    Q_PROPERTY(int tcpPort READ tcpPort NOTIFY listeningChanged)
+    Q_PROPERTY(bool replaying READ isReplaying NOTIFY replayingChanged)
+    Q_PROPERTY(int flushIntervalMs READ flushIntervalMs WRITE setFlushIntervalMs NOTIFY flushIntervalMsChanged)
+    Q_PROPERTY(qint64 receivedCount READ receivedCount NOTIFY statisticsChanged)
+    Q_PROPERTY(qint64 rejectedCount READ rejectedCount NOTIFY statisticsChanged)
+    Q_PROPERTY(qint64 appliedCount READ appliedCount NOTIFY statisticsChanged)
+    Q_PROPERTY(double inputsPerSecond READ inputsPerSecond NOTIFY statisticsChanged)
+    Q_PROPERTY(int pendingCount READ pendingCount NOTIFY statisticsChanged)
+    Q_PROPERTY(int clearDelayMs READ clearDelayMs WRITE setClearDelayMs NOTIFY debounceSettingsChanged)
+    Q_PROPERTY(int minDwellMs READ minDwellMs WRITE setMinDwellMs NOTIFY debounceSettingsChanged)
+    Q_PROPERTY(qint64 suppressedFlapCount READ suppressedFlapCount NOTIFY statisticsChanged)
+    Q_PROPERTY(qint64 duplicateInputCount READ duplicateInputCount NOTIFY statisticsChanged)
+    Q_PROPERTY(qint64 repeatedOccupationCount READ repeatedOccupationCount NOTIFY statisticsChanged)
+    Q_PROPERTY(int pendingClearCount READ pendingClearCount NOTIFY statisticsChanged)
+
+public:
+    explicit FieldGateway(QObject* parent = nullptr);
+    ~FieldGateway() override;
+
+    void setTopology(TrackTopology* topology);
+    void setDatabaseManager(DatabaseManager* manager);
+
+    bool isListening() const { return m_udp || m_tcp; }
+    int udpPort() const;
+    int tcpPort() const;
+    bool isReplaying() const { return m_replayTimer.isActive(); }
+
+    int flushIntervalMs() const { return m_flushIntervalMs; }
+    void setFlushIntervalMs(int intervalMs);
+
+    qint64 receivedCount() const { return m_received; }
+    qint64 rejectedCount() const { return m_rejected; }
+    qint64 appliedCount() const { return m_applied; }
+    double inputsPerSecond() const { return m_inputsPerSecond; }
+    int pendingCount() const { return m_dirtyTracks.size() + m_dirtyPoints.size(); }
+
+    // ===== Track circuit debounce =====
+    int clearDelayMs() const { return m_clearDelayMs; }
+    void setClearDelayMs(int delayMs);
+    int minDwellMs() const { return m_minDwellMs; }
+    void setMinDwellMs(int dwellMs);
+    qint64 suppressedFlapCount() const { return m_debouncer.statistics().suppressedFlaps; }
+    qint64 duplicateInputCount() const { return m_debouncer.statistics().duplicates; }
+    qint64 repeatedOccupationCount() const { return m_debouncer.statistics().repeatedOccupations; }
+    int pendingClearCount() const { return m_debouncer.pendingClears(); }
+
+    // Decodes up to `maxFrames` frames (-1 = all); returns the bytes consumed.
+    // A trailing partial frame is left for the caller to complete.
+    qsizetype ingest(const char* data, qsizetype size, int maxFrames = -1);
+
+    // ===== QML API =====
+    // Binds to localhost; a port of 0 leaves that transport closed
+    Q_INVOKABLE bool listen(int udpPort, int tcpPort);
+    Q_INVOKABLE void close();
+    // Replays a capture (concatenated frames); 0 telegrams/s = as fast as possible
+    Q_INVOKABLE bool replayFile(const QString& path, int telegramsPerSecond = 0);
+    Q_INVOKABLE void stopReplay();
+    // False while coalesced inputs are still waiting for a successful write
+    Q_INVOKABLE bool flush();
+    // Per-segment debounce timing for known bad circuits; -1 = gateway default
+    Q_INVOKABLE bool setSegmentDebounce(const QString& segmentId, int clearDelayMs, int minDwellMs);
+
+signals:
+    void listeningChanged();
+    void replayingChanged();
+    void flushIntervalMsChanged();
+    void debounceSettingsChanged();
+    void statisticsChanged();
+
+private slots:
+    void onUdpReadyRead();
+    void onNewTcpConnection();
+    void onReplayTick();
+    void onDebounceTick();
+
+private:
+    static constexpr int kReplayTickMs = 10;
+    static constexpr int kReplayBurstFrames = 20000;   // per tick when unthrottled
+
+    void rebuildLookup();
+    void accept(const Telegram::Frame& frame);
+    void queueTrack(int segment, Telegram::TrackState state);
+    void startFlushTimer();
+
+    TrackTopology* m_topology = nullptr;
+    QPointer<DatabaseManager> m_dbManager;   // destroyed before the gateway at shutdown
+
+    // ===== Layout validation (element ID -> topology index) =====
+    QHash<QByteArray, int> m_segmentLookup;
+    QHash<QByteArray, int> m_pointLookup;
+    QStringList m_segmentIds;
+    QStringList m_pointIds;
+
+    // ===== Coalesced pending inputs (latest state per element, -1 = none) =====
+    QList<qint8> m_pendingTracks;
+    QList<qint8> m_pendingPoints;
+    QList<int> m_dirtyTracks;
+    QList<int> m_dirtyPoints;
+    QTimer m_flushTimer;
+    int m_flushIntervalMs = 50;
+
+    // ===== Debounce =====
+    TrackCircuitDebouncer m_debouncer;
+    QHash<QString, QPair<int, int>> m_debounceOverrides;   // segment ID -> (clear delay, min dwell)
+    int m_clearDelayMs = 500;
+    int m_minDwellMs = 1000;
+    QElapsedTimer m_debounceClock;
+    QTimer m_debounceTimer;
+
+    // ===== Transports =====
+    QUdpSocket* m_udp = nullptr;
+    QTcpServer* m_tcp = nullptr;
+    QHash<QTcpSocket*, QByteArray> m_streams;   // unconsumed bytes per connection
+    QByteArray m_datagram;
+
+    // ===== Replay =====
+    QByteArray m_replayData;
+    qsizetype m_replayOffset = 0;
+    int m_replayRate = 0;
+    qint64 m_replayedFrames = 0;
+    QElapsedTimer m_replayClock;
+    QTimer m_replayTimer;
+
+    // ===== Statistics =====
+    qint64 m_received = 0;
+    qint64 m_rejected = 0;
+    qint64 m_applied = 0;
+    qint64 m_windowReceived = 0;
+    QElapsedTimer m_window;
+    double m_inputsPerSecond = 0.0;
+};
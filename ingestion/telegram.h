@@ -0,0 +1,113 @@
+#pragma once
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QtEndian>
+#include <QtGlobal>
+#include <cstring>
+
+// Framed binary telegram from field equipment.
+//
+//   offset  size  field
+//   0       2     magic "RF"
+//   2       1     version (1)
+//   3       1     type    (TrackCircuit, PointDetection)
+//   4       4     sequence number, big endian
+//   8       1     state   (TrackState / PointState)
+//   9       1     element ID length n (1..kMaxIdLength)
+//   10      n     element ID, ASCII (segment_id / machine_id)
+//
+// A datagram, TCP stream or replay file is simply a sequence of frames.
+// Decoding never allocates: the element ID is returned as a view into the
+// input buffer.
+namespace Telegram {
+
+constexpr char kMagic0 = 'R';
+constexpr char kMagic1 = 'F';
+constexpr quint8 kVersion = 1;
+constexpr int kHeaderSize = 10;
+constexpr int kMaxIdLength = 64;
+
+enum Type : quint8 {
+    TrackCircuit = 1,
+    PointDetection = 2
+};
+
+enum TrackState : quint8 {
+    TrackClear = 0,
+    TrackOccupied = 1
+};
+
+enum PointState : quint8 {
+    DetectedNormal = 0,
+    DetectedReverse = 1,
+    NoDetection = 2
+};
+
+struct Frame {
+    Type type = TrackCircuit;
+    quint32 sequence = 0;
+    quint8 state = 0;
+    QByteArrayView elementId;
+};
+
+enum class DecodeResult {
+    Ok,          // *frame is valid, *consumed bytes used
+    NeedMore,    // incomplete frame at the end of the buffer
+    Malformed    // garbage; skip *consumed bytes and try again
+};
+
+inline bool isValidState(Type type, quint8 state)
+{
+    return type == TrackCircuit ? state <= TrackOccupied : state <= NoDetection;
+}
+
+inline DecodeResult decode(const char* data, qsizetype size, Frame* frame, qsizetype* consumed)
+{
+    *consumed = 0;
+    if (size < 2) return DecodeResult::NeedMore;
+
+    if (data[0] != kMagic0 || data[1] != kMagic1) {
+        *consumed = 1;   // resynchronise on the next magic
+        return DecodeResult::Malformed;
+    }
+    if (size < kHeaderSize) return DecodeResult::NeedMore;
+
+    const quint8 version = quint8(data[2]);
+    const Type type = Type(quint8(data[3]));
+    const quint8 state = quint8(data[8]);
+    const int idLength = quint8(data[9]);
+
+    if (version != kVersion || (type != TrackCircuit && type != PointDetection)
+        || !isValidState(type, state) || idLength == 0 || idLength > kMaxIdLength) {
+        *consumed = 2;
+        return DecodeResult::Malformed;
+    }
+    if (size < kHeaderSize + idLength) return DecodeResult::NeedMore;
+
+    frame->type = type;
+    frame->sequence = qFromBigEndian<quint32>(data + 4);
+    frame->state = state;
+    frame->elementId = QByteArrayView(data + kHeaderSize, idLength);
+    *consumed = kHeaderSize + idLength;
+    return DecodeResult::Ok;
+}
+
+inline QByteArray encode(Type type, quint32 sequence, quint8 state, QByteArrayView elementId)
+{
+    const int idLength = int(qMin<qsizetype>(elementId.size(), kMaxIdLength));
+
+    QByteArray frame(kHeaderSize + idLength, Qt::Uninitialized);
+    char* out = frame.data();
+    out[0] = kMagic0;
+    out[1] = kMagic1;
+    out[2] = char(kVersion);
+    out[3] = char(type);
+    qToBigEndian<quint32>(sequence, out + 4);
+    out[8] = char(state);
+    out[9] = char(idLength);
+    memcpy(out + kHeaderSize, elementId.data(), idLength);
+    return frame;
+}
+
+} // namespace Telegram
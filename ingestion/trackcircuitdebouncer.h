@@ -0,0 +1,153 @@
+#pragma once
+
+#include <QList>
+#include <QtGlobal>
+
+#include "simulation/timerwheel.h"
+
+// Safety-biased debounce for track circuit inputs.
+//
+// Occupied is never delayed or dropped: every occupied report is passed on
+// to be written (the database skips rows that already match, and the
+// debouncer's idea of the applied state may be stale after a failed write).
+// Clear has to be confirmed: it is only applied once the circuit has
+// reported clear continuously for clearDelayMs and the segment has been
+// occupied for at least minDwellMs. An occupied report while a clear is
+// being confirmed cancels it (a suppressed flap); repeated clear reports
+// are dropped. A bobbing circuit therefore never writes a clear until it
+// has settled.
+//
+// Pending clears live on a timer wheel (O(1) schedule/cancel); advance()
+// must be called regularly with the same clock passed to input(). A
+// confirmed clear the caller could not queue stays unapplied, so the next
+// clear report confirms it again.
+class TrackCircuitDebouncer {
+public:
+    struct Statistics {
+        qint64 inputs = 0;
+        qint64 occupations = 0;          // occupied edges written immediately
+        qint64 repeatedOccupations = 0;  // occupied reports while already occupied (still written)
+        qint64 confirmedClears = 0;      // clears written after confirmation
+        qint64 suppressedFlaps = 0;      // clears cancelled by a new occupied report
+        qint64 duplicates = 0;           // clear reports while clear is applied or pending
+    };
+
+    static constexpr int kTickMs = 10;
+
+    void reset(int segmentCount)
+    {
+        m_circuits.fill(Circuit(), segmentCount);
+        m_wheel = TimerWheel<int>();
+        m_pendingClears = 0;
+    }
+
+    void setDefaults(int clearDelayMs, int minDwellMs)
+    {
+        m_clearDelayMs = qMax(0, clearDelayMs);
+        m_minDwellMs = qMax(0, minDwellMs);
+    }
+
+    // -1 falls back to the default
+    void setOverride(int segment, int clearDelayMs, int minDwellMs)
+    {
+        if (segment < 0 || segment >= m_circuits.size()) return;
+        m_circuits[segment].clearDelayMs = clearDelayMs;
+        m_circuits[segment].minDwellMs = minDwellMs;
+    }
+
+    int pendingClears() const { return m_pendingClears; }
+    bool hasPending() const { return m_pendingClears > 0; }
+    const Statistics& statistics() const { return m_statistics; }
+
+    // True when the input must be written now (every occupied report)
+    bool input(int segment, bool occupied, qint64 nowMs)
+    {
+        Circuit& circuit = m_circuits[segment];
+        ++m_statistics.inputs;
+
+        if (occupied) {
+            if (circuit.pendingClear != TimerWheel<int>::InvalidHandle) {
+                m_wheel.cancel(circuit.pendingClear);
+                circuit.pendingClear = TimerWheel<int>::InvalidHandle;
+                --m_pendingClears;
+                if (circuit.applied == Occupied) ++m_statistics.suppressedFlaps;
+            }
+
+            if (circuit.applied == Occupied) {
+                ++m_statistics.repeatedOccupations;
+            } else {
+                circuit.applied = Occupied;
+                circuit.occupiedAtMs = nowMs;
+                ++m_statistics.occupations;
+            }
+            return true;
+        }
+
+        if (circuit.applied == Clear || circuit.pendingClear != TimerWheel<int>::InvalidHandle) {
+            ++m_statistics.duplicates;
+            return false;
+        }
+
+        // Edge seen: confirm after the clear delay and the minimum dwell
+        const int clearDelayMs = circuit.clearDelayMs >= 0 ? circuit.clearDelayMs : m_clearDelayMs;
+        const int minDwellMs = circuit.minDwellMs >= 0 ? circuit.minDwellMs : m_minDwellMs;
+        qint64 dueMs = nowMs + clearDelayMs;
+        if (circuit.applied == Occupied) {
+            dueMs = qMax(dueMs, circuit.occupiedAtMs + minDwellMs);
+        }
+
+        // Scheduled on the absolute due tick (rounded up): while clears are
+        // pending the wheel only moves in advance(), so it may lag nowMs
+        syncWheel(nowMs);
+        const quint64 dueTick = quint64((dueMs + kTickMs - 1) / kTickMs);
+        circuit.pendingClear = m_wheel.schedule(dueTick - qMin(dueTick, m_wheel.now()), segment);
+        ++m_pendingClears;
+        return false;
+    }
+
+    // Calls onConfirmedClear(segment) for every clear that held long enough;
+    // the callback returns false when it could not queue the clear
+    template <typename Callback>
+    void advance(qint64 nowMs, Callback&& onConfirmedClear)
+    {
+        const quint64 target = quint64(nowMs / kTickMs);
+        if (target <= m_wheel.now()) return;
+
+        m_wheel.advance(target - m_wheel.now(), [&](int segment) {
+            Circuit& circuit = m_circuits[segment];
+            circuit.pendingClear = TimerWheel<int>::InvalidHandle;
+            --m_pendingClears;
+            if (onConfirmedClear(segment)) {
+                circuit.applied = Clear;
+                ++m_statistics.confirmedClears;
+            }
+        });
+    }
+
+private:
+    enum State : qint8 { Unknown = -1, Clear = 0, Occupied = 1 };
+
+    struct Circuit {
+        State applied = Unknown;
+        qint64 occupiedAtMs = 0;
+        TimerWheel<int>::Handle pendingClear = TimerWheel<int>::InvalidHandle;
+        int clearDelayMs = -1;
+        int minDwellMs = -1;
+    };
+
+    void syncWheel(qint64 nowMs)
+    {
+        // Idle wheel: jump to now so the delay counts from this input
+        const quint64 target = quint64(nowMs / kTickMs);
+        if (m_wheel.isEmpty() && target > m_wheel.now()) {
+            m_wheel.advance(target - m_wheel.now(), [](int) {});
+        }
+    }
+
+    QList<Circuit> m_circuits;
+    TimerWheel<int> m_wheel;
+    int m_pendingClears = 0;
+    int m_clearDelayMs = 500;
+    int m_minDwellMs = 1000;
+    Statistics m_statistics;
+};
@@ -0,0 +1,669 @@
+#include "interlockingengine.h"
+#include "database/databasemanager.h"
+#include "topology/tracktopology.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QtMath>
+#include <functional>
+
+namespace {
+
+// Signals stand 3-8 rows beside their track (UP above it, DOWN below it)
+const double kMaxSignalOffset = 10.0;
+// Longest route searched, in segments beyond the entry signal
+const int kMaxRouteLength = 32;
+
+} // namespace
+
+InterlockingEngine::InterlockingEngine(QObject* parent)
+    : QObject(parent)
+{
+}
+
+void InterlockingEngine::setTopology(TrackTopology* topology)
+{
+    if (m_topology) {
+        disconnect(m_topology, nullptr, this, nullptr);
+    }
+
+    m_topology = topology;
+    if (m_topology) {
+        connect(m_topology, &TrackTopology::topologyChanged, this, &InterlockingEngine::reload);
+    }
+}
+
+void InterlockingEngine::setDatabaseManager(DatabaseManager* manager)
+{
+    if (m_dbManager) {
+        disconnect(m_dbManager, nullptr, this, nullptr);
+    }
+
+    m_dbManager = manager;
+    if (!m_dbManager) return;
+
+    connect(m_dbManager, &DatabaseManager::connectionStateChanged, this, &InterlockingEngine::onConnectionStateChanged);
+    connect(m_dbManager, &DatabaseManager::trackSegmentUpdated, this, &InterlockingEngine::onTrackSegmentUpdated);
+    connect(m_dbManager, &DatabaseManager::signalUpdated, this, &InterlockingEngine::onSignalUpdated);
+    connect(m_dbManager, &DatabaseManager::pointMachineUpdated, this, &InterlockingEngine::onPointMachineUpdated);
+    connect(m_dbManager, &DatabaseManager::fieldInputsApplied, this, &InterlockingEngine::onFieldInputsApplied);
+}
+
+void InterlockingEngine::reload()
+{
+    if (!m_topology || !m_dbManager || !m_dbManager->isConnected()) {
+        return;
+    }
+    compile(m_dbManager->getAllSignalsList(), m_dbManager->getTrackSegmentsList(), m_dbManager->getAllPointMachinesList());
+}
+
+void InterlockingEngine::onConnectionStateChanged(bool connected)
+{
+    // A resumed session replays only the changed rows
+    if (connected && !m_dbManager->isStale()) {
+        reload();
+    }
+}
+
+void InterlockingEngine::onTrackSegmentUpdated(const QString& segmentId)
+{
+    const QVariantMap track = m_dbManager->getTrackSegmentById(segmentId);
+    if (!track.isEmpty()) {
+        setSegmentOccupied(segmentId, track["occupied"].toBool());
+    }
+}
+
+void InterlockingEngine::onSignalUpdated(const QString& signalId)
+{
+    const QVariantMap signal = m_dbManager->getSignalById(signalId);
+    if (!signal.isEmpty()) {
+        setSignalAspect(signalId, signal["currentAspect"].toString());
+    }
+}
+
+void InterlockingEngine::onPointMachineUpdated(const QString& machineId)
+{
+    const QVariantMap pm = m_dbManager->getPointMachineById(machineId);
+    if (!pm.isEmpty()) {
+        setPointState(machineId, pm["position"].toString(), pm["operatingStatus"].toString(), pm["isLocked"].toBool());
+    }
+}
+
+void InterlockingEngine::onFieldInputsApplied(const QVariantList& tracks, const QVariantList& pointMachines)
+{
+    if (!m_topology) return;
+
+    // The new states come with the batch: no row reads, one evaluation
+    for (const QVariant& value : tracks) {
+        const QVariantMap track = value.toMap();
+        const int index = m_topology->segmentIndex(track["id"].toString());
+        if (index >= 0 && index < m_occupied.size()) {
+            m_occupied.set(index, track["occupied"].toBool());
+        }
+    }
+    for (const QVariant& value : pointMachines) {
+        const QVariantMap pm = value.toMap();
+        const int index = m_topology->pointIndex(pm["id"].toString());
+        if (index >= 0 && index < m_pointsReverse.size()) {
+            m_pointsReverse.set(index, pm["position"].toString() == "REVERSE");
+            m_pointsUnavailable.set(index, pm["operatingStatus"].toString() != "CONNECTED");
+            m_pointsLocked.set(index, pm["isLocked"].toBool());
+        }
+    }
+    evaluate();
+}
+
+// ============================================================================
+// COMPILATION (once per layout)
+// ============================================================================
+
+bool InterlockingEngine::compile(const QVariantList& signalList, const QVariantList& trackSegments, const QVariantList& pointMachines)
+{
+    m_compiled = false;
+    if (!m_topology) return false;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    const int segmentCount = m_topology->segmentCount();
+    const int pointCount = m_topology->pointCount();
+
+    m_signals.clear();
+    m_signalIndex.clear();
+    m_signalsAtSegment.clear();
+    m_routes.clear();
+    m_routeIndex.clear();
+
+    placeSignals(signalList);
+    const int signalCount = m_signals.size();
+
+    for (int signal = 0; signal < signalCount; ++signal) {
+        compileRoutesFrom(signal);
+    }
+    compileConflicts();
+
+    // Database IDs used by interlocked_with / safety_interlocks
+    QHash<int, int> signalByDbId;
+    for (int i = 0; i < signalList.size(); ++i) {
+        signalByDbId.insert(signalList[i].toMap()["dbId"].toInt(), i);
+    }
+
+    m_signalsClear.resize(signalCount);
+    for (int i = 0; i < signalCount; ++i) {
+        const QVariantMap signal = signalList[i].toMap();
+        m_signals[i].interlockedSignals.resize(signalCount);
+        for (const QVariant& dbId : signal["interlockedWith"].toList()) {
+            const int other = signalByDbId.value(dbId.toInt(), -1);
+            if (other >= 0 && other != i) m_signals[i].interlockedSignals.set(other);
+        }
+        m_signalsClear.set(i, isProceedAspect(signal["currentAspect"].toString()));
+    }
+
+    m_occupied.resize(segmentCount);
+    for (const QVariant& item : trackSegments) {
+        const QVariantMap track = item.toMap();
+        const int index = m_topology->segmentIndex(track["id"].toString());
+        if (index >= 0) m_occupied.set(index, track["occupied"].toBool());
+    }
+
+    m_pointsReverse.resize(pointCount);
+    m_pointsUnavailable.resize(pointCount);
+    m_pointsLocked.resize(pointCount);
+    m_pointGuards = QList<RouteBitset>(pointCount, RouteBitset(signalCount));
+    for (const QVariant& item : pointMachines) {
+        const QVariantMap pm = item.toMap();
+        const int index = m_topology->pointIndex(pm["id"].toString());
+        if (index < 0) continue;
+
+        m_pointsReverse.set(index, pm["position"].toString() == "REVERSE");
+        m_pointsUnavailable.set(index, pm["operatingStatus"].toString() != "CONNECTED");
+        m_pointsLocked.set(index, pm["isLocked"].toBool());
+        for (const QVariant& dbId : pm["safetyInterlocks"].toList()) {
+            const int signal = signalByDbId.value(dbId.toInt(), -1);
+            if (signal >= 0) m_pointGuards[index].set(signal);
+        }
+    }
+
+    const int routeCount = m_routes.size();
+    m_setRoutes.resize(routeCount);
+    m_availableRoutes.resize(routeCount);
+    m_routeLockedPoints.resize(pointCount);
+
+    evaluate();
+
+    m_compiled = true;
+    m_compiledStation = m_dbManager ? m_dbManager->activeStation() : QString();
+    qDebug() << "🔐 Interlocking compiled:" << routeCount << "routes over" << segmentCount << "segments,"
+             << pointCount << "points," << signalCount << "signals in" << timer.elapsed() << "ms";
+
+    emit routesCompiled();
+    emit routeStatesChanged();
+    return true;
+}
+
+void InterlockingEngine::placeSignals(const QVariantList& signalList)
+{
+    // Nearest track beside each signal; runs once per layout load
+    m_signals.reserve(signalList.size());
+    for (const QVariant& item : signalList) {
+        const QVariantMap signal = item.toMap();
+
+        SignalInfo info;
+        info.id = signal["id"].toString();
+        info.up = signal["direction"].toString() == "UP";
+        info.col = signal["col"].toDouble();
+
+        const double row = signal["row"].toDouble();
+        double bestOffset = kMaxSignalOffset;
+        for (int i = 0; i < m_topology->segmentCount(); ++i) {
+            const TrackTopology::Segment& segment = m_topology->segment(i);
+            if (info.col < qMin(segment.startCol, segment.endCol) || info.col > qMax(segment.startCol, segment.endCol)) {
+                continue;
+            }
+
+            const double trackRow = qFuzzyCompare(segment.startCol, segment.endCol)
+                ? segment.startRow
+                : segment.startRow + (segment.endRow - segment.startRow) * (info.col - segment.startCol) / (segment.endCol - segment.startCol);
+            const double offset = trackRow - row;
+            if (info.up ? offset <= 0 : offset >= 0) continue;
+
+            if (qAbs(offset) < bestOffset) {
+                bestOffset = qAbs(offset);
+                info.segment = i;
+            }
+        }
+
+        if (info.segment < 0) {
+            qWarning() << "⚠️ Interlocking: signal" << info.id << "is not beside any track segment";
+        } else {
+            m_signalsAtSegment[info.segment].append(m_signals.size());
+        }
+
+        m_signalIndex.insert(info.id, m_signals.size());
+        m_signals.append(info);
+    }
+}
+
+void InterlockingEngine::compileRoutesFrom(int entrySignal)
+{
+    const SignalInfo& entry = m_signals[entrySignal];
+    if (entry.segment < 0) return;
+
+    const TrackTopology::Segment& first = m_topology->segment(entry.segment);
+    const bool increasing = first.endCol >= first.startCol;
+    const TrackTopology::TrackEnd firstExit = increasing == entry.up ? TrackTopology::AtEnd : TrackTopology::AtStart;
+
+    QList<int> pathSegments;
+    QList<QPair<int, TrackTopology::PointPosition>> pathPoints;
+
+    // First same-direction signal met when entering a segment at this end
+    auto exitSignalAt = [&](int segment, TrackTopology::TrackEnd entryEnd) {
+        const TrackTopology::Segment& s = m_topology->segment(segment);
+        const double entryCol = entryEnd == TrackTopology::AtStart ? s.startCol : s.endCol;
+        int best = -1;
+        for (int candidate : m_signalsAtSegment.value(segment)) {
+            if (m_signals[candidate].up != entry.up || candidate == entrySignal) continue;
+            if (best < 0 || qAbs(m_signals[candidate].col - entryCol) < qAbs(m_signals[best].col - entryCol)) {
+                best = candidate;
+            }
+        }
+        return best;
+    };
+
+    auto addRoute = [&](int exitSignal) {
+        Route route;
+        route.entrySignal = entrySignal;
+        route.exitSignal = exitSignal;
+        const QString exitId = routeExitId(route);
+        route.id = entry.id + "-" + exitId;
+        for (int n = 2; m_routeIndex.contains(route.id); ++n) {
+            route.id = QString("%1-%2/%3").arg(entry.id, exitId).arg(n);
+        }
+
+        route.segments.resize(m_topology->segmentCount());
+        route.pointsNormal.resize(m_topology->pointCount());
+        route.pointsReverse.resize(m_topology->pointCount());
+        route.points.resize(m_topology->pointCount());
+        for (int segment : pathSegments) route.segments.set(segment);
+        for (const auto& point : pathPoints) {
+            (point.second == TrackTopology::Normal ? route.pointsNormal : route.pointsReverse).set(point.first);
+            route.points.set(point.first);
+        }
+
+        m_routeIndex.insert(route.id, m_routes.size());
+        m_signals[entrySignal].routes.append(m_routes.size());
+        m_routes.append(route);
+    };
+
+    std::function<void(int, TrackTopology::TrackEnd)> walk = [&](int segment, TrackTopology::TrackEnd exitEnd) {
+        // Layout boundary or buffer stop: the path so far is the track ahead
+        const auto& links = m_topology->segment(segment).links[exitEnd];
+        if (links.isEmpty()) {
+            addRoute(-1);
+            return;
+        }
+
+        for (const TrackTopology::Link& link : links) {
+            const int next = link.to.segment;
+            if (next == entry.segment || pathSegments.contains(next)) continue;
+
+            // A point may be passed twice (crossover ends) but only in one position
+            bool opposing = false;
+            for (const auto& point : pathPoints) {
+                if (point.first == link.point && point.second != link.position) opposing = true;
+            }
+            if (opposing) continue;
+
+            if (link.point >= 0) pathPoints.append({link.point, link.position});
+            pathSegments.append(next);
+
+            const int exitSignal = exitSignalAt(next, link.to.end);
+            if (exitSignal >= 0) {
+                addRoute(exitSignal);
+            } else if (pathSegments.size() < kMaxRouteLength) {
+                walk(next, link.to.end == TrackTopology::AtStart ? TrackTopology::AtEnd : TrackTopology::AtStart);
+            }
+
+            pathSegments.removeLast();
+            if (link.point >= 0) pathPoints.removeLast();
+        }
+    };
+
+    walk(entry.segment, firstExit);
+}
+
+void InterlockingEngine::compileConflicts()
+{
+    // Quadratic in routes, once per layout load
+    const int routeCount = m_routes.size();
+    for (Route& route : m_routes) {
+        route.conflictingRoutes.resize(routeCount);
+    }
+
+    for (int a = 0; a < routeCount; ++a) {
+        for (int b = a + 1; b < routeCount; ++b) {
+            const Route& first = m_routes[a];
+            const Route& second = m_routes[b];
+            if (first.segments.intersects(second.segments)
+                || first.pointsNormal.intersects(second.pointsReverse)
+                || first.pointsReverse.intersects(second.pointsNormal)) {
+                m_routes[a].conflictingRoutes.set(b);
+                m_routes[b].conflictingRoutes.set(a);
+            }
+        }
+    }
+}
+
+// ============================================================================
+// EVALUATION (after every state change)
+// ============================================================================
+
+bool InterlockingEngine::isProceedAspect(const QString& aspect)
+{
+    return !aspect.isEmpty() && aspect != "RED";
+}
+
+bool InterlockingEngine::pointsLie(const Route& route) const
+{
+    return !route.pointsNormal.intersects(m_pointsReverse)
+           && route.pointsReverse.isSubsetOf(m_pointsReverse)
+           && !route.points.intersects(m_pointsUnavailable);
+}
+
+bool InterlockingEngine::pointsMoveable(const Route& route) const
+{
+    const quint64* normal = route.pointsNormal.words();
+    const quint64* reverse = route.pointsReverse.words();
+    const quint64* all = route.points.words();
+    const quint64* lying = m_pointsReverse.words();
+    const quint64* locked = m_pointsLocked.words();
+    const quint64* routeLocked = m_routeLockedPoints.words();
+    const quint64* unavailable = m_pointsUnavailable.words();
+
+    for (int i = 0; i < route.points.wordCount(); ++i) {
+        const quint64 toMove = (normal[i] & lying[i]) | (reverse[i] & ~lying[i]);
+        if ((toMove & (locked[i] | routeLocked[i])) || (all[i] & unavailable[i])) {
+            return false;
+        }
+
+        // safety_interlocks: guarding signals must be at danger before a throw
+        for (quint64 word = toMove; word; word &= word - 1) {
+            if (m_pointGuards[i * 64 + qCountTrailingZeroBits(word)].intersects(m_signalsClear)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void InterlockingEngine::evaluate()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    const RouteBitset previousSet = m_setRoutes;
+    const RouteBitset previousAvailable = m_availableRoutes;
+
+    m_setRoutes.clear();
+    m_routeLockedPoints.clear();
+    m_signalsClear.forEach([this](int signal) {
+        for (int index : m_signals[signal].routes) {
+            const Route& route = m_routes[index];
+            if (pointsLie(route)) {
+                m_setRoutes.set(index);
+                m_routeLockedPoints |= route.points;
+                break;
+            }
+        }
+    });
+
+    for (int index = 0; index < m_routes.size(); ++index) {
+        const Route& route = m_routes[index];
+        const bool available = !route.segments.intersects(m_occupied)
+                               && !route.conflictingRoutes.intersects(m_setRoutes)
+                               && !m_signals[route.entrySignal].interlockedSignals.intersects(m_signalsClear)
+                               && pointsMoveable(route);
+        m_availableRoutes.set(index, available);
+    }
+
+    m_lastEvaluationMicros = timer.nsecsElapsed() / 1000.0;
+
+    if (m_setRoutes != previousSet || m_availableRoutes != previousAvailable) {
+        emit routeStatesChanged();
+    }
+}
+
+void InterlockingEngine::setSegmentOccupied(const QString& segmentId, bool occupied)
+{
+    const int index = m_topology ? m_topology->segmentIndex(segmentId) : -1;
+    if (index < 0 || index >= m_occupied.size()) return;
+
+    m_occupied.set(index, occupied);
+    evaluate();
+}
+
+void InterlockingEngine::setSignalAspect(const QString& signalId, const QString& aspect)
+{
+    const int index = m_signalIndex.value(signalId, -1);
+    if (index < 0) return;
+
+    m_signalsClear.set(index, isProceedAspect(aspect));
+    evaluate();
+}
+
+void InterlockingEngine::setPointState(const QString& machineId, const QString& position, const QString& operatingStatus, bool isLocked)
+{
+    const int index = m_topology ? m_topology->pointIndex(machineId) : -1;
+    if (index < 0 || index >= m_pointsReverse.size()) return;
+
+    m_pointsReverse.set(index, position == "REVERSE");
+    m_pointsUnavailable.set(index, operatingStatus != "CONNECTED");
+    m_pointsLocked.set(index, isLocked);
+    evaluate();
+}
+
+// ============================================================================
+// CHECKS
+// ============================================================================
+
+bool InterlockingEngine::isCompiled() const
+{
+    // After a station switch the routes are void until the topology recompiles them
+    return m_compiled && (!m_dbManager || m_compiledStation == m_dbManager->activeStation());
+}
+
+bool InterlockingEngine::refuse(QString* reason, const QString& text)
+{
+    if (reason) *reason = text;
+    return false;
+}
+
+bool InterlockingEngine::canClearSignal(const QString& signalId, QString* reason) const
+{
+    if (!isCompiled()) return refuse(reason, "interlocking not compiled for this station");
+
+    const int index = m_signalIndex.value(signalId, -1);
+    if (index < 0) return refuse(reason, QString("signal %1 is unknown to the interlocking").arg(signalId));
+
+    const SignalInfo& signal = m_signals[index];
+    if (signal.interlockedSignals.intersects(m_signalsClear)) {
+        return refuse(reason, "an interlocked signal is not at danger");
+    }
+
+    // No compiled route: nothing vouches for the track ahead
+    if (signal.routes.isEmpty()) {
+        return refuse(reason, signal.segment < 0
+            ? QString("signal %1 is not placed on any track").arg(signalId)
+            : QString("no route found from %1").arg(signalId));
+    }
+
+    int candidate = -1;
+    for (int route : signal.routes) {
+        if (!pointsLie(m_routes[route])) continue;
+        if (m_availableRoutes.test(route) || m_setRoutes.test(route)) return true;
+        if (candidate < 0) candidate = route;
+    }
+
+    return refuse(reason, candidate >= 0
+        ? conflictsOf(candidate).join("; ")
+        : QString("points are not set for any route from %1").arg(signalId));
+}
+
+bool InterlockingEngine::canThrowPoint(const QString& machineId, QString* reason) const
+{
+    if (!isCompiled()) return refuse(reason, "interlocking not compiled for this station");
+
+    const int index = m_topology ? m_topology->pointIndex(machineId) : -1;
+    if (index < 0 || index >= m_pointsLocked.size()) {
+        return refuse(reason, QString("point %1 is unknown to the interlocking").arg(machineId));
+    }
+
+    if (m_pointsLocked.test(index)) {
+        return refuse(reason, "point is locked");
+    }
+    if (m_routeLockedPoints.test(index)) {
+        QString routeId;
+        m_setRoutes.forEach([&](int route) {
+            if (routeId.isEmpty() && m_routes[route].points.test(index)) routeId = m_routes[route].id;
+        });
+        return refuse(reason, QString("point is locked by route %1").arg(routeId));
+    }
+    if (m_pointGuards[index].intersects(m_signalsClear)) {
+        return refuse(reason, "a guarding signal is not at danger");
+    }
+
+    const TrackTopology::Point& point = m_topology->point(index);
+    for (const TrackTopology::Branch* branch : {&point.root, &point.normal, &point.reverse}) {
+        if (branch->track.isValid() && m_occupied.test(branch->track.segment)) {
+            return refuse(reason, QString("track %1 is occupied").arg(m_topology->segment(branch->track.segment).id));
+        }
+    }
+    return true;
+}
+
+bool InterlockingEngine::isSegmentOccupied(int segment) const
+{
+    return segment >= 0 && segment < m_occupied.size() && m_occupied.test(segment);
+}
+
+bool InterlockingEngine::isPointAvailable(int point) const
+{
+    return point < 0 || point >= m_pointsUnavailable.size() || !m_pointsUnavailable.test(point);
+}
+
+bool InterlockingEngine::signalPermitsExit(int segment, bool up) const
+{
+    for (int signal : m_signalsAtSegment.value(segment)) {
+        if (m_signals[signal].up == up && !m_signalsClear.test(signal)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+QStringList InterlockingEngine::conflictsOf(int routeIndex) const
+{
+    QStringList conflicts;
+    const Route& route = m_routes[routeIndex];
+
+    route.segments.forEach([&](int segment) {
+        if (m_occupied.test(segment)) {
+            conflicts << QString("track %1 occupied").arg(m_topology->segment(segment).id);
+        }
+    });
+    route.conflictingRoutes.forEach([&](int other) {
+        if (m_setRoutes.test(other)) {
+            conflicts << QString("conflicts with set route %1").arg(m_routes[other].id);
+        }
+    });
+    route.points.forEach([&](int point) {
+        const QString id = m_topology->point(point).id;
+        const bool mustMove = route.pointsReverse.test(point) != m_pointsReverse.test(point);
+        if (m_pointsUnavailable.test(point)) {
+            conflicts << QString("point %1 in transition or failed").arg(id);
+        } else if (mustMove && m_pointsLocked.test(point)) {
+            conflicts << QString("point %1 locked").arg(id);
+        } else if (mustMove && m_routeLockedPoints.test(point)) {
+            conflicts << QString("point %1 locked by another route").arg(id);
+        } else if (mustMove && m_pointGuards[point].intersects(m_signalsClear)) {
+            conflicts << QString("point %1 guarded by a clear signal").arg(id);
+        }
+    });
+    m_signals[route.entrySignal].interlockedSignals.forEach([&](int signal) {
+        if (m_signalsClear.test(signal)) {
+            conflicts << QString("signal %1 not at danger").arg(m_signals[signal].id);
+        }
+    });
+
+    return conflicts;
+}
+
+QString InterlockingEngine::routeExitId(const Route& route) const
+{
+    return route.exitSignal >= 0 ? m_signals[route.exitSignal].id : QStringLiteral("EXIT");
+}
+
+// ============================================================================
+// QML API
+// ============================================================================
+
+QVariantList InterlockingEngine::routes() const
+{
+    QVariantList result;
+    for (int index = 0; index < m_routes.size(); ++index) {
+        const Route& route = m_routes[index];
+
+        QStringList segments;
+        route.segments.forEach([&](int segment) { segments << m_topology->segment(segment).id; });
+
+        QVariantList points;
+        route.points.forEach([&](int point) {
+            points.append(QVariantMap{
+                {"id", m_topology->point(point).id},
+                {"position", route.pointsReverse.test(point) ? "REVERSE" : "NORMAL"}
+            });
+        });
+
+        QVariantMap item;
+        item["id"] = route.id;
+        item["entrySignal"] = m_signals[route.entrySignal].id;
+        item["exitSignal"] = routeExitId(route);
+        item["segments"] = segments;
+        item["points"] = points;
+        item["isSet"] = m_setRoutes.test(index);
+        item["isAvailable"] = m_availableRoutes.test(index);
+        result.append(item);
+    }
+    return result;
+}
+
+QVariantMap InterlockingEngine::checkRoute(const QString& entrySignalId, const QString& exitSignalId) const
+{
+    QVariantMap result;
+    result["exists"] = false;
+
+    const int entry = m_signalIndex.value(entrySignalId, -1);
+    if (entry < 0) return result;
+
+    for (int index : m_signals[entry].routes) {
+        const Route& route = m_routes[index];
+        if (routeExitId(route) != exitSignalId) continue;
+
+        // Prefer a usable alternative when several paths join the two signals
+        if (!result["exists"].toBool() || m_availableRoutes.test(index)) {
+            result["exists"] = true;
+            result["routeId"] = route.id;
+            result["isSet"] = m_setRoutes.test(index);
+            result["isAvailable"] = m_availableRoutes.test(index);
+            result["conflicts"] = conflictsOf(index);
+        }
+        if (m_availableRoutes.test(index)) break;
+    }
+    return result;
+}
+
+QStringList InterlockingEngine::routeConflicts(const QString& routeId) const
+{
+    const int index = m_routeIndex.value(routeId, -1);
+    return index >= 0 ? conflictsOf(index) : QStringList();
+}
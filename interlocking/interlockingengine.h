@@ -0,0 +1,152 @@
+#pragma once
+
+#include "routebitset.h"
+
+#include <QObject>
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QVariantList>
+#include <QVariantMap>
+
+class DatabaseManager;
+class TrackTopology;
+
+// Route-based interlocking over the track topology.
+//
+// When the layout loads, every route (entry signal -> next signal in the same
+// direction, through specific point positions) is compiled into bitsets over
+// segments, points, signals and other routes. Live state is kept in bitsets
+// of the same width, so "can this route be set / what conflicts" is a handful
+// of word ANDs and re-evaluating every route after a state change takes
+// microseconds.
+//
+// A route counts as set while its entry signal shows a proceed aspect and its
+// points lie as required; set routes lock their segments and points.
+// interlocked_with (signals) and safety_interlocks (points) are honoured.
+//
+// A path that reaches the layout boundary or a buffer stop before meeting a
+// same-direction signal becomes an exit route (exitSignal -1), so the last
+// signal before an exit is checked against the track ahead like any other.
+//
+// The checks fail safe: before the first compile, for a station other than
+// the compiled one, for unknown elements and for signals without any
+// compiled route (not placed on a track, or no path within kMaxRouteLength)
+// they refuse.
+class InterlockingEngine : public QObject {
+    Q_OBJECT
+    Q_PROPERTY(int routeCount READ routeCount NOTIFY routesCompiled)
+    Q_PROPERTY(int setRouteCount READ setRouteCount NOTIFY routeStatesChanged)
+    Q_PROPERTY(int availableRouteCount READ availableRouteCount NOTIFY routeStatesChanged)
+    Q_PROPERTY(double lastEvaluationMicros READ lastEvaluationMicros NOTIFY routeStatesChanged)
+
+public:
+    struct Route {
+        QString id;                      // "HM001-ST002"
+        int entrySignal = -1;
+        int exitSignal = -1;             // -1: exit route to the layout boundary
+        RouteBitset segments;            // over topology segments
+        RouteBitset pointsNormal;        // over topology points
+        RouteBitset pointsReverse;
+        RouteBitset points;              // pointsNormal | pointsReverse
+        RouteBitset conflictingRoutes;   // over routes (shared segment or opposing point)
+    };
+
+    explicit InterlockingEngine(QObject* parent = nullptr);
+
+    void setTopology(TrackTopology* topology);
+    void setDatabaseManager(DatabaseManager* manager);
+
+    // Compiles routes for the current topology and loads the full state
+    bool compile(const QVariantList& signalList, const QVariantList& trackSegments, const QVariantList& pointMachines);
+
+    // ===== State updates (each re-evaluates every route) =====
+    void setSegmentOccupied(const QString& segmentId, bool occupied);
+    void setSignalAspect(const QString& signalId, const QString& aspect);
+    void setPointState(const QString& machineId, const QString& position, const QString& operatingStatus, bool isLocked);
+
+    // ===== Checks used before commands reach the database =====
+    bool canClearSignal(const QString& signalId, QString* reason = nullptr) const;
+    bool canThrowPoint(const QString& machineId, QString* reason = nullptr) const;
+    bool isCompiled() const;
+
+    // ===== Live state queries (train simulation) =====
+    bool isSegmentOccupied(int segment) const;
+    bool isPointAvailable(int point) const;
+    // False while a signal at `segment` facing that direction shows danger
+    bool signalPermitsExit(int segment, bool up) const;
+
+    int routeCount() const { return m_routes.size(); }
+    int setRouteCount() const { return m_setRoutes.count(); }
+    int availableRouteCount() const { return m_availableRoutes.count(); }
+    double lastEvaluationMicros() const { return m_lastEvaluationMicros; }
+    const Route& route(int index) const { return m_routes[index]; }
+
+    // ===== QML API =====
+    Q_INVOKABLE QVariantList routes() const;
+    // exitSignalId "EXIT" selects the exit route(s) of a signal
+    Q_INVOKABLE QVariantMap checkRoute(const QString& entrySignalId, const QString& exitSignalId) const;
+    Q_INVOKABLE QStringList routeConflicts(const QString& routeId) const;
+    Q_INVOKABLE void reload();
+
+signals:
+    void routesCompiled();
+    void routeStatesChanged();
+
+private slots:
+    void onConnectionStateChanged(bool connected);
+    void onTrackSegmentUpdated(const QString& segmentId);
+    void onSignalUpdated(const QString& signalId);
+    void onPointMachineUpdated(const QString& machineId);
+    void onFieldInputsApplied(const QVariantList& tracks, const QVariantList& pointMachines);
+
+private:
+    struct SignalInfo {
+        QString id;
+        bool up = true;                  // UP signals face increasing columns
+        double col = 0;
+        int segment = -1;                // topology segment the signal stands at
+        RouteBitset interlockedSignals;  // must all be RED for this one to clear
+        QList<int> routes;               // routes starting at this signal
+    };
+
+    void placeSignals(const QVariantList& signalList);
+    void compileRoutesFrom(int signal);
+    void compileConflicts();
+
+    void evaluate();
+    bool pointsLie(const Route& route) const;
+    bool pointsMoveable(const Route& route) const;
+    QStringList conflictsOf(int routeIndex) const;
+    QString routeExitId(const Route& route) const;
+
+    static bool isProceedAspect(const QString& aspect);
+    static bool refuse(QString* reason, const QString& text);
+
+    TrackTopology* m_topology = nullptr;
+    DatabaseManager* m_dbManager = nullptr;
+
+    QList<SignalInfo> m_signals;
+    QHash<QString, int> m_signalIndex;
+    QHash<int, QList<int>> m_signalsAtSegment;   // topology segment -> signals
+    QList<Route> m_routes;
+    QHash<QString, int> m_routeIndex;
+    QList<RouteBitset> m_pointGuards;            // per point: safety_interlocks signals
+
+    // ===== Live state =====
+    RouteBitset m_occupied;          // segments
+    RouteBitset m_pointsReverse;     // points lying reverse
+    RouteBitset m_pointsUnavailable; // points in transition, failed or locked out
+    RouteBitset m_pointsLocked;      // points with is_locked
+    RouteBitset m_signalsClear;      // signals showing a proceed aspect
+
+    // ===== Derived by evaluate() =====
+    RouteBitset m_setRoutes;
+    RouteBitset m_availableRoutes;
+    RouteBitset m_routeLockedPoints;
+
+    double m_lastEvaluationMicros = 0.0;
+    bool m_compiled = false;
+    QString m_compiledStation;      // station the routes belong to (with a database manager)
+};
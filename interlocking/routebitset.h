@@ -0,0 +1,100 @@
+#pragma once
+
+#include <QVarLengthArray>
+#include <QtGlobal>
+#include <QtAlgorithms>
+#include <algorithm>
+
+// Bit set whose width is fixed when the layout is compiled (one bit per
+// segment, point, signal or route). Up to 256 bits stay inline; all sets of
+// the same index space share a word count, so the set operations are plain
+// word loops with no allocation.
+class RouteBitset {
+public:
+    RouteBitset() = default;
+    explicit RouteBitset(int size) { resize(size); }
+
+    void resize(int size)
+    {
+        m_size = size;
+        m_words.resize((size + 63) / 64);
+        clear();
+    }
+
+    int size() const { return m_size; }
+    int wordCount() const { return int(m_words.size()); }
+    const quint64* words() const { return m_words.constData(); }
+
+    void clear() { std::fill(m_words.begin(), m_words.end(), 0); }
+
+    void set(int index, bool value = true)
+    {
+        const quint64 mask = quint64(1) << (index & 63);
+        if (value) {
+            m_words[index >> 6] |= mask;
+        } else {
+            m_words[index >> 6] &= ~mask;
+        }
+    }
+
+    bool test(int index) const { return (m_words[index >> 6] >> (index & 63)) & 1; }
+
+    bool isEmpty() const
+    {
+        for (quint64 word : m_words) {
+            if (word) return false;
+        }
+        return true;
+    }
+
+    int count() const
+    {
+        int total = 0;
+        for (quint64 word : m_words) total += qPopulationCount(word);
+        return total;
+    }
+
+    bool intersects(const RouteBitset& other) const
+    {
+        for (int i = 0; i < m_words.size(); ++i) {
+            if (m_words[i] & other.m_words[i]) return true;
+        }
+        return false;
+    }
+
+    bool isSubsetOf(const RouteBitset& other) const
+    {
+        for (int i = 0; i < m_words.size(); ++i) {
+            if (m_words[i] & ~other.m_words[i]) return false;
+        }
+        return true;
+    }
+
+    RouteBitset& operator|=(const RouteBitset& other)
+    {
+        for (int i = 0; i < m_words.size(); ++i) m_words[i] |= other.m_words[i];
+        return *this;
+    }
+
+    bool operator==(const RouteBitset& other) const
+    {
+        return m_size == other.m_size && std::equal(m_words.begin(), m_words.end(), other.m_words.begin());
+    }
+    bool operator!=(const RouteBitset& other) const { return !(*this == other); }
+
+    template <typename Function>
+    void forEach(Function function) const
+    {
+        for (int i = 0; i < m_words.size(); ++i) {
+            quint64 word = m_words[i];
+            while (word) {
+                function(i * 64 + qCountTrailingZeroBits(word));
+                word &= word - 1;
+            }
+        }
+    }
+
+private:
+    QVarLengthArray<quint64, 4> m_words;
+    int m_size = 0;
+};
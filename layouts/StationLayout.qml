@@ -1,4 +1,5 @@
 import QtQuick
+import RailFlux.Rendering
 import "../components"
 
 Rectangle {
@@ -8,11 +9,24 @@ Rectangle {
     signal databaseResetRequested()
 
     property var dbManager
-    property int cellSize: Math.floor(width / 320)
+    property var trackTopology
+    property var spatialIndex
+    property var pointTransitions
+    property real zoom: 1.0
+    property real minZoom: 0.25
+    property real maxZoom: 8.0
+    property int cellSize: Math.max(2, Math.floor(width / 320 * zoom))
+    property real cullMargin: 20    // grid units instantiated beyond the visible edge
+    // Scrollable extent in grid units, from the spatial index bounds
+    property size layoutExtent: spatialIndex && spatialIndex.elementCount > 0
+                                ? Qt.size(spatialIndex.bounds.right + 10, spatialIndex.bounds.bottom + 10)
+                                : Qt.size(320, 0)
     property bool showGrid: true
 
     // ✅ NEW: Data properties from database (replaces StationData.js)
     property var trackSegmentsModel: []
+    property var trackLabelsModel: []
+    property var allSignalsModel: []
     property var outerSignalsModel: []
     property var homeSignalsModel: []
     property var starterSignalsModel: []
@@ -32,19 +46,12 @@ Rectangle {
         }
 
         console.log("Refreshing all station data from database")
-        refreshTrackData()
-        refreshSignalData()
-        refreshPointMachineData()
-        refreshTextLabelData()
-    }
-
-    function getTrackDataById(trackId) {
-        for (var i = 0; i < trackSegmentsModel.length; i++) {
-            if (trackSegmentsModel[i].id === trackId) {
-                return trackSegmentsModel[i];
-            }
-        }
-        return null;
+        // One snapshot: all four tables from the same database state
+        var snapshot = dbManager.getStationSnapshot()
+        applyTrackData(snapshot.tracks || [])
+        applySignalData(snapshot.signals || [])
+        applyPointMachineData(snapshot.pointMachines || [])
+        applyTextLabelData(snapshot.textLabels || [])
     }
 
     // ✅ UPDATED: Position mapping function
@@ -61,7 +68,16 @@ Rectangle {
         if (!dbManager || !dbManager.isConnected) return
 
         console.log("Refreshing track segments from database")
-        trackSegmentsModel = dbManager.getTrackSegmentsList()
+        applyTrackData(dbManager.getTrackSegmentInfos())
+    }
+
+    function applyTrackData(tracks) {
+        trackSegmentsModel = tracks
+        // Only occupied-by and platform-name captions need QML items
+        trackLabelsModel = trackSegmentsModel.filter(function(track) {
+            return (track.occupied && track.occupiedBy) ||
+                   (track.trackType === "PLATFORM" && track.name)
+        })
         console.log("Loaded", trackSegmentsModel.length, "track segments")
     }
 
@@ -69,7 +85,11 @@ Rectangle {
         if (!dbManager || !dbManager.isConnected) return
 
         console.log("Refreshing signals from database")
-        var allSignals = dbManager.getAllSignalsList()
+        applySignalData(dbManager.getSignalInfos())
+    }
+
+    function applySignalData(allSignals) {
+        allSignalsModel = allSignals
 
         // Filter signals by type
         outerSignalsModel = allSignals.filter(signal => signal.type === "OUTER")
@@ -87,7 +107,11 @@ Rectangle {
         if (!dbManager || !dbManager.isConnected) return
 
         console.log("Refreshing point machines from database")
-        pointMachinesModel = dbManager.getAllPointMachinesList()
+        applyPointMachineData(dbManager.getPointMachineInfos())
+    }
+
+    function applyPointMachineData(points) {
+        pointMachinesModel = points
         console.log("Loaded", pointMachinesModel.length, "point machines")
     }
 
@@ -95,10 +119,24 @@ Rectangle {
         if (!dbManager || !dbManager.isConnected) return
 
         console.log("Refreshing text labels from database")
-        textLabelsModel = dbManager.getTextLabelsList()
+        applyTextLabelData(dbManager.getTextLabelsList())
+    }
+
+    function applyTextLabelData(labels) {
+        textLabelsModel = labels
         console.log("Loaded", textLabelsModel.length, "text labels")
     }
 
+    // Zoom keeping the grid point under (viewX, viewY) fixed on screen
+    function zoomAt(factor, viewX, viewY) {
+        var gridX = (viewportFlick.contentX + viewX) / cellSize
+        var gridY = (viewportFlick.contentY + viewY) / cellSize
+        zoom = Math.max(minZoom, Math.min(maxZoom, zoom * factor))
+        viewportFlick.contentX = Math.max(0, gridX * cellSize - viewX)
+        viewportFlick.contentY = Math.max(0, gridY * cellSize - viewY)
+        viewportFlick.returnToBounds()
+    }
+
     // ✅ UPDATED: Signal handlers now update database instead of StationData.js
     function handleTrackClick(segmentId, currentState) {
         console.log("Track segment clicked:", segmentId, "Currently occupied:", currentState)
@@ -135,8 +173,8 @@ Rectangle {
         }
 
         // Get signal data from database to find possible aspects
-        var signalData = dbManager.getSignalById(signalId)
-        if (!signalData || !signalData.possibleAspects) {
+        var signalData = dbManager.getSignalInfo(signalId)
+        if (!signalData.id || signalData.possibleAspects.length === 0) {
             console.error("Could not get signal data for", signalId)
             return
         }
@@ -166,8 +204,8 @@ Rectangle {
             return
         }
 
-        var signalData = dbManager.getSignalById(signalId)
-        if (!signalData || !signalData.possibleAspects) {
+        var signalData = dbManager.getSignalInfo(signalId)
+        if (!signalData.id || signalData.possibleAspects.length === 0) {
             console.error("Could not get signal data for", signalId)
             return
         }
@@ -195,8 +233,8 @@ Rectangle {
             return
         }
 
-        var signalData = dbManager.getSignalById(signalId)
-        if (!signalData || !signalData.possibleAspects) {
+        var signalData = dbManager.getSignalInfo(signalId)
+        if (!signalData.id || signalData.possibleAspects.length === 0) {
             console.error("Could not get signal data for", signalId)
             return
         }
@@ -230,8 +268,10 @@ Rectangle {
 
         console.log("Operating point machine", machineId, "from", currentPosition, "to", targetPosition)
 
-        // ✅ FIXED: Send string position codes, not numbers
-        var success = dbManager.updatePointMachinePosition(machineId, targetPosition)
+        // Timed throw (IN_TRANSITION until the machine arrives) when the engine is available
+        var success = pointTransitions
+                ? pointTransitions.throwPoint(machineId, targetPosition)
+                : dbManager.updatePointMachinePosition(machineId, targetPosition)
         if (success) {
             console.log("Point machine operation initiated successfully")
         } else {
@@ -248,8 +288,8 @@ Rectangle {
             return
         }
 
-        var signalData = dbManager.getSignalById(signalId)
-        if (!signalData || !signalData.possibleAspects) {
+        var signalData = dbManager.getSignalInfo(signalId)
+        if (!signalData.id || signalData.possibleAspects.length === 0) {
             console.error("Could not get signal data for", signalId)
             return
         }
@@ -286,10 +326,15 @@ Rectangle {
         function onConnectionStateChanged(isConnected) {
             console.log("StationLayout: Database connection state changed:", isConnected)
             if (isConnected) {
-                refreshAllData()
+                // A resumed session only re-announces the rows that changed
+                if (!dbManager.isStale) refreshAllData()
+            } else if (dbManager.isStale) {
+                console.log("Database connection lost - keeping last known state until resync")
             } else {
                 console.log("Database disconnected - clearing data models")
                 trackSegmentsModel = []
+                trackLabelsModel = []
+                allSignalsModel = []
                 outerSignalsModel = []
                 homeSignalsModel = []
                 starterSignalsModel = []
@@ -308,33 +353,33 @@ Rectangle {
         // ✅ Handle real-time notifications (if available)
         function onTrackSegmentUpdated(segmentId) {
             console.log("StationLayout: Track segment updated:", segmentId)
-            refreshTrackData()
+            Qt.callLater(refreshTrackData)
         }
 
         function onSignalUpdated(signalId) {
             console.log("StationLayout: Signal updated:", signalId)
-            refreshSignalData()
+            Qt.callLater(refreshSignalData)
         }
 
         function onPointMachineUpdated(machineId) {
             console.log("StationLayout: Point machine updated:", machineId)
-            refreshPointMachineData()
+            Qt.callLater(refreshPointMachineData)
         }
 
         // ✅ Handle batch updates
         function onTrackSegmentsChanged() {
             console.log("StationLayout: Track segments changed")
-            refreshTrackData()
+            Qt.callLater(refreshTrackData)
         }
 
         function onSignalsChanged() {
             console.log("StationLayout: Signals changed")
-            refreshSignalData()
+            Qt.callLater(refreshSignalData)
         }
 
         function onPointMachinesChanged() {
             console.log("StationLayout: Point machines changed")
-            refreshPointMachineData()
+            Qt.callLater(refreshPointMachineData)
         }
 
         function onTextLabelsChanged() {
@@ -343,156 +388,192 @@ Rectangle {
         }
     }
 
-    // Main grid canvas
-    GridCanvas {
-        id: canvas
-        anchors.fill: parent
-        gridSize: stationLayout.cellSize
-        showGrid: stationLayout.showGrid
-
-        // ✅ UPDATED: Track segments from database
-        Repeater {
-            model: trackSegmentsModel
-
-            TrackSegment {
-                segmentId: modelData.id
-                segmentName: modelData.name || ""  // ✅ NEW
-                startRow: modelData.startRow
-                startCol: modelData.startCol
-                endRow: modelData.endRow
-                endCol: modelData.endCol
-                trackType: modelData.trackType || "STRAIGHT"  // ✅ NEW
-                cellSize: stationLayout.cellSize
-                isOccupied: modelData.occupied
-                isAssigned: modelData.assigned
-                occupiedBy: modelData.occupiedBy || ""  // ✅ NEW
-                isActive: modelData.isActive !== false  // ✅ NEW
-                onTrackClicked: stationLayout.handleTrackClick(segmentId, isOccupied)
-            }
-        }
+    // Viewport-culled models: only elements near the visible region get
+    // delegates, and delegates are pooled and rebound while panning/zooming
+    ViewportModel {
+        id: trackLabelViewport
+        spatialIndex: stationLayout.spatialIndex
+        elementType: "TRACK_SEGMENT"
+        elements: trackLabelsModel
+        viewport: viewportFlick.visibleCells
+        margin: stationLayout.cullMargin
+    }
 
-        // ✅ UPDATED: Point machines from database
-        Repeater {
-            model: pointMachinesModel
-
-            PointMachine {
-                machineId: modelData.id
-                machineName: modelData.name || ""
-                position: modelData.position // ✅ Convert 1/2 to NORMAL/REVERSE
-                operatingStatus: modelData.operatingStatus
-                junctionPoint: modelData.junctionPoint
-                rootTrack: modelData.rootTrack
-                normalTrack: modelData.normalTrack
-                reverseTrack: modelData.reverseTrack
-                transitionTime: modelData.transitionTime || 3000
-                isLocked: modelData.isLocked || false
-                lockReason: modelData.lockReason || ""
-                cellSize: stationLayout.cellSize
+    ViewportModel {
+        id: pointMachineViewport
+        spatialIndex: stationLayout.spatialIndex
+        elementType: "POINT_MACHINE"
+        elements: pointMachinesModel
+        viewport: viewportFlick.visibleCells
+        margin: stationLayout.cullMargin
+    }
 
-                // ✅ CRITICAL: Pass track lookup function
-                trackDataLookup: stationLayout.getTrackDataById
+    ViewportModel {
+        id: textLabelViewport
+        spatialIndex: stationLayout.spatialIndex
+        elementType: "TEXT_LABEL"
+        elements: textLabelsModel
+        viewport: viewportFlick.visibleCells
+        margin: stationLayout.cullMargin
+    }
 
-                onPointMachineClicked: function(machineId, currentPosition) {
-                    stationLayout.handlePointMachineClick(machineId, currentPosition)
-                }
+    // Pannable/zoomable view over the station grid
+    Flickable {
+        id: viewportFlick
+        anchors.fill: parent
+        clip: true
+        boundsBehavior: Flickable.StopAtBounds
+        contentWidth: canvas.width
+        contentHeight: canvas.height
+
+        // Visible region in grid units (x = col, y = row)
+        readonly property rect visibleCells: Qt.rect(contentX / stationLayout.cellSize,
+                                                     contentY / stationLayout.cellSize,
+                                                     width / stationLayout.cellSize,
+                                                     height / stationLayout.cellSize)
+
+        // Handlers live on the content item: convert to view coordinates
+        // Ctrl + wheel zooms around the cursor
+        WheelHandler {
+            acceptedModifiers: Qt.ControlModifier
+            onWheel: function(event) {
+                stationLayout.zoomAt(event.angleDelta.y > 0 ? 1.25 : 0.8,
+                                     point.position.x - viewportFlick.contentX,
+                                     point.position.y - viewportFlick.contentY)
             }
         }
 
-        // ✅ UPDATED: Outer signals from database
-        Repeater {
-            model: outerSignalsModel
-
-            OuterSignal {
-                x: modelData.col * stationLayout.cellSize
-                y: modelData.row * stationLayout.cellSize
-                signalId: modelData.id
-                signalName: modelData.name
-                currentAspect: modelData.currentAspect
-                aspectCount: modelData.aspectCount || 4  // ✅ NEW
-                possibleAspects: modelData.possibleAspects || []  // ✅ NEW
-                direction: modelData.direction
-                isActive: modelData.isActive
-                locationDescription: modelData.location || ""  // ✅ NEW
-                cellSize: stationLayout.cellSize
-                onSignalClicked: stationLayout.handleOuterSignalClick(signalId, currentAspect)
+        PinchHandler {
+            target: null
+            property real lastScale: 1.0
+            onActiveChanged: lastScale = 1.0
+            onActiveScaleChanged: {
+                stationLayout.zoomAt(activeScale / lastScale,
+                                     centroid.position.x - viewportFlick.contentX,
+                                     centroid.position.y - viewportFlick.contentY)
+                lastScale = activeScale
             }
         }
 
-        // ✅ UPDATED: Home signals from database
-        Repeater {
-            model: homeSignalsModel
-
-            HomeSignal {
-                x: modelData.col * stationLayout.cellSize
-                y: modelData.row * stationLayout.cellSize
-                signalId: modelData.id
-                signalName: modelData.name
-                currentAspect: modelData.currentAspect
-                aspectCount: modelData.aspectCount || 3  // ✅ NEW
-                possibleAspects: modelData.possibleAspects || []  // ✅ NEW
-                callingOnAspect: modelData.callingOnAspect
-                loopAspect: modelData.loopAspect
-                loopSignalConfiguration: modelData.loopSignalConfiguration
-                direction: modelData.direction
-                isActive: modelData.isActive
-                locationDescription: modelData.location || ""  // ✅ NEW
+        // Main grid canvas
+        GridCanvas {
+            id: canvas
+            width: Math.max(viewportFlick.width, stationLayout.layoutExtent.width * stationLayout.cellSize)
+            height: Math.max(viewportFlick.height, stationLayout.layoutExtent.height * stationLayout.cellSize)
+            gridSize: stationLayout.cellSize
+            showGrid: stationLayout.showGrid
+            viewRect: Qt.rect(viewportFlick.contentX, viewportFlick.contentY, viewportFlick.width, viewportFlick.height)
+
+            // All track segments: one batched scene-graph node
+            TrackLayer {
+                id: trackLayer
+                anchors.fill: parent
+                tracks: trackSegmentsModel
                 cellSize: stationLayout.cellSize
-                onSignalClicked: stationLayout.handleHomeSignalClick(signalId, currentAspect)
+                spatialIndex: stationLayout.spatialIndex
+                onTrackClicked: function(segmentId, currentState) {
+                    stationLayout.handleTrackClick(segmentId, currentState)
+                }
             }
-        }
 
-        // ✅ UPDATED: Starter signals from database
-        Repeater {
-            model: starterSignalsModel
-
-            StarterSignal {
-                x: modelData.col * stationLayout.cellSize
-                y: modelData.row * stationLayout.cellSize
-                signalId: modelData.id
-                signalName: modelData.name
-                currentAspect: modelData.currentAspect
-                aspectCount: modelData.aspectCount
-                possibleAspects: modelData.possibleAspects || []  // ✅ NEW
-                direction: modelData.direction
-                isActive: modelData.isActive
-                locationDescription: modelData.location || ""  // ✅ NEW
-                cellSize: stationLayout.cellSize
-                onSignalClicked: stationLayout.handleStarterSignalClick(signalId, currentAspect)
+            // Track captions (occupied by / platform name)
+            Repeater {
+                model: trackLabelViewport
+
+                Item {
+                    visible: model.slotActive
+                    x: (modelData.startCol + modelData.endCol) / 2 * stationLayout.cellSize
+                    y: (modelData.startRow + modelData.endRow) / 2 * stationLayout.cellSize + 4
+
+                    Rectangle {
+                        anchors.centerIn: parent
+                        width: occupiedByText.contentWidth + 8
+                        height: occupiedByText.contentHeight + 4
+                        color: "#000000"
+                        opacity: 0.8
+                        radius: 2
+                        visible: modelData.occupied && (modelData.occupiedBy || "") !== ""
+
+                        Text {
+                            id: occupiedByText
+                            anchors.centerIn: parent
+                            text: modelData.occupiedBy || ""
+                            color: "#ffffff"
+                            font.pixelSize: 7
+                            font.weight: Font.Bold
+                        }
+                    }
+
+                    Text {
+                        anchors.horizontalCenter: parent.horizontalCenter
+                        y: 6
+                        text: modelData.name || ""
+                        color: "#cccccc"
+                        font.pixelSize: 6
+                        font.family: "Arial"
+                        visible: modelData.trackType === "PLATFORM" && text !== ""
+                    }
+                }
             }
-        }
 
-        // ✅ UPDATED: Advanced starter signals from database
-        Repeater {
-            model: advanceStarterSignalsModel
-
-            AdvanceStarterSignal {
-                x: modelData.col * stationLayout.cellSize
-                y: modelData.row * stationLayout.cellSize
-                signalId: modelData.id
-                signalName: modelData.name
-                currentAspect: modelData.currentAspect
-                aspectCount: modelData.aspectCount || 2  // Always 2 for advanced starter
-                possibleAspects: modelData.possibleAspects || []  // ✅ NEW
-                direction: modelData.direction
-                isActive: modelData.isActive
-                locationDescription: modelData.location || ""  // ✅ NEW
-                cellSize: stationLayout.cellSize
-                onSignalClicked: stationLayout.handleAdvanceStarterSignalClick(signalId, currentAspect)
+            // ✅ UPDATED: Point machines from database
+            Repeater {
+                model: pointMachineViewport
+
+                PointMachine {
+                    visible: model.slotActive
+                    machineId: modelData.id
+                    machineName: modelData.name || ""
+                    position: modelData.position // ✅ Convert 1/2 to NORMAL/REVERSE
+                    operatingStatus: modelData.operatingStatus
+                    junctionPoint: modelData.junctionPoint
+                    rootTrack: modelData.rootTrack
+                    normalTrack: modelData.normalTrack
+                    reverseTrack: modelData.reverseTrack
+                    transitionTime: modelData.transitionTime || 3000
+                    isLocked: modelData.isLocked || false
+                    lockReason: modelData.lockReason || ""
+                    cellSize: stationLayout.cellSize
+
+                    // ✅ CRITICAL: Pass track topology for endpoint lookups
+                    topology: stationLayout.trackTopology
+
+                    onPointMachineClicked: function(machineId, currentPosition) {
+                        stationLayout.handlePointMachineClick(machineId, currentPosition)
+                    }
+                }
             }
-        }
 
-        // ✅ UPDATED: Text labels from database
-        Repeater {
-            model: textLabelsModel
+            // All signal heads: one batched scene-graph node
+            SignalLayer {
+                id: signalLayer
+                anchors.fill: parent
+                signalModel: allSignalsModel
+                cellSize: stationLayout.cellSize
+                spatialIndex: stationLayout.spatialIndex
+                onSignalClicked: function(signalId, currentAspect, signalType) {
+                    switch (signalType) {
+                        case "OUTER": stationLayout.handleOuterSignalClick(signalId, currentAspect); break
+                        case "HOME": stationLayout.handleHomeSignalClick(signalId, currentAspect); break
+                        case "STARTER": stationLayout.handleStarterSignalClick(signalId, currentAspect); break
+                        case "ADVANCED_STARTER": stationLayout.handleAdvanceStarterSignalClick(signalId, currentAspect); break
+                    }
+                }
+            }
 
-            Text {
-                x: modelData.col * stationLayout.cellSize
-                y: modelData.row * stationLayout.cellSize
-                text: modelData.text
-                color: modelData.color || "#ffffff"
-                font.pixelSize: modelData.fontSize || 12
-                font.family: modelData.fontFamily || "Arial"
-                visible: modelData.isVisible !== false
+            // ✅ UPDATED: Text labels from database
+            Repeater {
+                model: textLabelViewport
+
+                Text {
+                    x: modelData.col * stationLayout.cellSize
+                    y: modelData.row * stationLayout.cellSize
+                    text: modelData.text
+                    color: modelData.color || "#ffffff"
+                    font.pixelSize: modelData.fontSize || 12
+                    font.family: modelData.fontFamily || "Arial"
+                    visible: model.slotActive && modelData.isVisible !== false
+                }
             }
         }
     }
@@ -609,6 +690,7 @@ Rectangle {
                 border.width: 1
 
                 Column {
+                    id: databaseStatus
                     anchors.fill: parent
                     anchors.margins: 8
                     spacing: 4
@@ -629,13 +711,18 @@ Rectangle {
                             width: 60
                         }
                         Text {
-                            text: dbManager && dbManager.isConnected ? "Connected" : "Offline"
-                            color: dbManager && dbManager.isConnected ? "#38a169" : "#ef4444"
+                            text: dbManager && dbManager.isStale ? "Stale"
+                                : dbManager && dbManager.isConnected ? "Connected" : "Offline"
+                            color: dbManager && dbManager.isStale ? "#d69e2e"
+                                 : dbManager && dbManager.isConnected ? "#38a169" : "#ef4444"
                             font.pixelSize: 9
                             font.weight: Font.Bold
                         }
                     }
 
+                    // Pushed counters (station_status triggers): no model walks, no queries
+                    property var counters: dbManager ? dbManager.systemStatus : ({})
+
                     Row {
                         width: parent.width
                         Text {
@@ -645,7 +732,11 @@ Rectangle {
                             width: 60
                         }
                         Text {
-                            text: trackSegmentsModel.length.toString()
+                            text: databaseStatus.counters.tracks
+                                  ? databaseStatus.counters.tracks.occupied + " occ / "
+                                    + databaseStatus.counters.tracks.assigned + " asg / "
+                                    + databaseStatus.counters.tracks.total
+                                  : trackSegmentsModel.length.toString()
                             color: "#38a169"
                             font.pixelSize: 9
                             font.weight: Font.Bold
@@ -661,8 +752,10 @@ Rectangle {
                             width: 60
                         }
                         Text {
-                            text: (outerSignalsModel.length + homeSignalsModel.length +
-                                  starterSignalsModel.length + advanceStarterSignalsModel.length).toString()
+                            text: databaseStatus.counters.signals
+                                  ? databaseStatus.counters.signals.active + " / " + databaseStatus.counters.signals.total
+                                  : (outerSignalsModel.length + homeSignalsModel.length +
+                                     starterSignalsModel.length + advanceStarterSignalsModel.length).toString()
                             color: "#38a169"
                             font.pixelSize: 9
                             font.weight: Font.Bold
@@ -678,7 +771,11 @@ Rectangle {
                             width: 60
                         }
                         Text {
-                            text: pointMachinesModel.length.toString()
+                            text: databaseStatus.counters.point_machines
+                                  ? databaseStatus.counters.point_machines.total
+                                    + (databaseStatus.counters.point_machines.in_transition > 0
+                                       ? " (" + databaseStatus.counters.point_machines.in_transition + " moving)" : "")
+                                  : pointMachinesModel.length.toString()
                             color: "#38a169"
                             font.pixelSize: 9
                             font.weight: Font.Bold
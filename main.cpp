@@ -1,17 +1,123 @@
 #include <QGuiApplication>
+#include <QCommandLineParser>
 #include <QQmlApplicationEngine>
 #include <QQmlContext>
 #include <QIcon>
-#include "database/DatabaseManager.h"
-#include "database/DatabaseInitializer.h"
+#include <QQuickWindow>
+#include <QTimer>
+#include "database/databasemanager.h"
+#include "database/databaseinitializer.h"
+#include "database/elementinfo.h"
+#include "diagnostics/commandtracer.h"
+#include "diagnostics/tracebuffer.h"
+#include "topology/tracktopology.h"
+#include "topology/spatialindex.h"
+#include "interlocking/interlockingengine.h"
+#include "simulation/pointtransitionengine.h"
+#include "simulation/trainsimulator.h"
+#include "ingestion/fieldgateway.h"
+#include "broker/statebroker.h"
+#include "broker/statebrokerclient.h"
+#include "rendering/viewportmodel.h"
+#include "rendering/gridrenderer.h"
+#include "rendering/tracklayer.h"
+#include "rendering/signallayer.h"
+
+namespace {
+
+constexpr int kDefaultBrokerPort = 47200;
+constexpr int kDefaultFieldPort = 47100;
+constexpr int kTraceSnapshotIntervalMs = 60000;
+
+// Shared state subscription: one process LISTENs, every workstation follows it.
+// Field equipment listeners are opt-in so several HMIs can share a host.
+struct StartupOptions {
+    int servePort = 0;                  // --broker-port: serve state to other workstations
+    QString bindAddress = "127.0.0.1";  // --broker-bind
+    QString brokerHost;                 // --broker host[:port]: follow a broker instead of the database
+    int brokerPort = kDefaultBrokerPort;
+    int fieldPort = 0;                  // --field / --field-port: accept field telegrams (UDP and TCP)
+};
+
+StartupOptions parseStartupOptions(const QCoreApplication& app)
+{
+    QCommandLineParser parser;
+    QCommandLineOption servePort("broker-port", "Serve station state to other workstations on <port>.", "port");
+    QCommandLineOption bindAddress("broker-bind", "Address the state broker binds to (default 127.0.0.1).", "address");
+    QCommandLineOption broker("broker", "Follow the state broker at <host[:port]> instead of the database.", "host");
+    QCommandLineOption headless("headless", "Run only the state broker, without a window.");
+    QCommandLineOption field("field", QString("Accept field equipment telegrams on port %1.").arg(kDefaultFieldPort));
+    QCommandLineOption fieldPort("field-port", "Accept field equipment telegrams on <port> (UDP and TCP).", "port");
+    parser.addOptions({servePort, bindAddress, broker, headless, field, fieldPort});
+    parser.parse(app.arguments());
+
+    StartupOptions options;
+    if (parser.isSet(servePort)) options.servePort = parser.value(servePort).toInt();
+    if (parser.isSet(bindAddress)) options.bindAddress = parser.value(bindAddress);
+    if (parser.isSet(broker)) {
+        const QStringList parts = parser.value(broker).split(':');
+        options.brokerHost = parts.value(0);
+        if (parts.size() > 1) options.brokerPort = parts.value(1).toInt();
+    }
+    if (parser.isSet(field)) options.fieldPort = kDefaultFieldPort;
+    if (parser.isSet(fieldPort)) options.fieldPort = parser.value(fieldPort).toInt();
+    return options;
+}
+
+// Headless state broker: the database subscription without any HMI on top
+int runHeadlessBroker(QCoreApplication& app, const StartupOptions& options)
+{
+    DatabaseManager* dbManager = new DatabaseManager(&app);
+    StateBroker* stateBroker = new StateBroker(&app);
+    stateBroker->setDatabaseManager(dbManager);
+    if (!stateBroker->listen(options.servePort > 0 ? options.servePort : kDefaultBrokerPort, options.bindAddress)) {
+        return 1;
+    }
+
+    QObject::connect(&app, &QCoreApplication::aboutToQuit, [dbManager]() {
+        dbManager->cleanup();
+        dbManager->stopPolling();
+    });
+
+    if (dbManager->connectToDatabase()) {
+        dbManager->startPolling();
+        dbManager->enableRealTimeUpdates();
+    } else {
+        qWarning() << "Failed to connect to database";
+        return 1;
+    }
+
+    return app.exec();
+}
+
+} // namespace
 
 int main(int argc, char *argv[])
 {
+    for (int i = 1; i < argc; ++i) {
+        if (qstrcmp(argv[i], "--headless") == 0) {
+            QCoreApplication app(argc, argv);
+            return runHeadlessBroker(app, parseStartupOptions(app));
+        }
+    }
+
     QGuiApplication app(argc, argv);
+    const StartupOptions startupOptions = parseStartupOptions(app);
 
     // Register C++ types with QML
     qmlRegisterType<DatabaseManager>("RailFlux.Database", 1, 0, "DatabaseManager");
     qmlRegisterType<DatabaseInitializer>("RailFlux.Database", 1, 0, "DatabaseInitializer");
+    // Row value types: enums for QML (SignalInfo.Red, PointMachineInfo.Reverse, ...)
+    qmlRegisterUncreatableMetaObject(SignalInfo::staticMetaObject, "RailFlux.Database", 1, 0,
+                                     "SignalInfo", "SignalInfo is a value type returned by DatabaseManager");
+    qmlRegisterUncreatableMetaObject(TrackSegmentInfo::staticMetaObject, "RailFlux.Database", 1, 0,
+                                     "TrackSegmentInfo", "TrackSegmentInfo is a value type returned by DatabaseManager");
+    qmlRegisterUncreatableMetaObject(PointMachineInfo::staticMetaObject, "RailFlux.Database", 1, 0,
+                                     "PointMachineInfo", "PointMachineInfo is a value type returned by DatabaseManager");
+    qmlRegisterType<ViewportModel>("RailFlux.Rendering", 1, 0, "ViewportModel");
+    qmlRegisterType<GridRenderer>("RailFlux.Rendering", 1, 0, "GridRenderer");
+    qmlRegisterType<TrackLayer>("RailFlux.Rendering", 1, 0, "TrackLayer");
+    qmlRegisterType<SignalLayer>("RailFlux.Rendering", 1, 0, "SignalLayer");
 
     app.setWindowIcon(QIcon(":/resources/icons/railway-icon.ico"));
     qDebug() << "Icon exists??" << QFile(":/icons/railway-icon.ico").exists();
@@ -27,11 +133,83 @@ int main(int argc, char *argv[])
     DatabaseInitializer* dbInitializer = new DatabaseInitializer(&app);
     engine.rootContext()->setContextProperty("globalDatabaseInitializer", dbInitializer);
 
+    // Command latency tracing (click -> database -> notify -> frame)
+    CommandTracer* commandTracer = new CommandTracer(&app);
+    dbManager->setCommandTracer(commandTracer);
+    engine.rootContext()->setContextProperty("globalCommandTracer", commandTracer);
+
+    // Track topology graph (rebuilt only when the layout changes)
+    TrackTopology* trackTopology = new TrackTopology(&app);
+    trackTopology->setDatabaseManager(dbManager);
+    engine.rootContext()->setContextProperty("globalTrackTopology", trackTopology);
+
+    // Grid hash over layout coordinates (region queries and picking)
+    SpatialIndex* spatialIndex = new SpatialIndex(&app);
+    spatialIndex->setSources(dbManager);
+    engine.rootContext()->setContextProperty("globalSpatialIndex", spatialIndex);
+
+    // Route interlocking compiled from the topology; guards operator commands
+    InterlockingEngine* interlocking = new InterlockingEngine(&app);
+    interlocking->setTopology(trackTopology);
+    interlocking->setDatabaseManager(dbManager);
+    dbManager->setInterlockingEngine(interlocking);
+    engine.rootContext()->setContextProperty("globalInterlocking", interlocking);
+
+    // Timed point throws (IN_TRANSITION for transition_time_ms, then CONNECTED)
+    PointTransitionEngine* pointTransitions = new PointTransitionEngine(&app);
+    pointTransitions->setDatabaseManager(dbManager);
+    engine.rootContext()->setContextProperty("globalPointTransitions", pointTransitions);
+
+    // Synthetic train traffic (occupy/clear through the normal update path)
+    TrainSimulator* trainSimulator = new TrainSimulator(&app);
+    trainSimulator->setTopology(trackTopology);
+    trainSimulator->setDatabaseManager(dbManager);
+    trainSimulator->setInterlockingEngine(interlocking);
+    engine.rootContext()->setContextProperty("globalTrainSimulator", trainSimulator);
+
+    // Field equipment telegrams (track circuits, point detection), batched into the database
+    FieldGateway* fieldGateway = new FieldGateway(&app);
+    fieldGateway->setTopology(trackTopology);
+    fieldGateway->setDatabaseManager(dbManager);
+    if (startupOptions.fieldPort > 0) {
+        fieldGateway->listen(startupOptions.fieldPort, startupOptions.fieldPort);
+    }
+    engine.rootContext()->setContextProperty("globalFieldGateway", fieldGateway);
+
+    // State fan-out: serve other workstations, or follow a broker instead of LISTEN/polling
+    StateBroker* stateBroker = new StateBroker(&app);
+    stateBroker->setDatabaseManager(dbManager);
+    if (startupOptions.servePort > 0) {
+        stateBroker->listen(startupOptions.servePort, startupOptions.bindAddress);
+    }
+    engine.rootContext()->setContextProperty("globalStateBroker", stateBroker);
+
+    StateBrokerClient* stateBrokerClient = new StateBrokerClient(&app);
+    if (!startupOptions.brokerHost.isEmpty()) {
+        dbManager->setStateSource(stateBrokerClient);
+        stateBrokerClient->connectToBroker(startupOptions.brokerHost, startupOptions.brokerPort);
+    }
+    engine.rootContext()->setContextProperty("globalStateBrokerClient", stateBrokerClient);
+
+    // Keep the latest trace on disk even if the process dies without aboutToQuit
+    TraceBuffer::installCrashHandler(TraceBuffer::defaultDumpPath().replace(".rftrace", "-crash.rftrace"));
+    QTimer* traceSnapshotTimer = new QTimer(&app);
+    QObject::connect(traceSnapshotTimer, &QTimer::timeout, traceSnapshotTimer, []() {
+        TraceBuffer::dumpToFile(TraceBuffer::rollingDumpPath());
+    });
+    traceSnapshotTimer->start(kTraceSnapshotIntervalMs);
+
     // ✅ ADD: Cleanup on application exit
-    QObject::connect(&app, &QCoreApplication::aboutToQuit, [dbManager]() {
+    QObject::connect(&app, &QCoreApplication::aboutToQuit, [dbManager, fieldGateway]() {
         qDebug() << "🧹 Application shutting down, cleaning up database...";
+        // Write queued field inputs while the connection still exists
+        fieldGateway->close();
+        fieldGateway->flush();
         dbManager->cleanup();
         dbManager->stopPolling();
+
+        // Hot-path trace (decode with railfluxTraceDecode)
+        TraceBuffer::dumpToFile(TraceBuffer::defaultDumpPath());
     });
 
     QObject::connect(
@@ -41,14 +219,25 @@ int main(int argc, char *argv[])
         []() { QCoreApplication::exit(-1); },
         Qt::QueuedConnection);
 
+    // Database startup (system probe, or initdb/pg_ctl for the portable
+    // server) runs in the background while the QML engine loads
+    QObject::connect(dbManager, &DatabaseManager::connectionStateChanged, dbManager, [dbManager](bool connected) {
+        if (connected) dbManager->startPolling();
+    });
+    QObject::connect(dbManager, &DatabaseManager::startupFinished, dbManager, [](bool connected, const QVariantMap& timings) {
+        if (!connected) qWarning() << "Failed to connect to database" << timings;
+    });
+    dbManager->connectToDatabaseAsync();
+
     engine.loadFromModule("RailFlux", "Main");
 
-    // Start database connection and polling
-    if (dbManager->connectToDatabase()) {
-        dbManager->startPolling();
-        dbManager->enableRealTimeUpdates();  // ✅ Enable LISTEN/NOTIFY
-    } else {
-        qWarning() << "Failed to connect to database";
+    // frameSwapped fires on the render thread; the tracer only stores a timestamp there
+    if (!engine.rootObjects().isEmpty()) {
+        if (auto* window = qobject_cast<QQuickWindow*>(engine.rootObjects().constFirst())) {
+            QObject::connect(window, &QQuickWindow::frameSwapped, commandTracer,
+                             [commandTracer]() { commandTracer->recordFrameSwapped(); },
+                             Qt::DirectConnection);
+        }
     }
 
     return app.exec();
@@ -0,0 +1,149 @@
+#include "gridrenderer.h"
+#include "vertexcolor.h"
+
+#include <QSGGeometryNode>
+#include <QSGVertexColorMaterial>
+
+namespace {
+
+struct LineStyle {
+    VertexColor color;
+    float width;
+};
+
+LineStyle makeStyle(const QColor& color, qreal opacity, float width)
+{
+    return {VertexColor::premultiplied(color, opacity), width};
+}
+
+void appendQuad(QSGGeometry::ColoredPoint2D*& vertex, float x0, float y0, float x1, float y1, const LineStyle& style)
+{
+    const VertexColor& c = style.color;
+    vertex[0].set(x0, y0, c.r, c.g, c.b, c.a);
+    vertex[1].set(x1, y0, c.r, c.g, c.b, c.a);
+    vertex[2].set(x0, y1, c.r, c.g, c.b, c.a);
+    vertex[3].set(x1, y0, c.r, c.g, c.b, c.a);
+    vertex[4].set(x1, y1, c.r, c.g, c.b, c.a);
+    vertex[5].set(x0, y1, c.r, c.g, c.b, c.a);
+    vertex += 6;
+}
+
+} // namespace
+
+GridRenderer::GridRenderer(QQuickItem* parent)
+    : QQuickItem(parent)
+{
+    setFlag(ItemHasContents, true);
+}
+
+void GridRenderer::setGridSize(int size)
+{
+    if (m_gridSize == size) return;
+    m_gridSize = size;
+    emit gridSizeChanged();
+    invalidateGeometry();
+}
+
+void GridRenderer::setGridColorNormal(const QColor& color)
+{
+    if (m_colorNormal == color) return;
+    m_colorNormal = color;
+    emit styleChanged();
+    invalidateGeometry();
+}
+
+void GridRenderer::setGridColorMajor(const QColor& color)
+{
+    if (m_colorMajor == color) return;
+    m_colorMajor = color;
+    emit styleChanged();
+    invalidateGeometry();
+}
+
+void GridRenderer::setGridColorPrimary(const QColor& color)
+{
+    if (m_colorPrimary == color) return;
+    m_colorPrimary = color;
+    emit styleChanged();
+    invalidateGeometry();
+}
+
+void GridRenderer::setGridOpacity(qreal opacity)
+{
+    if (qFuzzyCompare(m_opacity, opacity)) return;
+    m_opacity = opacity;
+    emit styleChanged();
+    invalidateGeometry();
+}
+
+void GridRenderer::invalidateGeometry()
+{
+    m_geometryDirty = true;
+    update();
+}
+
+void GridRenderer::geometryChange(const QRectF& newGeometry, const QRectF& oldGeometry)
+{
+    QQuickItem::geometryChange(newGeometry, oldGeometry);
+    if (newGeometry.size() != oldGeometry.size()) {
+        invalidateGeometry();
+    }
+}
+
+QSGNode* GridRenderer::updatePaintNode(QSGNode* oldNode, UpdatePaintNodeData*)
+{
+    auto* node = static_cast<QSGGeometryNode*>(oldNode);
+
+    if (m_gridSize <= 0 || width() <= 0 || height() <= 0) {
+        delete node;
+        m_geometryDirty = true;
+        return nullptr;
+    }
+
+    if (!node) {
+        node = new QSGGeometryNode;
+        auto* geometry = new QSGGeometry(QSGGeometry::defaultAttributes_ColoredPoint2D(), 0);
+        geometry->setDrawingMode(QSGGeometry::DrawTriangles);
+        node->setGeometry(geometry);
+        node->setFlag(QSGNode::OwnsGeometry);
+        node->setMaterial(new QSGVertexColorMaterial);
+        node->setFlag(QSGNode::OwnsMaterial);
+        m_geometryDirty = true;
+    }
+
+    if (!m_geometryDirty) {
+        return node;
+    }
+
+    // Every 20th line is primary (2px), every 10th major, the rest normal
+    const LineStyle normal = makeStyle(m_colorNormal, m_opacity, 1.0f);
+    const LineStyle major = makeStyle(m_colorMajor, m_opacity, 1.0f);
+    const LineStyle primary = makeStyle(m_colorPrimary, m_opacity, 2.0f);
+    auto styleFor = [&](int line) -> const LineStyle& {
+        return line % 20 == 0 ? primary : line % 10 == 0 ? major : normal;
+    };
+
+    const float w = float(width());
+    const float h = float(height());
+    const int columns = int(w / m_gridSize) + 1;
+    const int rows = int(h / m_gridSize) + 1;
+
+    QSGGeometry* geometry = node->geometry();
+    geometry->allocate((columns + rows) * 6);
+    QSGGeometry::ColoredPoint2D* vertex = geometry->vertexDataAsColoredPoint2D();
+
+    for (int col = 0; col < columns; ++col) {
+        const LineStyle& style = styleFor(col);
+        const float x = float(col * m_gridSize);
+        appendQuad(vertex, x, 0.0f, x + style.width, h, style);
+    }
+    for (int row = 0; row < rows; ++row) {
+        const LineStyle& style = styleFor(row);
+        const float y = float(row * m_gridSize);
+        appendQuad(vertex, 0.0f, y, w, y + style.width, style);
+    }
+
+    node->markDirty(QSGNode::DirtyGeometry);
+    m_geometryDirty = false;
+    return node;
+}
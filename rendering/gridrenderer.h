@@ -0,0 +1,53 @@
+#pragma once
+
+#include <QColor>
+#include <QQuickItem>
+
+// Station grid drawn as a single scene-graph node.
+//
+// All grid lines are emitted as quads in one vertex buffer with per-vertex
+// colour (normal / every 10th / every 20th line), so the whole grid is one
+// draw call. The geometry is only rebuilt when gridSize, the item size or the
+// line styling changes; panning a Flickable over it costs nothing.
+class GridRenderer : public QQuickItem {
+    Q_OBJECT
+    Q_PROPERTY(int gridSize READ gridSize WRITE setGridSize NOTIFY gridSizeChanged)
+    Q_PROPERTY(QColor gridColorNormal READ gridColorNormal WRITE setGridColorNormal NOTIFY styleChanged)
+    Q_PROPERTY(QColor gridColorMajor READ gridColorMajor WRITE setGridColorMajor NOTIFY styleChanged)
+    Q_PROPERTY(QColor gridColorPrimary READ gridColorPrimary WRITE setGridColorPrimary NOTIFY styleChanged)
+    Q_PROPERTY(qreal gridOpacity READ gridOpacity WRITE setGridOpacity NOTIFY styleChanged)
+
+public:
+    explicit GridRenderer(QQuickItem* parent = nullptr);
+
+    int gridSize() const { return m_gridSize; }
+    void setGridSize(int size);
+
+    QColor gridColorNormal() const { return m_colorNormal; }
+    void setGridColorNormal(const QColor& color);
+    QColor gridColorMajor() const { return m_colorMajor; }
+    void setGridColorMajor(const QColor& color);
+    QColor gridColorPrimary() const { return m_colorPrimary; }
+    void setGridColorPrimary(const QColor& color);
+    qreal gridOpacity() const { return m_opacity; }
+    void setGridOpacity(qreal opacity);
+
+signals:
+    void gridSizeChanged();
+    void styleChanged();
+
+protected:
+    QSGNode* updatePaintNode(QSGNode* oldNode, UpdatePaintNodeData* data) override;
+    void geometryChange(const QRectF& newGeometry, const QRectF& oldGeometry) override;
+
+private:
+    void invalidateGeometry();
+
+    int m_gridSize = 20;
+    QColor m_colorNormal = QColor("#333333");
+    QColor m_colorMajor = QColor("#666666");
+    QColor m_colorPrimary = QColor("#cc0000");
+    qreal m_opacity = 0.4;
+
+    bool m_geometryDirty = true;
+};
@@ -0,0 +1,524 @@
+#include "signallayer.h"
+#include "topology/spatialindex.h"
+#include "vertexcolor.h"
+
+#include <QCursor>
+#include <QDebug>
+#include <QMouseEvent>
+#include <QSGGeometryNode>
+#include <QSGVertexColorMaterial>
+#include <QtMath>
+
+namespace {
+
+// Same proportions and colours as the former per-type signal QML components
+constexpr float kAspectRatio = 0.46875f;       // height / width
+constexpr int kEllipseSegments = 12;
+constexpr float kLampBorderWidth = 0.5f;
+constexpr float kOverlayBorderWidth = 2.0f;
+constexpr qreal kInactiveOpacity = 0.5;
+constexpr qreal kHoverOpacity = 0.1;
+
+// Largest glyph, in grid cells, for picking through the spatial index
+constexpr double kMaxGlyphCells = 15.0;
+
+const QColor kMastColor("#ffffff");
+const QColor kInactiveMastColor("#888888");
+const QColor kArmDimColor("#b3b3b3");
+const QColor kBorderColor("#b3b3b3");
+const QColor kLampOffColor("#404040");
+const QColor kInactiveLampColor("#606060");
+const QColor kRedColor("#ff0000");
+const QColor kYellowColor("#ffff00");
+const QColor kGreenColor("#00ff00");
+const QColor kCallingOnColor("#f0f8ff");
+const QColor kInactiveBorderColor("#ff6600");
+
+float glyphCells(const QString& type, int aspectCount)
+{
+    if (type == "STARTER") return aspectCount == 2 ? 10.0f : 12.0f;
+    return 15.0f;
+}
+
+} // namespace
+
+SignalLayer::SignalLayer(QQuickItem* parent)
+    : QQuickItem(parent)
+{
+    setFlag(ItemHasContents, true);
+    setAcceptedMouseButtons(Qt::LeftButton);
+    setAcceptHoverEvents(true);
+}
+
+bool SignalLayer::Instance::operational() const
+{
+    return active && (possibleAspects.isEmpty() || possibleAspects.contains(currentAspect));
+}
+
+// ============================================================================
+// MODEL
+// ============================================================================
+
+QString SignalLayer::glyphKeyFor(const SignalInfo& signal)
+{
+    const bool home = signal.type == "HOME";
+    return QStringLiteral("%1|%2|%3|%4|%5")
+        .arg(signal.type, signal.direction)
+        .arg(signal.aspectCount)
+        .arg(home ? signal.loopSignalConfiguration : QString())
+        .arg(home && signal.loop != SignalInfo::Inactive ? 1 : 0);
+}
+
+void SignalLayer::setSignalModel(const QVariantList& signalList)
+{
+    m_signalModel = signalList;
+
+    QList<Instance> instances;
+    instances.reserve(signalList.size());
+    for (const QVariant& item : signalList) {
+        const SignalInfo signal = SignalInfo::fromVariant(item);
+        Instance instance;
+        instance.id = signal.id;
+        instance.type = signal.type;
+        instance.glyphKey = glyphKeyFor(signal);
+        instance.row = signal.row;
+        instance.col = signal.col;
+        instance.currentAspect = signal.currentAspect();
+        instance.callingOnAspect = signal.callingOnAspect();
+        instance.loopAspect = signal.loopAspect();
+        instance.possibleAspects = signal.possibleAspects;
+        instance.active = signal.isActive;
+        instances.append(instance);
+    }
+
+    bool layoutChanged = instances.size() != m_instances.size();
+    for (int i = 0; !layoutChanged && i < instances.size(); ++i) {
+        const Instance& a = instances[i];
+        const Instance& b = m_instances[i];
+        layoutChanged = a.id != b.id || a.glyphKey != b.glyphKey || a.row != b.row || a.col != b.col;
+    }
+
+    if (layoutChanged) {
+        m_instances = std::move(instances);
+        m_indexById.clear();
+        m_indexById.reserve(m_instances.size());
+        for (int i = 0; i < m_instances.size(); ++i) {
+            m_indexById.insert(m_instances[i].id, i);
+        }
+        m_hovered = m_pressed = -1;
+        assignGlyphs();
+    } else {
+        // Aspect changes: only this signal's vertex colours are rewritten
+        for (int i = 0; i < instances.size(); ++i) {
+            Instance& current = m_instances[i];
+            Instance& next = instances[i];
+            if (current.currentAspect != next.currentAspect || current.callingOnAspect != next.callingOnAspect
+                || current.loopAspect != next.loopAspect || current.active != next.active
+                || current.possibleAspects != next.possibleAspects) {
+                next.glyph = current.glyph;
+                next.firstVertex = current.firstVertex;
+                current = std::move(next);
+                markInstanceDirty(i);
+            }
+        }
+    }
+
+    emit signalModelChanged();
+}
+
+void SignalLayer::setCellSize(int size)
+{
+    if (m_cellSize == size) return;
+    m_cellSize = size;
+    m_glyphs.clear();
+    assignGlyphs();
+    emit cellSizeChanged();
+}
+
+QObject* SignalLayer::spatialIndex() const
+{
+    return m_index.data();
+}
+
+void SignalLayer::setSpatialIndex(QObject* index)
+{
+    SpatialIndex* spatialIndex = qobject_cast<SpatialIndex*>(index);
+    if (m_index == spatialIndex) return;
+    m_index = spatialIndex;
+    emit spatialIndexChanged();
+}
+
+void SignalLayer::assignGlyphs()
+{
+    m_vertexCount = 0;
+    for (Instance& instance : m_instances) {
+        auto glyph = m_glyphs.value(instance.glyphKey);
+        if (!glyph) {
+            glyph = buildGlyph(instance.glyphKey);
+            m_glyphs.insert(instance.glyphKey, glyph);
+        }
+        instance.glyph = glyph;
+        instance.firstVertex = m_vertexCount;
+        m_vertexCount += glyph->vertexCount();
+    }
+
+    m_dirtyInstances.clear();
+    m_geometryDirty = true;
+    update();
+}
+
+void SignalLayer::markInstanceDirty(int index)
+{
+    if (index < 0 || m_geometryDirty) return;
+    m_dirtyInstances.append(index);
+    update();
+}
+
+// ============================================================================
+// GLYPHS
+// ============================================================================
+
+QSharedPointer<const SignalLayer::Glyph> SignalLayer::buildGlyph(const QString& key) const
+{
+    const QStringList fields = key.split('|');
+    const QString type = fields.value(0);
+    const bool down = fields.value(1) == "DOWN";
+    const int aspectCount = fields.value(2).toInt();
+    const QString loopConfiguration = fields.value(3);
+    const bool loopActive = fields.value(4) == "1";
+
+    auto glyph = QSharedPointer<Glyph>::create();
+    const float W = glyphCells(type, aspectCount) * m_cellSize;
+    const float H = W * kAspectRatio;
+    const float cy = H / 2;
+    glyph->width = W;
+    glyph->height = H;
+
+    // Shapes are laid out for UP signals; DOWN signals are the mirror image
+    auto vertex = [&](float x, float y, bool mirror) {
+        glyph->positions.append(mirror && down ? W - x : x);
+        glyph->positions.append(y);
+    };
+    auto beginPart = [&](Role role, const QString& slot) {
+        glyph->parts.append({role, slot, glyph->vertexCount(), 0});
+    };
+    auto endPart = [&]() {
+        GlyphPart& part = glyph->parts.last();
+        part.vertexCount = glyph->vertexCount() - part.firstVertex;
+    };
+    auto quad = [&](Role role, const QString& slot, float x, float y, float w, float h, bool mirror = true) {
+        beginPart(role, slot);
+        vertex(x, y, mirror);     vertex(x + w, y, mirror);     vertex(x, y + h, mirror);
+        vertex(x + w, y, mirror); vertex(x + w, y + h, mirror); vertex(x, y + h, mirror);
+        endPart();
+    };
+    auto line = [&](Role role, const QString& slot, float cx, float cy0, float length, float angle, float thickness) {
+        const float dx = qCos(angle) * length / 2, dy = qSin(angle) * length / 2;
+        const float nx = -qSin(angle) * thickness / 2, ny = qCos(angle) * thickness / 2;
+        beginPart(role, slot);
+        vertex(cx - dx - nx, cy0 - dy - ny, false); vertex(cx + dx - nx, cy0 + dy - ny, false);
+        vertex(cx - dx + nx, cy0 - dy + ny, false); vertex(cx + dx - nx, cy0 + dy - ny, false);
+        vertex(cx + dx + nx, cy0 + dy + ny, false); vertex(cx - dx + nx, cy0 - dy + ny, false);
+        endPart();
+    };
+    auto ellipse = [&](Role role, const QString& slot, float cx, float cy0, float rx, float ry) {
+        beginPart(role, slot);
+        for (int i = 0; i < kEllipseSegments; ++i) {
+            const float a0 = 2 * float(M_PI) * i / kEllipseSegments;
+            const float a1 = 2 * float(M_PI) * (i + 1) / kEllipseSegments;
+            vertex(cx, cy0, true);
+            vertex(cx + rx * qCos(a0), cy0 + ry * qSin(a0), true);
+            vertex(cx + rx * qCos(a1), cy0 + ry * qSin(a1), true);
+        }
+        endPart();
+    };
+    auto lamp = [&](const QString& slot, float cx, float cy0, float w, float h) {
+        ellipse(Role::LampBorder, slot, cx, cy0, w / 2 + kLampBorderWidth, h / 2 + kLampBorderWidth);
+        ellipse(Role::Lamp, slot, cx, cy0, w / 2, h / 2);
+    };
+
+    // Horizontal run: mast, arm, lamps, left to right for UP signals
+    float x = 0;
+    auto mast = [&](float w, float h) { quad(Role::Mast, {}, x, cy - h / 2, w, h); x += w; };
+    auto arm = [&](float w, float h) { quad(Role::Arm, {}, x, cy - h / 2, w, h); x += w; };
+    auto lampInRow = [&](const QString& slot, float w, float h) { lamp(slot, x + w / 2, cy, w, h); x += w; };
+
+    const float armHeight = H * 0.053f;
+    const float lampWidth = W * 0.15625f;
+    const float lampHeight = H * 0.333f;
+
+    if (type == "HOME") {
+        mast(W * 0.03125f, H * 0.4f);
+        arm(W * 0.1125f, armHeight);
+        lampInRow("CALLING_ON", lampWidth * 0.75f, lampHeight * 0.75f);
+
+        if (loopActive) {
+            // Loop branch: mast 2 rises (U) or drops (D) from the middle of arm
+            // segment 2, arm 3 runs left or right, the loop lamp sits at its end
+            const float arm2Width = W * 0.1125f;
+            const float mast2Width = W * 0.025f;
+            const float mast2Height = H * 0.43f;
+            const float arm3Width = W * 0.08f;
+            const bool mastUp = loopConfiguration.left(1) != "D";
+            const bool armRight = loopConfiguration.mid(1, 1) != "L";
+
+            quad(Role::Arm, {}, x, cy - armHeight / 2, arm2Width, armHeight);
+            const float mastX = x + arm2Width / 2 - mast2Width / 2;
+            const float mastY = mastUp ? cy - armHeight / 2 - mast2Height : cy + armHeight / 2;
+            quad(Role::Mast, {}, mastX, mastY, mast2Width, mast2Height);
+
+            const float branchY = mastUp ? mastY : mastY + mast2Height;
+            const float arm3X = armRight ? mastX + mast2Width : mastX - arm3Width;
+            quad(Role::Arm, {}, arm3X, branchY - armHeight / 2, arm3Width, armHeight);
+
+            const float loopWidth = lampWidth * 0.7f;
+            const float loopHeight = lampHeight * 0.7f;
+            const float loopX = armRight ? arm3X + arm3Width + loopWidth / 2 : arm3X - loopWidth / 2;
+            lamp("LOOP", loopX, branchY, loopWidth, loopHeight);
+            x += arm2Width;
+        }
+
+        lampInRow("RED", lampWidth, lampHeight);
+        if (aspectCount >= 2) lampInRow("YELLOW", lampWidth, lampHeight);
+        if (aspectCount >= 3) lampInRow("GREEN", lampWidth, lampHeight);
+    } else if (type == "STARTER") {
+        mast(W * 0.04f, H * 0.4f);
+        arm(W * 0.15f, armHeight);
+        lampInRow("RED", W * 0.16f, lampHeight);
+        lampInRow("YELLOW", W * 0.16f, lampHeight);
+        if (aspectCount >= 3) lampInRow("GREEN", W * 0.16f, lampHeight);
+    } else if (type == "ADVANCED_STARTER") {
+        mast(W * 0.03125f, H * 0.4f);
+        arm(W * 0.1125f, armHeight);
+        lampInRow("RED", lampWidth, lampHeight);
+        lampInRow("GREEN", lampWidth, lampHeight);
+    } else {   // OUTER
+        mast(W * 0.03125f, H * 0.4f);
+        arm(W * 0.1125f, armHeight);
+        if (aspectCount >= 3) lampInRow("SINGLE_YELLOW", lampWidth, lampHeight);
+        lampInRow("RED", lampWidth, lampHeight);
+        if (aspectCount >= 4) lampInRow("DOUBLE_YELLOW", lampWidth, lampHeight);
+        if (aspectCount >= 3) lampInRow("GREEN", lampWidth, lampHeight);
+    }
+
+    // Hover highlight and out-of-service cross cover the whole glyph
+    quad(Role::Hover, {}, 0, 0, W, H, false);
+    quad(Role::InactiveOverlay, {}, 0, 0, W, kOverlayBorderWidth, false);
+    quad(Role::InactiveOverlay, {}, 0, H - kOverlayBorderWidth, W, kOverlayBorderWidth, false);
+    quad(Role::InactiveOverlay, {}, 0, 0, kOverlayBorderWidth, H, false);
+    quad(Role::InactiveOverlay, {}, W - kOverlayBorderWidth, 0, kOverlayBorderWidth, H, false);
+    line(Role::InactiveOverlay, "DIAGONAL", W / 2, H / 2, W * 1.414f, float(M_PI) / 4, 1.0f);
+    line(Role::InactiveOverlay, "DIAGONAL", W / 2, H / 2, W * 1.414f, -float(M_PI) / 4, 1.0f);
+
+    return glyph;
+}
+
+// ============================================================================
+// PICKING
+// ============================================================================
+
+int SignalLayer::pick(qreal x, qreal y) const
+{
+    if (m_instances.isEmpty() || m_cellSize <= 0) return -1;
+
+    auto hit = [&](int index) {
+        const Instance& instance = m_instances[index];
+        const qreal left = instance.col * m_cellSize;
+        const qreal top = instance.row * m_cellSize;
+        return x >= left && x < left + instance.glyph->width && y >= top && y < top + instance.glyph->height;
+    };
+
+    // Later signals are drawn on top, so prefer the highest index
+    int best = -1;
+    if (m_index && m_index->elementCount() > 0) {
+        const double row = y / m_cellSize;
+        const double col = x / m_cellSize;
+        const QList<int> candidates = m_index->queryRect(row - kMaxGlyphCells * kAspectRatio, col - kMaxGlyphCells,
+                                                         row, col, 1u << SpatialIndex::Signal);
+        for (int candidate : candidates) {
+            const int index = m_indexById.value(m_index->element(candidate).id, -1);
+            if (index > best && hit(index)) best = index;
+        }
+        return best;
+    }
+
+    for (int i = m_instances.size() - 1; i >= 0; --i) {
+        if (hit(i)) return i;
+    }
+    return -1;
+}
+
+QString SignalLayer::signalAt(qreal x, qreal y) const
+{
+    const int index = pick(x, y);
+    return index >= 0 ? m_instances[index].id : QString();
+}
+
+void SignalLayer::setHovered(int index)
+{
+    if (m_hovered == index) return;
+
+    const int previous = m_hovered;
+    m_hovered = index;
+    markInstanceDirty(previous);
+    markInstanceDirty(index);
+
+    if (index >= 0) {
+        setCursor(m_instances[index].operational() ? Qt::PointingHandCursor : Qt::ForbiddenCursor);
+    } else {
+        unsetCursor();
+    }
+}
+
+void SignalLayer::hoverMoveEvent(QHoverEvent* event)
+{
+    setHovered(pick(event->position().x(), event->position().y()));
+}
+
+void SignalLayer::hoverLeaveEvent(QHoverEvent*)
+{
+    setHovered(-1);
+}
+
+void SignalLayer::mousePressEvent(QMouseEvent* event)
+{
+    m_pressed = pick(event->position().x(), event->position().y());
+    if (m_pressed < 0) {
+        event->ignore();
+        return;
+    }
+    event->accept();
+}
+
+void SignalLayer::mouseReleaseEvent(QMouseEvent* event)
+{
+    const int released = pick(event->position().x(), event->position().y());
+    const int pressed = m_pressed;
+    m_pressed = -1;
+
+    if (pressed < 0 || released != pressed) return;
+
+    const Instance& instance = m_instances[pressed];
+    if (!instance.operational()) {
+        qDebug() << "Signal operation blocked:" << instance.id << "Active:" << instance.active;
+        return;
+    }
+    emit signalClicked(instance.id, instance.currentAspect, instance.type);
+}
+
+// ============================================================================
+// RENDERING
+// ============================================================================
+
+void SignalLayer::writePositions(void* vertices, int index) const
+{
+    const Instance& instance = m_instances[index];
+    auto* vertex = static_cast<QSGGeometry::ColoredPoint2D*>(vertices) + instance.firstVertex;
+    const float originX = float(instance.col * m_cellSize);
+    const float originY = float(instance.row * m_cellSize);
+
+    const QList<float>& positions = instance.glyph->positions;
+    for (int i = 0; i < positions.size(); i += 2, ++vertex) {
+        vertex->x = originX + positions[i];
+        vertex->y = originY + positions[i + 1];
+    }
+}
+
+void SignalLayer::writeColours(void* vertices, int index) const
+{
+    const Instance& s = m_instances[index];
+    auto* vertex = static_cast<QSGGeometry::ColoredPoint2D*>(vertices) + s.firstVertex;
+    const qreal opacity = s.active ? 1.0 : kInactiveOpacity;
+
+    auto lampColour = [&](const QString& slot) -> QColor {
+        if (!s.active) return kInactiveLampColor;
+        if (slot == "CALLING_ON") return s.callingOnAspect == "WHITE" ? kCallingOnColor : kLampOffColor;
+        if (slot == "LOOP") return s.loopAspect == "YELLOW" ? kYellowColor : kLampOffColor;
+
+        bool lit = s.currentAspect == slot;
+        if (slot == "SINGLE_YELLOW") lit = lit || s.currentAspect == "DOUBLE_YELLOW";
+        if (!lit) return kLampOffColor;
+        if (slot == "RED") return kRedColor;
+        if (slot == "GREEN") return kGreenColor;
+        return kYellowColor;
+    };
+
+    for (const GlyphPart& part : s.glyph->parts) {
+        VertexColor colour;
+        switch (part.role) {
+        case Role::Mast:
+            colour = VertexColor::premultiplied(s.active ? kMastColor : kInactiveMastColor, opacity);
+            break;
+        case Role::Arm: {
+            QColor arm = s.active ? kMastColor : kInactiveMastColor;
+            if (s.active && s.type == "HOME" && s.callingOnAspect != "WHITE") arm = kArmDimColor;
+            colour = VertexColor::premultiplied(arm, opacity);
+            break;
+        }
+        case Role::LampBorder:
+            colour = VertexColor::premultiplied(kBorderColor, opacity);
+            break;
+        case Role::Lamp:
+            colour = VertexColor::premultiplied(lampColour(part.slot), opacity);
+            break;
+        case Role::Hover:
+            if (index == m_hovered) {
+                colour = VertexColor::premultiplied(s.operational() ? Qt::white : Qt::red, kHoverOpacity);
+            }
+            break;
+        case Role::InactiveOverlay:
+            if (!s.active) {
+                colour = VertexColor::premultiplied(kInactiveBorderColor, part.slot == "DIAGONAL" ? 0.42 : 0.7);
+            }
+            break;
+        }
+
+        for (int v = 0; v < part.vertexCount; ++v) {
+            colour.applyTo(vertex[part.firstVertex + v]);
+        }
+    }
+}
+
+QSGNode* SignalLayer::updatePaintNode(QSGNode* oldNode, UpdatePaintNodeData*)
+{
+    auto* node = static_cast<QSGGeometryNode*>(oldNode);
+
+    if (m_instances.isEmpty() || m_cellSize <= 0) {
+        delete node;
+        m_geometryDirty = true;
+        m_dirtyInstances.clear();
+        return nullptr;
+    }
+
+    if (!node) {
+        node = new QSGGeometryNode;
+        auto* geometry = new QSGGeometry(QSGGeometry::defaultAttributes_ColoredPoint2D(), 0);
+        geometry->setDrawingMode(QSGGeometry::DrawTriangles);
+        node->setGeometry(geometry);
+        node->setFlag(QSGNode::OwnsGeometry);
+        node->setMaterial(new QSGVertexColorMaterial);
+        node->setFlag(QSGNode::OwnsMaterial);
+        m_geometryDirty = true;
+    }
+
+    QSGGeometry* geometry = node->geometry();
+
+    if (m_geometryDirty) {
+        geometry->allocate(m_vertexCount);
+        for (int i = 0; i < m_instances.size(); ++i) {
+            writePositions(geometry->vertexData(), i);
+            writeColours(geometry->vertexData(), i);
+        }
+        m_geometryDirty = false;
+        m_dirtyInstances.clear();
+        node->markDirty(QSGNode::DirtyGeometry);
+    } else if (!m_dirtyInstances.isEmpty()) {
+        for (int index : std::as_const(m_dirtyInstances)) {
+            writeColours(geometry->vertexData(), index);
+        }
+        m_dirtyInstances.clear();
+        node->markDirty(QSGNode::DirtyGeometry);
+    }
+
+    return node;
+}
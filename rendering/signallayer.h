@@ -0,0 +1,129 @@
+#pragma once
+
+#include <QHash>
+#include <QList>
+#include <QPointer>
+#include <QQuickItem>
+#include <QSharedPointer>
+#include <QStringList>
+#include <QVariantList>
+
+#include "database/elementinfo.h"
+
+class SpatialIndex;
+
+// Every signal head of every type (outer, home, starter, advanced starter)
+// drawn in one scene-graph node.
+//
+// Each distinct signal shape (type, direction, aspect count, loop arm
+// configuration) is tessellated once per cellSize into a shared glyph table;
+// instances copy the glyph's vertices at their position. Every glyph part has
+// a role (mast, arm, lamp slot, overlay), and a change of currentAspect,
+// callingOnAspect, loopAspect or isActive only rewrites the colours of that
+// signal's vertices.
+class SignalLayer : public QQuickItem {
+    Q_OBJECT
+    Q_PROPERTY(QVariantList signalModel READ signalModel WRITE setSignalModel NOTIFY signalModelChanged)
+    Q_PROPERTY(int cellSize READ cellSize WRITE setCellSize NOTIFY cellSizeChanged)
+    Q_PROPERTY(QObject* spatialIndex READ spatialIndex WRITE setSpatialIndex NOTIFY spatialIndexChanged)
+    Q_PROPERTY(int signalCount READ signalCount NOTIFY signalModelChanged)
+    Q_PROPERTY(int glyphCount READ glyphCount NOTIFY signalModelChanged)
+
+public:
+    explicit SignalLayer(QQuickItem* parent = nullptr);
+
+    QVariantList signalModel() const { return m_signalModel; }
+    void setSignalModel(const QVariantList& signalList);
+
+    int cellSize() const { return m_cellSize; }
+    void setCellSize(int size);
+
+    QObject* spatialIndex() const;
+    void setSpatialIndex(QObject* index);
+
+    int signalCount() const { return m_instances.size(); }
+    int glyphCount() const { return m_glyphs.size(); }
+
+    // Signal under a point in item coordinates ("" when none)
+    Q_INVOKABLE QString signalAt(qreal x, qreal y) const;
+
+signals:
+    void signalModelChanged();
+    void cellSizeChanged();
+    void spatialIndexChanged();
+    void signalClicked(const QString& signalId, const QString& currentAspect, const QString& signalType);
+
+protected:
+    QSGNode* updatePaintNode(QSGNode* oldNode, UpdatePaintNodeData* data) override;
+    void mousePressEvent(QMouseEvent* event) override;
+    void mouseReleaseEvent(QMouseEvent* event) override;
+    void hoverMoveEvent(QHoverEvent* event) override;
+    void hoverLeaveEvent(QHoverEvent* event) override;
+
+private:
+    enum class Role : quint8 {
+        Mast,
+        Arm,
+        LampBorder,
+        Lamp,
+        Hover,
+        InactiveOverlay
+    };
+
+    struct GlyphPart {
+        Role role;
+        QString slot;          // lamp aspect ("RED", "SINGLE_YELLOW", "CALLING_ON", "LOOP", ...) or overlay detail
+        int firstVertex;
+        int vertexCount;
+    };
+
+    struct Glyph {
+        QList<float> positions;   // x, y pairs relative to the signal origin
+        QList<GlyphPart> parts;
+        float width = 0;
+        float height = 0;
+        int vertexCount() const { return positions.size() / 2; }
+    };
+
+    struct Instance {
+        QString id;
+        QString type;
+        QString glyphKey;
+        QSharedPointer<const Glyph> glyph;
+        double row = 0, col = 0;
+        int firstVertex = 0;
+
+        QString currentAspect;
+        QString callingOnAspect;
+        QString loopAspect;
+        QStringList possibleAspects;
+        bool active = true;
+
+        bool operational() const;
+    };
+
+    // "TYPE|DIRECTION|aspectCount|loopConfiguration|loopActive"
+    static QString glyphKeyFor(const SignalInfo& signal);
+    QSharedPointer<const Glyph> buildGlyph(const QString& key) const;
+    void assignGlyphs();
+
+    int pick(qreal x, qreal y) const;
+    void setHovered(int index);
+    void markInstanceDirty(int index);
+    void writePositions(void* vertices, int index) const;
+    void writeColours(void* vertices, int index) const;
+
+    QVariantList m_signalModel;
+    QList<Instance> m_instances;
+    QHash<QString, int> m_indexById;
+    QHash<QString, QSharedPointer<const Glyph>> m_glyphs;   // per cellSize
+    QPointer<SpatialIndex> m_index;
+    int m_cellSize = 20;
+    int m_vertexCount = 0;
+
+    int m_hovered = -1;
+    int m_pressed = -1;
+
+    bool m_geometryDirty = true;
+    QList<int> m_dirtyInstances;
+};
@@ -0,0 +1,346 @@
+#include "tracklayer.h"
+#include "topology/spatialindex.h"
+#include "vertexcolor.h"
+
+#include <QCursor>
+#include <QDebug>
+#include <QMouseEvent>
+#include <QSGGeometryNode>
+#include <QSGVertexColorMaterial>
+#include <QtMath>
+
+namespace {
+
+// Same visual constants as the former TrackSegment.qml delegate
+constexpr float kTrackThickness = 8.0f;
+constexpr float kRailThickness = 1.0f;
+constexpr float kRailMargin = 1.0f;
+constexpr qreal kHoverMix = 0.2;
+constexpr qreal kPickTolerance = 4.0;   // pixels beyond the track bed
+
+const QColor kOccupiedColor("#ff3232");
+const QColor kAssignedColor("#ffff00");
+const QColor kInactiveColor("#606060");
+const QColor kRailColor("#a6a6a6");
+
+} // namespace
+
+TrackLayer::TrackLayer(QQuickItem* parent)
+    : QQuickItem(parent)
+{
+    setFlag(ItemHasContents, true);
+    setAcceptedMouseButtons(Qt::LeftButton);
+    setAcceptHoverEvents(true);
+}
+
+// ============================================================================
+// MODEL
+// ============================================================================
+
+TrackLayer::Segment TrackLayer::segmentFrom(const TrackSegmentInfo& track)
+{
+    Segment segment;
+    segment.id = track.id;
+    segment.trackType = track.trackType.toUpper();
+    segment.startRow = track.startRow;
+    segment.startCol = track.startCol;
+    segment.endRow = track.endRow;
+    segment.endCol = track.endCol;
+    segment.occupied = track.occupied;
+    segment.assigned = track.assigned;
+    segment.active = track.isActive;
+    return segment;
+}
+
+bool TrackLayer::sameGeometry(const Segment& a, const Segment& b)
+{
+    return a.id == b.id && a.trackType == b.trackType
+        && a.startRow == b.startRow && a.startCol == b.startCol
+        && a.endRow == b.endRow && a.endCol == b.endCol;
+}
+
+QColor TrackLayer::typeColor(const QString& trackType)
+{
+    if (trackType == "CURVED") return QColor("#9999aa");
+    if (trackType == "SIDING") return QColor("#aa9966");
+    if (trackType == "PLATFORM") return QColor("#66aa99");
+    if (trackType == "YARD") return QColor("#996699");
+    return QColor("#a6a6a6");
+}
+
+void TrackLayer::setTracks(const QVariantList& tracks)
+{
+    m_tracks = tracks;
+
+    QList<Segment> segments;
+    segments.reserve(tracks.size());
+    for (const QVariant& item : tracks) {
+        segments.append(segmentFrom(TrackSegmentInfo::fromVariant(item)));
+    }
+
+    bool layoutChanged = segments.size() != m_segments.size();
+    for (int i = 0; !layoutChanged && i < segments.size(); ++i) {
+        layoutChanged = !sameGeometry(segments[i], m_segments[i]);
+    }
+
+    if (layoutChanged) {
+        m_segments = std::move(segments);
+        m_indexById.clear();
+        m_indexById.reserve(m_segments.size());
+        for (int i = 0; i < m_segments.size(); ++i) {
+            m_indexById.insert(m_segments[i].id, i);
+        }
+        m_hovered = m_pressed = -1;
+        m_dirtySegments.clear();
+        m_geometryDirty = true;
+        update();
+    } else {
+        // State refresh: only segments whose flags flipped get new colours
+        for (int i = 0; i < segments.size(); ++i) {
+            Segment& current = m_segments[i];
+            const Segment& next = segments[i];
+            if (current.occupied != next.occupied || current.assigned != next.assigned
+                || current.active != next.active) {
+                current.occupied = next.occupied;
+                current.assigned = next.assigned;
+                current.active = next.active;
+                markSegmentDirty(i);
+            }
+        }
+    }
+
+    emit tracksChanged();
+}
+
+void TrackLayer::setCellSize(int size)
+{
+    if (m_cellSize == size) return;
+    m_cellSize = size;
+    m_geometryDirty = true;
+    emit cellSizeChanged();
+    update();
+}
+
+QObject* TrackLayer::spatialIndex() const
+{
+    return m_index.data();
+}
+
+void TrackLayer::setSpatialIndex(QObject* index)
+{
+    SpatialIndex* spatialIndex = qobject_cast<SpatialIndex*>(index);
+    if (m_index == spatialIndex) return;
+    m_index = spatialIndex;
+    emit spatialIndexChanged();
+}
+
+QString TrackLayer::hoveredSegment() const
+{
+    return m_hovered >= 0 ? m_segments[m_hovered].id : QString();
+}
+
+void TrackLayer::markSegmentDirty(int index)
+{
+    if (index < 0 || m_geometryDirty) return;
+    m_dirtySegments.append(index);
+    update();
+}
+
+// ============================================================================
+// PICKING
+// ============================================================================
+
+int TrackLayer::pick(qreal x, qreal y) const
+{
+    if (m_segments.isEmpty() || m_cellSize <= 0) return -1;
+
+    // Undo the half-thickness offset of the bed, then work in grid units
+    const double row = (y - kTrackThickness / 2) / m_cellSize;
+    const double col = x / m_cellSize;
+    const double tolerance = (kTrackThickness / 2 + kPickTolerance) / m_cellSize;
+
+    if (m_index && m_index->elementCount() > 0) {
+        const int hit = m_index->nearest(row, col, tolerance, 1u << SpatialIndex::TrackSegment);
+        return hit >= 0 ? m_indexById.value(m_index->element(hit).id, -1) : -1;
+    }
+
+    int best = -1;
+    double bestDistance = tolerance;
+    for (int i = 0; i < m_segments.size(); ++i) {
+        const Segment& s = m_segments[i];
+        const double dRow = s.endRow - s.startRow;
+        const double dCol = s.endCol - s.startCol;
+        const double lengthSquared = dRow * dRow + dCol * dCol;
+        const double t = lengthSquared > 0.0
+            ? qBound(0.0, ((row - s.startRow) * dRow + (col - s.startCol) * dCol) / lengthSquared, 1.0)
+            : 0.0;
+        const double distance = qHypot(s.startRow + t * dRow - row, s.startCol + t * dCol - col);
+        if (distance <= bestDistance) {
+            bestDistance = distance;
+            best = i;
+        }
+    }
+    return best;
+}
+
+QString TrackLayer::segmentAt(qreal x, qreal y) const
+{
+    const int index = pick(x, y);
+    return index >= 0 ? m_segments[index].id : QString();
+}
+
+void TrackLayer::setHovered(int index)
+{
+    if (m_hovered == index) return;
+
+    const int previous = m_hovered;
+    m_hovered = index;
+    markSegmentDirty(previous);
+    markSegmentDirty(index);
+
+    if (index >= 0) {
+        setCursor(m_segments[index].active ? Qt::PointingHandCursor : Qt::ForbiddenCursor);
+        emit trackHovered(m_segments[index].id);
+    } else {
+        unsetCursor();
+    }
+    emit hoveredSegmentChanged();
+}
+
+void TrackLayer::hoverMoveEvent(QHoverEvent* event)
+{
+    setHovered(pick(event->position().x(), event->position().y()));
+}
+
+void TrackLayer::hoverLeaveEvent(QHoverEvent*)
+{
+    setHovered(-1);
+}
+
+void TrackLayer::mousePressEvent(QMouseEvent* event)
+{
+    m_pressed = pick(event->position().x(), event->position().y());
+    if (m_pressed < 0) {
+        event->ignore();   // let items and the Flickable underneath have it
+        return;
+    }
+    event->accept();
+}
+
+void TrackLayer::mouseReleaseEvent(QMouseEvent* event)
+{
+    const int released = pick(event->position().x(), event->position().y());
+    const int pressed = m_pressed;
+    m_pressed = -1;
+
+    if (pressed < 0 || released != pressed) return;
+
+    const Segment& segment = m_segments[pressed];
+    if (!segment.active) {
+        qDebug() << "Track segment inactive:" << segment.id << "- Click ignored";
+        return;
+    }
+    emit trackClicked(segment.id, segment.occupied);
+}
+
+// ============================================================================
+// RENDERING
+// ============================================================================
+
+void TrackLayer::writePositions(void* vertices, int index) const
+{
+    auto* vertex = static_cast<QSGGeometry::ColoredPoint2D*>(vertices) + index * kVerticesPerSegment;
+    const Segment& s = m_segments[index];
+
+    // Centre line sits half a bed below the grid line, as the QML delegate did
+    const float x0 = float(s.startCol * m_cellSize);
+    const float y0 = float(s.startRow * m_cellSize) + kTrackThickness / 2;
+    const float x1 = float(s.endCol * m_cellSize);
+    const float y1 = float(s.endRow * m_cellSize) + kTrackThickness / 2;
+
+    const float length = qHypot(x1 - x0, y1 - y0);
+    const float nx = length > 0 ? -(y1 - y0) / length : 0.0f;
+    const float ny = length > 0 ? (x1 - x0) / length : 0.0f;
+
+    auto quad = [&](float from, float to) {
+        vertex[0].x = x0 + nx * from; vertex[0].y = y0 + ny * from;
+        vertex[1].x = x1 + nx * from; vertex[1].y = y1 + ny * from;
+        vertex[2].x = x0 + nx * to;   vertex[2].y = y0 + ny * to;
+        vertex[3] = vertex[1];
+        vertex[4].x = x1 + nx * to;   vertex[4].y = y1 + ny * to;
+        vertex[5] = vertex[2];
+        vertex += 6;
+    };
+
+    const float half = kTrackThickness / 2;
+    quad(-half, half);                                                    // bed
+    quad(-half + kRailMargin, -half + kRailMargin + kRailThickness);      // rail
+    quad(half - kRailMargin - kRailThickness, half - kRailMargin);        // rail
+}
+
+void TrackLayer::writeColours(void* vertices, int index) const
+{
+    auto* vertex = static_cast<QSGGeometry::ColoredPoint2D*>(vertices) + index * kVerticesPerSegment;
+    const Segment& s = m_segments[index];
+
+    QColor bed = !s.active ? kInactiveColor
+               : s.assigned ? kAssignedColor
+               : s.occupied ? kOccupiedColor
+               : typeColor(s.trackType);
+    if (index == m_hovered) {
+        bed.setRgbF(bed.redF() + (1.0f - bed.redF()) * kHoverMix,
+                    bed.greenF() + (1.0f - bed.greenF()) * kHoverMix,
+                    bed.blueF() + (1.0f - bed.blueF()) * kHoverMix);
+    }
+
+    const VertexColor bedColour = VertexColor::premultiplied(bed, s.active ? 1.0 : 0.6);
+    const VertexColor railColour = VertexColor::premultiplied(kRailColor, s.active ? 1.0 : 0.3);
+
+    for (int v = 0; v < kVerticesPerSegment; ++v) {
+        (v < 6 ? bedColour : railColour).applyTo(vertex[v]);
+    }
+}
+
+QSGNode* TrackLayer::updatePaintNode(QSGNode* oldNode, UpdatePaintNodeData*)
+{
+    auto* node = static_cast<QSGGeometryNode*>(oldNode);
+
+    if (m_segments.isEmpty() || m_cellSize <= 0) {
+        delete node;
+        m_geometryDirty = true;
+        m_dirtySegments.clear();
+        return nullptr;
+    }
+
+    if (!node) {
+        node = new QSGGeometryNode;
+        auto* geometry = new QSGGeometry(QSGGeometry::defaultAttributes_ColoredPoint2D(), 0);
+        geometry->setDrawingMode(QSGGeometry::DrawTriangles);
+        node->setGeometry(geometry);
+        node->setFlag(QSGNode::OwnsGeometry);
+        node->setMaterial(new QSGVertexColorMaterial);
+        node->setFlag(QSGNode::OwnsMaterial);
+        m_geometryDirty = true;
+    }
+
+    QSGGeometry* geometry = node->geometry();
+
+    if (m_geometryDirty) {
+        geometry->allocate(m_segments.size() * kVerticesPerSegment);
+        for (int i = 0; i < m_segments.size(); ++i) {
+            writePositions(geometry->vertexData(), i);
+            writeColours(geometry->vertexData(), i);
+        }
+        m_geometryDirty = false;
+        m_dirtySegments.clear();
+        node->markDirty(QSGNode::DirtyGeometry);
+    } else if (!m_dirtySegments.isEmpty()) {
+        for (int index : std::as_const(m_dirtySegments)) {
+            writeColours(geometry->vertexData(), index);
+        }
+        m_dirtySegments.clear();
+        node->markDirty(QSGNode::DirtyGeometry);
+    }
+
+    return node;
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <QColor>
+#include <QHash>
+#include <QList>
+#include <QPointer>
+#include <QQuickItem>
+#include <QVariantList>
+
+#include "database/elementinfo.h"
+
+class SpatialIndex;
+
+// All track segments of a station drawn as quads in one scene-graph node.
+//
+// Each segment owns a fixed run of vertices (bed + two rails). Geometry is
+// rebuilt only when the layout or cellSize changes; occupancy, assignment,
+// activity and hover changes rewrite the colours of the affected segment's
+// vertices and nothing else. Clicks are resolved with segmentAt(), which uses
+// the SpatialIndex when one is set.
+class TrackLayer : public QQuickItem {
+    Q_OBJECT
+    Q_PROPERTY(QVariantList tracks READ tracks WRITE setTracks NOTIFY tracksChanged)
+    Q_PROPERTY(int cellSize READ cellSize WRITE setCellSize NOTIFY cellSizeChanged)
+    Q_PROPERTY(QObject* spatialIndex READ spatialIndex WRITE setSpatialIndex NOTIFY spatialIndexChanged)
+    Q_PROPERTY(QString hoveredSegment READ hoveredSegment NOTIFY hoveredSegmentChanged)
+    Q_PROPERTY(int segmentCount READ segmentCount NOTIFY tracksChanged)
+
+public:
+    explicit TrackLayer(QQuickItem* parent = nullptr);
+
+    QVariantList tracks() const { return m_tracks; }
+    void setTracks(const QVariantList& tracks);
+
+    int cellSize() const { return m_cellSize; }
+    void setCellSize(int size);
+
+    QObject* spatialIndex() const;
+    void setSpatialIndex(QObject* index);
+
+    QString hoveredSegment() const;
+    int segmentCount() const { return m_segments.size(); }
+
+    // Segment under a point in item coordinates ("" when none)
+    Q_INVOKABLE QString segmentAt(qreal x, qreal y) const;
+
+signals:
+    void tracksChanged();
+    void cellSizeChanged();
+    void spatialIndexChanged();
+    void hoveredSegmentChanged();
+    void trackClicked(const QString& segmentId, bool currentState);
+    void trackHovered(const QString& segmentId);
+
+protected:
+    QSGNode* updatePaintNode(QSGNode* oldNode, UpdatePaintNodeData* data) override;
+    void mousePressEvent(QMouseEvent* event) override;
+    void mouseReleaseEvent(QMouseEvent* event) override;
+    void hoverMoveEvent(QHoverEvent* event) override;
+    void hoverLeaveEvent(QHoverEvent* event) override;
+
+private:
+    struct Segment {
+        QString id;
+        QString trackType;
+        double startRow = 0, startCol = 0;
+        double endRow = 0, endCol = 0;
+        bool occupied = false;
+        bool assigned = false;
+        bool active = true;
+    };
+
+    static constexpr int kVerticesPerSegment = 18;   // 3 quads, 2 triangles each
+
+    static Segment segmentFrom(const TrackSegmentInfo& track);
+    static bool sameGeometry(const Segment& a, const Segment& b);
+    static QColor typeColor(const QString& trackType);
+
+    int pick(qreal x, qreal y) const;
+    void setHovered(int index);
+    void markSegmentDirty(int index);
+    void writeColours(void* vertices, int index) const;
+    void writePositions(void* vertices, int index) const;
+
+    QVariantList m_tracks;
+    QList<Segment> m_segments;
+    QHash<QString, int> m_indexById;
+    QPointer<SpatialIndex> m_index;
+    int m_cellSize = 20;
+
+    int m_hovered = -1;
+    int m_pressed = -1;
+
+    bool m_geometryDirty = true;
+    QList<int> m_dirtySegments;
+};
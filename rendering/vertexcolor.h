@@ -0,0 +1,24 @@
+#pragma once
+
+#include <QColor>
+#include <QSGGeometry>
+
+// Vertex colour for QSGVertexColorMaterial, which expects premultiplied alpha
+struct VertexColor {
+    uchar r = 0, g = 0, b = 0, a = 0;
+
+    static VertexColor premultiplied(const QColor& color, qreal opacity = 1.0)
+    {
+        const qreal alpha = color.alphaF() * opacity;
+        return {uchar(color.red() * alpha), uchar(color.green() * alpha),
+                uchar(color.blue() * alpha), uchar(alpha * 255)};
+    }
+
+    void applyTo(QSGGeometry::ColoredPoint2D& vertex) const
+    {
+        vertex.r = r;
+        vertex.g = g;
+        vertex.b = b;
+        vertex.a = a;
+    }
+};
@@ -0,0 +1,233 @@
+#include "viewportmodel.h"
+#include "topology/spatialindex.h"
+
+#include <QMetaProperty>
+
+namespace {
+QString elementId(const QVariant& element)
+{
+    // Value types resolve "id" through their static metaobject
+    if (const QMetaObject* metaObject = element.metaType().metaObject()) {
+        const int property = metaObject->indexOfProperty("id");
+        if (property >= 0) {
+            return metaObject->property(property).readOnGadget(element.constData()).toString();
+        }
+    }
+    return element.toMap().value("id").toString();
+}
+}
+
+ViewportModel::ViewportModel(QObject* parent)
+    : QAbstractListModel(parent)
+{
+}
+
+int ViewportModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : m_slots.size();
+}
+
+QVariant ViewportModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_slots.size()) {
+        return QVariant();
+    }
+
+    const Slot& slot = m_slots[index.row()];
+    switch (role) {
+    case ModelDataRole:
+        return slot.data;
+    case SlotActiveRole:
+        return slot.active;
+    default:
+        return QVariant();
+    }
+}
+
+QHash<int, QByteArray> ViewportModel::roleNames() const
+{
+    // "modelData" keeps existing delegates (modelData.startRow, ...) unchanged
+    return {
+        {ModelDataRole, "modelData"},
+        {SlotActiveRole, "slotActive"}
+    };
+}
+
+QObject* ViewportModel::spatialIndex() const
+{
+    return m_index.data();
+}
+
+void ViewportModel::setSpatialIndex(QObject* index)
+{
+    SpatialIndex* spatialIndex = qobject_cast<SpatialIndex*>(index);
+    if (m_index == spatialIndex) return;
+
+    if (m_index) {
+        disconnect(m_index, nullptr, this, nullptr);
+    }
+    m_index = spatialIndex;
+    if (m_index) {
+        connect(m_index, &SpatialIndex::indexRebuilt, this, [this]() { updateSlots(); });
+    }
+
+    emit spatialIndexChanged();
+    updateSlots();
+}
+
+void ViewportModel::setElementType(const QString& type)
+{
+    if (m_elementType == type) return;
+    m_elementType = type;
+    emit elementTypeChanged();
+    updateSlots();
+}
+
+void ViewportModel::setElements(const QVariantList& elements)
+{
+    m_elements = elements;
+
+    QHash<QString, QVariant> dataById;
+    dataById.reserve(elements.size());
+    for (const QVariant& item : elements) {
+        dataById.insert(elementId(item), item);
+    }
+
+    m_dataById = std::move(dataById);
+
+    // State refreshes keep the same IDs: only rebind slots whose data moved
+    for (int row = 0; row < m_slots.size(); ++row) {
+        Slot& slot = m_slots[row];
+        const auto it = m_dataById.constFind(slot.id);
+        if (slot.active && it != m_dataById.constEnd() && it.value() != slot.data) {
+            slot.data = it.value();
+            const QModelIndex changed = index(row);
+            emit dataChanged(changed, changed, {ModelDataRole});
+        }
+    }
+
+    emit elementsChanged();
+    updateSlots();
+}
+
+void ViewportModel::setViewport(const QRectF& viewport)
+{
+    if (m_viewport == viewport) return;
+    m_viewport = viewport;
+    emit viewportChanged();
+
+    // Panning inside the margin needs no work at all
+    if (!m_coveredRect.contains(viewport)) {
+        updateSlots();
+    }
+}
+
+void ViewportModel::setMargin(double margin)
+{
+    if (qFuzzyCompare(m_margin, margin)) return;
+    m_margin = margin;
+    emit marginChanged();
+    updateSlots();
+}
+
+quint32 ViewportModel::typeMask() const
+{
+    for (int type = 0; type < SpatialIndex::ElementTypeCount; ++type) {
+        if (SpatialIndex::typeName(SpatialIndex::ElementType(type)) == m_elementType) {
+            return 1u << type;
+        }
+    }
+    return SpatialIndex::AllTypes;
+}
+
+QList<QString> ViewportModel::visibleIds() const
+{
+    QList<QString> ids;
+
+    if (!m_index || m_index->elementCount() == 0 || m_viewport.isEmpty()) {
+        ids.reserve(m_dataById.size());
+        for (auto it = m_dataById.constBegin(); it != m_dataById.constEnd(); ++it) {
+            ids.append(it.key());
+        }
+        return ids;
+    }
+
+    const QList<int> hits = m_index->queryRect(m_coveredRect.top(), m_coveredRect.left(),
+                                               m_coveredRect.bottom(), m_coveredRect.right(), typeMask());
+    ids.reserve(hits.size());
+    for (int hit : hits) {
+        const QString& id = m_index->element(hit).id;
+        // Signals share one index type; each model keeps only its own
+        if (m_dataById.contains(id)) {
+            ids.append(id);
+        }
+    }
+    return ids;
+}
+
+void ViewportModel::updateSlots()
+{
+    m_coveredRect = m_viewport.adjusted(-m_margin, -m_margin, m_margin, m_margin);
+
+    const QList<QString> ids = visibleIds();
+    QHash<QString, int> wanted;
+    wanted.reserve(ids.size());
+    for (const QString& id : ids) {
+        wanted.insert(id, -1);
+    }
+
+    // Keep slots whose element is still visible, free the rest
+    QList<int> freeSlots;
+    for (int row = 0; row < m_slots.size(); ++row) {
+        Slot& slot = m_slots[row];
+        auto it = slot.active ? wanted.find(slot.id) : wanted.end();
+        if (it != wanted.end()) {
+            it.value() = row;
+            continue;
+        }
+
+        if (slot.active) {
+            slot.active = false;
+            const QModelIndex changed = index(row);
+            emit dataChanged(changed, changed, {SlotActiveRole});
+        }
+        freeSlots.append(row);
+    }
+
+    // Newly visible elements reuse free slots first, then grow the pool
+    QList<QString> pending;
+    for (const QString& id : ids) {
+        if (wanted.value(id) >= 0) continue;
+        if (!freeSlots.isEmpty()) {
+            const int row = freeSlots.takeFirst();
+            m_slots[row] = {id, m_dataById.value(id), true};
+            const QModelIndex changed = index(row);
+            emit dataChanged(changed, changed, {ModelDataRole, SlotActiveRole});
+        } else {
+            pending.append(id);
+        }
+    }
+
+    if (!pending.isEmpty()) {
+        const int first = m_slots.size();
+        beginInsertRows(QModelIndex(), first, first + pending.size() - 1);
+        for (const QString& id : pending) {
+            m_slots.append({id, m_dataById.value(id), true});
+        }
+        endInsertRows();
+    }
+
+    m_activeCount = ids.size();
+
+    // Trim idle slots at the tail once the pool is mostly unused
+    int last = m_slots.size() - 1;
+    while (last >= 0 && !m_slots[last].active) --last;
+    const int idleTail = m_slots.size() - 1 - last;
+    if (m_slots.size() > 2 * m_activeCount + 64 && idleTail > 0) {
+        beginRemoveRows(QModelIndex(), last + 1, m_slots.size() - 1);
+        m_slots.resize(last + 1);
+        endRemoveRows();
+    }
+
+    emit poolChanged();
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <QAbstractListModel>
+#include <QHash>
+#include <QList>
+#include <QPointer>
+#include <QRectF>
+#include <QVariant>
+#include <QVariantList>
+
+class SpatialIndex;
+
+// Repeater model that only exposes the elements near the visible region.
+//
+// Rows are a pool of delegate slots: when the viewport moves, slots whose
+// element scrolled away are handed to newly visible elements (dataChanged),
+// so delegates are rebound instead of destroyed and recreated. The pool only
+// grows when more elements are visible than ever before and is trimmed when
+// it is mostly idle. Free slots keep their last data and report
+// slotActive = false so delegates can hide themselves.
+//
+// Visibility comes from SpatialIndex::queryRect(); without an index every
+// element is active (no culling). Elements may be row maps or value types
+// with an "id" property (SignalInfo, ...); either is handed out unchanged.
+class ViewportModel : public QAbstractListModel {
+    Q_OBJECT
+    Q_PROPERTY(QObject* spatialIndex READ spatialIndex WRITE setSpatialIndex NOTIFY spatialIndexChanged)
+    Q_PROPERTY(QString elementType READ elementType WRITE setElementType NOTIFY elementTypeChanged)
+    Q_PROPERTY(QVariantList elements READ elements WRITE setElements NOTIFY elementsChanged)
+    Q_PROPERTY(QRectF viewport READ viewport WRITE setViewport NOTIFY viewportChanged)
+    Q_PROPERTY(double margin READ margin WRITE setMargin NOTIFY marginChanged)
+    Q_PROPERTY(int activeCount READ activeCount NOTIFY poolChanged)
+    Q_PROPERTY(int poolSize READ poolSize NOTIFY poolChanged)
+
+public:
+    enum Roles {
+        ModelDataRole = Qt::UserRole + 1,
+        SlotActiveRole
+    };
+
+    explicit ViewportModel(QObject* parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    QObject* spatialIndex() const;
+    void setSpatialIndex(QObject* index);
+
+    // "TRACK_SEGMENT", "SIGNAL", "POINT_MACHINE" or "TEXT_LABEL"
+    QString elementType() const { return m_elementType; }
+    void setElementType(const QString& type);
+
+    QVariantList elements() const { return m_elements; }
+    void setElements(const QVariantList& elements);
+
+    // Visible region in grid units (x = col, y = row)
+    QRectF viewport() const { return m_viewport; }
+    void setViewport(const QRectF& viewport);
+
+    // Extra grid units instantiated around the viewport
+    double margin() const { return m_margin; }
+    void setMargin(double margin);
+
+    int activeCount() const { return m_activeCount; }
+    int poolSize() const { return m_slots.size(); }
+
+signals:
+    void spatialIndexChanged();
+    void elementTypeChanged();
+    void elementsChanged();
+    void viewportChanged();
+    void marginChanged();
+    void poolChanged();
+
+private:
+    struct Slot {
+        QString id;
+        QVariant data;        // kept while inactive so hidden delegates stay bound
+        bool active = false;
+    };
+
+    void updateSlots();
+    QList<QString> visibleIds() const;
+    quint32 typeMask() const;
+
+    QPointer<SpatialIndex> m_index;
+    QString m_elementType = "TRACK_SEGMENT";
+    QVariantList m_elements;
+    QHash<QString, QVariant> m_dataById;
+
+    QRectF m_viewport;
+    QRectF m_coveredRect;     // viewport + margin used for the current slots
+    double m_margin = 20.0;
+
+    QList<Slot> m_slots;
+    int m_activeCount = 0;
+};
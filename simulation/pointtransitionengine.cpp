@@ -0,0 +1,136 @@
+#include "pointtransitionengine.h"
+#include "database/databasemanager.h"
+
+#include <QDebug>
+#include <QStringList>
+
+PointTransitionEngine::PointTransitionEngine(QObject* parent)
+    : QObject(parent)
+{
+    m_clock.start();
+    m_tickTimer.setInterval(kTickMs);
+    m_tickTimer.setTimerType(Qt::PreciseTimer);
+    connect(&m_tickTimer, &QTimer::timeout, this, &PointTransitionEngine::onTick);
+}
+
+void PointTransitionEngine::setDatabaseManager(DatabaseManager* manager)
+{
+    if (m_dbManager) {
+        disconnect(m_dbManager, nullptr, this, nullptr);
+    }
+    m_dbManager = manager;
+    m_reconciled = false;
+    if (!m_dbManager) return;
+
+    connect(m_dbManager, &DatabaseManager::connectionStateChanged, this, &PointTransitionEngine::onConnectionStateChanged);
+    onConnectionStateChanged(m_dbManager->isConnected());
+}
+
+void PointTransitionEngine::onConnectionStateChanged(bool connected)
+{
+    // Once per run: nothing of ours is in flight yet, so any IN_TRANSITION
+    // row that outlived its transition time was abandoned by a previous run
+    if (!connected || m_reconciled) return;
+
+    QStringList machineIds;
+    if (!m_dbManager->reconcilePointTransitions(&machineIds)) return;
+    m_reconciled = true;
+
+    for (const QString& machineId : std::as_const(machineIds)) {
+        if (!m_inFlight.contains(machineId)) {
+            emit transitionFailed(machineId, "abandoned by a previous run");
+        }
+    }
+}
+
+quint64 PointTransitionEngine::elapsedTicks() const
+{
+    return quint64(m_clock.elapsed()) / kTickMs;
+}
+
+bool PointTransitionEngine::throwPoint(const QString& machineId, const QString& targetPosition)
+{
+    if (!m_dbManager || !m_dbManager->isConnected()) {
+        return false;
+    }
+    if (targetPosition != "NORMAL" && targetPosition != "REVERSE") {
+        qWarning() << "❌ Invalid point position for" << machineId << ":" << targetPosition;
+        return false;
+    }
+    if (m_inFlight.contains(machineId)) {
+        qWarning() << "⏳ Point machine" << machineId << "is already in transition";
+        emit transitionFailed(machineId, "already in transition");
+        return false;
+    }
+
+    // DatabaseManager checks the interlocking (canThrowPoint) before the
+    // server-side CONNECTED -> IN_TRANSITION switch
+    const int transitionTimeMs = m_dbManager->beginPointTransition(machineId);
+    if (transitionTimeMs < 0) {
+        emit transitionFailed(machineId, "transition refused");
+        return false;
+    }
+
+    // Catch the wheel up first so the delay counts from now
+    if (m_wheel.isEmpty()) {
+        m_wheel.advance(elapsedTicks() - m_wheel.now(), [](const QString&) {});
+    }
+
+    const quint64 delayTicks = (quint64(transitionTimeMs) + kTickMs - 1) / kTickMs;
+    Transition transition;
+    transition.targetPosition = targetPosition;
+    transition.timer = m_wheel.schedule(delayTicks, machineId);
+    m_inFlight.insert(machineId, transition);
+
+    if (!m_tickTimer.isActive()) {
+        m_tickTimer.start();
+    }
+
+    qDebug() << "🔀 Point machine" << machineId << "moving to" << targetPosition << "(" << transitionTimeMs << "ms )";
+    emit transitionStarted(machineId, targetPosition, transitionTimeMs);
+    emit inTransitionCountChanged();
+    return true;
+}
+
+void PointTransitionEngine::onTick()
+{
+    QStringList machineIds;
+    QStringList positions;
+
+    const quint64 target = elapsedTicks();
+    if (target > m_wheel.now()) {
+        m_wheel.advance(target - m_wheel.now(), [&](const QString& machineId) {
+            const auto it = m_inFlight.constFind(machineId);
+            if (it == m_inFlight.constEnd()) return;
+            machineIds.append(machineId);
+            positions.append(it->targetPosition);
+        });
+    }
+
+    if (m_wheel.isEmpty()) {
+        m_tickTimer.stop();
+    }
+    if (machineIds.isEmpty()) {
+        return;
+    }
+
+    // Everything that finished this tick is committed in one round trip
+    const bool committed = m_dbManager && m_dbManager->completePointTransitions(machineIds, positions);
+    if (!committed) {
+        // The rows are still IN_TRANSITION: keep the machines in flight and retry
+        qWarning() << "❌ Failed to complete" << machineIds.size() << "point transitions - retrying in" << kRetryMs << "ms";
+        for (const QString& machineId : std::as_const(machineIds)) {
+            m_inFlight[machineId].timer = m_wheel.schedule(quint64(kRetryMs / kTickMs), machineId);
+        }
+        if (!m_tickTimer.isActive()) {
+            m_tickTimer.start();
+        }
+        return;
+    }
+
+    for (int i = 0; i < machineIds.size(); ++i) {
+        m_inFlight.remove(machineIds[i]);
+        emit transitionCompleted(machineIds[i], positions[i]);
+    }
+    emit inTransitionCountChanged();
+}
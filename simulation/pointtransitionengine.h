@@ -0,0 +1,65 @@
+#pragma once
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QObject>
+#include <QString>
+#include <QTimer>
+
+#include "simulation/timerwheel.h"
+
+class DatabaseManager;
+
+// Models the transit of point machines instead of throwing them instantly.
+//
+// throwPoint() moves a machine to IN_TRANSITION in the database and schedules
+// its completion transition_time_ms later on a hierarchical timer wheel. A
+// 10 ms tick advances the wheel; every machine that finishes within a tick is
+// committed (final position, CONNECTED) in one batched database call. A
+// batch that cannot be committed stays in flight and is retried every
+// retry interval. On the first connection, machines a previous run left
+// IN_TRANSITION are reconnected at their recorded position.
+// Scheduling is O(1), so thousands of points can be in motion at once.
+class PointTransitionEngine : public QObject {
+    Q_OBJECT
+    Q_PROPERTY(int inTransitionCount READ inTransitionCount NOTIFY inTransitionCountChanged)
+
+public:
+    explicit PointTransitionEngine(QObject* parent = nullptr);
+
+    void setDatabaseManager(DatabaseManager* manager);
+
+    int inTransitionCount() const { return m_inFlight.size(); }
+
+    // Starts a timed throw; false when refused (interlocking, already moving, ...)
+    Q_INVOKABLE bool throwPoint(const QString& machineId, const QString& targetPosition);
+    Q_INVOKABLE bool isInTransition(const QString& machineId) const { return m_inFlight.contains(machineId); }
+
+signals:
+    void transitionStarted(const QString& machineId, const QString& targetPosition, int transitionTimeMs);
+    void transitionCompleted(const QString& machineId, const QString& position);
+    void transitionFailed(const QString& machineId, const QString& reason);
+    void inTransitionCountChanged();
+
+private slots:
+    void onTick();
+    void onConnectionStateChanged(bool connected);
+
+private:
+    static constexpr int kTickMs = 10;
+    static constexpr int kRetryMs = 250;
+
+    struct Transition {
+        QString targetPosition;
+        TimerWheel<QString>::Handle timer = TimerWheel<QString>::InvalidHandle;
+    };
+
+    quint64 elapsedTicks() const;
+
+    DatabaseManager* m_dbManager = nullptr;
+    TimerWheel<QString> m_wheel;
+    QHash<QString, Transition> m_inFlight;
+    QElapsedTimer m_clock;
+    QTimer m_tickTimer;
+    bool m_reconciled = false;
+};
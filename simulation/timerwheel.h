@@ -0,0 +1,160 @@
+#pragma once
+
+#include <QList>
+#include <QtGlobal>
+
+// Hierarchical timer wheel (Varghese & Lauck) with tick granularity.
+//
+// Four levels of 64 slots cover 64^4 ticks; level 0 holds timers due within
+// 64 ticks, higher levels hold coarser ranges and are cascaded down when the
+// level below wraps. schedule() and cancel() are O(1) (intrusive lists over a
+// node pool with a free list), and each tick touches one level-0 slot plus,
+// every 64^n ticks, one higher slot. Delays beyond the wheel's range are
+// clamped to it.
+template <typename Payload>
+class TimerWheel {
+public:
+    using Handle = int;
+    static constexpr Handle InvalidHandle = -1;
+
+    static constexpr int kBits = 6;
+    static constexpr int kSlots = 1 << kBits;
+    static constexpr int kLevels = 4;
+    static constexpr quint64 kMask = kSlots - 1;
+    static constexpr quint64 kMaxDelay = (quint64(1) << (kBits * kLevels)) - 1;
+
+    TimerWheel()
+    {
+        for (int& head : m_heads) head = -1;
+    }
+
+    quint64 now() const { return m_now; }
+    int size() const { return m_size; }
+    bool isEmpty() const { return m_size == 0; }
+
+    // Fires after `delayTicks` further ticks (0 = on the next tick)
+    Handle schedule(quint64 delayTicks, const Payload& payload)
+    {
+        Handle handle;
+        if (m_freeHead >= 0) {
+            handle = m_freeHead;
+            m_freeHead = m_nodes[handle].next;
+        } else {
+            handle = m_nodes.size();
+            m_nodes.append(Node());
+        }
+
+        Node& node = m_nodes[handle];
+        node.expires = m_now + qMax<quint64>(1, qMin(delayTicks, kMaxDelay));
+        node.payload = payload;
+        node.active = true;
+        place(handle);
+        ++m_size;
+        return handle;
+    }
+
+    bool cancel(Handle handle)
+    {
+        if (handle < 0 || handle >= m_nodes.size() || !m_nodes[handle].active) return false;
+        unlink(handle);
+        release(handle);
+        return true;
+    }
+
+    // Moves time forward, calling onExpired(payload) for every due timer
+    template <typename Callback>
+    void advance(quint64 ticks, Callback&& onExpired)
+    {
+        while (ticks > 0) {
+            if (m_size == 0) {   // nothing pending: jump straight to the target
+                m_now += ticks;
+                return;
+            }
+            tick(onExpired);
+            --ticks;
+        }
+    }
+
+private:
+    struct Node {
+        quint64 expires = 0;
+        Payload payload{};
+        int prev = -1;
+        int next = -1;
+        int bucket = -1;   // level * kSlots + slot
+        bool active = false;
+    };
+
+    template <typename Callback>
+    void tick(Callback& onExpired)
+    {
+        ++m_now;
+
+        // Cascade each higher level whose lower neighbour just wrapped
+        for (int level = 1; level < kLevels; ++level) {
+            if ((m_now & ((quint64(1) << (kBits * level)) - 1)) != 0) break;
+            const int bucket = level * kSlots + int((m_now >> (kBits * level)) & kMask);
+            int handle = m_heads[bucket];
+            m_heads[bucket] = -1;
+            while (handle >= 0) {
+                const int next = m_nodes[handle].next;
+                place(handle);
+                handle = next;
+            }
+        }
+
+        const int bucket = int(m_now & kMask);
+        int handle = m_heads[bucket];
+        m_heads[bucket] = -1;
+        while (handle >= 0) {
+            const int next = m_nodes[handle].next;
+            const Payload payload = m_nodes[handle].payload;
+            release(handle);
+            onExpired(payload);
+            handle = next;
+        }
+    }
+
+    void place(int handle)
+    {
+        Node& node = m_nodes[handle];
+        const quint64 delta = node.expires - m_now;
+
+        int level = 0;
+        while (level < kLevels - 1 && delta >= (quint64(1) << (kBits * (level + 1)))) {
+            ++level;
+        }
+
+        node.bucket = level * kSlots + int((node.expires >> (kBits * level)) & kMask);
+        node.prev = -1;
+        node.next = m_heads[node.bucket];
+        if (node.next >= 0) m_nodes[node.next].prev = handle;
+        m_heads[node.bucket] = handle;
+    }
+
+    void unlink(int handle)
+    {
+        Node& node = m_nodes[handle];
+        if (node.prev >= 0) m_nodes[node.prev].next = node.next;
+        else m_heads[node.bucket] = node.next;
+        if (node.next >= 0) m_nodes[node.next].prev = node.prev;
+    }
+
+    void release(int handle)
+    {
+        Node& node = m_nodes[handle];
+        node.active = false;
+        node.payload = Payload{};
+        node.bucket = -1;
+        node.prev = -1;
+        node.next = m_freeHead;
+        m_freeHead = handle;
+        --m_size;
+    }
+
+    QList<Node> m_nodes;
+    int m_heads[kLevels * kSlots];
+    int m_freeHead = -1;
+    int m_size = 0;
+    quint64 m_now = 0;
+};
@@ -0,0 +1,266 @@
+#include "trainsimulator.h"
+#include "database/databasemanager.h"
+#include "interlocking/interlockingengine.h"
+
+#include <QDebug>
+#include <algorithm>
+
+TrainSimulator::TrainSimulator(QObject* parent)
+    : QObject(parent)
+{
+    m_clock.start();
+    m_tickTimer.setInterval(kTickMs);
+    m_tickTimer.setTimerType(Qt::PreciseTimer);
+    connect(&m_tickTimer, &QTimer::timeout, this, &TrainSimulator::onTick);
+}
+
+void TrainSimulator::setTopology(TrackTopology* topology)
+{
+    if (m_topology) {
+        disconnect(m_topology, nullptr, this, nullptr);
+    }
+    m_topology = topology;
+    if (m_topology) {
+        // Segment indices are only valid for the layout the trains were placed on
+        connect(m_topology, &TrackTopology::topologyChanged, this, [this]() {
+            if (isRunning()) {
+                qWarning() << "🚆 Layout changed, stopping train simulation";
+                stop();
+            }
+        });
+    }
+}
+
+void TrainSimulator::setDatabaseManager(DatabaseManager* manager)
+{
+    m_dbManager = manager;
+}
+
+void TrainSimulator::setInterlockingEngine(InterlockingEngine* interlocking)
+{
+    m_interlocking = interlocking;
+}
+
+void TrainSimulator::setStepIntervalMs(int intervalMs)
+{
+    intervalMs = qMax(kTickMs, intervalMs);
+    if (m_stepIntervalMs == intervalMs) return;
+    m_stepIntervalMs = intervalMs;
+    emit settingsChanged();
+}
+
+void TrainSimulator::setTrainLength(int length)
+{
+    length = qMax(1, length);
+    if (m_trainLength == length) return;
+    m_trainLength = length;
+    emit settingsChanged();
+}
+
+void TrainSimulator::setRespectSignals(bool respect)
+{
+    if (m_respectSignals == respect) return;
+    m_respectSignals = respect;
+    emit settingsChanged();
+}
+
+quint64 TrainSimulator::elapsedTicks() const
+{
+    return quint64(m_clock.elapsed()) / kTickMs;
+}
+
+int TrainSimulator::start(int count, quint32 seed)
+{
+    stop();
+
+    if (!m_topology || !m_dbManager || !m_dbManager->isConnected() || m_topology->segmentCount() == 0) {
+        qWarning() << "❌ Train simulator needs a connected database and a loaded topology";
+        return 0;
+    }
+
+    m_random = QRandomGenerator(seed ? seed : QRandomGenerator::global()->generate());
+
+    const int segmentCount = m_topology->segmentCount();
+    m_segmentIds.clear();
+    m_segmentIds.reserve(segmentCount);
+    QList<int> freeSegments;
+    for (int segment = 0; segment < segmentCount; ++segment) {
+        m_segmentIds.append(m_topology->segment(segment).id);
+        if (!m_interlocking || !m_interlocking->isSegmentOccupied(segment)) {
+            freeSegments.append(segment);
+        }
+    }
+    std::shuffle(freeSegments.begin(), freeSegments.end(), m_random);
+    m_segmentOwner.fill(-1, segmentCount);
+
+    // Catch the wheel up first so the first steps count from now
+    m_wheel.advance(elapsedTicks() - m_wheel.now(), [](int) {});
+
+    const int placed = qMin(count, int(freeSegments.size()));
+    for (int i = 0; i < placed; ++i) {
+        const int segment = freeSegments[i];
+        if (!writeOccupancy(segment, true)) continue;
+
+        Train train;
+        train.id = QString("SIM-%1").arg(m_trains.size() + 1, 2, 10, QChar('0'));
+        train.body.append({segment, m_random.bounded(2) ? TrackTopology::AtEnd : TrackTopology::AtStart});
+        m_segmentOwner[segment] = m_trains.size();
+        m_trains.append(train);
+        scheduleStep(m_trains.size() - 1);
+    }
+
+    m_windowUpdates = 0;
+    m_windowStartMs = m_clock.elapsed();
+    if (!m_trains.isEmpty()) {
+        m_tickTimer.start();
+    }
+
+    qDebug() << "🚆 Train simulator started:" << m_trains.size() << "trains, step" << m_stepIntervalMs << "ms, length" << m_trainLength;
+    emit runningChanged();
+    emit statisticsChanged();
+    return m_trains.size();
+}
+
+void TrainSimulator::stop()
+{
+    if (!isRunning()) return;
+
+    m_tickTimer.stop();
+    m_wheel = TimerWheel<int>();
+
+    // Leave the layout as clear as it was before the trains arrived
+    for (const Train& train : std::as_const(m_trains)) {
+        for (const BodyPart& part : train.body) {
+            writeOccupancy(part.segment, false);
+        }
+    }
+
+    qDebug() << "🚆 Train simulator stopped after" << m_totalUpdates << "occupancy updates";
+
+    m_trains.clear();
+    m_segmentOwner.clear();
+    m_updatesPerSecond = 0.0;
+    m_waitingTrains = 0;
+    emit runningChanged();
+    emit statisticsChanged();
+}
+
+void TrainSimulator::scheduleStep(int train)
+{
+    // ±25% jitter keeps trains from stepping in lockstep
+    const double intervalMs = m_stepIntervalMs * (0.75 + 0.5 * m_random.generateDouble());
+    m_wheel.schedule(quint64(qMax(1.0, intervalMs / kTickMs)), train);
+}
+
+void TrainSimulator::onTick()
+{
+    QList<int> due;
+    const quint64 target = elapsedTicks();
+    if (target > m_wheel.now()) {
+        m_wheel.advance(target - m_wheel.now(), [&](int train) { due.append(train); });
+    }
+
+    for (int train : std::as_const(due)) {
+        if (train < m_trains.size()) {
+            step(train);
+        }
+    }
+
+    const qint64 nowMs = m_clock.elapsed();
+    if (nowMs - m_windowStartMs >= 1000) {
+        m_updatesPerSecond = m_windowUpdates * 1000.0 / (nowMs - m_windowStartMs);
+        m_waitingTrains = int(std::count_if(m_trains.cbegin(), m_trains.cend(),
+                                            [](const Train& train) { return train.waitSteps > 0; }));
+        m_windowUpdates = 0;
+        m_windowStartMs = nowMs;
+        emit statisticsChanged();
+    }
+}
+
+void TrainSimulator::step(int index)
+{
+    Train& train = m_trains[index];
+    const BodyPart head = train.body.constFirst();
+
+    TrackTopology::TrackEnd entryEnd = TrackTopology::AtStart;
+    bool deadEnd = false;
+    const bool signalClear = !m_respectSignals || !m_interlocking
+                             || m_interlocking->signalPermitsExit(head.segment, movesUp(head));
+    const int next = signalClear ? nextSegment(head, &entryEnd, &deadEnd) : -1;
+
+    if (next < 0) {
+        if (deadEnd || ++train.waitSteps > kMaxWaitSteps) {
+            reverse(train);
+        }
+        scheduleStep(index);
+        return;
+    }
+
+    if (!writeOccupancy(next, true)) {
+        scheduleStep(index);
+        return;
+    }
+
+    m_segmentOwner[next] = index;
+    train.body.prepend({next, entryEnd});
+    train.waitSteps = 0;
+
+    while (train.body.size() > m_trainLength) {
+        const BodyPart tail = train.body.takeLast();
+        m_segmentOwner[tail.segment] = -1;
+        writeOccupancy(tail.segment, false);
+    }
+
+    scheduleStep(index);
+}
+
+int TrainSimulator::nextSegment(const BodyPart& head, TrackTopology::TrackEnd* entryEnd, bool* deadEnd) const
+{
+    const TrackTopology::TrackEnd exitEnd = head.end == TrackTopology::AtStart ? TrackTopology::AtEnd : TrackTopology::AtStart;
+    const auto& links = m_topology->segment(head.segment).links[exitEnd];
+    *deadEnd = links.isEmpty();
+
+    for (const TrackTopology::Link& link : links) {
+        if (link.point >= 0) {
+            if (m_topology->point(link.point).position != link.position) continue;
+            if (m_interlocking && !m_interlocking->isPointAvailable(link.point)) return -1;
+        }
+
+        const int segment = link.to.segment;
+        if (m_segmentOwner[segment] >= 0) return -1;
+        if (m_interlocking && m_interlocking->isSegmentOccupied(segment)) return -1;
+
+        *entryEnd = link.to.end;
+        return segment;
+    }
+    return -1;   // points set against every branch
+}
+
+bool TrainSimulator::movesUp(const BodyPart& part) const
+{
+    const TrackTopology::Segment& segment = m_topology->segment(part.segment);
+    const double entryCol = part.end == TrackTopology::AtStart ? segment.startCol : segment.endCol;
+    const double exitCol = part.end == TrackTopology::AtStart ? segment.endCol : segment.startCol;
+    return exitCol >= entryCol;
+}
+
+void TrainSimulator::reverse(Train& train)
+{
+    std::reverse(train.body.begin(), train.body.end());
+    for (BodyPart& part : train.body) {
+        part.end = part.end == TrackTopology::AtStart ? TrackTopology::AtEnd : TrackTopology::AtStart;
+    }
+    train.waitSteps = 0;
+}
+
+bool TrainSimulator::writeOccupancy(int segment, bool occupied)
+{
+    if (!m_dbManager || segment < 0 || segment >= m_segmentIds.size()) return false;
+
+    if (!m_dbManager->updateTrackOccupancy(m_segmentIds[segment], occupied)) {
+        return false;
+    }
+    ++m_totalUpdates;
+    ++m_windowUpdates;
+    return true;
+}
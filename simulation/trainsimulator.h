@@ -0,0 +1,119 @@
+#pragma once
+
+#include <QElapsedTimer>
+#include <QList>
+#include <QObject>
+#include <QRandomGenerator>
+#include <QString>
+#include <QStringList>
+#include <QTimer>
+
+#include "simulation/timerwheel.h"
+#include "topology/tracktopology.h"
+
+class DatabaseManager;
+class InterlockingEngine;
+
+// Moves simulated trains along the track topology to generate field load.
+//
+// Each train occupies `trainLength` consecutive segments. Every
+// `stepIntervalMs` (±25% jitter) its head advances into the segment the
+// points currently lead to: the new head is occupied and the tail cleared
+// through DatabaseManager::updateTrackOccupancy(), i.e. the same traced path
+// an operator click takes, so notifications, refreshes and rendering see real
+// traffic. Trains wait at signals showing danger (when respectSignals is set),
+// in front of occupied track and at points in transition, and reverse at
+// buffer stops or after waiting too long. Steps are scheduled per train on
+// a timer wheel, so hundreds of trains cost one 10 ms tick.
+class TrainSimulator : public QObject {
+    Q_OBJECT
+    Q_PROPERTY(bool running READ isRunning NOTIFY runningChanged)
+    Q_PROPERTY(int trainCount READ trainCount NOTIFY runningChanged)
+    Q_PROPERTY(int stepIntervalMs READ stepIntervalMs WRITE setStepIntervalMs NOTIFY settingsChanged)
+    Q_PROPERTY(int trainLength READ trainLength WRITE setTrainLength NOTIFY settingsChanged)
+    Q_PROPERTY(bool respectSignals READ respectSignals WRITE setRespectSignals NOTIFY settingsChanged)
+    Q_PROPERTY(double updatesPerSecond READ updatesPerSecond NOTIFY statisticsChanged)
+    Q_PROPERTY(qint64 totalUpdates READ totalUpdates NOTIFY statisticsChanged)
+    Q_PROPERTY(int waitingTrains READ waitingTrains NOTIFY statisticsChanged)
+
+public:
+    explicit TrainSimulator(QObject* parent = nullptr);
+
+    void setTopology(TrackTopology* topology);
+    void setDatabaseManager(DatabaseManager* manager);
+    void setInterlockingEngine(InterlockingEngine* interlocking);
+
+    bool isRunning() const { return !m_trains.isEmpty(); }
+    int trainCount() const { return m_trains.size(); }
+
+    int stepIntervalMs() const { return m_stepIntervalMs; }
+    void setStepIntervalMs(int intervalMs);
+
+    int trainLength() const { return m_trainLength; }
+    void setTrainLength(int length);
+
+    bool respectSignals() const { return m_respectSignals; }
+    void setRespectSignals(bool respect);
+
+    double updatesPerSecond() const { return m_updatesPerSecond; }
+    qint64 totalUpdates() const { return m_totalUpdates; }
+    int waitingTrains() const { return m_waitingTrains; }
+
+    // Places up to `count` trains on free segments; returns how many were placed
+    Q_INVOKABLE int start(int count, quint32 seed = 0);
+    // Removes every train and clears the track it occupied
+    Q_INVOKABLE void stop();
+
+signals:
+    void runningChanged();
+    void settingsChanged();
+    void statisticsChanged();
+
+private slots:
+    void onTick();
+
+private:
+    static constexpr int kTickMs = 10;
+    static constexpr int kMaxWaitSteps = 10;   // then the train turns back
+
+    // A segment of a train body and the end it was entered from
+    using BodyPart = TrackTopology::Endpoint;
+
+    struct Train {
+        QString id;
+        QList<BodyPart> body;                  // head first
+        int waitSteps = 0;
+    };
+
+    quint64 elapsedTicks() const;
+    void scheduleStep(int train);
+    void step(int train);
+    int nextSegment(const BodyPart& head, TrackTopology::TrackEnd* entryEnd, bool* deadEnd) const;
+    bool movesUp(const BodyPart& part) const;
+    void reverse(Train& train);
+    bool writeOccupancy(int segment, bool occupied);
+
+    TrackTopology* m_topology = nullptr;
+    DatabaseManager* m_dbManager = nullptr;
+    InterlockingEngine* m_interlocking = nullptr;
+
+    QList<Train> m_trains;
+    QStringList m_segmentIds;                  // segment IDs of the layout the trains run on
+    QList<int> m_segmentOwner;                 // per topology segment: train index or -1
+    TimerWheel<int> m_wheel;
+    QRandomGenerator m_random;
+
+    int m_stepIntervalMs = 1000;
+    int m_trainLength = 2;
+    bool m_respectSignals = true;
+
+    QElapsedTimer m_clock;
+    QTimer m_tickTimer;
+
+    // ===== Statistics =====
+    qint64 m_totalUpdates = 0;
+    qint64 m_windowUpdates = 0;
+    qint64 m_windowStartMs = 0;
+    double m_updatesPerSecond = 0.0;
+    int m_waitingTrains = 0;
+};
@@ -0,0 +1,313 @@
+// Unit tests for the broker wire format: snapshots and deltas must round-trip
+// rows unchanged, NULL text and unknown codes must read back as "", and any
+// truncated or foreign blob must be refused rather than half decoded.
+
+#include <QTest>
+#include <QtEndian>
+
+#include "broker/stationwire.h"
+
+namespace {
+using Table = StationStateStore::Table;
+
+QVariantMap trackRow(const QString& id, bool occupied, bool assigned, bool active, const QVariant& occupiedBy)
+{
+    return {
+        {"id", id}, {"name", "Track " + id}, {"startX", 12.5}, {"startY", 100.0}, {"endX", 87.25},
+        {"occupied", occupied}, {"assigned", assigned}, {"isActive", active}, {"occupiedBy", occupiedBy},
+    };
+}
+
+QVariantMap signalRow(const QString& id, const QString& aspect, const QString& callingOn, const QString& loop)
+{
+    return {
+        {"id", id}, {"name", "Signal " + id}, {"x", 10.25}, {"type", "HOME"},
+        {"possibleAspects", QVariantList{"RED", "YELLOW", "GREEN"}},
+        {"interlocking", QVariantMap{{"protectedTracks", QVariantList{"T1", "T2"}}, {"priority", 2}}},
+        {"currentAspect", aspect}, {"callingOnAspect", callingOn}, {"loopAspect", loop}, {"isActive", true},
+    };
+}
+
+QVariantMap pointRow(const QString& id, const QString& position, const QString& status, bool locked,
+                     const QVariant& lockReason)
+{
+    return {
+        {"id", id}, {"name", "Point " + id}, {"junctionX", 3.0}, {"throwTimeMs", 3500},
+        {"position", position}, {"operatingStatus", status}, {"isLocked", locked}, {"lockReason", lockReason},
+    };
+}
+
+StationStateStore sampleStation()
+{
+    StationStateStore store;
+    store.reset("STN1",
+                {trackRow("T1", true, false, true, "2A45"), trackRow("T2", false, true, true, ""),
+                 trackRow("T3", false, false, false, "")},
+                {signalRow("S1", "RED", "", "INACTIVE"), signalRow("S2", "GREEN", "WHITE", "YELLOW")},
+                {pointRow("P1", "NORMAL", "CONNECTED", true, "Route R12 set"),
+                 pointRow("P2", "REVERSE", "IN_TRANSITION", false, "")},
+                {QVariantMap{{"id", "L1"}, {"text", "Platform 1"}, {"x", 40.5}, {"fontSize", 12}}});
+    return store;
+}
+
+QVariantMap withValue(QVariantMap row, const QString& key, const QVariant& value)
+{
+    row.insert(key, value);
+    return row;
+}
+
+// Offset of the first signal record in a snapshot's state section
+qsizetype signalRecordOffset(const QByteArray& blob, int trackCount)
+{
+    const qsizetype layoutSize = qFromBigEndian<quint32>(blob.constData() + 4);
+    return 8 + layoutSize + 12 + 3 * ((trackCount + 7) / 8);
+}
+}
+
+class StationWireTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void snapshotRoundTrip()
+    {
+        const StationStateStore store = sampleStation();
+        const QByteArray blob = StationWire::encodeSnapshot(store);
+
+        StationStateStore decoded;
+        QVERIFY(StationWire::decodeSnapshot(blob, &decoded));
+        QCOMPARE(decoded.stationId(), QString("STN1"));
+        for (int table = 0; table < StationStateStore::TableCount; ++table) {
+            QCOMPARE(decoded.rows(Table(table)), store.rows(Table(table)));
+        }
+        QCOMPARE(decoded.textLabels(), store.textLabels());
+        QVERIFY(decoded.counters() == store.counters());
+        QCOMPARE(decoded.indexOf(StationStateStore::PointMachines, "P2"), 1);
+    }
+
+    void nullTextReadsBackEmpty()
+    {
+        StationStateStore store;
+        QVariantMap nullName = trackRow("T1", true, false, true, QVariant());
+        nullName.insert("name", QVariant());
+        store.reset("STN1", {nullName}, {}, {pointRow("P1", "NORMAL", "FAILED", true, QVariant())},
+                    {QVariantMap{{"id", "L1"}, {"text", QVariant()}}});
+
+        StationStateStore decoded;
+        QVERIFY(StationWire::decodeSnapshot(StationWire::encodeSnapshot(store), &decoded));
+
+        // State text is always present; NULL layout values are left out
+        const QVariantMap decodedTrack = decoded.rowAt(StationStateStore::TrackSegments, 0);
+        QCOMPARE(decodedTrack.value("occupiedBy"), QVariant(QString()));
+        QVERIFY(!decodedTrack.contains("name"));
+        QCOMPARE(decoded.rowAt(StationStateStore::PointMachines, 0).value("lockReason"), QVariant(QString()));
+        QCOMPARE(decoded.textLabels(), QVariantList({QVariantMap{{"id", "L1"}}}));
+    }
+
+    void unknownCodesReadBackEmpty()
+    {
+        StationStateStore store;
+        store.reset("STN1", {}, {signalRow("S1", "PURPLE", "RED", "")},
+                    {pointRow("P1", "SIDEWAYS", "UNPLUGGED", false, "")}, {});
+
+        StationStateStore decoded;
+        QVERIFY(StationWire::decodeSnapshot(StationWire::encodeSnapshot(store), &decoded));
+
+        const QVariantMap decodedSignal = decoded.rowAt(StationStateStore::Signals, 0);
+        QCOMPARE(decodedSignal.value("currentAspect").toString(), QString());
+        QCOMPARE(decodedSignal.value("callingOnAspect").toString(), QString("RED"));
+        QCOMPARE(decodedSignal.value("loopAspect").toString(), QString());
+        const QVariantMap decodedPoint = decoded.rowAt(StationStateStore::PointMachines, 0);
+        QCOMPARE(decodedPoint.value("position").toString(), QString());
+        QCOMPARE(decodedPoint.value("operatingStatus").toString(), QString());
+    }
+
+    void outOfRangeRecordValuesReadBackEmpty()
+    {
+        StationStateStore store;
+        store.reset("STN1", {}, {signalRow("S1", "RED", "", "")}, {pointRow("P1", "NORMAL", "CONNECTED", false, "")}, {});
+        QByteArray blob = StationWire::encodeSnapshot(store);
+
+        // Aspect nibbles 15 and status 7 have no code
+        const qsizetype signalOffset = signalRecordOffset(blob, 0);
+        blob[signalOffset] = char(0xFF);
+        blob[signalOffset + 2] = char(0x1C);
+
+        StationStateStore decoded;
+        QVERIFY(StationWire::decodeSnapshot(blob, &decoded));
+        QCOMPARE(decoded.rowAt(StationStateStore::Signals, 0).value("currentAspect").toString(), QString());
+        QCOMPARE(decoded.rowAt(StationStateStore::Signals, 0).value("callingOnAspect").toString(), QString());
+        QCOMPARE(decoded.rowAt(StationStateStore::PointMachines, 0).value("operatingStatus").toString(), QString());
+    }
+
+    void emptyStationRoundTrip()
+    {
+        StationStateStore store;
+        store.reset("EMPTY", {}, {}, {}, {});
+        const QByteArray blob = StationWire::encodeSnapshot(store);
+
+        StationStateStore decoded;
+        decoded = sampleStation();
+        QVERIFY(StationWire::decodeSnapshot(blob, &decoded));
+        QCOMPARE(decoded.stationId(), QString("EMPTY"));
+        for (int table = 0; table < StationStateStore::TableCount; ++table) {
+            QVERIFY(decoded.rows(Table(table)).isEmpty());
+        }
+        QVERIFY(decoded.textLabels().isEmpty());
+
+        StationWire::StateView view;
+        QVERIFY(view.parse(blob));
+        QCOMPARE(view.trackCount(), 0);
+        QCOMPARE(view.signalCount(), 0);
+        QCOMPARE(view.pointCount(), 0);
+    }
+
+    void stateView()
+    {
+        const QByteArray blob = StationWire::encodeSnapshot(sampleStation());
+
+        StationWire::StateView view;
+        QVERIFY(view.parse(blob));
+        QCOMPARE(view.trackCount(), 3);
+        QCOMPARE(view.signalCount(), 2);
+        QCOMPARE(view.pointCount(), 2);
+
+        QVERIFY(view.track(0).occupied);
+        QCOMPARE(view.track(0).occupiedBy.toByteArray(), QByteArray("2A45"));
+        QVERIFY(view.track(1).assigned);
+        QVERIFY(view.track(1).occupiedBy.isEmpty());
+        QVERIFY(!view.track(2).active);
+
+        QCOMPARE(view.signal(0).aspect, ElementCodes::Red);
+        QCOMPARE(view.signal(0).loop, ElementCodes::Inactive);
+        QCOMPARE(view.signal(1).callingOn, ElementCodes::White);
+
+        QCOMPARE(view.point(0).position, ElementCodes::Normal);
+        QVERIFY(view.point(0).locked);
+        QCOMPARE(view.point(0).lockReason.toByteArray(), QByteArray("Route R12 set"));
+        QCOMPARE(view.point(1).status, ElementCodes::InTransition);
+
+        // Rows outside the snapshot read as defaults
+        QVERIFY(!view.track(3).occupied);
+        QCOMPARE(view.signal(-1).aspect, ElementCodes::AspectUnknown);
+        QCOMPARE(view.point(2).position, ElementCodes::PositionUnknown);
+    }
+
+    void truncatedSnapshotIsRejected()
+    {
+        const QByteArray blob = StationWire::encodeSnapshot(sampleStation());
+        for (qsizetype size = 0; size < blob.size(); ++size) {
+            const QByteArrayView prefix(blob.constData(), size);
+            StationStateStore decoded;
+            StationWire::StateView view;
+            if (StationWire::decodeSnapshot(prefix, &decoded) || view.parse(prefix)) {
+                QFAIL(qPrintable(QString("prefix of %1 of %2 bytes accepted").arg(size).arg(blob.size())));
+            }
+        }
+    }
+
+    void foreignSnapshotIsRejected()
+    {
+        const QByteArray blob = StationWire::encodeSnapshot(sampleStation());
+        StationStateStore decoded;
+
+        QByteArray badMagic = blob;
+        badMagic[0] = 'X';
+        QVERIFY(!StationWire::decodeSnapshot(badMagic, &decoded));
+
+        QByteArray badVersion = blob;
+        badVersion[3] = char(StationWire::kVersion + 1);
+        QVERIFY(!StationWire::decodeSnapshot(badVersion, &decoded));
+        QVERIFY(!StationWire::StateView().parse(badVersion));
+    }
+
+    void deltaRoundTrip_data()
+    {
+        QTest::addColumn<int>("table");
+        QTest::addColumn<QVariantMap>("before");
+        QTest::addColumn<QVariantMap>("after");
+
+        const QVariantMap trackState = trackRow("T1", false, false, true, "");
+        QTest::newRow("track occupied") << int(StationStateStore::TrackSegments) << trackState
+                                        << withValue(withValue(trackState, "occupied", true), "occupiedBy", "2A45");
+        QTest::newRow("track inactive") << int(StationStateStore::TrackSegments) << trackState
+                                        << withValue(trackState, "isActive", false);
+
+        const QVariantMap signalState = signalRow("S1", "RED", "", "INACTIVE");
+        QTest::newRow("signal aspect") << int(StationStateStore::Signals) << signalState
+                                       << withValue(withValue(signalState, "currentAspect", "DOUBLE_YELLOW"),
+                                                    "callingOnAspect", "WHITE");
+
+        const QVariantMap pointState = pointRow("P1", "NORMAL", "CONNECTED", false, "");
+        QTest::newRow("point locked") << int(StationStateStore::PointMachines) << pointState
+                                      << withValue(withValue(pointState, "isLocked", true), "lockReason", "Route R12 set");
+        QTest::newRow("point failed") << int(StationStateStore::PointMachines)
+                                      << withValue(pointState, "lockReason", "Maintenance")
+                                      << withValue(withValue(pointState, "operatingStatus", "FAILED"), "position", "REVERSE");
+    }
+
+    void deltaRoundTrip()
+    {
+        QFETCH(int, table);
+        QFETCH(QVariantMap, before);
+        QFETCH(QVariantMap, after);
+
+        const QByteArray encoded = StationWire::encodeDelta(300, Table(table), 7, after);
+
+        StationWire::Delta delta;
+        QVERIFY(StationWire::decodeDelta(encoded, &delta));
+        QCOMPARE(delta.sequence, quint64(300));
+        QCOMPARE(int(delta.table), table);
+        QCOMPARE(delta.row, 7);
+
+        QVariantMap row = before;
+        StationWire::applyDelta(delta, &row);
+        QCOMPARE(row, after);
+    }
+
+    void deltaNullTextClears()
+    {
+        const QVariantMap before = trackRow("T1", true, false, true, "2A45");
+        const QByteArray encoded = StationWire::encodeDelta(
+            1, StationStateStore::TrackSegments, 0, trackRow("T1", false, false, true, QVariant()));
+
+        StationWire::Delta delta;
+        QVERIFY(StationWire::decodeDelta(encoded, &delta));
+        QVERIFY(delta.track.occupiedBy.isEmpty());
+
+        QVariantMap row = before;
+        StationWire::applyDelta(delta, &row);
+        QCOMPARE(row.value("occupiedBy"), QVariant(QString()));
+        QCOMPARE(row.value("occupied"), QVariant(false));
+    }
+
+    void truncatedDeltaIsRejected()
+    {
+        const QByteArray deltas[] = {
+            StationWire::encodeDelta(1u << 20, StationStateStore::TrackSegments, 1000,
+                                     trackRow("T1", true, false, true, "2A45")),
+            StationWire::encodeDelta(5, StationStateStore::TrackSegments, 0, trackRow("T1", false, false, true, "")),
+            StationWire::encodeDelta(5, StationStateStore::Signals, 0, signalRow("S1", "GREEN", "", "")),
+            StationWire::encodeDelta(5, StationStateStore::PointMachines, 200,
+                                     pointRow("P1", "NORMAL", "CONNECTED", true, "Route R12 set")),
+        };
+        for (const QByteArray& encoded : deltas) {
+            StationWire::Delta delta;
+            QVERIFY(StationWire::decodeDelta(encoded, &delta));
+            for (qsizetype size = 0; size < encoded.size(); ++size) {
+                QVERIFY(!StationWire::decodeDelta(QByteArrayView(encoded.constData(), size), &delta));
+            }
+        }
+    }
+
+    void unknownDeltaTableIsRejected()
+    {
+        QByteArray encoded = StationWire::encodeDelta(5, StationStateStore::Signals, 0, signalRow("S1", "RED", "", ""));
+        encoded[1] = char(StationStateStore::TableCount);
+
+        StationWire::Delta delta;
+        QVERIFY(!StationWire::decodeDelta(encoded, &delta));
+    }
+};
+
+QTEST_APPLESS_MAIN(StationWireTest)
+#include "stationwiretest.moc"
@@ -0,0 +1,154 @@
+// Unit tests for the field telegram codec: round trips, truncated frames
+// (NeedMore for every prefix) and resynchronisation after malformed input.
+
+#include <QTest>
+
+#include "ingestion/telegram.h"
+
+namespace {
+using Telegram::DecodeResult;
+
+DecodeResult decode(const QByteArray& data, Telegram::Frame* frame, qsizetype* consumed)
+{
+    return Telegram::decode(data.constData(), data.size(), frame, consumed);
+}
+
+// Decodes frames the way the gateway does: skip what a Malformed result
+// consumed, stop at NeedMore. Returns the element IDs decoded.
+QList<QByteArray> decodeAll(const QByteArray& data, qsizetype* remaining = nullptr)
+{
+    QList<QByteArray> ids;
+    qsizetype offset = 0;
+    while (offset < data.size()) {
+        Telegram::Frame frame;
+        qsizetype consumed = 0;
+        const DecodeResult result = Telegram::decode(data.constData() + offset, data.size() - offset,
+                                                     &frame, &consumed);
+        if (result == DecodeResult::NeedMore) break;
+        if (result == DecodeResult::Ok) ids.append(frame.elementId.toByteArray());
+        offset += consumed;
+    }
+    if (remaining) *remaining = data.size() - offset;
+    return ids;
+}
+}
+
+class TelegramTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void roundTrip()
+    {
+        const QByteArray encoded = Telegram::encode(Telegram::PointDetection, 0x01020304,
+                                                    Telegram::DetectedReverse, "PM001");
+        QCOMPARE(encoded.size(), qsizetype(Telegram::kHeaderSize + 5));
+
+        Telegram::Frame frame;
+        qsizetype consumed = 0;
+        QCOMPARE(decode(encoded, &frame, &consumed), DecodeResult::Ok);
+        QCOMPARE(consumed, encoded.size());
+        QCOMPARE(frame.type, Telegram::PointDetection);
+        QCOMPARE(frame.sequence, quint32(0x01020304));
+        QCOMPARE(frame.state, quint8(Telegram::DetectedReverse));
+        QCOMPARE(frame.elementId.toByteArray(), QByteArray("PM001"));
+    }
+
+    void longestIdRoundTrips()
+    {
+        const QByteArray id(Telegram::kMaxIdLength, 'T');
+        const QByteArray encoded = Telegram::encode(Telegram::TrackCircuit, 1, Telegram::TrackOccupied, id);
+
+        Telegram::Frame frame;
+        qsizetype consumed = 0;
+        QCOMPARE(decode(encoded, &frame, &consumed), DecodeResult::Ok);
+        QCOMPARE(frame.elementId.toByteArray(), id);
+    }
+
+    void truncatedFrameNeedsMore()
+    {
+        const QByteArray encoded = Telegram::encode(Telegram::TrackCircuit, 7, Telegram::TrackClear, "T1A");
+        for (qsizetype size = 0; size < encoded.size(); ++size) {
+            Telegram::Frame frame;
+            qsizetype consumed = -1;
+            QCOMPARE(Telegram::decode(encoded.constData(), size, &frame, &consumed), DecodeResult::NeedMore);
+            QCOMPARE(consumed, qsizetype(0));
+        }
+    }
+
+    void badMagicSkipsOneByte()
+    {
+        Telegram::Frame frame;
+        qsizetype consumed = 0;
+        QCOMPARE(decode(QByteArray("XRF"), &frame, &consumed), DecodeResult::Malformed);
+        QCOMPARE(consumed, qsizetype(1));
+        QCOMPARE(decode(QByteArray("RX"), &frame, &consumed), DecodeResult::Malformed);
+        QCOMPARE(consumed, qsizetype(1));
+    }
+
+    void malformedHeaderSkipsMagic_data()
+    {
+        QTest::addColumn<int>("offset");
+        QTest::addColumn<char>("value");
+
+        QTest::newRow("version") << 2 << char(2);
+        QTest::newRow("type zero") << 3 << char(0);
+        QTest::newRow("type unknown") << 3 << char(3);
+        QTest::newRow("track state") << 8 << char(Telegram::TrackOccupied + 1);
+        QTest::newRow("id length zero") << 9 << char(0);
+        QTest::newRow("id length too long") << 9 << char(Telegram::kMaxIdLength + 1);
+    }
+
+    void malformedHeaderSkipsMagic()
+    {
+        QFETCH(int, offset);
+        QFETCH(char, value);
+
+        QByteArray encoded = Telegram::encode(Telegram::TrackCircuit, 1, Telegram::TrackClear, "T1A");
+        encoded[offset] = value;
+
+        Telegram::Frame frame;
+        qsizetype consumed = 0;
+        QCOMPARE(decode(encoded, &frame, &consumed), DecodeResult::Malformed);
+        QCOMPARE(consumed, qsizetype(2));
+    }
+
+    void pointStateRange()
+    {
+        QByteArray encoded = Telegram::encode(Telegram::PointDetection, 1, Telegram::NoDetection, "PM001");
+        Telegram::Frame frame;
+        qsizetype consumed = 0;
+        QCOMPARE(decode(encoded, &frame, &consumed), DecodeResult::Ok);
+
+        encoded[8] = char(Telegram::NoDetection + 1);
+        QCOMPARE(decode(encoded, &frame, &consumed), DecodeResult::Malformed);
+    }
+
+    void resynchronisesAfterGarbage()
+    {
+        QByteArray stream("garbage");
+        stream += Telegram::encode(Telegram::TrackCircuit, 1, Telegram::TrackOccupied, "T1A");
+        stream += "RF\x07";   // magic followed by a bad version
+        stream += Telegram::encode(Telegram::PointDetection, 2, Telegram::DetectedNormal, "PM001");
+        QByteArray tooLong = Telegram::encode(Telegram::TrackCircuit, 3, Telegram::TrackClear, "T2B");
+        tooLong[9] = char(Telegram::kMaxIdLength + 1);
+        stream += tooLong;
+        stream += Telegram::encode(Telegram::TrackCircuit, 4, Telegram::TrackClear, "T3C");
+
+        qsizetype remaining = -1;
+        QCOMPARE(decodeAll(stream, &remaining), QList<QByteArray>({"T1A", "PM001", "T3C"}));
+        QCOMPARE(remaining, qsizetype(0));
+    }
+
+    void partialFrameAtEndIsKept()
+    {
+        const QByteArray first = Telegram::encode(Telegram::TrackCircuit, 1, Telegram::TrackOccupied, "T1A");
+        const QByteArray second = Telegram::encode(Telegram::TrackCircuit, 2, Telegram::TrackClear, "T2B");
+
+        qsizetype remaining = -1;
+        QCOMPARE(decodeAll(first + second.left(6), &remaining), QList<QByteArray>({"T1A"}));
+        QCOMPARE(remaining, qsizetype(6));
+    }
+};
+
+QTEST_APPLESS_MAIN(TelegramTest)
+#include "telegramtest.moc"
@@ -0,0 +1,163 @@
+// Unit tests for TimerWheel: every timer must fire on exactly its due tick,
+// including timers parked on the coarser levels that cascade down when the
+// level below wraps (every 64 and 4096 ticks).
+
+#include <QRandomGenerator>
+#include <QTest>
+
+#include "simulation/timerwheel.h"
+
+namespace {
+using Wheel = TimerWheel<int>;
+
+struct Fired {
+    int payload;
+    quint64 tick;
+    bool operator==(const Fired& other) const { return payload == other.payload && tick == other.tick; }
+};
+
+// Steps one tick at a time so the tick each timer fired on is observable
+QList<Fired> run(Wheel& wheel, quint64 ticks)
+{
+    QList<Fired> fired;
+    for (quint64 i = 0; i < ticks; ++i) {
+        wheel.advance(1, [&](int payload) { fired.append({payload, wheel.now()}); });
+    }
+    return fired;
+}
+}
+
+class TimerWheelTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void firesOnDueTick()
+    {
+        Wheel wheel;
+        wheel.schedule(5, 1);
+        QCOMPARE(wheel.size(), 1);
+        QCOMPARE(run(wheel, 10), QList<Fired>({{1, 5}}));
+        QVERIFY(wheel.isEmpty());
+    }
+
+    void zeroDelayFiresOnNextTick()
+    {
+        Wheel wheel;
+        wheel.schedule(0, 7);
+        QCOMPARE(run(wheel, 1), QList<Fired>({{7, 1}}));
+    }
+
+    void cascadesAtLevelBoundaries_data()
+    {
+        QTest::addColumn<quint64>("start");
+        QTest::addColumn<quint64>("delay");
+
+        const quint64 delays[] = {63, 64, 65, 127, 128, 100, 4095, 4096, 4097, 5000, 8192};
+        const quint64 starts[] = {0, 1, 10, 63, 64, 4000, 4095, 4096};
+        for (quint64 start : starts) {
+            for (quint64 delay : delays) {
+                QTest::addRow("start %llu delay %llu", start, delay) << start << delay;
+            }
+        }
+    }
+
+    void cascadesAtLevelBoundaries()
+    {
+        QFETCH(quint64, start);
+        QFETCH(quint64, delay);
+
+        Wheel wheel;
+        wheel.advance(start, [](int) {});   // empty wheel: jumps straight there
+        QCOMPARE(wheel.now(), start);
+
+        wheel.schedule(delay, 1);
+        const QList<Fired> fired = run(wheel, delay + 1);
+        QCOMPARE(fired, QList<Fired>({{1, start + delay}}));
+    }
+
+    void cancel()
+    {
+        Wheel wheel;
+        const Wheel::Handle first = wheel.schedule(100, 1);
+        wheel.schedule(100, 2);
+
+        QVERIFY(wheel.cancel(first));
+        QVERIFY(!wheel.cancel(first));
+        QVERIFY(!wheel.cancel(Wheel::InvalidHandle));
+        QCOMPARE(wheel.size(), 1);
+
+        // The freed node is reused by the next schedule()
+        QCOMPARE(wheel.schedule(200, 3), first);
+
+        QCOMPARE(run(wheel, 250), QList<Fired>({{2, 100}, {3, 200}}));
+        QVERIFY(wheel.isEmpty());
+    }
+
+    void cancelAfterCascade()
+    {
+        Wheel wheel;
+        const Wheel::Handle handle = wheel.schedule(5000, 1);
+        QVERIFY(run(wheel, 4500).isEmpty());   // cascaded to level 1 by now
+        QVERIFY(wheel.cancel(handle));
+        QVERIFY(run(wheel, 1000).isEmpty());
+        QVERIFY(wheel.isEmpty());
+    }
+
+    void clampsToMaximumDelay()
+    {
+        Wheel wheel;
+        wheel.schedule(Wheel::kMaxDelay + 1000, 1);
+
+        int fired = 0;
+        wheel.advance(Wheel::kMaxDelay - 1, [&](int) { ++fired; });
+        QCOMPARE(fired, 0);
+        wheel.advance(1, [&](int) { ++fired; });
+        QCOMPARE(fired, 1);
+        QCOMPARE(wheel.now(), Wheel::kMaxDelay);
+    }
+
+    // Timers scheduled at random points in time, with random delays across
+    // all four levels, each fire once and exactly on their due tick
+    void randomScheduleFiresOnTime()
+    {
+        QRandomGenerator random(20240611);
+        Wheel wheel;
+        QList<quint64> expected;
+        QList<quint64> firedAt;
+        QList<Wheel::Handle> handles;
+
+        auto onExpired = [&](int payload) {
+            QCOMPARE(firedAt[payload], quint64(0));
+            firedAt[payload] = wheel.now();
+        };
+
+        for (int step = 0; step < 20000; ++step) {
+            const int count = random.bounded(3);
+            for (int i = 0; i < count; ++i) {
+                const quint64 delay = random.bounded(300000);
+                const int payload = expected.size();
+                expected.append(wheel.now() + qMax<quint64>(1, delay));
+                firedAt.append(0);
+                handles.append(wheel.schedule(delay, payload));
+            }
+            // Cancel the odd timer that has not fired yet
+            if (random.bounded(10) == 0 && !handles.isEmpty()) {
+                const int payload = random.bounded(int(handles.size()));
+                if (firedAt[payload] == 0 && expected[payload] > wheel.now()
+                    && wheel.cancel(handles[payload])) {
+                    expected[payload] = 0;
+                }
+            }
+            wheel.advance(1 + random.bounded(8), onExpired);
+        }
+        wheel.advance(300000, onExpired);
+
+        QVERIFY(wheel.isEmpty());
+        for (int payload = 0; payload < expected.size(); ++payload) {
+            QCOMPARE(firedAt[payload], expected[payload]);
+        }
+    }
+};
+
+QTEST_APPLESS_MAIN(TimerWheelTest)
+#include "timerwheeltest.moc"
@@ -0,0 +1,208 @@
+// Unit tests for TrackCircuitDebouncer: occupied passes straight through,
+// clear is only confirmed after the clear delay and the minimum dwell, and a
+// flapping or unqueueable clear never leaves the segment shown clear early.
+
+#include <QTest>
+
+#include "ingestion/trackcircuitdebouncer.h"
+
+namespace {
+// Advances to nowMs and returns the segments whose clear was confirmed;
+// `queued` is what the write queue reports back for each of them
+QList<int> advance(TrackCircuitDebouncer& debouncer, qint64 nowMs, bool queued = true)
+{
+    QList<int> confirmed;
+    debouncer.advance(nowMs, [&](int segment) {
+        confirmed.append(segment);
+        return queued;
+    });
+    return confirmed;
+}
+}
+
+class TrackCircuitDebouncerTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void occupiedIsWrittenImmediately()
+    {
+        TrackCircuitDebouncer debouncer;
+        debouncer.reset(2);
+        debouncer.setDefaults(500, 1000);
+
+        QVERIFY(debouncer.input(0, true, 0));
+        QVERIFY(debouncer.input(0, true, 10));   // repeats are still written
+        QCOMPARE(debouncer.statistics().occupations, qint64(1));
+        QCOMPARE(debouncer.statistics().repeatedOccupations, qint64(1));
+        QVERIFY(!debouncer.hasPending());
+    }
+
+    void clearWaitsForClearDelay()
+    {
+        TrackCircuitDebouncer debouncer;
+        debouncer.reset(1);
+        debouncer.setDefaults(500, 0);
+
+        QVERIFY(debouncer.input(0, true, 0));
+        QVERIFY(!debouncer.input(0, false, 1000));
+        QCOMPARE(debouncer.pendingClears(), 1);
+
+        QVERIFY(advance(debouncer, 1490).isEmpty());
+        QCOMPARE(advance(debouncer, 1500), QList<int>({0}));
+        QCOMPARE(debouncer.statistics().confirmedClears, qint64(1));
+        QVERIFY(!debouncer.hasPending());
+    }
+
+    void clearDelayRoundsUp()
+    {
+        TrackCircuitDebouncer debouncer;
+        debouncer.reset(1);
+        debouncer.setDefaults(500, 0);
+
+        debouncer.input(0, true, 0);
+        debouncer.input(0, false, 105);   // due at 605
+        QVERIFY(advance(debouncer, 600).isEmpty());
+        QCOMPARE(advance(debouncer, 610), QList<int>({0}));
+    }
+
+    void initialClearIsConfirmed()
+    {
+        TrackCircuitDebouncer debouncer;
+        debouncer.reset(1);
+        debouncer.setDefaults(500, 1000);
+
+        // Unknown -> clear: no dwell to respect, only the clear delay
+        QVERIFY(!debouncer.input(0, false, 0));
+        QVERIFY(advance(debouncer, 490).isEmpty());
+        QCOMPARE(advance(debouncer, 500), QList<int>({0}));
+    }
+
+    void clearWaitsForMinimumDwell()
+    {
+        TrackCircuitDebouncer debouncer;
+        debouncer.reset(1);
+        debouncer.setDefaults(100, 1000);
+
+        debouncer.input(0, true, 0);
+        debouncer.input(0, false, 200);   // delay says 300, dwell says 1000
+        QVERIFY(advance(debouncer, 300).isEmpty());
+        QVERIFY(advance(debouncer, 990).isEmpty());
+        QCOMPARE(advance(debouncer, 1000), QList<int>({0}));
+    }
+
+    void occupiedSuppressesPendingClear()
+    {
+        TrackCircuitDebouncer debouncer;
+        debouncer.reset(1);
+        debouncer.setDefaults(500, 0);
+
+        debouncer.input(0, true, 0);
+        debouncer.input(0, false, 100);
+        QVERIFY(debouncer.input(0, true, 300));
+        QCOMPARE(debouncer.statistics().suppressedFlaps, qint64(1));
+        QVERIFY(!debouncer.hasPending());
+
+        // A circuit bobbing faster than the clear delay never writes a clear
+        qint64 now = 300;
+        for (int i = 0; i < 10; ++i) {
+            QVERIFY(!debouncer.input(0, false, now += 100));
+            QVERIFY(advance(debouncer, now).isEmpty());
+            QVERIFY(debouncer.input(0, true, now += 100));
+        }
+        QCOMPARE(debouncer.statistics().suppressedFlaps, qint64(11));
+        QVERIFY(advance(debouncer, 10000).isEmpty());
+        QCOMPARE(debouncer.statistics().confirmedClears, qint64(0));
+    }
+
+    void repeatedClearIsDuplicate()
+    {
+        TrackCircuitDebouncer debouncer;
+        debouncer.reset(1);
+        debouncer.setDefaults(500, 0);
+
+        debouncer.input(0, true, 0);
+        debouncer.input(0, false, 100);
+        debouncer.input(0, false, 200);   // already pending: due time unchanged
+        QCOMPARE(debouncer.statistics().duplicates, qint64(1));
+        QCOMPARE(debouncer.pendingClears(), 1);
+
+        QCOMPARE(advance(debouncer, 600), QList<int>({0}));
+        debouncer.input(0, false, 700);   // already applied
+        QCOMPARE(debouncer.statistics().duplicates, qint64(2));
+        QVERIFY(!debouncer.hasPending());
+    }
+
+    void clearAfterFailedQueueIsConfirmedAgain()
+    {
+        TrackCircuitDebouncer debouncer;
+        debouncer.reset(1);
+        debouncer.setDefaults(100, 0);
+
+        debouncer.input(0, true, 0);
+        debouncer.input(0, false, 100);
+        QCOMPARE(advance(debouncer, 200, false), QList<int>({0}));
+        QCOMPARE(debouncer.statistics().confirmedClears, qint64(0));
+        QVERIFY(!debouncer.hasPending());
+
+        // Still occupied as far as the debouncer knows: not a duplicate
+        QVERIFY(!debouncer.input(0, false, 300));
+        QCOMPARE(debouncer.statistics().duplicates, qint64(0));
+        QCOMPARE(debouncer.pendingClears(), 1);
+        QVERIFY(advance(debouncer, 390).isEmpty());
+        QCOMPARE(advance(debouncer, 400), QList<int>({0}));
+        QCOMPARE(debouncer.statistics().confirmedClears, qint64(1));
+    }
+
+    void occupiedAfterFailedQueueIsWritten()
+    {
+        TrackCircuitDebouncer debouncer;
+        debouncer.reset(1);
+        debouncer.setDefaults(100, 0);
+
+        debouncer.input(0, true, 0);
+        debouncer.input(0, false, 100);
+        QCOMPARE(advance(debouncer, 200, false), QList<int>({0}));
+
+        QVERIFY(debouncer.input(0, true, 250));
+        QCOMPARE(debouncer.statistics().repeatedOccupations, qint64(1));
+        QVERIFY(advance(debouncer, 10000).isEmpty());
+    }
+
+    void perSegmentOverride()
+    {
+        TrackCircuitDebouncer debouncer;
+        debouncer.reset(2);
+        debouncer.setDefaults(500, 0);
+        debouncer.setOverride(1, 2000, -1);
+
+        debouncer.input(0, true, 0);
+        debouncer.input(1, true, 0);
+        debouncer.input(0, false, 100);
+        debouncer.input(1, false, 100);
+
+        QCOMPARE(advance(debouncer, 600), QList<int>({0}));
+        QVERIFY(advance(debouncer, 2090).isEmpty());
+        QCOMPARE(advance(debouncer, 2100), QList<int>({1}));
+    }
+
+    // While a clear is pending the wheel only moves in advance(); a clear
+    // reported in between must still wait its full delay from the report
+    void clearScheduledWhileWheelLags()
+    {
+        TrackCircuitDebouncer debouncer;
+        debouncer.reset(2);
+        debouncer.setDefaults(500, 0);
+
+        debouncer.input(0, true, 0);
+        debouncer.input(1, true, 0);
+        debouncer.input(0, false, 100);   // due at 600
+        debouncer.input(1, false, 400);   // due at 900, wheel still at 100
+
+        QCOMPARE(advance(debouncer, 600), QList<int>({0}));
+        QVERIFY(advance(debouncer, 890).isEmpty());
+        QCOMPARE(advance(debouncer, 900), QList<int>({1}));
+    }
+};
+
+QTEST_APPLESS_MAIN(TrackCircuitDebouncerTest)
+#include "trackcircuitdebouncertest.moc"
@@ -0,0 +1,146 @@
+// Offline decoder for RailFlux binary trace dumps (.rftrace).
+//
+//   railfluxTraceDecode <file.rftrace> [--category NAME] [--event NAME] [--thread N]
+//
+// Prints one line per record: wall-clock time, offset from the first record,
+// writing thread, category and the formatted event.
+
+#include "diagnostics/traceevents.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::string formatEvent(const TraceRecord& record)
+{
+    std::string text(record.text, strnlen(record.text, sizeof(record.text)));
+    std::string out;
+
+    for (const char* p = traceEventFormat(record.event); *p; ++p) {
+        if (p[0] == '{' && p[1] && p[2] == '}') {
+            if (p[1] == 't') {
+                out += text;
+                p += 2;
+                continue;
+            }
+            if (p[1] >= '0' && p[1] <= '2') {
+                out += std::to_string(record.args[p[1] - '0']);
+                p += 2;
+                continue;
+            }
+        }
+        out += *p;
+    }
+
+    return out;
+}
+
+std::string formatWallClock(std::int64_t unixNs)
+{
+    const std::time_t seconds = static_cast<std::time_t>(unixNs / 1000000000LL);
+    std::tm utc{};
+#ifdef _WIN32
+    gmtime_s(&utc, &seconds);
+#else
+    gmtime_r(&seconds, &utc);
+#endif
+    char buffer[32];
+    std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%S", &utc);
+
+    char result[48];
+    std::snprintf(result, sizeof(result), "%s.%06" PRId64 "Z", buffer, static_cast<std::int64_t>((unixNs % 1000000000LL) / 1000));
+    return result;
+}
+
+int usage()
+{
+    std::fprintf(stderr, "usage: railfluxTraceDecode <file.rftrace> [--category NAME] [--event NAME] [--thread N]\n");
+    return 2;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2) {
+        return usage();
+    }
+
+    const char* path = argv[1];
+    std::string categoryFilter;
+    std::string eventFilter;
+    long threadFilter = -1;
+
+    for (int i = 2; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--category") && i + 1 < argc) {
+            categoryFilter = argv[++i];
+        } else if (!std::strcmp(argv[i], "--event") && i + 1 < argc) {
+            eventFilter = argv[++i];
+        } else if (!std::strcmp(argv[i], "--thread") && i + 1 < argc) {
+            threadFilter = std::strtol(argv[++i], nullptr, 10);
+        } else {
+            return usage();
+        }
+    }
+
+    std::FILE* file = std::fopen(path, "rb");
+    if (!file) {
+        std::fprintf(stderr, "cannot open %s\n", path);
+        return 1;
+    }
+
+    TraceFileHeader header{};
+    if (std::fread(&header, sizeof(header), 1, file) != 1
+        || std::memcmp(header.magic, "RFTRACE1", sizeof(header.magic)) != 0) {
+        std::fprintf(stderr, "%s is not a RailFlux trace file\n", path);
+        std::fclose(file);
+        return 1;
+    }
+    if (header.version != 1 || header.recordSize != sizeof(TraceRecord)) {
+        std::fprintf(stderr, "unsupported trace version %u (record size %u)\n", header.version, header.recordSize);
+        std::fclose(file);
+        return 1;
+    }
+
+    std::vector<TraceRecord> records(header.recordCount);
+    const size_t read = std::fread(records.data(), sizeof(TraceRecord), records.size(), file);
+    std::fclose(file);
+    if (read != records.size()) {
+        std::fprintf(stderr, "warning: file truncated, %zu of %" PRIu64 " records\n", read, header.recordCount);
+        records.resize(read);
+    }
+
+    // Crash dumps are written ring by ring
+    std::stable_sort(records.begin(), records.end(), [](const TraceRecord& a, const TraceRecord& b) {
+        return a.timestampNs < b.timestampNs;
+    });
+
+    const std::uint64_t firstNs = records.empty() ? 0 : records.front().timestampNs;
+    std::uint64_t printed = 0;
+
+    for (const TraceRecord& record : records) {
+        const char* category = traceCategoryName(record.category);
+        const char* event = traceEventName(record.event);
+        if (!categoryFilter.empty() && categoryFilter != category) continue;
+        if (!eventFilter.empty() && eventFilter != event) continue;
+        if (threadFilter >= 0 && record.threadIndex != static_cast<std::uint32_t>(threadFilter)) continue;
+
+        const std::int64_t wallNs = header.wallClockAtZeroNs + static_cast<std::int64_t>(record.timestampNs);
+        std::printf("%s %+12.3f ms T%-2u %-8s %s\n",
+                    formatWallClock(wallNs).c_str(),
+                    (record.timestampNs - firstNs) / 1e6,
+                    record.threadIndex,
+                    category,
+                    formatEvent(record).c_str());
+        ++printed;
+    }
+
+    std::fprintf(stderr, "%" PRIu64 " of %zu records\n", printed, records.size());
+    return 0;
+}
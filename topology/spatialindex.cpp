@@ -0,0 +1,258 @@
+#include "spatialindex.h"
+#include "database/databasemanager.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QtMath>
+#include <limits>
+
+SpatialIndex::SpatialIndex(QObject* parent)
+    : QObject(parent)
+{
+}
+
+void SpatialIndex::setSources(DatabaseManager* manager)
+{
+    m_dbManager = manager;
+    if (!m_dbManager) return;
+
+    connect(m_dbManager, &DatabaseManager::connectionStateChanged, this, [this](bool connected) {
+        if (connected && !m_dbManager->isStale()) reload();
+    });
+    // Not TrackTopology::topologyChanged: its fingerprint leaves out signals and labels
+    connect(m_dbManager, &DatabaseManager::activeStationChanged, this, &SpatialIndex::reload);
+    connect(m_dbManager, &DatabaseManager::layoutChanged, this, &SpatialIndex::reload);
+}
+
+void SpatialIndex::reload()
+{
+    if (!m_dbManager || !m_dbManager->isConnected()) {
+        return;
+    }
+    const QVariantMap snapshot = m_dbManager->getStationSnapshot();
+    build(toVariantMaps<TrackSegmentInfo>(snapshot["tracks"].toList()),
+          toVariantMaps<SignalInfo>(snapshot["signals"].toList()),
+          toVariantMaps<PointMachineInfo>(snapshot["pointMachines"].toList()),
+          snapshot["textLabels"].toList());
+}
+
+// ============================================================================
+// BUILD
+// ============================================================================
+
+qint32 SpatialIndex::cellOf(double coordinate)
+{
+    return qFloor(coordinate / kCellSize);
+}
+
+quint64 SpatialIndex::cellKey(qint32 row, qint32 col)
+{
+    return (quint64(quint32(row)) << 32) | quint32(col);
+}
+
+void SpatialIndex::build(const QVariantList& trackSegments, const QVariantList& signalList,
+                         const QVariantList& pointMachines, const QVariantList& textLabels)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    m_elements.clear();
+    m_cells.clear();
+    m_bounds = QRectF();
+    m_minCellRow = m_minCellCol = std::numeric_limits<qint32>::max();
+    m_maxCellRow = m_maxCellCol = std::numeric_limits<qint32>::min();
+    m_elements.reserve(trackSegments.size() + signalList.size() + pointMachines.size() + textLabels.size());
+
+    for (const QVariant& item : trackSegments) {
+        const QVariantMap track = item.toMap();
+        insert({track["id"].toString(), TrackSegment,
+                track["startRow"].toDouble(), track["startCol"].toDouble(),
+                track["endRow"].toDouble(), track["endCol"].toDouble()});
+    }
+
+    for (const QVariant& item : signalList) {
+        const QVariantMap signal = item.toMap();
+        const double row = signal["row"].toDouble();
+        const double col = signal["col"].toDouble();
+        insert({signal["id"].toString(), Signal, row, col, row, col});
+    }
+
+    for (const QVariant& item : pointMachines) {
+        const QVariantMap pm = item.toMap();
+        const QVariantMap junction = pm["junctionPoint"].toMap();
+        const double row = junction["row"].toDouble();
+        const double col = junction["col"].toDouble();
+        insert({pm["id"].toString(), PointMachine, row, col, row, col});
+    }
+
+    for (const QVariant& item : textLabels) {
+        const QVariantMap label = item.toMap();
+        const double row = label["row"].toDouble();
+        const double col = label["col"].toDouble();
+        insert({label["id"].toString(), TextLabel, row, col, row, col});
+    }
+
+    m_visited = QList<quint32>(m_elements.size(), 0);
+    m_queryStamp = 0;
+
+    qDebug() << "🗺️ Spatial index built:" << m_elements.size() << "elements in" << m_cells.size()
+             << "cells (" << timer.elapsed() << "ms )";
+
+    emit indexRebuilt();
+}
+
+void SpatialIndex::insert(const Element& element)
+{
+    const int index = m_elements.size();
+    m_elements.append(element);
+
+    const qint32 rowFrom = cellOf(qMin(element.startRow, element.endRow));
+    const qint32 rowTo = cellOf(qMax(element.startRow, element.endRow));
+    const qint32 colFrom = cellOf(qMin(element.startCol, element.endCol));
+    const qint32 colTo = cellOf(qMax(element.startCol, element.endCol));
+
+    for (qint32 row = rowFrom; row <= rowTo; ++row) {
+        for (qint32 col = colFrom; col <= colTo; ++col) {
+            m_cells[cellKey(row, col)].append(index);
+        }
+    }
+
+    m_minCellRow = qMin(m_minCellRow, rowFrom);
+    m_maxCellRow = qMax(m_maxCellRow, rowTo);
+    m_minCellCol = qMin(m_minCellCol, colFrom);
+    m_maxCellCol = qMax(m_maxCellCol, colTo);
+
+    const QRectF extent(QPointF(qMin(element.startCol, element.endCol), qMin(element.startRow, element.endRow)),
+                        QPointF(qMax(element.startCol, element.endCol), qMax(element.startRow, element.endRow)));
+    m_bounds = m_bounds.isNull() ? extent : m_bounds.united(extent);
+}
+
+// ============================================================================
+// QUERIES
+// ============================================================================
+
+QList<int> SpatialIndex::queryRect(double minRow, double minCol, double maxRow, double maxCol, quint32 typeMask) const
+{
+    QList<int> result;
+    if (m_elements.isEmpty()) return result;
+
+    if (++m_queryStamp == 0) {   // wrapped: reset stamps once every 2^32 queries
+        m_visited.fill(0);
+        m_queryStamp = 1;
+    }
+
+    const qint32 rowFrom = qMax(cellOf(minRow), m_minCellRow);
+    const qint32 rowTo = qMin(cellOf(maxRow), m_maxCellRow);
+    const qint32 colFrom = qMax(cellOf(minCol), m_minCellCol);
+    const qint32 colTo = qMin(cellOf(maxCol), m_maxCellCol);
+
+    for (qint32 row = rowFrom; row <= rowTo; ++row) {
+        for (qint32 col = colFrom; col <= colTo; ++col) {
+            const auto cell = m_cells.constFind(cellKey(row, col));
+            if (cell == m_cells.constEnd()) continue;
+
+            for (int index : *cell) {
+                if (m_visited[index] == m_queryStamp) continue;
+                m_visited[index] = m_queryStamp;
+
+                const Element& e = m_elements[index];
+                if (!(typeMask & (1u << e.type))) continue;
+                if (qMax(e.startRow, e.endRow) < minRow || qMin(e.startRow, e.endRow) > maxRow) continue;
+                if (qMax(e.startCol, e.endCol) < minCol || qMin(e.startCol, e.endCol) > maxCol) continue;
+                result.append(index);
+            }
+        }
+    }
+
+    return result;
+}
+
+double SpatialIndex::distanceTo(const Element& element, double row, double col)
+{
+    const double dRow = element.endRow - element.startRow;
+    const double dCol = element.endCol - element.startCol;
+    const double lengthSquared = dRow * dRow + dCol * dCol;
+
+    double t = 0.0;
+    if (lengthSquared > 0.0) {
+        t = qBound(0.0, ((row - element.startRow) * dRow + (col - element.startCol) * dCol) / lengthSquared, 1.0);
+    }
+
+    const double nearestRow = element.startRow + t * dRow - row;
+    const double nearestCol = element.startCol + t * dCol - col;
+    return qSqrt(nearestRow * nearestRow + nearestCol * nearestCol);
+}
+
+int SpatialIndex::nearest(double row, double col, double maxDistance, quint32 typeMask, double* distance) const
+{
+    if (m_elements.isEmpty()) return -1;
+
+    const qint32 centerRow = cellOf(row);
+    const qint32 centerCol = cellOf(col);
+    const qint32 maxRing = maxDistance >= 0
+        ? qCeil(maxDistance / kCellSize) + 1
+        : qMax(qMax(qAbs(centerRow - m_minCellRow), qAbs(centerRow - m_maxCellRow)),
+               qMax(qAbs(centerCol - m_minCellCol), qAbs(centerCol - m_maxCellCol)));
+
+    int best = -1;
+    double bestDistance = maxDistance >= 0 ? maxDistance : std::numeric_limits<double>::max();
+
+    for (qint32 ring = 0; ring <= maxRing; ++ring) {
+        // Everything in this ring is at least (ring - 1) cells away
+        if (best >= 0 && (ring - 1) * kCellSize > bestDistance) break;
+
+        for (qint32 r = centerRow - ring; r <= centerRow + ring; ++r) {
+            const bool edgeRow = r == centerRow - ring || r == centerRow + ring;
+            const qint32 step = edgeRow ? 1 : 2 * ring;   // interior rows: only the two edge cells
+            for (qint32 c = centerCol - ring; c <= centerCol + ring; c += step) {
+                const auto cell = m_cells.constFind(cellKey(r, c));
+                if (cell == m_cells.constEnd()) continue;
+
+                for (int index : *cell) {
+                    const Element& e = m_elements[index];
+                    if (!(typeMask & (1u << e.type))) continue;
+
+                    const double d = distanceTo(e, row, col);
+                    if (d <= bestDistance && (best < 0 || d < bestDistance)) {
+                        bestDistance = d;
+                        best = index;
+                    }
+                }
+            }
+        }
+    }
+
+    if (distance && best >= 0) *distance = bestDistance;
+    return best;
+}
+
+QString SpatialIndex::typeName(ElementType type)
+{
+    switch (type) {
+    case TrackSegment: return "TRACK_SEGMENT";
+    case Signal: return "SIGNAL";
+    case PointMachine: return "POINT_MACHINE";
+    case TextLabel: return "TEXT_LABEL";
+    default: return "UNKNOWN";
+    }
+}
+
+QVariantList SpatialIndex::elementsInRect(double minRow, double minCol, double maxRow, double maxCol) const
+{
+    QVariantList result;
+    for (int index : queryRect(minRow, minCol, maxRow, maxCol)) {
+        const Element& e = m_elements[index];
+        result.append(QVariantMap{{"type", typeName(e.type)}, {"id", e.id}});
+    }
+    return result;
+}
+
+QVariantMap SpatialIndex::nearestElement(double row, double col, double maxDistance) const
+{
+    double distance = 0.0;
+    const int index = nearest(row, col, maxDistance, AllTypes, &distance);
+    if (index < 0) return QVariantMap();
+
+    const Element& e = m_elements[index];
+    return QVariantMap{{"type", typeName(e.type)}, {"id", e.id}, {"distance", distance}};
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <QObject>
+#include <QHash>
+#include <QList>
+#include <QRectF>
+#include <QString>
+#include <QVariantList>
+#include <QVariantMap>
+
+class DatabaseManager;
+
+// Uniform grid hash over layout coordinates (rows/cols of the station grid).
+//
+// Every element (track segment, signal, point machine, text label) is stored
+// once and referenced from each grid cell its bounding box touches. Rectangle
+// queries visit only the covered cells; nearest-element queries search rings
+// of cells outwards and stop once no closer element can exist. Track
+// segments are measured as line segments, everything else as a point.
+//
+// The server-side counterpart is railway_control.elements_in_box(), backed by
+// GiST box indexes on the same coordinates.
+class SpatialIndex : public QObject {
+    Q_OBJECT
+    Q_PROPERTY(int elementCount READ elementCount NOTIFY indexRebuilt)
+    Q_PROPERTY(QRectF bounds READ bounds NOTIFY indexRebuilt)
+
+public:
+    enum ElementType : quint8 {
+        TrackSegment = 0,
+        Signal,
+        PointMachine,
+        TextLabel,
+        ElementTypeCount
+    };
+    Q_ENUM(ElementType)
+
+    struct Element {
+        QString id;
+        ElementType type = TrackSegment;
+        double startRow = 0, startCol = 0;   // points: start == end
+        double endRow = 0, endCol = 0;
+    };
+
+    static constexpr quint32 AllTypes = (1u << ElementTypeCount) - 1;
+
+    explicit SpatialIndex(QObject* parent = nullptr);
+
+    // Rebuilds on connect, on a station switch and on every layout change
+    void setSources(DatabaseManager* manager);
+
+    void build(const QVariantList& trackSegments, const QVariantList& signalList,
+               const QVariantList& pointMachines, const QVariantList& textLabels);
+
+    int elementCount() const { return m_elements.size(); }
+    const Element& element(int index) const { return m_elements[index]; }
+    // Layout extent in grid units (x = col, y = row)
+    QRectF bounds() const { return m_bounds; }
+
+    // Indices of elements whose bounding box intersects the rectangle
+    QList<int> queryRect(double minRow, double minCol, double maxRow, double maxCol, quint32 typeMask = AllTypes) const;
+    // Closest element within maxDistance grid units (-1 when none)
+    int nearest(double row, double col, double maxDistance, quint32 typeMask = AllTypes, double* distance = nullptr) const;
+
+    // ===== QML API =====
+    Q_INVOKABLE QVariantList elementsInRect(double minRow, double minCol, double maxRow, double maxCol) const;
+    Q_INVOKABLE QVariantMap nearestElement(double row, double col, double maxDistance = 5.0) const;
+    Q_INVOKABLE void reload();
+
+    static QString typeName(ElementType type);
+
+signals:
+    void indexRebuilt();
+
+private:
+    static constexpr double kCellSize = 16.0;   // grid units per index cell
+
+    void insert(const Element& element);
+    static double distanceTo(const Element& element, double row, double col);
+    static qint32 cellOf(double coordinate);
+    static quint64 cellKey(qint32 row, qint32 col);
+
+    DatabaseManager* m_dbManager = nullptr;
+
+    QList<Element> m_elements;
+    QHash<quint64, QList<int>> m_cells;
+    qint32 m_minCellRow = 0, m_maxCellRow = -1;
+    qint32 m_minCellCol = 0, m_maxCellCol = -1;
+    QRectF m_bounds;
+
+    // Per-element visit stamps so multi-cell elements are reported once
+    mutable QList<quint32> m_visited;
+    mutable quint32 m_queryStamp = 0;
+};
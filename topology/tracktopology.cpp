@@ -0,0 +1,455 @@
+#include "tracktopology.h"
+#include "database/databasemanager.h"
+
+#include <QCryptographicHash>
+#include <QDebug>
+#include <QtMath>
+#include <limits>
+
+namespace {
+
+// Generated stations leave 10 cells between consecutive segments of a line,
+// the hand-written one a single cell. Parallel lines are 18+ cells apart.
+const double kMaxJointGap = 12.0;
+// Both ends must face each other (cosine between the outward directions)
+const double kMinJointAlignment = 0.7;
+
+quint64 bucketKey(double row, double col)
+{
+    const qint32 bucketRow = qFloor(row / kMaxJointGap);
+    const qint32 bucketCol = qFloor(col / kMaxJointGap);
+    return (quint64(quint32(bucketRow)) << 32) | quint32(bucketCol);
+}
+
+void appendNumber(QByteArray& out, double value)
+{
+    out += QByteArray::number(value, 'g', 10);
+    out += ',';
+}
+
+} // namespace
+
+TrackTopology::TrackTopology(QObject* parent)
+    : QObject(parent)
+{
+}
+
+void TrackTopology::setDatabaseManager(DatabaseManager* manager)
+{
+    if (m_dbManager) {
+        disconnect(m_dbManager, nullptr, this, nullptr);
+    }
+
+    m_dbManager = manager;
+    if (!m_dbManager) return;
+
+    connect(m_dbManager, &DatabaseManager::connectionStateChanged, this, &TrackTopology::onConnectionStateChanged);
+    connect(m_dbManager, &DatabaseManager::pointMachineUpdated, this, &TrackTopology::onPointMachineUpdated);
+    connect(m_dbManager, &DatabaseManager::fieldInputsApplied, this, &TrackTopology::onFieldInputsApplied);
+    // Interlocking, spatial index and field gateway follow via topologyChanged
+    connect(m_dbManager, &DatabaseManager::activeStationChanged, this, &TrackTopology::reload);
+    connect(m_dbManager, &DatabaseManager::layoutChanged, this, &TrackTopology::reload);
+
+    if (m_dbManager->isConnected()) {
+        reload();
+    }
+}
+
+void TrackTopology::reload()
+{
+    if (!m_dbManager || !m_dbManager->isConnected()) {
+        return;
+    }
+    build(m_dbManager->getTrackSegmentsList(), m_dbManager->getAllPointMachinesList());
+}
+
+void TrackTopology::onConnectionStateChanged(bool connected)
+{
+    // A resumed session replays only the changed rows
+    if (connected && !m_dbManager->isStale()) {
+        reload();
+    }
+}
+
+void TrackTopology::onPointMachineUpdated(const QString& machineId)
+{
+    if (!m_dbManager) return;
+
+    // An unknown point means the layout itself changed
+    if (pointIndex(machineId) < 0) {
+        reload();
+        return;
+    }
+
+    const QVariantMap pointMachine = m_dbManager->getPointMachineById(machineId);
+    if (!pointMachine.isEmpty()) {
+        setPointPosition(machineId, pointMachine["position"].toString());
+    }
+}
+
+void TrackTopology::onFieldInputsApplied(const QVariantList& /*tracks*/, const QVariantList& pointMachines)
+{
+    // Field inputs only touch known elements; the detected position comes with the batch
+    for (const QVariant& value : pointMachines) {
+        const QVariantMap pointMachine = value.toMap();
+        setPointPosition(pointMachine["id"].toString(), pointMachine["position"].toString());
+    }
+}
+
+// ============================================================================
+// BUILD
+// ============================================================================
+
+bool TrackTopology::build(const QVariantList& trackSegments, const QVariantList& pointMachines)
+{
+    const QByteArray fingerprint = geometryFingerprint(trackSegments, pointMachines);
+
+    if (fingerprint == m_fingerprint) {
+        // Same layout version: only the positions can have moved
+        for (const QVariant& item : pointMachines) {
+            const QVariantMap pm = item.toMap();
+            setPointPosition(pm["id"].toString(), pm["position"].toString());
+        }
+        return false;
+    }
+
+    m_segments.clear();
+    m_points.clear();
+    m_segmentIndex.clear();
+    m_pointIndex.clear();
+
+    m_segments.reserve(trackSegments.size());
+    m_segmentIndex.reserve(trackSegments.size());
+    for (const QVariant& item : trackSegments) {
+        const QVariantMap track = item.toMap();
+        const QString id = track["id"].toString();
+        if (m_segmentIndex.contains(id)) {
+            qWarning() << "⚠️ Topology: duplicate track segment" << id;
+            continue;
+        }
+
+        Segment segment;
+        segment.id = id;
+        segment.startRow = track["startRow"].toDouble();
+        segment.startCol = track["startCol"].toDouble();
+        segment.endRow = track["endRow"].toDouble();
+        segment.endCol = track["endCol"].toDouble();
+
+        m_segmentIndex.insert(id, m_segments.size());
+        m_segments.append(segment);
+    }
+
+    // Ends used by a point are never plain joints
+    QList<bool> claimed(m_segments.size() * 2, false);
+
+    m_points.reserve(pointMachines.size());
+    m_pointIndex.reserve(pointMachines.size());
+    for (const QVariant& item : pointMachines) {
+        const QVariantMap pm = item.toMap();
+        const QString id = pm["id"].toString();
+        if (m_pointIndex.contains(id)) {
+            qWarning() << "⚠️ Topology: duplicate point machine" << id;
+            continue;
+        }
+
+        Point point;
+        point.id = id;
+        point.junctionRow = pm["junctionPoint"].toMap()["row"].toDouble();
+        point.junctionCol = pm["junctionPoint"].toMap()["col"].toDouble();
+        point.root = parseBranch(pm["rootTrack"].toMap());
+        point.normal = parseBranch(pm["normalTrack"].toMap());
+        point.reverse = parseBranch(pm["reverseTrack"].toMap());
+        point.position = parsePosition(pm["position"].toString());
+
+        if (!point.root.track.isValid() || !point.normal.track.isValid() || !point.reverse.track.isValid()) {
+            qWarning() << "⚠️ Topology: point machine" << id << "references an unknown track segment";
+        }
+
+        for (const Branch* branch : {&point.root, &point.normal, &point.reverse}) {
+            if (branch->track.isValid()) {
+                claimed[branch->track.segment * 2 + branch->track.end] = true;
+            }
+        }
+
+        m_pointIndex.insert(id, m_points.size());
+        m_points.append(point);
+        linkPoint(m_points.size() - 1);
+    }
+
+    linkPlainJoints(claimed);
+
+    m_fingerprint = fingerprint;
+    ++m_layoutVersion;
+
+    qDebug() << "🧭 Topology built:" << m_segments.size() << "segments," << m_points.size()
+             << "points (layout version" << m_layoutVersion << ")";
+
+    emit topologyChanged();
+    return true;
+}
+
+TrackTopology::Branch TrackTopology::parseBranch(const QVariantMap& connection) const
+{
+    Branch branch;
+    branch.track.segment = segmentIndex(connection["trackId"].toString());
+    branch.track.end = connection["connectionEnd"].toString() == "START" ? AtStart : AtEnd;
+
+    const QVariantMap offset = connection["offset"].toMap();
+    branch.offsetRow = offset["row"].toDouble();
+    branch.offsetCol = offset["col"].toDouble();
+    return branch;
+}
+
+void TrackTopology::linkPoint(int pointIndex)
+{
+    const Point& point = m_points[pointIndex];
+    const Endpoint root = point.root.track;
+    if (!root.isValid()) return;
+
+    auto linkBranch = [&](const Endpoint& branch, PointPosition position) {
+        if (!branch.isValid()) return;
+        m_segments[root.segment].links[root.end].append({branch, pointIndex, position});
+        m_segments[branch.segment].links[branch.end].append({root, pointIndex, position});
+    };
+
+    linkBranch(point.normal.track, Normal);
+    linkBranch(point.reverse.track, Reverse);
+}
+
+void TrackTopology::linkPlainJoints(const QList<bool>& claimed)
+{
+    const int endCount = m_segments.size() * 2;
+
+    auto position = [&](int code, double& row, double& col) {
+        const Segment& segment = m_segments[code / 2];
+        row = (code & 1) ? segment.endRow : segment.startRow;
+        col = (code & 1) ? segment.endCol : segment.startCol;
+    };
+
+    // Unit vector pointing away from the segment at this end
+    auto outward = [&](int code, double& dRow, double& dCol) {
+        const Segment& segment = m_segments[code / 2];
+        dRow = segment.endRow - segment.startRow;
+        dCol = segment.endCol - segment.startCol;
+        if (!(code & 1)) {
+            dRow = -dRow;
+            dCol = -dCol;
+        }
+        const double length = qSqrt(dRow * dRow + dCol * dCol);
+        if (length > 0) {
+            dRow /= length;
+            dCol /= length;
+        }
+    };
+
+    QHash<quint64, QVarLengthArray<int, 4>> buckets;
+    buckets.reserve(endCount);
+    for (int code = 0; code < endCount; ++code) {
+        if (claimed[code]) continue;
+        double row, col;
+        position(code, row, col);
+        buckets[bucketKey(row, col)].append(code);
+    }
+
+    // Nearest facing partner of every free end
+    QList<int> partner(endCount, -1);
+    for (int code = 0; code < endCount; ++code) {
+        if (claimed[code]) continue;
+
+        double row, col, dRow, dCol;
+        position(code, row, col);
+        outward(code, dRow, dCol);
+
+        const qint32 bucketRow = qFloor(row / kMaxJointGap);
+        const qint32 bucketCol = qFloor(col / kMaxJointGap);
+        double bestDistance = std::numeric_limits<double>::max();
+
+        for (int r = bucketRow - 1; r <= bucketRow + 1; ++r) {
+            for (int c = bucketCol - 1; c <= bucketCol + 1; ++c) {
+                const auto it = buckets.constFind((quint64(quint32(r)) << 32) | quint32(c));
+                if (it == buckets.constEnd()) continue;
+
+                for (int other : *it) {
+                    if (other / 2 == code / 2) continue;
+
+                    double otherRow, otherCol, otherDRow, otherDCol;
+                    position(other, otherRow, otherCol);
+                    outward(other, otherDRow, otherDCol);
+
+                    const double gapRow = otherRow - row;
+                    const double gapCol = otherCol - col;
+                    const double distance = qSqrt(gapRow * gapRow + gapCol * gapCol);
+                    if (distance > kMaxJointGap || distance >= bestDistance) continue;
+                    if (-(dRow * otherDRow + dCol * otherDCol) < kMinJointAlignment) continue;
+                    if (distance > 0 && (gapRow * dRow + gapCol * dCol) <= 0) continue;
+
+                    bestDistance = distance;
+                    partner[code] = other;
+                }
+            }
+        }
+    }
+
+    for (int code = 0; code < endCount; ++code) {
+        const int other = partner[code];
+        if (other < code || partner[other] != code) continue;
+
+        const Endpoint a{code / 2, TrackEnd(code & 1)};
+        const Endpoint b{other / 2, TrackEnd(other & 1)};
+        m_segments[a.segment].links[a.end].append({b, -1, Normal});
+        m_segments[b.segment].links[b.end].append({a, -1, Normal});
+    }
+}
+
+QByteArray TrackTopology::geometryFingerprint(const QVariantList& trackSegments, const QVariantList& pointMachines)
+{
+    // Everything that shapes the graph; positions and occupancy are excluded
+    QByteArray data;
+    data.reserve(trackSegments.size() * 48 + pointMachines.size() * 160);
+
+    for (const QVariant& item : trackSegments) {
+        const QVariantMap track = item.toMap();
+        data += track["id"].toString().toUtf8() + ':';
+        appendNumber(data, track["startRow"].toDouble());
+        appendNumber(data, track["startCol"].toDouble());
+        appendNumber(data, track["endRow"].toDouble());
+        appendNumber(data, track["endCol"].toDouble());
+    }
+
+    for (const QVariant& item : pointMachines) {
+        const QVariantMap pm = item.toMap();
+        data += pm["id"].toString().toUtf8() + ':';
+        appendNumber(data, pm["junctionPoint"].toMap()["row"].toDouble());
+        appendNumber(data, pm["junctionPoint"].toMap()["col"].toDouble());
+        for (const char* key : {"rootTrack", "normalTrack", "reverseTrack"}) {
+            const QVariantMap connection = pm[QLatin1String(key)].toMap();
+            data += connection["trackId"].toString().toUtf8() + '/' + connection["connectionEnd"].toString().toUtf8() + '/';
+            appendNumber(data, connection["offset"].toMap()["row"].toDouble());
+            appendNumber(data, connection["offset"].toMap()["col"].toDouble());
+        }
+    }
+
+    return QCryptographicHash::hash(data, QCryptographicHash::Sha1);
+}
+
+TrackTopology::PointPosition TrackTopology::parsePosition(const QString& position, bool* ok)
+{
+    if (ok) *ok = position == "NORMAL" || position == "REVERSE";
+    return position == "REVERSE" ? Reverse : Normal;
+}
+
+bool TrackTopology::setPointPosition(const QString& machineId, const QString& position)
+{
+    const int index = pointIndex(machineId);
+    bool ok = false;
+    const PointPosition parsed = parsePosition(position, &ok);
+    if (index < 0 || !ok || m_points[index].position == parsed) {
+        return false;
+    }
+
+    m_points[index].position = parsed;
+    emit pointPositionChanged(machineId);
+    return true;
+}
+
+// ============================================================================
+// QUERIES
+// ============================================================================
+
+QVarLengthArray<TrackTopology::Endpoint, 2> TrackTopology::connectedNeighbours(int segment, TrackEnd end) const
+{
+    QVarLengthArray<Endpoint, 2> result;
+    for (const Link& link : m_segments[segment].links[end]) {
+        if (link.point < 0 || m_points[link.point].position == link.position) {
+            result.append(link.to);
+        }
+    }
+    return result;
+}
+
+const TrackTopology::Branch& TrackTopology::activeBranch(int point) const
+{
+    const Point& p = m_points[point];
+    return p.position == Normal ? p.normal : p.reverse;
+}
+
+QVariantMap TrackTopology::endpointToVariant(const Endpoint& endpoint) const
+{
+    QVariantMap result;
+    if (!endpoint.isValid()) return result;
+
+    const Segment& segment = m_segments[endpoint.segment];
+    result["row"] = endpoint.end == AtStart ? segment.startRow : segment.endRow;
+    result["col"] = endpoint.end == AtStart ? segment.startCol : segment.endCol;
+    return result;
+}
+
+QVariantMap TrackTopology::trackEndpoint(const QString& segmentId, const QString& connectionEnd) const
+{
+    return endpointToVariant({segmentIndex(segmentId), connectionEnd == "START" ? AtStart : AtEnd});
+}
+
+QVariantMap TrackTopology::segmentEndpoints(const QString& segmentId) const
+{
+    QVariantMap result;
+    const int index = segmentIndex(segmentId);
+    if (index < 0) return result;
+
+    const Segment& segment = m_segments[index];
+    result["startRow"] = segment.startRow;
+    result["startCol"] = segment.startCol;
+    result["endRow"] = segment.endRow;
+    result["endCol"] = segment.endCol;
+    return result;
+}
+
+QStringList TrackTopology::neighbours(const QString& segmentId) const
+{
+    QStringList result;
+    const int index = segmentIndex(segmentId);
+    if (index < 0) return result;
+
+    for (TrackEnd end : {AtStart, AtEnd}) {
+        for (const Endpoint& neighbour : connectedNeighbours(index, end)) {
+            result.append(m_segments[neighbour.segment].id);
+        }
+    }
+    return result;
+}
+
+QString TrackTopology::activeTrack(const QString& machineId) const
+{
+    const int index = pointIndex(machineId);
+    if (index < 0) return QString();
+
+    const Endpoint& track = activeBranch(index).track;
+    return track.isValid() ? m_segments[track.segment].id : QString();
+}
+
+QVariantMap TrackTopology::pointConnection(const QString& machineId) const
+{
+    QVariantMap result;
+    const int index = pointIndex(machineId);
+    if (index < 0) return result;
+
+    const Point& point = m_points[index];
+    const Branch& active = activeBranch(index);
+
+    // Endpoints include the branch offsets, ready to draw from the junction
+    auto branchEnd = [&](const Branch& branch) {
+        QVariantMap end = endpointToVariant(branch.track);
+        if (!end.isEmpty()) {
+            end["row"] = end["row"].toDouble() + branch.offsetRow;
+            end["col"] = end["col"].toDouble() + branch.offsetCol;
+        }
+        return end;
+    };
+
+    result["id"] = point.id;
+    result["position"] = point.position == Normal ? "NORMAL" : "REVERSE";
+    result["rootTrackId"] = point.root.track.isValid() ? m_segments[point.root.track.segment].id : QString();
+    result["activeTrackId"] = active.track.isValid() ? m_segments[active.track.segment].id : QString();
+    result["rootEndpoint"] = branchEnd(point.root);
+    result["activeEndpoint"] = branchEnd(active);
+    return result;
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <QObject>
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QVarLengthArray>
+#include <QVariantList>
+#include <QVariantMap>
+
+class DatabaseManager;
+
+// Track topology graph, built once per layout version.
+//
+// Track segments are nodes with two ends (START/END). Ends are joined either
+// by a plain joint (the next segment along the line) or through a point
+// machine, which is a switchable edge: root <-> normal in NORMAL position,
+// root <-> reverse in REVERSE position. All lookups are hash or index based,
+// so neighbour, endpoint and "where does this point lead now" queries are
+// constant time. Point throws only update the stored position.
+class TrackTopology : public QObject {
+    Q_OBJECT
+    Q_PROPERTY(int layoutVersion READ layoutVersion NOTIFY topologyChanged)
+    Q_PROPERTY(int segmentCount READ segmentCount NOTIFY topologyChanged)
+    Q_PROPERTY(int pointCount READ pointCount NOTIFY topologyChanged)
+
+public:
+    enum TrackEnd : quint8 { AtStart = 0, AtEnd = 1 };
+    enum PointPosition : quint8 { Normal = 0, Reverse = 1 };
+
+    struct Endpoint {
+        int segment = -1;
+        TrackEnd end = AtStart;
+        bool isValid() const { return segment >= 0; }
+    };
+
+    // point < 0: plain joint, always connected
+    struct Link {
+        Endpoint to;
+        int point = -1;
+        PointPosition position = Normal;   // position the point must lie in
+    };
+
+    struct Segment {
+        QString id;
+        double startRow = 0, startCol = 0;
+        double endRow = 0, endCol = 0;
+        QVarLengthArray<Link, 2> links[2];   // indexed by TrackEnd
+    };
+
+    struct Branch {
+        Endpoint track;
+        double offsetRow = 0, offsetCol = 0;
+    };
+
+    struct Point {
+        QString id;
+        double junctionRow = 0, junctionCol = 0;
+        Branch root, normal, reverse;
+        PointPosition position = Normal;
+    };
+
+    explicit TrackTopology(QObject* parent = nullptr);
+
+    // Follows layout loads and point throws reported by the manager
+    void setDatabaseManager(DatabaseManager* manager);
+
+    // Rebuilds the graph when the geometry differs from the current version;
+    // otherwise only point positions are refreshed. Returns true on a rebuild.
+    bool build(const QVariantList& trackSegments, const QVariantList& pointMachines);
+    bool setPointPosition(const QString& machineId, const QString& position);
+
+    // ===== C++ API =====
+    int layoutVersion() const { return m_layoutVersion; }
+    int segmentCount() const { return m_segments.size(); }
+    int pointCount() const { return m_points.size(); }
+
+    int segmentIndex(const QString& segmentId) const { return m_segmentIndex.value(segmentId, -1); }
+    int pointIndex(const QString& machineId) const { return m_pointIndex.value(machineId, -1); }
+    const Segment& segment(int index) const { return m_segments[index]; }
+    const Point& point(int index) const { return m_points[index]; }
+
+    // Ends reachable from one end of a segment with the points as they lie now
+    QVarLengthArray<Endpoint, 2> connectedNeighbours(int segment, TrackEnd end) const;
+    // Branch the point's root currently leads to
+    const Branch& activeBranch(int point) const;
+
+    // ===== QML API =====
+    Q_INVOKABLE QVariantMap trackEndpoint(const QString& segmentId, const QString& connectionEnd) const;
+    Q_INVOKABLE QVariantMap segmentEndpoints(const QString& segmentId) const;
+    Q_INVOKABLE QStringList neighbours(const QString& segmentId) const;
+    Q_INVOKABLE QString activeTrack(const QString& machineId) const;
+    Q_INVOKABLE QVariantMap pointConnection(const QString& machineId) const;
+    Q_INVOKABLE void reload();
+
+signals:
+    void topologyChanged();
+    void pointPositionChanged(const QString& machineId);
+
+private slots:
+    void onConnectionStateChanged(bool connected);
+    void onPointMachineUpdated(const QString& machineId);
+    void onFieldInputsApplied(const QVariantList& tracks, const QVariantList& pointMachines);
+
+private:
+    static QByteArray geometryFingerprint(const QVariantList& trackSegments, const QVariantList& pointMachines);
+    static PointPosition parsePosition(const QString& position, bool* ok = nullptr);
+
+    Branch parseBranch(const QVariantMap& connection) const;
+    void linkPlainJoints(const QList<bool>& claimed);
+    void linkPoint(int pointIndex);
+
+    QVariantMap endpointToVariant(const Endpoint& endpoint) const;
+
+    DatabaseManager* m_dbManager = nullptr;
+
+    QList<Segment> m_segments;
+    QList<Point> m_points;
+    QHash<QString, int> m_segmentIndex;
+    QHash<QString, int> m_pointIndex;
+
+    QByteArray m_fingerprint;
+    int m_layoutVersion = 0;
+};